@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdint.h>
+#include <inttypes.h>
 #include <assert.h>
 
 #include <sstream>
@@ -37,7 +38,9 @@
 
 #include "Camera.h"
 
-#include "test.h"
+#include "compute_backend.h"
+#include "test_cpu.h"
+#include "task_scheduler.h"
 #include "split_operations.h"
 #include "join_operations.h"
 #include "move_operations.h"
@@ -47,17 +50,22 @@
 #include "obj_helper.h"
 
 #include "mesh_cluster.h"
+#include "cluster_archive.h"
+#include "cluster_chunk_reader.h"
+#include "cluster_pages.h"
+#include "cluster_store.h"
+#include "spatial_index.h"
 #include "test_raster.h"
 #include "test_cluster_streaming.h"
 
 #include "boundary_operations.h"
 #include "simplify_operations.h"
 #include "metis_operations.h"
-#include "system_command.h"
 #include "cleanup_operations.h"
 
 #include "obj_helper.h"
 
+#include "adjacency_operations.h"
 #include "adjacency_operations_cuda.h"
 
 uint64_t giTotalVertexPositionDataOffset = 0;
@@ -85,16 +93,11 @@ void buildClusterGroups(
     std::vector<std::vector<uint32_t>>& aaiClusterGroupTriangleNormalIndices,
     std::vector<std::vector<uint32_t>>& aaiClusterGroupTriangleUVIndices,
     std::vector<uint32_t>& aiClusterGroupMap,
-    std::vector<std::vector<float3>> const& aaClusterVertexPositions,
-    std::vector<std::vector<float3>> const& aaClusterVertexNormals,
-    std::vector<std::vector<float2>> const& aaClusterVertexUVs,
-    std::vector<std::vector<uint32_t>> const& aaiClusterTrianglePositionIndices,
-    std::vector<std::vector<uint32_t>> const& aaiClusterTriangleNormalIndices,
-    std::vector<std::vector<uint32_t>> const& aaiClusterTriangleUVIndices,
+    ClusterStore const& clusters,
     uint32_t iNumClusterGroups,
     uint32_t iNumClusters,
     uint32_t iLODLevel,
-    std::string const& meshClusterOutputName,
+    std::vector<uint32_t> const& aiClusterGroups,
     std::string const& homeDirectory,
     std::string const& meshModelName);
 
@@ -120,6 +123,43 @@ int main(int argc, char* argv[])
 
     std::string objMeshModelName = argv[1];
 
+    // compute backend, "-cpu" or "-cuda" to override the default, "-benchmark" to time the backends first
+    //      "-surface-error" measures cluster error as the distance to the LOD 0 surface instead of the closest LOD 0 vertex
+    //      "-pages" adds streaming pages of compressed vertices to the archive, "-page-size <bytes>" sets their size
+    ComputeBackendType computeBackendType = getDefaultComputeBackendType();
+    bool bSurfaceError = false;
+    bool bExportPages = false;
+    uint32_t iPageSize = MESH_CLUSTER_PAGE_SIZE;
+    for(int32_t iArg = 2; iArg < argc; iArg++)
+    {
+        if(strcmp(argv[iArg], "-cpu") == 0)
+        {
+            computeBackendType = COMPUTE_BACKEND_CPU;
+        }
+        else if(strcmp(argv[iArg], "-cuda") == 0)
+        {
+            computeBackendType = COMPUTE_BACKEND_CUDA;
+        }
+        else if(strcmp(argv[iArg], "-benchmark") == 0)
+        {
+            benchmarkComputeBackends(1024);
+        }
+        else if(strcmp(argv[iArg], "-surface-error") == 0)
+        {
+            bSurfaceError = true;
+        }
+        else if(strcmp(argv[iArg], "-pages") == 0)
+        {
+            bExportPages = true;
+        }
+        else if(strcmp(argv[iArg], "-page-size") == 0 && iArg + 1 < argc)
+        {
+            bExportPages = true;
+            iPageSize = static_cast<uint32_t>(strtoul(argv[++iArg], nullptr, 10));
+        }
+    }
+    setComputeBackend(computeBackendType);
+
     // load initial mesh file
     //std::string fullOBJFilePath = homeDirectory + "face-meshlet-test.obj";
     //std::string fullOBJFilePath = homeDirectory + "guan-yu-5-meshlet-test.obj";
@@ -202,278 +242,236 @@ int main(int argc, char* argv[])
     // generate initial clusters
     uint32_t iNumClusters = uint32_t(ceilf(float(aiTrianglePositionIndices.size()) / 3.0f) / kiMaxTrianglesPerCluster);
     uint32_t iNumClusterGroups = iNumClusters / 4;
-    std::vector<std::vector<float3>> aaClusterVertexPositions(iNumClusters);
-    std::vector<std::vector<float3>> aaClusterVertexNormals(iNumClusters);
-    std::vector<std::vector<float2>> aaClusterVertexUVs(iNumClusters);
-    std::vector<std::vector<uint32_t>> aaiClusterTrianglePositionIndices(iNumClusters);
-    std::vector<std::vector<uint32_t>> aaiClusterTriangleNormalIndices(iNumClusters);
-    std::vector<std::vector<uint32_t>> aaiClusterTriangleUVIndices(iNumClusters);
+    ClusterStore clusters;
     {
-        std::ostringstream outputMetisMeshFolderPath;
+        std::vector<std::vector<float3>> aaClusterVertexPositions(iNumClusters);
+        std::vector<std::vector<float3>> aaClusterVertexNormals(iNumClusters);
+        std::vector<std::vector<float2>> aaClusterVertexUVs(iNumClusters);
+        std::vector<std::vector<uint32_t>> aaiClusterTrianglePositionIndices(iNumClusters);
+        std::vector<std::vector<uint32_t>> aaiClusterTriangleNormalIndices(iNumClusters);
+        std::vector<std::vector<uint32_t>> aaiClusterTriangleUVIndices(iNumClusters);
         {
-            outputMetisMeshFolderPath << homeDirectory << "metis\\" << meshModelName << "\\";
-
-            std::filesystem::path outputMetisMeshFolderFileSystemPath(outputMetisMeshFolderPath.str());
-            if(!std::filesystem::exists(outputMetisMeshFolderFileSystemPath))
-            {
-                std::filesystem::create_directory(outputMetisMeshFolderFileSystemPath);
-            }
-        }
-
-        std::ostringstream outputMetisMeshFilePath;
-        outputMetisMeshFilePath << outputMetisMeshFolderPath.str() << "output";
-        outputMetisMeshFilePath << "-lod" << 0 << ".mesh";
+            assert(iNumClusters > 0);
 
 auto start = std::chrono::high_resolution_clock::now();
 
-        buildMETISMeshFile2(
-            outputMetisMeshFilePath.str(),
-            aiTrianglePositionIndices);
+            // partition the triangles into the initial clusters, same settings as mpmetis -gtype=dual -ncommon=2 -objtype=vol -contig
+            std::vector<uint32_t> aiClusters;
+            bool bPartitioned = partitionMETISMesh(
+                aiClusters,
+                aiTrianglePositionIndices,
+                iNumClusters,
+                true,
+                true,
+                -1);
+            assert(bPartitioned);
 
 auto end = std::chrono::high_resolution_clock::now();
 uint64_t iSeconds = std::chrono::duration_cast<std::chrono::seconds>(end - start).count();
-DEBUG_PRINTF("%lld seconds to build cluster Metis mesh file\n", iSeconds);
-
-
-        assert(iNumClusters > 0);
-
-        // exec the mpmetis to generate the initial clusters
-        std::ostringstream metisCommand;
-        metisCommand << "D:\\test\\METIS\\build\\windows\\programs\\Debug\\mpmetis.exe ";
-        metisCommand << outputMetisMeshFilePath.str() << " ";
-        metisCommand << "-gtype=dual ";
-        metisCommand << "-ncommon=2 ";
-        metisCommand << "-objtype=vol ";
-        //metisCommand << "-ufactor=100 ";
-        metisCommand << "-contig ";
-        //metisCommand << "-minconn ";
-        //metisCommand << "-niter=20 ";
-        metisCommand << iNumClusters;
-        std::string result = execCommand(metisCommand.str(), false);
-        if(result.find("Metis returned with an error.") != std::string::npos)
-        {
-            metisCommand = std::ostringstream();
-            metisCommand << "D:\\test\\METIS\\build\\windows\\programs\\Debug\\mpmetis.exe ";
-            metisCommand << outputMetisMeshFilePath.str() << " ";
-            metisCommand << "-gtype=dual ";
-            metisCommand << "-ncommon=2 ";
-            metisCommand << "-objtype=vol ";
-            metisCommand << iNumClusters;
-            std::string result = execCommand(metisCommand.str(), false);
-
-            assert(result.find("Metis returned with an error.") == std::string::npos);
-        }
+DEBUG_PRINTF("%" PRIu64 " seconds to partition mesh into clusters\n", iSeconds);
 
-        // create clusters based on the partition files from the above metis command
-        std::ostringstream outputPartitionFilePath;
-        //outputPartitionFilePath << "c:\\Users\\Dingwings\\demo-models\\metis\\output.mesh.epart.";
-        outputPartitionFilePath << outputMetisMeshFilePath.str() << ".epart.";
-        outputPartitionFilePath << iNumClusters;
-        
 start = std::chrono::high_resolution_clock::now();
 
-        // map of element index to cluster
-        std::map<uint32_t, std::vector<uint32_t>> aClusterMap;
-        {
-            std::vector<uint32_t> aiClusters;
-            readMetisClusterFile(aiClusters, outputPartitionFilePath.str());
-            for(uint32_t i = 0; i < static_cast<uint32_t>(aiClusters.size()); i++)
+            // map of element index to cluster
+            std::map<uint32_t, std::vector<uint32_t>> aClusterMap;
             {
-                uint32_t const& iCluster = aiClusters[i];
-                aClusterMap[iCluster].push_back(i);
+                for(uint32_t i = 0; i < static_cast<uint32_t>(aiClusters.size()); i++)
+                {
+                    uint32_t const& iCluster = aiClusters[i];
+                    aClusterMap[iCluster].push_back(i);
+                }
             }
-        }
-        for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
-        {
-            outputMeshClusters2(
-                aaClusterVertexPositions[iCluster],
-                aaClusterVertexNormals[iCluster],
-                aaClusterVertexUVs[iCluster],
-                aaiClusterTrianglePositionIndices[iCluster],
-                aaiClusterTriangleNormalIndices[iCluster],
-                aaiClusterTriangleUVIndices[iCluster],
-                aClusterMap[iCluster],
-                aVertexPositions,
-                aVertexNormals,
-                aVertexTexCoords,
-                aiTrianglePositionIndices,
-                aiTriangleNormalIndices,
-                aiTriangleTexCoordIndices,
-                0,
-                iCluster);
-            assert(aaiClusterTrianglePositionIndices[iCluster].size() % 3 == 0);
-            assert(aaiClusterTriangleNormalIndices[iCluster].size() % 3 == 0);
-            assert(aaiClusterTriangleUVIndices[iCluster].size() % 3 == 0);
+            for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
+            {
+                outputMeshClusters2(
+                    aaClusterVertexPositions[iCluster],
+                    aaClusterVertexNormals[iCluster],
+                    aaClusterVertexUVs[iCluster],
+                    aaiClusterTrianglePositionIndices[iCluster],
+                    aaiClusterTriangleNormalIndices[iCluster],
+                    aaiClusterTriangleUVIndices[iCluster],
+                    aClusterMap[iCluster],
+                    aVertexPositions,
+                    aVertexNormals,
+                    aVertexTexCoords,
+                    aiTrianglePositionIndices,
+                    aiTriangleNormalIndices,
+                    aiTriangleTexCoordIndices,
+                    0,
+                    iCluster);
+                assert(aaiClusterTrianglePositionIndices[iCluster].size() % 3 == 0);
+                assert(aaiClusterTriangleNormalIndices[iCluster].size() % 3 == 0);
+                assert(aaiClusterTriangleUVIndices[iCluster].size() % 3 == 0);
 
-            assert(aaiClusterTrianglePositionIndices[iCluster].size() == aaiClusterTriangleNormalIndices[iCluster].size());
-            assert(aaiClusterTrianglePositionIndices[iCluster].size() == aaiClusterTriangleUVIndices[iCluster].size());
-        }
+                assert(aaiClusterTrianglePositionIndices[iCluster].size() == aaiClusterTriangleNormalIndices[iCluster].size());
+                assert(aaiClusterTrianglePositionIndices[iCluster].size() == aaiClusterTriangleUVIndices[iCluster].size());
+            }
 end = std::chrono::high_resolution_clock::now();
 iSeconds = std::chrono::duration_cast<std::chrono::seconds>(end - start).count();
-DEBUG_PRINTF("%lld seconds to build clusters\n", iSeconds);
-    }
+DEBUG_PRINTF("%" PRIu64 " seconds to build clusters\n", iSeconds);
+        }
 
-    // check cluster validity
-    {
-        for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
+        // check cluster validity
         {
-            bool bRestart = false;
-            int32_t iNumClusterTri = static_cast<int32_t>(aaiClusterTrianglePositionIndices[iCluster].size());
-            for(int32_t iTri = 0; iTri < iNumClusterTri; iTri += 3)
+            for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
             {
-                if(bRestart)
+                bool bRestart = false;
+                int32_t iNumClusterTri = static_cast<int32_t>(aaiClusterTrianglePositionIndices[iCluster].size());
+                for(int32_t iTri = 0; iTri < iNumClusterTri; iTri += 3)
                 {
-                    iTri = 0;
-                    bRestart = false;
-                }
+                    if(bRestart)
+                    {
+                        iTri = 0;
+                        bRestart = false;
+                    }
 
-                uint32_t iPos0 = aaiClusterTrianglePositionIndices[iCluster][iTri];
-                uint32_t iPos1 = aaiClusterTrianglePositionIndices[iCluster][iTri + 1];
-                uint32_t iPos2 = aaiClusterTrianglePositionIndices[iCluster][iTri + 2];
+                    uint32_t iPos0 = aaiClusterTrianglePositionIndices[iCluster][iTri];
+                    uint32_t iPos1 = aaiClusterTrianglePositionIndices[iCluster][iTri + 1];
+                    uint32_t iPos2 = aaiClusterTrianglePositionIndices[iCluster][iTri + 2];
 
-                if(iPos0 == iPos1 || iPos0 == iPos2 || iPos1 == iPos2)
-                {
-                    aaiClusterTrianglePositionIndices[iCluster].erase(aaiClusterTrianglePositionIndices[iCluster].begin() + iTri, aaiClusterTrianglePositionIndices[iCluster].begin() + iTri + 3);
-                    aaiClusterTriangleNormalIndices[iCluster].erase(aaiClusterTriangleNormalIndices[iCluster].begin() + iTri, aaiClusterTriangleNormalIndices[iCluster].begin() + iTri + 3);
-                    aaiClusterTriangleUVIndices[iCluster].erase(aaiClusterTriangleUVIndices[iCluster].begin() + iTri, aaiClusterTriangleUVIndices[iCluster].begin() + iTri + 3);
-                    iNumClusterTri = static_cast<int32_t>(aaiClusterTrianglePositionIndices[iCluster].size());
-                    bRestart = true;
+                    if(iPos0 == iPos1 || iPos0 == iPos2 || iPos1 == iPos2)
+                    {
+                        aaiClusterTrianglePositionIndices[iCluster].erase(aaiClusterTrianglePositionIndices[iCluster].begin() + iTri, aaiClusterTrianglePositionIndices[iCluster].begin() + iTri + 3);
+                        aaiClusterTriangleNormalIndices[iCluster].erase(aaiClusterTriangleNormalIndices[iCluster].begin() + iTri, aaiClusterTriangleNormalIndices[iCluster].begin() + iTri + 3);
+                        aaiClusterTriangleUVIndices[iCluster].erase(aaiClusterTriangleUVIndices[iCluster].begin() + iTri, aaiClusterTriangleUVIndices[iCluster].begin() + iTri + 3);
+                        iNumClusterTri = static_cast<int32_t>(aaiClusterTrianglePositionIndices[iCluster].size());
+                        bRestart = true;
+                    }
                 }
-            }
 
-            assert(aaiClusterTrianglePositionIndices[iCluster].size() == aaiClusterTriangleNormalIndices[iCluster].size());
-            assert(aaiClusterTrianglePositionIndices[iCluster].size() == aaiClusterTriangleUVIndices[iCluster].size());
+                assert(aaiClusterTrianglePositionIndices[iCluster].size() == aaiClusterTriangleNormalIndices[iCluster].size());
+                assert(aaiClusterTrianglePositionIndices[iCluster].size() == aaiClusterTriangleUVIndices[iCluster].size());
+            }
         }
-    }
 
-    uint32_t const kiMaxTrianglesToSplit = 384;
+        uint32_t const kiMaxTrianglesToSplit = 384;
 
-    DEBUG_PRINTF("start split large clusters\n");
-    {
-        auto start = std::chrono::high_resolution_clock::now();
+        DEBUG_PRINTF("start split large clusters\n");
         {
-            std::vector<std::vector<float3>> aaTempClusterVertexPositions;
-            std::vector<std::vector<float3>> aaTempClusterVertexNormals;
-            std::vector<std::vector<float2>> aaTempClusterVertexUVs;
-            std::vector<std::vector<uint32_t>> aaiTempClusterTrianglePositionIndices;
-            std::vector<std::vector<uint32_t>> aaiTempClusterTriangleNormalIndices;
-            std::vector<std::vector<uint32_t>> aaiTempClusterTriangleUVIndices;
+            auto start = std::chrono::high_resolution_clock::now();
+            {
+                std::vector<std::vector<float3>> aaTempClusterVertexPositions;
+                std::vector<std::vector<float3>> aaTempClusterVertexNormals;
+                std::vector<std::vector<float2>> aaTempClusterVertexUVs;
+                std::vector<std::vector<uint32_t>> aaiTempClusterTrianglePositionIndices;
+                std::vector<std::vector<uint32_t>> aaiTempClusterTriangleNormalIndices;
+                std::vector<std::vector<uint32_t>> aaiTempClusterTriangleUVIndices;
 
-            auto start0 = std::chrono::high_resolution_clock::now();
+                auto start0 = std::chrono::high_resolution_clock::now();
 
-            for(uint32_t iCluster = 0; iCluster < static_cast<uint32_t>(aaClusterVertexPositions.size()); iCluster++)
-            {
-                std::vector<std::vector<float3>> aaSplitClusterVertexPositions;
-                std::vector<std::vector<float3>> aaSplitClusterVertexNormals;
-                std::vector<std::vector<float2>> aaSplitClusterVertexUVs;
-                std::vector<std::vector<uint32_t>> aaiSplitClusterTrianglePositionIndices;
-                std::vector<std::vector<uint32_t>> aaiSplitClusterTriangleNormalIndices;
-                std::vector<std::vector<uint32_t>> aaiSplitClusterTriangleUVIndices;
-
-                splitCluster3(
-                    aaSplitClusterVertexPositions,
-                    aaSplitClusterVertexNormals,
-                    aaSplitClusterVertexUVs,
-                    aaiSplitClusterTrianglePositionIndices,
-                    aaiSplitClusterTriangleNormalIndices,
-                    aaiSplitClusterTriangleUVIndices,
-                    aaClusterVertexPositions,
-                    aaClusterVertexNormals,
-                    aaClusterVertexUVs,
-                    aaiClusterTrianglePositionIndices,
-                    aaiClusterTriangleNormalIndices,
-                    aaiClusterTriangleUVIndices,
-                    iCluster,
-                    kiMaxTrianglesToSplit);
-
-                for(auto const& aSplitclusterVertexPositions : aaSplitClusterVertexPositions)
+                for(uint32_t iCluster = 0; iCluster < static_cast<uint32_t>(aaClusterVertexPositions.size()); iCluster++)
                 {
-                    aaTempClusterVertexPositions.push_back(aSplitclusterVertexPositions);
-                }
+                    std::vector<std::vector<float3>> aaSplitClusterVertexPositions;
+                    std::vector<std::vector<float3>> aaSplitClusterVertexNormals;
+                    std::vector<std::vector<float2>> aaSplitClusterVertexUVs;
+                    std::vector<std::vector<uint32_t>> aaiSplitClusterTrianglePositionIndices;
+                    std::vector<std::vector<uint32_t>> aaiSplitClusterTriangleNormalIndices;
+                    std::vector<std::vector<uint32_t>> aaiSplitClusterTriangleUVIndices;
+
+                    splitCluster3(
+                        aaSplitClusterVertexPositions,
+                        aaSplitClusterVertexNormals,
+                        aaSplitClusterVertexUVs,
+                        aaiSplitClusterTrianglePositionIndices,
+                        aaiSplitClusterTriangleNormalIndices,
+                        aaiSplitClusterTriangleUVIndices,
+                        aaClusterVertexPositions,
+                        aaClusterVertexNormals,
+                        aaClusterVertexUVs,
+                        aaiClusterTrianglePositionIndices,
+                        aaiClusterTriangleNormalIndices,
+                        aaiClusterTriangleUVIndices,
+                        iCluster,
+                        kiMaxTrianglesToSplit);
 
-                for(auto const& aSplitclusterVertexNormals : aaSplitClusterVertexNormals)
-                {
-                    aaTempClusterVertexNormals.push_back(aSplitclusterVertexNormals);
-                }
+                    for(auto const& aSplitclusterVertexPositions : aaSplitClusterVertexPositions)
+                    {
+                        aaTempClusterVertexPositions.push_back(aSplitclusterVertexPositions);
+                    }
 
-                for(auto const& aSplitclusterVertexUVs : aaSplitClusterVertexUVs)
-                {
-                    aaTempClusterVertexUVs.push_back(aSplitclusterVertexUVs);
-                }
+                    for(auto const& aSplitclusterVertexNormals : aaSplitClusterVertexNormals)
+                    {
+                        aaTempClusterVertexNormals.push_back(aSplitclusterVertexNormals);
+                    }
 
-                for(auto const& aiSplitClusterVertexPositionIndices : aaiSplitClusterTrianglePositionIndices)
-                {
-                    aaiTempClusterTrianglePositionIndices.push_back(aiSplitClusterVertexPositionIndices);
-                }
+                    for(auto const& aSplitclusterVertexUVs : aaSplitClusterVertexUVs)
+                    {
+                        aaTempClusterVertexUVs.push_back(aSplitclusterVertexUVs);
+                    }
 
-                for(auto const& aiSplitClusterTriangleNormalIndices : aaiSplitClusterTriangleNormalIndices)
-                {
-                    aaiTempClusterTriangleNormalIndices.push_back(aiSplitClusterTriangleNormalIndices);
-                }
+                    for(auto const& aiSplitClusterVertexPositionIndices : aaiSplitClusterTrianglePositionIndices)
+                    {
+                        aaiTempClusterTrianglePositionIndices.push_back(aiSplitClusterVertexPositionIndices);
+                    }
 
-                for(auto const& aiSplitClusterVertexUVIndices : aaiSplitClusterTriangleUVIndices)
-                {
-                    aaiTempClusterTriangleUVIndices.push_back(aiSplitClusterVertexUVIndices);
+                    for(auto const& aiSplitClusterTriangleNormalIndices : aaiSplitClusterTriangleNormalIndices)
+                    {
+                        aaiTempClusterTriangleNormalIndices.push_back(aiSplitClusterTriangleNormalIndices);
+                    }
+
+                    for(auto const& aiSplitClusterVertexUVIndices : aaiSplitClusterTriangleUVIndices)
+                    {
+                        aaiTempClusterTriangleUVIndices.push_back(aiSplitClusterVertexUVIndices);
+                    }
                 }
+                uint64_t iSplitElapsedSeconds = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::high_resolution_clock::now() - start0).count();
+                DEBUG_PRINTF("Took %" PRIu64 " seconds to split all clusters\n", iSplitElapsedSeconds);
+
+                start0 = std::chrono::high_resolution_clock::now();
+
+                std::vector<std::vector<uint32_t>> aaiGroupClusterIndices;
+                cleanupClusters2(
+                    aaTempClusterVertexPositions,
+                    aaTempClusterVertexNormals,
+                    aaTempClusterVertexUVs,
+                    aaiTempClusterTrianglePositionIndices,
+                    aaiTempClusterTriangleNormalIndices,
+                    aaiTempClusterTriangleUVIndices,
+                    aaiGroupClusterIndices);
+
+                // the LOD levels work on the flat store from here, the per-cluster vectors go out of scope with this block
+                appendClusters(
+                    clusters,
+                    aaTempClusterVertexPositions,
+                    aaTempClusterVertexNormals,
+                    aaTempClusterVertexUVs,
+                    aaiTempClusterTrianglePositionIndices,
+                    aaiTempClusterTriangleNormalIndices,
+                    aaiTempClusterTriangleUVIndices);
+
+                iNumClusters = getNumClusters(clusters);
+                iNumClusterGroups = iNumClusters / 4;
+
+                uint64_t iCleanupElapsedSeconds = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::high_resolution_clock::now() - start0).count();
+                DEBUG_PRINTF("Took %" PRIu64 " seconds to clean up all clusters\n", iCleanupElapsedSeconds);
+
+                //std::ostringstream outputFolderPath;
+                //{
+                //    outputFolderPath << homeDirectory << "large-clusters\\" << meshModelName;
+                //    std::filesystem::path folderFileSystemPath(outputFolderPath.str());
+                //    if(!std::filesystem::exists(folderFileSystemPath))
+                //    {
+                //        std::filesystem::create_directories(folderFileSystemPath);
+                //    }
+                //}
+                //
+                //std::ostringstream clusterName;
+                //clusterName << meshModelName << "-cluster-lod0";
+                //outputFolderPath << "\\" << clusterName.str() << ".obj";
+                //writeTotalClusterOBJ(
+                //    outputFolderPath.str(),
+                //    clusterName.str(),
+                //    aaClusterVertexPositions,
+                //    aaClusterVertexNormals,
+                //    aaClusterVertexUVs,
+                //    aaiClusterTrianglePositionIndices,
+                //    aaiClusterTriangleNormalIndices,
+                //    aaiClusterTriangleUVIndices);
             }
-            uint64_t iSplitElapsedSeconds = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::high_resolution_clock::now() - start0).count();
-            DEBUG_PRINTF("Took %lld seconds to split all clusters\n", iSplitElapsedSeconds);
-
-            start0 = std::chrono::high_resolution_clock::now();
-
-            std::vector<std::vector<uint32_t>> aaiGroupClusterIndices;
-            cleanupClusters2(
-                aaTempClusterVertexPositions,
-                aaTempClusterVertexNormals,
-                aaTempClusterVertexUVs,
-                aaiTempClusterTrianglePositionIndices,
-                aaiTempClusterTriangleNormalIndices,
-                aaiTempClusterTriangleUVIndices,
-                aaiGroupClusterIndices);
-
-            aaClusterVertexPositions = aaTempClusterVertexPositions;
-            aaClusterVertexNormals = aaTempClusterVertexNormals;
-            aaClusterVertexUVs = aaTempClusterVertexUVs;
-            aaiClusterTrianglePositionIndices = aaiTempClusterTrianglePositionIndices;
-            aaiClusterTriangleNormalIndices = aaiTempClusterTriangleNormalIndices;
-            aaiClusterTriangleUVIndices = aaiTempClusterTriangleUVIndices;
-
-            assert(aaClusterVertexPositions.size() == aaiClusterTrianglePositionIndices.size());
-            assert(aaClusterVertexNormals.size() == aaiClusterTriangleNormalIndices.size());
-            assert(aaClusterVertexUVs.size() == aaiClusterTriangleUVIndices.size());
-
-            iNumClusters = static_cast<uint32_t>(aaTempClusterVertexPositions.size());
-            iNumClusterGroups = iNumClusters / 4;
-
-            uint64_t iCleanupElapsedSeconds = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::high_resolution_clock::now() - start0).count();
-            DEBUG_PRINTF("Took %lld seconds to clean up all clusters\n", iCleanupElapsedSeconds);
-
-            //std::ostringstream outputFolderPath;
-            //{
-            //    outputFolderPath << homeDirectory << "large-clusters\\" << meshModelName;
-            //    std::filesystem::path folderFileSystemPath(outputFolderPath.str());
-            //    if(!std::filesystem::exists(folderFileSystemPath))
-            //    {
-            //        std::filesystem::create_directories(folderFileSystemPath);
-            //    }
-            //}
-            //
-            //std::ostringstream clusterName;
-            //clusterName << meshModelName << "-cluster-lod0";
-            //outputFolderPath << "\\" << clusterName.str() << ".obj";
-            //writeTotalClusterOBJ(
-            //    outputFolderPath.str(),
-            //    clusterName.str(),
-            //    aaClusterVertexPositions,
-            //    aaClusterVertexNormals,
-            //    aaClusterVertexUVs,
-            //    aaiClusterTrianglePositionIndices,
-            //    aaiClusterTriangleNormalIndices,
-            //    aaiClusterTriangleUVIndices);
-        }
 
-        uint64_t iSeconds = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::high_resolution_clock::now() - start).count();
-        DEBUG_PRINTF("took %lld seconds to split large clusters\n", iSeconds);
+            uint64_t iSeconds = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::high_resolution_clock::now() - start).count();
+            DEBUG_PRINTF("took %" PRIu64 " seconds to split large clusters\n", iSeconds);
+        }
     }
 
     std::vector<std::vector<uint32_t>> aaiClusterGroupMap;
@@ -493,13 +491,6 @@ auto start = std::chrono::high_resolution_clock::now();
     {
 auto totalLODStart = std::chrono::high_resolution_clock::now();
 
-        assert(aaClusterVertexPositions.size() == aaiClusterTrianglePositionIndices.size());
-        for(uint32_t iCluster = 0; iCluster < static_cast<uint32_t>(aaClusterVertexPositions.size()); iCluster++)
-        {
-            assert(aaiClusterTrianglePositionIndices[iCluster].size() == aaiClusterTriangleNormalIndices[iCluster].size());
-            assert(aaiClusterTrianglePositionIndices[iCluster].size() == aaiClusterTriangleUVIndices[iCluster].size());
-        }
-
         start = std::chrono::high_resolution_clock::now();
         DEBUG_PRINTF("*** start saving total cluster obj ***\n");
         {
@@ -520,122 +511,75 @@ auto totalLODStart = std::chrono::high_resolution_clock::now();
             writeTotalClusterOBJ(
                 outputTotalClusterFilePath.str(),
                 objectName.str(),
-                aaClusterVertexPositions,
-                aaClusterVertexNormals,
-                aaClusterVertexUVs,
-                aaiClusterTrianglePositionIndices,
-                aaiClusterTriangleNormalIndices,
-                aaiClusterTriangleUVIndices);
+                clusters);
         }
 auto end = std::chrono::high_resolution_clock::now();
 uint64_t iSeconds = std::chrono::duration_cast<std::chrono::seconds>(end - start).count();
-DEBUG_PRINTF("%lld seconds save total cluster obj\n", iSeconds);
+DEBUG_PRINTF("%" PRIu64 " seconds save total cluster obj\n", iSeconds);
 
 
 start = std::chrono::high_resolution_clock::now();
 DEBUG_PRINTF("*** start average triangle surface area ***\n");
         // average triangle surface area of individual clusters
         {
-            iNumClusters = static_cast<uint32_t>(aaClusterVertexPositions.size());
+            // drop triangles with repeated vertices or edges shorter than 1.0e-8 in one compaction pass over the store
+            uint32_t iNumDegenerateTriangles = removeDegenerateClusterTriangles(clusters, 1.0e-8f);
+            DEBUG_PRINTF("removed %d degenerate triangles\n", iNumDegenerateTriangles);
+
+            iNumClusters = getNumClusters(clusters);
             for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
             {
+                ClusterView cluster = getClusterView(clusters, iCluster);
+
                 aafClusterAverageTriangleArea[iLODLevel].push_back(0.0f);
-                bool bRestart = false;
-                for(uint32_t iTri = 0; iTri < static_cast<uint32_t>(aaiClusterTrianglePositionIndices[iCluster].size()); iTri += 3)
+                for(uint32_t iTri = 0; iTri < cluster.maiTrianglePositionIndices.size(); iTri += 3)
                 {
-                    if(bRestart)
-                    {
-                        iTri = 0;
-                        bRestart = false;
-                    }
-
-                    uint32_t iPos0 = aaiClusterTrianglePositionIndices[iCluster][iTri];
-                    uint32_t iPos1 = aaiClusterTrianglePositionIndices[iCluster][iTri + 1];
-                    uint32_t iPos2 = aaiClusterTrianglePositionIndices[iCluster][iTri + 2];
-
-                    float3 const& pos0 = aaClusterVertexPositions[iCluster][iPos0];
-                    float3 const& pos1 = aaClusterVertexPositions[iCluster][iPos1];
-                    float3 const& pos2 = aaClusterVertexPositions[iCluster][iPos2];
+                    float3 const& pos0 = cluster.mVertexPositions[cluster.maiTrianglePositionIndices[iTri]];
+                    float3 const& pos1 = cluster.mVertexPositions[cluster.maiTrianglePositionIndices[iTri + 1]];
+                    float3 const& pos2 = cluster.mVertexPositions[cluster.maiTrianglePositionIndices[iTri + 2]];
 
                     float3 diff0 = pos1 - pos0;
                     float3 diff1 = pos2 - pos0;
-                    float3 diff2 = pos1 - pos2;
-
-                    float const kfDiffThreshold = 1.0e-8f;
-                    if((length(diff0) < kfDiffThreshold || length(diff1) < kfDiffThreshold || length(diff2) < kfDiffThreshold) && (iPos0 != iPos1 && iPos0 != iPos2 && iPos1 != iPos2) ||
-                        (iPos0 == iPos1 || iPos0 == iPos2 || iPos1 == iPos2))
-                    {
-                        aaiClusterTrianglePositionIndices[iCluster].erase(
-                            aaiClusterTrianglePositionIndices[iCluster].begin() + iTri,
-                            aaiClusterTrianglePositionIndices[iCluster].begin() + iTri + 3);
-                        
-                        aaiClusterTriangleNormalIndices[iCluster].erase(
-                            aaiClusterTriangleNormalIndices[iCluster].begin() + iTri,
-                            aaiClusterTriangleNormalIndices[iCluster].begin() + iTri + 3);
-
-                        aaiClusterTriangleUVIndices[iCluster].erase(
-                            aaiClusterTriangleUVIndices[iCluster].begin() + iTri,
-                            aaiClusterTriangleUVIndices[iCluster].begin() + iTri + 3);
-                        
-                        bRestart = true;
-                    }
 
                     float fArea = length(cross(diff0, diff1)) * 0.5f;
                     aafClusterAverageTriangleArea[iLODLevel][iCluster] += fArea;
                 }
 
-                aafClusterAverageTriangleArea[iLODLevel][iCluster] /= static_cast<float>(aaiClusterTrianglePositionIndices[iCluster].size());
+                aafClusterAverageTriangleArea[iLODLevel][iCluster] /= static_cast<float>(cluster.maiTrianglePositionIndices.size());
 
                 // compute cluster's average normal
                 float3 avgNormal = float3(0.0f, 0.0f, 0.0f);
-                std::vector<float3> aFaceNormals(aaiClusterTrianglePositionIndices[iCluster].size() / 3);
-                for(uint32_t iTri = 0; iTri < static_cast<uint32_t>(aaiClusterTriangleNormalIndices[iCluster].size()); iTri += 3)
+                for(uint32_t iTri = 0; iTri < cluster.maiTriangleNormalIndices.size(); iTri += 3)
                 {
-                    avgNormal += normalize(aaClusterVertexNormals[iCluster][aaiClusterTriangleNormalIndices[iCluster][iTri]]);
-                    avgNormal += normalize(aaClusterVertexNormals[iCluster][aaiClusterTriangleNormalIndices[iCluster][iTri + 1]]);
-                    avgNormal += normalize(aaClusterVertexNormals[iCluster][aaiClusterTriangleNormalIndices[iCluster][iTri + 2]]);
+                    avgNormal += normalize(cluster.mVertexNormals[cluster.maiTriangleNormalIndices[iTri]]);
+                    avgNormal += normalize(cluster.mVertexNormals[cluster.maiTriangleNormalIndices[iTri + 1]]);
+                    avgNormal += normalize(cluster.mVertexNormals[cluster.maiTriangleNormalIndices[iTri + 2]]);
                 }
                 avgNormal = normalize(avgNormal);
                 
                 // get the cone radius (min dot product of average normal with triangle normal, ie. greatest cosine angle)
                 float fMinDP = FLT_MAX;
-                for(uint32_t iTri = 0; iTri < static_cast<uint32_t>(aaiClusterTriangleNormalIndices[iCluster].size()); iTri += 3)
+                for(uint32_t iTri = 0; iTri < cluster.maiTriangleNormalIndices.size(); iTri += 3)
                 {
-                    fMinDP = minf(fMinDP, dot(avgNormal, normalize(aaClusterVertexNormals[iCluster][aaiClusterTriangleNormalIndices[iCluster][iTri]])));
-                    fMinDP = minf(fMinDP, dot(avgNormal, normalize(aaClusterVertexNormals[iCluster][aaiClusterTriangleNormalIndices[iCluster][iTri + 1]])));
-                    fMinDP = minf(fMinDP, dot(avgNormal, normalize(aaClusterVertexNormals[iCluster][aaiClusterTriangleNormalIndices[iCluster][iTri + 2]])));
+                    fMinDP = minf(fMinDP, dot(avgNormal, normalize(cluster.mVertexNormals[cluster.maiTriangleNormalIndices[iTri]])));
+                    fMinDP = minf(fMinDP, dot(avgNormal, normalize(cluster.mVertexNormals[cluster.maiTriangleNormalIndices[iTri + 1]])));
+                    fMinDP = minf(fMinDP, dot(avgNormal, normalize(cluster.mVertexNormals[cluster.maiTriangleNormalIndices[iTri + 2]])));
                 }
 
                 float fSinAngle = (fMinDP < 0.0f) ? -1.0f : -sqrtf(1.0f - fMinDP * fMinDP);
                 aaClusterNormalCones[iLODLevel].push_back(float4(avgNormal, fSinAngle));
             }
-
-            for(uint32_t iCluster = 0; iCluster < static_cast<uint32_t>(aaClusterVertexPositions.size()); iCluster++)
-            {
-                assert(aaiClusterTrianglePositionIndices[iCluster].size() == aaiClusterTriangleNormalIndices[iCluster].size());
-                assert(aaiClusterTrianglePositionIndices[iCluster].size() == aaiClusterTriangleUVIndices[iCluster].size());
-            }
         }
 
 
 end = std::chrono::high_resolution_clock::now();
 iSeconds = std::chrono::duration_cast<std::chrono::seconds>(end - start).count();
-DEBUG_PRINTF("%lld seconds to compute cluster average triangle area and normal cones\n", iSeconds);
+DEBUG_PRINTF("%" PRIu64 " seconds to compute cluster average triangle area and normal cones\n", iSeconds);
         
-        std::ostringstream metisClusterLODFolderPath;
-        {
-            metisClusterLODFolderPath << homeDirectory << "metis\\" << meshModelName << "\\";
-            std::filesystem::path metisClusterLODFolderFileSystemPath(metisClusterLODFolderPath.str());
-            if(!std::filesystem::exists(metisClusterLODFolderFileSystemPath))
-            {
-                std::filesystem::create_directory(metisClusterLODFolderFileSystemPath);
-            }
-        }
-
-        std::ostringstream outputClusterMeshFilePath;
-        outputClusterMeshFilePath << metisClusterLODFolderPath.str() << "clusters-lod" << iLODLevel << ".mesh";
+        // cluster group for each cluster from partitioning the cluster adjacency graph
+        std::vector<uint32_t> aiClusterGroupPartitions;
 
-        // build a metis graph file with the number of shared vertices as edge weights between clusters
+        // partition the cluster graph with the number of shared vertices as edge weights between clusters
         if(iNumClusterGroups > 1)
         {
             {
@@ -643,199 +587,37 @@ DEBUG_PRINTF("%lld seconds to compute cluster average triangle area and normal c
                 
                 auto startMetisTime = std::chrono::high_resolution_clock::now();
 
-                uint32_t iNumClusters = static_cast<uint32_t>(aaClusterVertexPositions.size());
-
                 std::vector<std::vector<uint32_t>> aaiClusterBoundaryVertices;
                 std::vector<std::vector<uint32_t>> aaiClusterNonBoundaryVertices;
                 getBoundaryAndNonBoundaryVertices(
                     aaiClusterBoundaryVertices,
                     aaiClusterNonBoundaryVertices,
-                    aaClusterVertexPositions,
-                    aaiClusterTrianglePositionIndices);
-
-                std::vector<float3> aBoundaryMin(iNumClusters);
-                std::vector<float3> aBoundaryMax(iNumClusters);
-                for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
-                {
-                    float3 minPos(FLT_MAX, FLT_MAX, FLT_MAX);
-                    float3 maxPos(-FLT_MAX, -FLT_MAX, -FLT_MAX);
-                    for(auto const& iIndex : aaiClusterBoundaryVertices[iCluster])
-                    {
-                        float3 const& pos = aaClusterVertexPositions[iCluster][iIndex];
-                        minPos = fminf(minPos, pos);
-                        maxPos = fmaxf(maxPos, pos);
-                    }
-
-                    aBoundaryMin[iCluster] = minPos;
-                    aBoundaryMax[iCluster] = maxPos;
-                }
-
-                //std::vector<std::vector<uint32_t>> aaiNumAdjacentClusters;
-                //buildClusterEdgeAdjacencyCUDA3(
-                //    aaiNumAdjacentClusters,
-                //    aaClusterVertexPositions,
-                //    aaiClusterBoundaryVertices,
-                //    aBoundaryMin,
-                //    aBoundaryMax);
-
-
-                std::vector<std::vector<uint32_t>> aaiNumAdjacentClusters(aaClusterVertexPositions.size());
-                for(uint32_t i = 0; i < static_cast<uint32_t>(aaiNumAdjacentClusters.size()); i++)
-                {
-                    aaiNumAdjacentClusters[i].resize(aaiNumAdjacentClusters.size());
-                }
-
-                uint32_t const kiMaxThreads = 12;
-                std::vector<std::unique_ptr<std::thread>> apThreads(kiMaxThreads);
-                
-                static std::atomic<uint32_t> siCurrCluster;
-                static std::mutex sAdjacencyMutex;
-
-                siCurrCluster = 0;
-                for(uint32_t iThread = 0; iThread < kiMaxThreads; iThread++)
-                {
-                    apThreads[iThread] = std::make_unique<std::thread>(
-                        [&aaiNumAdjacentClusters,
-                        aaiClusterBoundaryVertices,
-                        aaClusterVertexPositions,
-                        iNumClusters,
-                        startMetisTime,
-                        aBoundaryMin,
-                        aBoundaryMax]()
-                        {
-                            for(;;)
-                            {
-                                uint32_t iCluster = siCurrCluster.fetch_add(1);
-                                if(iCluster >= iNumClusters)
-                                {
-                                    break;
-                                }
-
-                                //if(iCluster > 0 && iCluster % 100 == 0)
-                                //{
-                                //    uint64_t iElapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - startMetisTime).count();
-                                //    DEBUG_PRINTF("Took %d seconds to process cluster %d (%d) adjacency\n", iElapsed / 1000, iCluster, iNumClusters);
-                                //}
-
-                                float3 const& clusterMin = aBoundaryMin[iCluster];
-                                float3 const& clusterMax = aBoundaryMax[iCluster];
-
-                                //std::vector<uint32_t> aiAdjacencyFlags(iNumClusters);
-                                auto const& aiClusterBoundaryVertices = aaiClusterBoundaryVertices[iCluster];
-                                auto const& aClusterVertexPositions = aaClusterVertexPositions[iCluster];
-                                for(uint32_t i = 0; i < static_cast<uint32_t>(aiClusterBoundaryVertices.size()); i++)
-                                {
-                                    float3 const& clusterVertexPosition = aClusterVertexPositions[aiClusterBoundaryVertices[i]];
-
-                                    for(uint32_t iCheckCluster = iCluster + 1; iCheckCluster < iNumClusters; iCheckCluster++)
-                                    {
-                                        if(iCheckCluster == iCluster)
-                                        {
-                                            continue;
-                                        }
-                                        auto const& aiCheckClusterBoundaryVertices = aaiClusterBoundaryVertices[iCheckCluster];
-                                        auto const& aCheckClusterVertexPositions = aaClusterVertexPositions[iCheckCluster];
-
-                                        float3 const& checkClusterMin = aBoundaryMin[iCheckCluster];
-                                        float3 const& checkClusterMax = aBoundaryMax[iCheckCluster];
-
-                                        // intersection?
-                                        bool bIntersection = (
-                                            clusterMin.x <= checkClusterMax.x &&
-                                            clusterMax.x >= checkClusterMin.x &&
-                                            clusterMin.y <= checkClusterMax.y &&
-                                            clusterMax.y >= checkClusterMin.y &&
-                                            clusterMin.z <= checkClusterMax.z &&
-                                            clusterMax.z >= checkClusterMin.z);
-                                        if(!bIntersection)
-                                        {
-                                            continue;
-                                        }
-
-                                        bool bAdjacent = false;
-                                        for(uint32_t j = 0; j < static_cast<uint32_t>(aiCheckClusterBoundaryVertices.size()); j++)
-                                        {
-                                            float3 const& checkClusterVertexPosition = aCheckClusterVertexPositions[aiCheckClusterBoundaryVertices[j]];
-                                            float fDistance = lengthSquared(checkClusterVertexPosition - clusterVertexPosition);
-                                            if(fDistance <= 1.0e-8f)
-                                            {
-                                                bAdjacent = true;
-                                                break;
-                                            }
-                                        }
-
-                                        if(bAdjacent)
-                                        {
-                                            //aiAdjacencyFlags[iCheckCluster] += 1;
-                                            std::lock_guard<std::mutex> lock(sAdjacencyMutex);
-                                            aaiNumAdjacentClusters[iCluster][iCheckCluster] += 1;
-                                            aaiNumAdjacentClusters[iCheckCluster][iCluster] += 1;
-                                        }
-
-                                    } // for boundary vertex to num boundary vertices for check cluster
-
-                                }   // for boundary vertex to num boundary vertices for cluster
-
-                            }
-                        });
-                }
-
-                for(uint32_t iThread = 0; iThread < kiMaxThreads; iThread++)
-                {
-                    if(apThreads[iThread]->joinable())
-                    {
-                        apThreads[iThread]->join();
-                    }
-                }
-
-
-                uint32_t iNumEdges = 0;
-                for(uint32_t i = 0; i < iNumClusters; i++)
-                {
-                    for(uint32_t j = i + 1; j < static_cast<uint32_t>(aaiNumAdjacentClusters[i].size()); j++)
-                    {
-                        if(aaiNumAdjacentClusters[i][j] > 0)
-                        {
-                            ++iNumEdges;
-                        }
-                    }
-                }
-                assert(iNumEdges > 0);
-                
-                FILE* fp = fopen(outputClusterMeshFilePath.str().c_str(), "wb");
-                fprintf(fp, "%d %d 001\n", iNumClusters, iNumEdges);
-                for(uint32_t i = 0; i < iNumClusters; i++)
-                {
-                    for(uint32_t j = 0; j < iNumClusters; j++)
-                    {
-                        if(aaiNumAdjacentClusters[i][j] > 0)
-                        {
-                            fprintf(fp, "%d %d", j + 1, aaiNumAdjacentClusters[i][j]);
-                            if(j < iNumClusters - 1)
-                            {
-                                fprintf(fp, " ");
-                            }
-                        }
-                    }
-
-                    fprintf(fp, "\n");
-                }
-
-                fclose(fp);
-
-                // generate cluster groups for all the initial clusters
-                std::ostringstream clusterGroupCommand;
-                clusterGroupCommand << "D:\\test\\METIS\\build\\windows\\programs\\Debug\\gpmetis.exe ";
-                clusterGroupCommand << outputClusterMeshFilePath.str() << " ";
-                clusterGroupCommand << iNumClusterGroups;
-                std::string result = execCommand(clusterGroupCommand.str(), false);
-                if(result.find("Metis returned with an error.") != std::string::npos)
-                {
-                    assert(0);
-                }
+                    clusters);
+
+                // sparse graph of clusters sharing boundary vertices (squared distance <= 1.0e-8), edge weights are the number of shared vertices
+                std::vector<uint32_t> aiAdjacencyStart;
+                std::vector<uint32_t> aiAdjacency;
+                std::vector<uint32_t> aiAdjacencyWeights;
+                buildClusterAdjacencyGraph(
+                    aiAdjacencyStart,
+                    aiAdjacency,
+                    aiAdjacencyWeights,
+                    clusters,
+                    aaiClusterBoundaryVertices,
+                    1.0e-4f);
+                assert(aiAdjacency.size() > 0);
+
+                // generate cluster groups for all the clusters
+                bool bPartitioned = partitionMETISGraph(
+                    aiClusterGroupPartitions,
+                    aiAdjacencyStart,
+                    aiAdjacency,
+                    aiAdjacencyWeights,
+                    iNumClusterGroups);
+                assert(bPartitioned);
 
                 uint64_t iElapsed = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::high_resolution_clock::now() - startMetisTime).count();
-                DEBUG_PRINTF("Took %lld seconds to build metis file from cluster adjacency for cluster group\n", iElapsed);
+                DEBUG_PRINTF("Took %" PRIu64 " seconds to partition cluster adjacency for cluster group\n", iElapsed);
 
             }   // new cluster adjacency
 
@@ -860,16 +642,11 @@ auto start = std::chrono::high_resolution_clock::now();
             aaiClusterGroupTriangleNormalIndices,
             aaiClusterGroupTriangleUVIndices,
             aiClusterGroupMap,
-            aaClusterVertexPositions,
-            aaClusterVertexNormals,
-            aaClusterVertexUVs,
-            aaiClusterTrianglePositionIndices,
-            aaiClusterTriangleNormalIndices,
-            aaiClusterTriangleUVIndices,
+            clusters,
             iNumClusterGroups,
             iNumClusters,
             iLODLevel,
-            outputClusterMeshFilePath.str(),
+            aiClusterGroupPartitions,
             homeDirectory,
             meshModelName);
 
@@ -892,7 +669,7 @@ auto start = std::chrono::high_resolution_clock::now();
 
 end = std::chrono::high_resolution_clock::now();
 iSeconds = std::chrono::duration_cast<std::chrono::seconds>(end - start).count();
-DEBUG_PRINTF("%lld seconds to build cluster groups\n", iSeconds);
+DEBUG_PRINTF("%" PRIu64 " seconds to build cluster groups\n", iSeconds);
 
 DEBUG_PRINTF("*** start build mesh cluster data ***\n");
 start = std::chrono::high_resolution_clock::now();
@@ -901,6 +678,8 @@ start = std::chrono::high_resolution_clock::now();
         std::map<uint32_t, std::vector<uint32_t>> aClusterGroupToClusterMap;
         for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
         {
+            ClusterView cluster = getClusterView(clusters, iCluster);
+
             // parent mesh cluster will be cluster group index * 2
             aaMeshClusters[iLODLevel].emplace_back(
                 giTotalVertexPositionDataOffset,
@@ -909,10 +688,10 @@ start = std::chrono::high_resolution_clock::now();
                 giTotalTrianglePositionIndexDataOffset,
                 giTotalTriangleNormalIndexDataOffset,
                 giTotalTriangleUVIndexDataOffset,
-                static_cast<uint32_t>(aaClusterVertexPositions[iCluster].size()),
-                static_cast<uint32_t>(aaClusterVertexNormals[iCluster].size()),
-                static_cast<uint32_t>(aaClusterVertexUVs[iCluster].size()),
-                static_cast<uint32_t>(aaiClusterTrianglePositionIndices[iCluster].size()),
+                static_cast<uint32_t>(cluster.mVertexPositions.size()),
+                static_cast<uint32_t>(cluster.mVertexNormals.size()),
+                static_cast<uint32_t>(cluster.mVertexUVs.size()),
+                static_cast<uint32_t>(cluster.maiTrianglePositionIndices.size()),
                 aiClusterGroupMap[iCluster],
                 iLODLevel,
                 iTotalMeshClusters,
@@ -920,7 +699,7 @@ start = std::chrono::high_resolution_clock::now();
 
             // copy vertex positions, normals, uvs, and triangle indices their respective buffers
             // position
-            uint64_t iDataSize = aaClusterVertexPositions[iCluster].size();
+            uint64_t iDataSize = cluster.mVertexPositions.size();
             if(vertexPositionBuffer.size() <= giTotalVertexPositionDataOffset * sizeof(float3) + iDataSize * sizeof(float3))
             {
                 vertexPositionBuffer.resize(vertexPositionBuffer.size() * 2);
@@ -928,12 +707,12 @@ start = std::chrono::high_resolution_clock::now();
             }
             memcpy(
                 vertexPositionBuffer.data() + giTotalVertexPositionDataOffset * sizeof(float3),
-                aaClusterVertexPositions[iCluster].data(),
+                cluster.mVertexPositions.data(),
                 iDataSize * sizeof(float3));
             giTotalVertexPositionDataOffset += iDataSize;
 
             // normal
-            iDataSize = aaClusterVertexNormals[iCluster].size();
+            iDataSize = cluster.mVertexNormals.size();
             if(vertexNormalBuffer.size() <= giTotalVertexPositionDataOffset * sizeof(float3) + iDataSize * sizeof(float3))
             {
                 vertexNormalBuffer.resize(vertexNormalBuffer.size() * 2);
@@ -941,12 +720,12 @@ start = std::chrono::high_resolution_clock::now();
             }
             memcpy(
                 vertexNormalBuffer.data() + giTotalVertexNormalDataOffset * sizeof(float3),
-                aaClusterVertexNormals[iCluster].data(),
+                cluster.mVertexNormals.data(),
                 iDataSize * sizeof(float3));
             giTotalVertexNormalDataOffset += iDataSize;
 
             // uv
-            iDataSize = aaClusterVertexUVs[iCluster].size();
+            iDataSize = cluster.mVertexUVs.size();
             if(vertexUVBuffer.size() <= giTotalVertexUVDataOffset * sizeof(float2) + iDataSize * sizeof(float2))
             {
                 vertexUVBuffer.resize(vertexUVBuffer.size() * 2);
@@ -954,12 +733,12 @@ start = std::chrono::high_resolution_clock::now();
             }
             memcpy(
                 vertexUVBuffer.data() + giTotalVertexUVDataOffset * sizeof(float2),
-                aaClusterVertexUVs[iCluster].data(),
+                cluster.mVertexUVs.data(),
                 iDataSize * sizeof(float2));
             giTotalVertexUVDataOffset += iDataSize;
 
             // position indices
-            iDataSize = aaiClusterTrianglePositionIndices[iCluster].size();
+            iDataSize = cluster.maiTrianglePositionIndices.size();
             if(trianglePositionIndexBuffer.size() <= giTotalTrianglePositionIndexDataOffset * sizeof(uint32_t) + iDataSize * sizeof(uint32_t))
             {
                 trianglePositionIndexBuffer.resize(trianglePositionIndexBuffer.size() * 2);
@@ -967,12 +746,12 @@ start = std::chrono::high_resolution_clock::now();
             }
             memcpy(
                 trianglePositionIndexBuffer.data() + giTotalTrianglePositionIndexDataOffset * sizeof(uint32_t),
-                aaiClusterTrianglePositionIndices[iCluster].data(),
+                cluster.maiTrianglePositionIndices.data(),
                 iDataSize * sizeof(uint32_t));
             giTotalTrianglePositionIndexDataOffset += iDataSize;
 
             // normal indices
-            iDataSize = aaiClusterTriangleNormalIndices[iCluster].size();
+            iDataSize = cluster.maiTriangleNormalIndices.size();
             if(triangleNormalIndexBuffer.size() <= giTotalTriangleNormalIndexDataOffset * sizeof(uint32_t) + iDataSize * sizeof(uint32_t))
             {
                 triangleNormalIndexBuffer.resize(triangleNormalIndexBuffer.size() * 2);
@@ -980,12 +759,12 @@ start = std::chrono::high_resolution_clock::now();
             }
             memcpy(
                 triangleNormalIndexBuffer.data() + giTotalTriangleNormalIndexDataOffset * sizeof(uint32_t),
-                aaiClusterTriangleNormalIndices[iCluster].data(),
+                cluster.maiTriangleNormalIndices.data(),
                 iDataSize * sizeof(uint32_t));
             giTotalTriangleNormalIndexDataOffset += iDataSize;
 
             // uv indices
-            iDataSize = aaiClusterTriangleUVIndices[iCluster].size();
+            iDataSize = cluster.maiTriangleUVIndices.size();
             if(triangleUVIndexBuffer.size() <= giTotalTriangleUVIndexDataOffset * sizeof(uint32_t) + iDataSize * sizeof(uint32_t))
             {
                 triangleUVIndexBuffer.resize(triangleUVIndexBuffer.size() * 2);
@@ -993,7 +772,7 @@ start = std::chrono::high_resolution_clock::now();
             }
             memcpy(
                 triangleUVIndexBuffer.data() + giTotalTriangleUVIndexDataOffset * sizeof(uint32_t),
-                aaiClusterTriangleUVIndices[iCluster].data(),
+                cluster.maiTriangleUVIndices.data(),
                 iDataSize * sizeof(uint32_t));
             giTotalTriangleUVIndexDataOffset += iDataSize;
 
@@ -1006,7 +785,7 @@ start = std::chrono::high_resolution_clock::now();
         {
             for(uint32_t iV = 0; iV < aaMeshClusters[iLODLevel][iCluster].miNumVertexPositions; iV++)
             {
-                auto const& pos = aaClusterVertexPositions[iCluster][iV];
+                auto const& pos = getClusterView(clusters, iCluster).mVertexPositions[iV];
 
                 uint64_t iAbsoluteAddress = aaMeshClusters[iLODLevel][iCluster].miVertexPositionStartArrayAddress * sizeof(float3);
                 auto const& checkPos = reinterpret_cast<float3 const*>(vertexPositionBuffer.data() + iAbsoluteAddress)[iV];
@@ -1031,104 +810,34 @@ start = std::chrono::high_resolution_clock::now();
 
 end = std::chrono::high_resolution_clock::now();
 iSeconds = std::chrono::duration_cast<std::chrono::seconds>(end - start).count();
-DEBUG_PRINTF("%lld seconds to pack cluster group data\n", iSeconds);
+DEBUG_PRINTF("%" PRIu64 " seconds to pack cluster group data\n", iSeconds);
 
-DEBUG_PRINTF("*** start getting boundary and non-boundary edges ***\n");
+DEBUG_PRINTF("*** start getting cluster group boundary vertices, inner edges and boundary edges ***\n");
 start = std::chrono::high_resolution_clock::now();
 
-        // get cluster boundary vertices
+        // boundary and non-boundary vertices, and the inner edges (collapse candidates, boundary edges excluded) of all the cluster groups
         std::vector<std::vector<uint32_t>> aaiClusterGroupBoundaryVertices;
         std::vector<std::vector<uint32_t>> aaiClusterGroupNonBoundaryVertices;
-        getBoundaryAndNonBoundaryVertices(
+        std::vector<std::vector<std::pair<uint32_t, uint32_t>>> aaValidClusterGroupEdgePairs;
+        std::vector<BoundaryEdgeInfo> aBoundaryEdges;
+        getClusterGroupTopology(
             aaiClusterGroupBoundaryVertices,
             aaiClusterGroupNonBoundaryVertices,
-            aaClusterGroupVertexPositions,
-            aaiClusterGroupTrianglePositionIndices);
-        
-end = std::chrono::high_resolution_clock::now();
-iSeconds = std::chrono::duration_cast<std::chrono::seconds>(end - start).count();
-DEBUG_PRINTF("took %lld seconds to get cluster group boundary vertices\n", iSeconds);
-   
-DEBUG_PRINTF("*** start getting inner edges and vertices ***\n");
-start = std::chrono::high_resolution_clock::now();
-
-        // get inner edges of all the cluster groups
-        std::vector<std::vector<uint32_t>> aaiValidClusterGroupEdges(iNumClusterGroups);
-        std::vector<std::vector<std::pair<uint32_t, uint32_t>>> aaValidClusterGroupEdgePairs(iNumClusterGroups);
-        std::vector<std::map<uint32_t, uint32_t>> aaValidVerticesFlags(iNumClusterGroups);
-        std::vector<std::vector<uint32_t>> aaiClusterGroupTrisWithEdges(iNumClusterGroups);
-        std::vector<std::vector<std::pair<uint32_t, uint32_t>>> aaClusterGroupEdges(iNumClusterGroups);
-        getInnerEdgesAndVertices(
-            aaiValidClusterGroupEdges,
             aaValidClusterGroupEdgePairs,
-            aaValidVerticesFlags,
-            aaiClusterGroupTrisWithEdges,
-            aaClusterGroupEdges,
-            aaiClusterGroupTrianglePositionIndices,
-            aaiClusterGroupNonBoundaryVertices,
-            iNumClusterGroups);
-
-end = std::chrono::high_resolution_clock::now();
-iSeconds = std::chrono::duration_cast<std::chrono::seconds>(end - start).count();
-DEBUG_PRINTF("took %lld seconds to get inner edges and vertices\n", iSeconds);
-
-DEBUG_PRINTF("*** start getting boundary edges ***\n");
-start = std::chrono::high_resolution_clock::now();
-
-        // check if edges are not adjacent to anything
-        std::vector<BoundaryEdgeInfo> aBoundaryEdges;
-        getBoundaryEdges(
             aBoundaryEdges,
             aaClusterGroupVertexPositions,
-            aaClusterGroupVertexNormals,
-            aaClusterGroupVertexUVs,
-            aaiClusterGroupTrianglePositionIndices,
-            aaiClusterGroupTriangleNormalIndices,
-            aaiClusterGroupTriangleUVIndices);
-
-end = std::chrono::high_resolution_clock::now();
-iSeconds = std::chrono::duration_cast<std::chrono::seconds>(end - start).count();
-DEBUG_PRINTF("took %lld seconds to get boundary edges\n", iSeconds);
-
-start = std::chrono::high_resolution_clock::now();
-
-        // delete boundary edges from collapse candidates 
-        uint32_t iEdge = 0;
-        //std::vector<std::pair<uint32_t, uint32_t>> aBoundaryVertices;
-        for(auto const& boundaryEdgeInfo : aBoundaryEdges)
-        {
-            // see if the edges are boundary edges
-            auto boundaryEdgeIter = std::find_if(
-                aaValidClusterGroupEdgePairs[boundaryEdgeInfo.miClusterGroup].begin(),
-                aaValidClusterGroupEdgePairs[boundaryEdgeInfo.miClusterGroup].end(),
-                [boundaryEdgeInfo](std::pair<uint32_t, uint32_t> const& checkEdge)
-                {
-                    return (boundaryEdgeInfo.miPos0 == checkEdge.first && boundaryEdgeInfo.miPos1 == checkEdge.second) || (boundaryEdgeInfo.miPos1 == checkEdge.first && boundaryEdgeInfo.miPos0 == checkEdge.second);
-                }
-            );
-
-            if(boundaryEdgeIter != aaValidClusterGroupEdgePairs[boundaryEdgeInfo.miClusterGroup].end())
-            {
-                //DEBUG_PRINTF("delete from cluster group %d edge (%d, %d)\n",
-                //    boundaryEdgeInfo.miClusterGroup,
-                //    boundaryEdgeInfo.miPos0,
-                //    boundaryEdgeInfo.miPos1);
-                aaValidClusterGroupEdgePairs[boundaryEdgeInfo.miClusterGroup].erase(boundaryEdgeIter);
-            }
-
-            ++iEdge;
-        }
+            aaiClusterGroupTrianglePositionIndices);
 
 end = std::chrono::high_resolution_clock::now();
 iSeconds = std::chrono::duration_cast<std::chrono::seconds>(end - start).count();
-DEBUG_PRINTF("%lld seconds to delete boundary edges\n", iSeconds);
+DEBUG_PRINTF("took %" PRIu64 " seconds to get cluster group boundary vertices, inner edges and boundary edges\n", iSeconds);
 
 #if 0
         // cuda simplify cluster groups
         std::vector<float> afErrors(iNumClusterGroups);
         {
             auto start0 = std::chrono::high_resolution_clock::now();
-            std::vector<std::map<uint32_t, mat4>> aaQuadrics(iNumClusterGroups);
+            std::vector<std::vector<Quadric>> aaQuadrics(iNumClusterGroups);
             float fTotalError = 0.0f;
             for(uint32_t iClusterGroup = 0; iClusterGroup < iNumClusterGroups; iClusterGroup++)
             {
@@ -1163,106 +872,83 @@ DEBUG_PRINTF("%lld seconds to delete boundary edges\n", iSeconds);
         }   //   cuda simplify cluster group
 #endif // #if 0
 
-        std::vector<std::map<uint32_t, mat4>> aaQuadrics(iNumClusterGroups);
+        std::vector<std::vector<Quadric>> aaQuadrics(iNumClusterGroups);
         std::vector<float> afErrors(iNumClusterGroups);
-        float fTotalError = 0.0f;
         
 start = std::chrono::high_resolution_clock::now();
 
-        uint32_t const kiMaxThreads = 8;
-        std::unique_ptr<std::thread> apThreads[kiMaxThreads];
-        std::atomic<uint32_t> iCurrClusterGroup{ 0 };
-        for(uint32_t iThread = 0; iThread < kiMaxThreads; iThread++)
-        {
-            apThreads[iThread] = std::make_unique<std::thread>(
-                [&iCurrClusterGroup,
-                &aaQuadrics,
-                &aaClusterGroupVertexPositions,
-                &aaClusterGroupVertexNormals,
-                &aaClusterGroupVertexUVs,
-                &aaiClusterGroupNonBoundaryVertices,
-                &aaiClusterGroupBoundaryVertices,
-                &aaiClusterGroupTrianglePositionIndices,
-                &aaiClusterGroupTriangleNormalIndices,
-                &aaiClusterGroupTriangleUVIndices,
-                &aaValidClusterGroupEdgePairs,
-                &fTotalError,
-                &afErrors,
-                iLODLevel,
-                iNumClusterGroups,
-                start,
-                meshModelName,
-                homeDirectory,
-                iThread]()
-                {
-                    for(;;)
-                    {
+        parallelFor(
+            iNumClusterGroups,
+            1,
+            [&aaQuadrics,
+            &aaClusterGroupVertexPositions,
+            &aaClusterGroupVertexNormals,
+            &aaClusterGroupVertexUVs,
+            &aaiClusterGroupNonBoundaryVertices,
+            &aaiClusterGroupBoundaryVertices,
+            &aaiClusterGroupTrianglePositionIndices,
+            &aaiClusterGroupTriangleNormalIndices,
+            &aaiClusterGroupTriangleUVIndices,
+            &aaValidClusterGroupEdgePairs,
+            &afErrors,
+            &meshModelName,
+            &homeDirectory,
+            iLODLevel,
+            iNumClusterGroups,
+            start](uint32_t iThreadClusterGroup, uint32_t /*iSlot*/)
+            {
 auto clusterGroupStart = std::chrono::high_resolution_clock::now();
-                        uint32_t iThreadClusterGroup = iCurrClusterGroup.fetch_add(1);
-                        if(iThreadClusterGroup >= iNumClusterGroups)
-                        {
-                            break;
-                        }
 
-                        assert(aaiClusterGroupTrianglePositionIndices[iThreadClusterGroup].size() == aaiClusterGroupTriangleNormalIndices[iThreadClusterGroup].size());
-                        assert(aaiClusterGroupTrianglePositionIndices[iThreadClusterGroup].size() == aaiClusterGroupTriangleUVIndices[iThreadClusterGroup].size());
-
-                        uint32_t iMaxTriangles = static_cast<uint32_t>(static_cast<float>(aaiClusterGroupTrianglePositionIndices[iThreadClusterGroup].size()) * 0.5f);
-                        simplifyClusterGroup(
-                            aaQuadrics[iThreadClusterGroup],
-                            aaClusterGroupVertexPositions[iThreadClusterGroup],
-                            aaClusterGroupVertexNormals[iThreadClusterGroup],
-                            aaClusterGroupVertexUVs[iThreadClusterGroup],
-                            aaiClusterGroupNonBoundaryVertices[iThreadClusterGroup],
-                            aaiClusterGroupBoundaryVertices[iThreadClusterGroup],
-                            aaiClusterGroupTrianglePositionIndices[iThreadClusterGroup],
-                            aaiClusterGroupTriangleNormalIndices[iThreadClusterGroup],
-                            aaiClusterGroupTriangleUVIndices[iThreadClusterGroup],
-                            aaValidClusterGroupEdgePairs[iThreadClusterGroup],
-                            fTotalError,
-                            iMaxTriangles,
-                            iThreadClusterGroup,
-                            iLODLevel,
-                            meshModelName,
-                            homeDirectory);
-                        afErrors[iThreadClusterGroup] = fTotalError;
-
-                        assert(aaiClusterGroupTrianglePositionIndices[iThreadClusterGroup].size() == aaiClusterGroupTriangleNormalIndices[iThreadClusterGroup].size());
-                        assert(aaiClusterGroupTrianglePositionIndices[iThreadClusterGroup].size() == aaiClusterGroupTriangleUVIndices[iThreadClusterGroup].size());
+                assert(aaiClusterGroupTrianglePositionIndices[iThreadClusterGroup].size() == aaiClusterGroupTriangleNormalIndices[iThreadClusterGroup].size());
+                assert(aaiClusterGroupTrianglePositionIndices[iThreadClusterGroup].size() == aaiClusterGroupTriangleUVIndices[iThreadClusterGroup].size());
+
+                uint32_t iMaxTriangles = static_cast<uint32_t>(static_cast<float>(aaiClusterGroupTrianglePositionIndices[iThreadClusterGroup].size()) * 0.5f);
+                float fTotalError = 0.0f;
+                simplifyClusterGroup(
+                    aaQuadrics[iThreadClusterGroup],
+                    aaClusterGroupVertexPositions[iThreadClusterGroup],
+                    aaClusterGroupVertexNormals[iThreadClusterGroup],
+                    aaClusterGroupVertexUVs[iThreadClusterGroup],
+                    aaiClusterGroupNonBoundaryVertices[iThreadClusterGroup],
+                    aaiClusterGroupBoundaryVertices[iThreadClusterGroup],
+                    aaiClusterGroupTrianglePositionIndices[iThreadClusterGroup],
+                    aaiClusterGroupTriangleNormalIndices[iThreadClusterGroup],
+                    aaiClusterGroupTriangleUVIndices[iThreadClusterGroup],
+                    aaValidClusterGroupEdgePairs[iThreadClusterGroup],
+                    fTotalError,
+                    iMaxTriangles,
+                    iThreadClusterGroup,
+                    iLODLevel,
+                    meshModelName,
+                    homeDirectory);
+                afErrors[iThreadClusterGroup] = fTotalError;
+
+                assert(aaiClusterGroupTrianglePositionIndices[iThreadClusterGroup].size() == aaiClusterGroupTriangleNormalIndices[iThreadClusterGroup].size());
+                assert(aaiClusterGroupTrianglePositionIndices[iThreadClusterGroup].size() == aaiClusterGroupTriangleUVIndices[iThreadClusterGroup].size());
 
 auto clusterGroupEnd = std::chrono::high_resolution_clock::now();
 uint64_t iClusterGroupMilliSeconds = std::chrono::duration_cast<std::chrono::milliseconds>(clusterGroupEnd - clusterGroupStart).count();
 uint64_t iTotalSeconds = std::chrono::duration_cast<std::chrono::seconds>(clusterGroupEnd - start).count();
 if(iThreadClusterGroup % 10 == 0)
 {
-    DEBUG_PRINTF("took %lld milliseconds (total: %lld secs) to simplify cluster group %d of cluster groups %d\n", 
+    DEBUG_PRINTF("took %" PRIu64 " milliseconds (total: %" PRIu64 " secs) to simplify cluster group %d of cluster groups %d\n", 
         iClusterGroupMilliSeconds, 
         iTotalSeconds,
         iThreadClusterGroup, 
         iNumClusterGroups);
 }
-                    }
-                }
-            );
-        }
-        for(uint32_t iThread = 0; iThread < kiMaxThreads; iThread++)
-        {
-            if(apThreads[iThread]->joinable())
-            {
-                apThreads[iThread]->join();
-            }
-        }
+            });
 
         aafClusterGroupErrors.push_back(afErrors);
 
 end = std::chrono::high_resolution_clock::now();
 iSeconds = std::chrono::duration_cast<std::chrono::seconds>(end - start).count();
-DEBUG_PRINTF("took %lld seconds to simplify cluster groups\n", iSeconds);
+DEBUG_PRINTF("took %" PRIu64 " seconds to simplify cluster groups\n", iSeconds);
 
         // set the error for each clusters using cluster group errors
         if(iLODLevel > 0)
         {
-            for(uint32_t iCluster = 0; iCluster < static_cast<uint32_t>(aaClusterVertexPositions.size()); iCluster++)
+            for(uint32_t iCluster = 0; iCluster < getNumClusters(clusters); iCluster++)
             {
                 uint32_t iClusterGroup = iCluster / 2;
                 if(iClusterGroup < aafClusterGroupErrors[iLODLevel - 1].size())
@@ -1273,153 +959,139 @@ DEBUG_PRINTF("took %lld seconds to simplify cluster groups\n", iSeconds);
         }
 
         // clear old cluster data
-        {
-            for(uint32_t i = 0; i < static_cast<uint32_t>(aaClusterVertexPositions.size()); i++)
-            {
-                aaClusterVertexPositions[i].clear();
-            }
-            aaClusterVertexPositions.clear();
-
-            for(uint32_t i = 0; i < static_cast<uint32_t>(aaiClusterTrianglePositionIndices.size()); i++)
-            {
-                aaiClusterTrianglePositionIndices[i].clear();
-            }
-            aaiClusterTrianglePositionIndices.clear();
+        clearClusterStore(clusters);
 
-            for(uint32_t i = 0; i < static_cast<uint32_t>(aaClusterVertexNormals.size()); i++)
-            {
-                aaClusterVertexNormals[i].clear();
-            }
-            aaClusterVertexNormals.clear();
-
-            for(uint32_t i = 0; i < static_cast<uint32_t>(aaiClusterTriangleNormalIndices.size()); i++)
-            {
-                aaiClusterTriangleNormalIndices[i].clear();
-            }
-            aaiClusterTriangleNormalIndices.clear();
-
-            for(uint32_t i = 0; i < static_cast<uint32_t>(aaClusterVertexUVs.size()); i++)
-            {
-                aaClusterVertexUVs[i].clear();
-            }
-            aaClusterVertexUVs.clear();
+        // split cluster groups
+        {
+auto start = std::chrono::high_resolution_clock::now();
 
-            for(uint32_t i = 0; i < static_cast<uint32_t>(aaiClusterTriangleUVIndices.size()); i++)
+            // compact out the invalid (empty) cluster groups in one pass, keeping the index of the mesh cluster group they came from
+            uint32_t iNumValidClusterGroups = 0;
+            std::vector<uint32_t> aiSrcClusterGroups;
+            aiSrcClusterGroups.reserve(aaiClusterGroupTrianglePositionIndices.size());
+            for(uint32_t iClusterGroup = 0; iClusterGroup < static_cast<uint32_t>(aaiClusterGroupTrianglePositionIndices.size()); iClusterGroup++)
             {
-                aaiClusterTriangleUVIndices[i].clear();
-            }
-            aaiClusterTriangleUVIndices.clear();
+                if(aaiClusterGroupTrianglePositionIndices[iClusterGroup].size() <= 0)
+                {
+                    continue;
+                }
 
-        }   // clear old cluster data
+                if(iNumValidClusterGroups != iClusterGroup)
+                {
+                    aaClusterGroupVertexPositions[iNumValidClusterGroups] = std::move(aaClusterGroupVertexPositions[iClusterGroup]);
+                    aaClusterGroupVertexNormals[iNumValidClusterGroups] = std::move(aaClusterGroupVertexNormals[iClusterGroup]);
+                    aaClusterGroupVertexUVs[iNumValidClusterGroups] = std::move(aaClusterGroupVertexUVs[iClusterGroup]);
 
-        // split cluster groups
-        {
-auto start = std::chrono::high_resolution_clock::now();
+                    aaiClusterGroupTrianglePositionIndices[iNumValidClusterGroups] = std::move(aaiClusterGroupTrianglePositionIndices[iClusterGroup]);
+                    aaiClusterGroupTriangleNormalIndices[iNumValidClusterGroups] = std::move(aaiClusterGroupTriangleNormalIndices[iClusterGroup]);
+                    aaiClusterGroupTriangleUVIndices[iNumValidClusterGroups] = std::move(aaiClusterGroupTriangleUVIndices[iClusterGroup]);
+                }
+                aiSrcClusterGroups.push_back(iClusterGroup);
+                ++iNumValidClusterGroups;
+            }
+            aaClusterGroupVertexPositions.resize(iNumValidClusterGroups);
+            aaClusterGroupVertexNormals.resize(iNumValidClusterGroups);
+            aaClusterGroupVertexUVs.resize(iNumValidClusterGroups);
+            aaiClusterGroupTrianglePositionIndices.resize(iNumValidClusterGroups);
+            aaiClusterGroupTriangleNormalIndices.resize(iNumValidClusterGroups);
+            aaiClusterGroupTriangleUVIndices.resize(iNumValidClusterGroups);
+
+            // split cluster group, this will be store in MIP 1 of the cluster group, also the children of MIP 0 as well as children of the next LOD level
+            // the cluster groups are split independently into their own stores
+            std::vector<ClusterStore> aGroupClusters(iNumValidClusterGroups);
+            parallelFor(
+                iNumValidClusterGroups,
+                1,
+                [&aGroupClusters,
+                &aaClusterGroupVertexPositions,
+                &aaClusterGroupVertexNormals,
+                &aaClusterGroupVertexUVs,
+                &aaiClusterGroupTrianglePositionIndices,
+                &aaiClusterGroupTriangleNormalIndices,
+                &aaiClusterGroupTriangleUVIndices](uint32_t iThreadClusterGroup, uint32_t /*iSlot*/)
+                {
+                    uint32_t iNumGroupClusters = 0;
+                    splitClusterGroups(
+                        aGroupClusters[iThreadClusterGroup],
+                        iNumGroupClusters,
+                        aaClusterGroupVertexPositions[iThreadClusterGroup],
+                        aaClusterGroupVertexNormals[iThreadClusterGroup],
+                        aaClusterGroupVertexUVs[iThreadClusterGroup],
+                        aaiClusterGroupTrianglePositionIndices[iThreadClusterGroup],
+                        aaiClusterGroupTriangleNormalIndices[iThreadClusterGroup],
+                        aaiClusterGroupTriangleUVIndices[iThreadClusterGroup],
+                        kiMaxTrianglesPerCluster);
+                });
 
+            // append in cluster group order, the running cluster count is the global index of the group's first split cluster
             uint32_t iNumClusters = 0;
             uint32_t iTotalClusterIndex = 0;
-            bool bResetLoop = false;
             uint32_t iLastClusterSize = 0;
-            std::vector<std::vector<uint32_t>> aaiGroupClustersIndices(aaiClusterGroupTrianglePositionIndices.size());
-            for(uint32_t iClusterGroup = 0; iClusterGroup < static_cast<uint32_t>(aaiClusterGroupTrianglePositionIndices.size()); iClusterGroup++)
+            std::vector<std::vector<uint32_t>> aaiGroupClustersIndices(iNumValidClusterGroups);
             {
-                if(bResetLoop)
-                {
-                    iClusterGroup = 0;
-                    bResetLoop = false;
-                }
-
-                auto const& aClusterGroupVertexPositions = aaClusterGroupVertexPositions[iClusterGroup];
-                auto const& aiClusterGroupTrianglePositionIndices = aaiClusterGroupTrianglePositionIndices[iClusterGroup];
-
-                auto const& aClusterGroupVertexNormals = aaClusterGroupVertexNormals[iClusterGroup];
-                auto const& aiClusterGroupTriangleNormalIndices = aaiClusterGroupTriangleNormalIndices[iClusterGroup];
-
-                auto const& aClusterGroupVertexUVs = aaClusterGroupVertexUVs[iClusterGroup];
-                auto const& aiClusterGroupTriangleUVIndices = aaiClusterGroupTriangleUVIndices[iClusterGroup];
-
-                // invalid cluster group, skip
-                if(aiClusterGroupTrianglePositionIndices.size() <= 0)
+                uint32_t iNumTotalVertices = 0, iNumTotalTriangleIndices = 0, iNumTotalClusters = 0;
+                for(auto const& groupClusters : aGroupClusters)
                 {
-                    aaClusterGroupVertexPositions.erase(aaClusterGroupVertexPositions.begin() + iClusterGroup);
-                    aaClusterGroupVertexNormals.erase(aaClusterGroupVertexNormals.begin() + iClusterGroup);
-                    aaClusterGroupVertexUVs.erase(aaClusterGroupVertexUVs.begin() + iClusterGroup);
-
-                    aaiClusterGroupTrianglePositionIndices.erase(aaiClusterGroupTrianglePositionIndices.begin() + iClusterGroup);
-                    aaiClusterGroupTriangleNormalIndices.erase(aaiClusterGroupTriangleNormalIndices.begin() + iClusterGroup);
-                    aaiClusterGroupTriangleUVIndices.erase(aaiClusterGroupTriangleUVIndices.begin() + iClusterGroup);
-
-                    bResetLoop = true;
-                    continue;
+                    iNumTotalClusters += getNumClusters(groupClusters);
+                    iNumTotalVertices += static_cast<uint32_t>(groupClusters.maVertexPositions.size());
+                    iNumTotalTriangleIndices += static_cast<uint32_t>(groupClusters.maiTrianglePositionIndices.size());
                 }
+                reserveClusterStore(clusters, iNumTotalClusters, iNumTotalVertices, iNumTotalTriangleIndices);
+            }
+            for(uint32_t iClusterGroup = 0; iClusterGroup < iNumValidClusterGroups; iClusterGroup++)
+            {
+                uint32_t iPrevNumClusters = getNumClusters(clusters);
+                appendClusters(clusters, aGroupClusters[iClusterGroup]);
+                aGroupClusters[iClusterGroup] = ClusterStore();
 
-                // split cluster group, this will be store in MIP 1 of the cluster group, also the children of MIP 0 as well as children of the next LOD level
-                uint32_t iNumSplitClusters = (aaiClusterGroupTrianglePositionIndices.size() <= 1 && aaiClusterGroupTrianglePositionIndices[0].size() / 3 <= kiMaxTrianglesPerCluster) ? 1 : 2;
-                uint32_t iPrevNumClusters = static_cast<uint32_t>(aaClusterVertexPositions.size());
-                splitClusterGroups(
-                    aaClusterVertexPositions,
-                    aaClusterVertexNormals,
-                    aaClusterVertexUVs,
-                    aaiClusterTrianglePositionIndices,
-                    aaiClusterTriangleNormalIndices,
-                    aaiClusterTriangleUVIndices,
-                    iTotalClusterIndex,
-                    aClusterGroupVertexPositions,
-                    aClusterGroupVertexNormals,
-                    aClusterGroupVertexUVs,
-                    aiClusterGroupTrianglePositionIndices,
-                    aiClusterGroupTriangleNormalIndices,
-                    aiClusterGroupTriangleUVIndices,
-                    kiMaxTrianglesPerCluster,
-                    iNumSplitClusters,
-                    iLODLevel,
-                    iClusterGroup,
-                    meshModelName,
-                    homeDirectory);
-
-                uint32_t iNumCreatedClusters = static_cast<uint32_t>(aaClusterVertexPositions.size() - iPrevNumClusters);
+                uint32_t iNumCreatedClusters = getNumClusters(clusters) - iPrevNumClusters;
                 for(uint32_t iSplitCluster = 0; iSplitCluster < iNumCreatedClusters; iSplitCluster++)
                 {
                     uint32_t iCurrCluster = iSplitCluster + iPrevNumClusters;
-                    assert(aaClusterVertexPositions[iCurrCluster].size() > 0 && aaiClusterTrianglePositionIndices[iCurrCluster].size() > 0);
+                    assert(getClusterView(clusters, iCurrCluster).mVertexPositions.size() > 0 && getClusterView(clusters, iCurrCluster).maiTrianglePositionIndices.size() > 0);
 
                     aaiGroupClustersIndices[iClusterGroup].push_back(iCurrCluster);
                 }
 
             }   // for cluster group = 0 to num cluster groups
 
+            // cluster index to its position in this LOD's mesh clusters for setting the parents below
+            std::vector<uint32_t> aiMeshClusterPositions;
+            for(uint32_t iMeshCluster = 0; iMeshCluster < static_cast<uint32_t>(aaMeshClusters[iLODLevel].size()); iMeshCluster++)
+            {
+                uint32_t iClusterID = aaMeshClusters[iLODLevel][iMeshCluster].miIndex;
+                if(iClusterID >= static_cast<uint32_t>(aiMeshClusterPositions.size()))
+                {
+                    aiMeshClusterPositions.resize(iClusterID + 1, UINT32_MAX);
+                }
+                aiMeshClusterPositions[iClusterID] = iMeshCluster;
+            }
+
             iTotalClusterIndex = 0;
-            for(uint32_t iClusterGroup = 0; iClusterGroup < static_cast<uint32_t>(aaiClusterGroupTrianglePositionIndices.size()); iClusterGroup++)
+            for(uint32_t iClusterGroup = 0; iClusterGroup < iNumValidClusterGroups; iClusterGroup++)
             {
                 iTotalClusterIndex += static_cast<uint32_t>(aaiGroupClustersIndices[iClusterGroup].size());
-                uint32_t iCurrNumClusters = static_cast<uint32_t>(aaClusterVertexPositions.size());
+                auto& meshClusterGroup = aaMeshClusterGroups[iLODLevel][aiSrcClusterGroups[iClusterGroup]];
 
                 // add the split clusters into the cluster group for MIP 1
                 //uint32_t iNumNewlySplitClusters = iCurrNumClusters - iPrevNumClusters;
                 uint32_t iNumNewlySplitClusters = static_cast<uint32_t>(aaiGroupClustersIndices[iClusterGroup].size());
                 assert(iNumNewlySplitClusters < MAX_CLUSTERS_IN_GROUP);
-                aaMeshClusterGroups[iLODLevel][iClusterGroup].maiNumClusters[1] = (aaMeshClusterGroups[iLODLevel][iClusterGroup].maiNumClusters[1] > 20) ? 0 : aaMeshClusterGroups[iLODLevel][iClusterGroup].maiNumClusters[1];
+                meshClusterGroup.maiNumClusters[1] = (meshClusterGroup.maiNumClusters[1] > 20) ? 0 : meshClusterGroup.maiNumClusters[1];
                 for(uint32_t i = 0; i < iNumNewlySplitClusters; i++)
                 {
-                    aaMeshClusterGroups[iLODLevel][iClusterGroup].maiClusters[1][i] = iTotalMeshClusters + iNumClusters + i;
-                    assert(aaMeshClusterGroups[iLODLevel][iClusterGroup].maiNumClusters[1] < MAX_CLUSTERS_IN_GROUP);
-                    aaMeshClusterGroups[iLODLevel][iClusterGroup].maiNumClusters[1] += 1;
+                    meshClusterGroup.maiClusters[1][i] = iTotalMeshClusters + iNumClusters + i;
+                    assert(meshClusterGroup.maiNumClusters[1] < MAX_CLUSTERS_IN_GROUP);
+                    meshClusterGroup.maiNumClusters[1] += 1;
                 }
 
                 // set the parents of the previous clusters (MIP 0) from the split clusters (MIP 1)
                 uint32_t const kiParentMIP = 0;
-                for(uint32_t i = 0; i < static_cast<uint32_t>(aaMeshClusterGroups[iLODLevel][iClusterGroup].maiNumClusters[kiParentMIP]); i++)
+                for(uint32_t i = 0; i < static_cast<uint32_t>(meshClusterGroup.maiNumClusters[kiParentMIP]); i++)
                 {
-                    uint32_t iClusterID = aaMeshClusterGroups[iLODLevel][iClusterGroup].maiClusters[kiParentMIP][i];
-                    auto iter = std::find_if(
-                        aaMeshClusters[iLODLevel].begin(),
-                        aaMeshClusters[iLODLevel].end(),
-                        [iClusterID](MeshCluster const& checkCluster)
-                        {
-                            return checkCluster.miIndex == iClusterID;
-                        }
-                    );
-                    assert(iter != aaMeshClusters[iLODLevel].end());
+                    uint32_t iClusterID = meshClusterGroup.maiClusters[kiParentMIP][i];
+                    assert(iClusterID < static_cast<uint32_t>(aiMeshClusterPositions.size()) && aiMeshClusterPositions[iClusterID] != UINT32_MAX);
+                    auto iter = aaMeshClusters[iLODLevel].begin() + aiMeshClusterPositions[iClusterID];
                     for(uint32_t i = 0; i < iNumNewlySplitClusters; i++)
                     {
                         // parent cluster from the total cluster index
@@ -1435,7 +1107,7 @@ auto start = std::chrono::high_resolution_clock::now();
                 }
 
                 // has MIP 1
-                ++aaMeshClusterGroups[iLODLevel][iClusterGroup].miNumMIPS;
+                ++meshClusterGroup.miNumMIPS;
                 iNumClusters = iTotalClusterIndex;
 
                 iLastClusterSize = static_cast<uint32_t>(aaClusterGroupVertexPositions.size());
@@ -1444,44 +1116,23 @@ auto start = std::chrono::high_resolution_clock::now();
 
 auto end = std::chrono::high_resolution_clock::now();
 uint64_t iSeconds = std::chrono::duration_cast<std::chrono::seconds>(end - start).count();
-DEBUG_PRINTF("took %lld seconds to split cluster groups\n", iSeconds);
+DEBUG_PRINTF("took %" PRIu64 " seconds to split cluster groups\n", iSeconds);
 
         }   // split cluster groups
 
         // delete de-generate cluster with no vertex positions
-        bool bReset = false;
-        for(uint32_t i = 0; i < static_cast<uint32_t>(aaClusterVertexPositions.size()); i++)
+        uint32_t iNumDeletedClusters = removeEmptyClusters(clusters);
+        if(iNumDeletedClusters > 0)
         {
-            if(bReset)
-            {
-                i = 0;
-                bReset = false;
-            }
-
-            if(aaClusterVertexPositions[i].size() <= 0)
-            {
-                DEBUG_PRINTF("!!! delete cluster %d with %d vertex positions !!!\n",
-                    i,
-                    static_cast<uint32_t>(aaClusterVertexPositions[i].size()));
-
-                aaClusterVertexPositions.erase(aaClusterVertexPositions.begin() + i);
-                aaClusterVertexNormals.erase(aaClusterVertexNormals.begin() + i);
-                aaClusterVertexUVs.erase(aaClusterVertexUVs.begin() + i);
-
-                aaiClusterTrianglePositionIndices.erase(aaiClusterTrianglePositionIndices.begin() + i);
-                aaiClusterTriangleNormalIndices.erase(aaiClusterTriangleNormalIndices.begin() + i);
-                aaiClusterTriangleUVIndices.erase(aaiClusterTriangleUVIndices.begin() + i);
-
-                bReset = true;
-            }
+            DEBUG_PRINTF("!!! deleted %d clusters with no vertex positions !!!\n", iNumDeletedClusters);
         }
 
-        iNumClusters = static_cast<uint32_t>(aaClusterVertexPositions.size());
+        iNumClusters = getNumClusters(clusters);
         iNumClusterGroups = static_cast<uint32_t>(ceilf(float(iNumClusters) / 4.0f));
 
 auto totalLODEnd = std::chrono::high_resolution_clock::now();
 uint64_t iTotalLODSeconds = std::chrono::duration_cast<std::chrono::seconds>(totalLODEnd - totalLODStart).count();
-DEBUG_PRINTF("\n************\n\ntook total %lld seconds for lod %d\n\n**************\n", iTotalLODSeconds, iLODLevel);
+DEBUG_PRINTF("\n************\n\ntook total %" PRIu64 " seconds for lod %d\n\n**************\n", iTotalLODSeconds, iLODLevel);
 
     }   // for lod = 0 to num lod levels
 
@@ -1494,6 +1145,8 @@ DEBUG_PRINTF("\n************\n\ntook total %lld seconds for lod %d\n\n**********
             std::vector<uint32_t> aiClusterGroupMap(iNumClusters);
             aiClusterGroupMap[0] = 0;
 
+            ClusterView cluster = getClusterView(clusters, iCluster);
+
             // parent mesh cluster will be cluster group index * 2
             aaMeshClusters[iNumLODLevels - 1].emplace_back(
                 giTotalVertexPositionDataOffset,
@@ -1502,10 +1155,10 @@ DEBUG_PRINTF("\n************\n\ntook total %lld seconds for lod %d\n\n**********
                 giTotalTrianglePositionIndexDataOffset,
                 giTotalTriangleNormalIndexDataOffset,
                 giTotalTriangleUVIndexDataOffset,
-                static_cast<uint32_t>(aaClusterVertexPositions[iCluster].size()),
-                static_cast<uint32_t>(aaClusterVertexNormals[iCluster].size()),
-                static_cast<uint32_t>(aaClusterVertexUVs[iCluster].size()),
-                static_cast<uint32_t>(aaiClusterTrianglePositionIndices[iCluster].size()),
+                static_cast<uint32_t>(cluster.mVertexPositions.size()),
+                static_cast<uint32_t>(cluster.mVertexNormals.size()),
+                static_cast<uint32_t>(cluster.mVertexUVs.size()),
+                static_cast<uint32_t>(cluster.maiTrianglePositionIndices.size()),
                 aiClusterGroupMap[iCluster],
                 iNumLODLevels - 1,
                 iTotalMeshClusters,
@@ -1513,16 +1166,16 @@ DEBUG_PRINTF("\n************\n\ntook total %lld seconds for lod %d\n\n**********
 
             // compute cluster's average normal
             float3 avgNormal = float3(0.0f, 0.0f, 0.0f);
-            std::vector<float3> aFaceNormals(aaiClusterTrianglePositionIndices[iCluster].size() / 3);
-            for(uint32_t iTri = 0; iTri < static_cast<uint32_t>(aaiClusterTrianglePositionIndices[iCluster].size()); iTri += 3)
+            std::vector<float3> aFaceNormals(cluster.maiTrianglePositionIndices.size() / 3);
+            for(uint32_t iTri = 0; iTri < cluster.maiTrianglePositionIndices.size(); iTri += 3)
             {
-                uint32_t iPos0 = aaiClusterTrianglePositionIndices[iCluster][iTri];
-                uint32_t iPos1 = aaiClusterTrianglePositionIndices[iCluster][iTri + 1];
-                uint32_t iPos2 = aaiClusterTrianglePositionIndices[iCluster][iTri + 2];
+                uint32_t iPos0 = cluster.maiTrianglePositionIndices[iTri];
+                uint32_t iPos1 = cluster.maiTrianglePositionIndices[iTri + 1];
+                uint32_t iPos2 = cluster.maiTrianglePositionIndices[iTri + 2];
 
-                float3 const& pos0 = aaClusterVertexPositions[iCluster][iPos0];
-                float3 const& pos1 = aaClusterVertexPositions[iCluster][iPos1];
-                float3 const& pos2 = aaClusterVertexPositions[iCluster][iPos2];
+                float3 const& pos0 = cluster.mVertexPositions[iPos0];
+                float3 const& pos1 = cluster.mVertexPositions[iPos1];
+                float3 const& pos2 = cluster.mVertexPositions[iPos2];
 
                 float3 diff0 = pos1 - pos0;
                 float3 diff1 = pos2 - pos0;
@@ -1530,7 +1183,7 @@ DEBUG_PRINTF("\n************\n\ntook total %lld seconds for lod %d\n\n**********
                 aFaceNormals[iTri / 3] = cross(normalize(diff1), normalize(diff0));
                 avgNormal += aFaceNormals[iTri / 3];
             }
-            avgNormal /= static_cast<float>(aaiClusterTrianglePositionIndices[iCluster].size() / 3);
+            avgNormal /= static_cast<float>(cluster.maiTrianglePositionIndices.size() / 3);
 
             // get the cone radius (min dot product of average normal with triangle normal, ie. greatest cosine angle)
             float fMinDP = FLT_MAX;
@@ -1542,50 +1195,50 @@ DEBUG_PRINTF("\n************\n\ntook total %lld seconds for lod %d\n\n**********
 
 
             // copy vertex positions and triangle indices their respective buffers
-            uint64_t iDataSize = aaClusterVertexPositions[iCluster].size();
+            uint64_t iDataSize = cluster.mVertexPositions.size();
             memcpy(
                 vertexPositionBuffer.data() + giTotalVertexPositionDataOffset * sizeof(float3),
-                aaClusterVertexPositions[iCluster].data(),
+                cluster.mVertexPositions.data(),
                 iDataSize * sizeof(float3));
             giTotalVertexPositionDataOffset += iDataSize;
 
             // normal
-            iDataSize = aaClusterVertexNormals[iCluster].size();
+            iDataSize = cluster.mVertexNormals.size();
             memcpy(
                 vertexNormalBuffer.data() + giTotalVertexNormalDataOffset * sizeof(float3),
-                aaClusterVertexNormals[iCluster].data(),
+                cluster.mVertexNormals.data(),
                 iDataSize * sizeof(float3));
             giTotalVertexNormalDataOffset += iDataSize;
 
             // uv
-            iDataSize = aaClusterVertexUVs[iCluster].size();
+            iDataSize = cluster.mVertexUVs.size();
             memcpy(
                 vertexUVBuffer.data() + giTotalVertexUVDataOffset * sizeof(float3),
-                aaClusterVertexUVs[iCluster].data(),
+                cluster.mVertexUVs.data(),
                 iDataSize * sizeof(float2));
             giTotalVertexUVDataOffset += iDataSize;
 
             // position indices
-            iDataSize = aaiClusterTrianglePositionIndices[iCluster].size();
+            iDataSize = cluster.maiTrianglePositionIndices.size();
             memcpy(
                 trianglePositionIndexBuffer.data() + giTotalTrianglePositionIndexDataOffset * sizeof(uint32_t),
-                aaiClusterTrianglePositionIndices[iCluster].data(),
+                cluster.maiTrianglePositionIndices.data(),
                 iDataSize * sizeof(uint32_t));
             giTotalTrianglePositionIndexDataOffset += iDataSize;
 
             // normal indices
-            iDataSize = aaiClusterTriangleNormalIndices[iCluster].size();
+            iDataSize = cluster.maiTriangleNormalIndices.size();
             memcpy(
                 triangleNormalIndexBuffer.data() + giTotalTriangleNormalIndexDataOffset * sizeof(uint32_t),
-                aaiClusterTriangleNormalIndices[iCluster].data(),
+                cluster.maiTriangleNormalIndices.data(),
                 iDataSize * sizeof(uint32_t));
             giTotalTriangleNormalIndexDataOffset += iDataSize;
 
             // uv indices
-            iDataSize = aaiClusterTriangleUVIndices[iCluster].size();
+            iDataSize = cluster.maiTriangleUVIndices.size();
             memcpy(
                 triangleUVIndexBuffer.data() + giTotalTriangleUVIndexDataOffset * sizeof(uint32_t),
-                aaiClusterTriangleUVIndices[iCluster].data(),
+                cluster.maiTriangleUVIndices.data(),
                 iDataSize * sizeof(uint32_t));
             giTotalTriangleUVIndexDataOffset += iDataSize;
 
@@ -1639,55 +1292,50 @@ DEBUG_PRINTF("\n************\n\ntook total %lld seconds for lod %d\n\n**********
     DEBUG_PRINTF("*** assign cluster to cluster group ***\n");
     start = std::chrono::high_resolution_clock::now();
     {
-        uint32_t iClusterIndex = 0;
+        // cluster index to cluster, then one pass over the groups' cluster lists in group order
+        std::vector<MeshCluster*> apClustersByIndex;
         for(auto* pCluster : apTotalMeshClusters)
         {
             assert(pCluster->miNumClusterGroups == 0);
-            for(auto const* pClusterGroup : apTotalMeshClusterGroups)
+            if(pCluster->miIndex >= static_cast<uint32_t>(apClustersByIndex.size()))
+            {
+                apClustersByIndex.resize(pCluster->miIndex + 1, nullptr);
+            }
+            apClustersByIndex[pCluster->miIndex] = pCluster;
+        }
+
+        for(auto const* pClusterGroup : apTotalMeshClusterGroups)
+        {
+            for(uint32_t iMIP = 0; iMIP < 2; iMIP++)
             {
-                for(uint32_t iMIP = 0; iMIP < 2; iMIP++)
+                if(pClusterGroup->maiNumClusters[iMIP] >= MAX_CLUSTERS_IN_GROUP)
+                {
+                    continue;
+                }
+                uint32_t iNumClustersInGroup = pClusterGroup->maiNumClusters[iMIP];
+                for(uint32_t iClusterInGroup = 0; iClusterInGroup < iNumClustersInGroup; iClusterInGroup++)
                 {
-                    if(pClusterGroup->maiNumClusters[iMIP] >= MAX_CLUSTERS_IN_GROUP)
+                    uint32_t iClusterID = pClusterGroup->maiClusters[iMIP][iClusterInGroup];
+                    if(iClusterID >= static_cast<uint32_t>(apClustersByIndex.size()) || apClustersByIndex[iClusterID] == nullptr)
                     {
                         continue;
                     }
-                    uint32_t iNumClustersInGroup = pClusterGroup->maiNumClusters[iMIP];
-                    //printf("mip %d iNumClustersInGroup = %d cluster group %d\n", 
-                    //    iMIP,
-                    //    iNumClustersInGroup, 
-                    //    pClusterGroup->miIndex);
-                    for(uint32_t iClusterInGroup = 0; iClusterInGroup < iNumClustersInGroup; iClusterInGroup++)
+
+                    MeshCluster* pCluster = apClustersByIndex[iClusterID];
+                    if(pCluster->maiClusterGroups[0] != pClusterGroup->miIndex && pCluster->maiClusterGroups[1] != pClusterGroup->miIndex)
                     {
-                        //printf("cluster in group %d(%d) curr cluster index %d, id %d with num associated cluster groups %d\n", 
-                        //    iClusterInGroup,
-                        //    iNumClustersInGroup,
-                        //    iClusterIndex, 
-                        //    pCluster->miIndex, 
-                        //    pCluster->miNumClusterGroups);
-                        if(pClusterGroup->maiClusters[iMIP][iClusterInGroup] == pCluster->miIndex)
-                        {
-                            //printf("\tcluster group %d, cluster %d = %d\n", 
-                            //    pClusterGroup->miIndex, 
-                            //    iClusterInGroup, 
-                            //    pCluster->miIndex);
-                            if(pCluster->maiClusterGroups[0] != pClusterGroup->miIndex && pCluster->maiClusterGroups[1] != pClusterGroup->miIndex)
-                            {
-                                assert(pCluster->miNumClusterGroups < MAX_ASSOCIATED_GROUPS);
-                                pCluster->maiClusterGroups[pCluster->miNumClusterGroups] = pClusterGroup->miIndex;
+                        assert(pCluster->miNumClusterGroups < MAX_ASSOCIATED_GROUPS);
+                        pCluster->maiClusterGroups[pCluster->miNumClusterGroups] = pClusterGroup->miIndex;
 
-                                //DEBUG_PRINTF("cluster %d lod %d group: %d\n", pCluster->miIndex, pCluster->miLODLevel, pClusterGroup->miIndex);
-                                ++pCluster->miNumClusterGroups;
-                            }
-                        }
+                        //DEBUG_PRINTF("cluster %d lod %d group: %d\n", pCluster->miIndex, pCluster->miLODLevel, pClusterGroup->miIndex);
+                        ++pCluster->miNumClusterGroups;
                     }
                 }
             }
-
-            ++iClusterIndex;
         }
     }
     uint64_t iElapsedSeconds = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::high_resolution_clock::now() - start).count();
-    DEBUG_PRINTF("Took %lld seconds to assign cluster to cluster group\n", iElapsedSeconds);
+    DEBUG_PRINTF("Took %" PRIu64 " seconds to assign cluster to cluster group\n", iElapsedSeconds);
 
     DEBUG_PRINTF("*** start getting shortest distance from LOD 0 and cluster error terms ***\n");
     start = std::chrono::high_resolution_clock::now();
@@ -1697,87 +1345,76 @@ DEBUG_PRINTF("\n************\n\ntook total %lld seconds for lod %d\n\n**********
     std::vector<std::vector<std::pair<float3, float3>>> aaMaxErrorPositionsFromLOD0(iNumLODLevels);
     std::vector<std::vector<float>> aafClusterAverageDistanceFromLOD0(iNumLODLevels);
     {
-        struct MeshClusterDistanceInfo
-        {
-            uint32_t        miClusterLOD0;
-            float           mfDistance;
-        };
+        uint32_t const kiNumUpperClustersToCheck = 3;
 
         DEBUG_PRINTF("*** start getting shortest distance from LOD 0\n");
         start = std::chrono::high_resolution_clock::now();
 
-        // get cluster distances from the LOD 0 clusters
-        std::vector<std::vector<std::vector<MeshClusterDistanceInfo>>> aaaMeshClusterDistanceInfo(iNumLODLevels);
+        // closest LOD 0 clusters by center distance, k-d tree over the LOD 0 cluster centers
+        std::vector<float3> aClusterCentersLOD0(aaMeshClusters[0].size());
+        for(uint32_t iCluster = 0; iCluster < static_cast<uint32_t>(aaMeshClusters[0].size()); iCluster++)
+        {
+            aClusterCentersLOD0[iCluster] = aaMeshClusters[0][iCluster].mCenter;
+        }
+        PointKDTree clusterCenterTreeLOD0;
+        buildPointKDTree(clusterCenterTreeLOD0, aClusterCentersLOD0);
+        uint32_t iNumUpperClustersToCheck = std::min(kiNumUpperClustersToCheck, static_cast<uint32_t>(aaMeshClusters[0].size()));
 
-        static std::atomic<uint32_t> siCurrCluster;
-        uint32_t const kiMaxThreads = 12;
-        for(uint32_t iLODLevel = 0; iLODLevel < iNumLODLevels; iLODLevel++)
+        // iNumUpperClustersToCheck entries per cluster, nearest first, LOD 0 clusters are their own closest
+        std::vector<std::vector<uint32_t>> aaiClosestClustersLOD0(iNumLODLevels);
+        for(uint32_t iLODLevel = 1; iLODLevel < iNumLODLevels; iLODLevel++)
         {
             uint32_t iNumProcessClusters = static_cast<uint32_t>(aaMeshClusters[iLODLevel].size());
-            aaaMeshClusterDistanceInfo[iLODLevel].resize(iNumProcessClusters);
-            
-            // allocate distance info for cluster
-            for(uint32_t iCluster = 0; iCluster < iNumProcessClusters; iCluster++)
-            {
-                aaaMeshClusterDistanceInfo[iLODLevel][iCluster].resize(aaMeshClusters[0].size());
-            }
-
-            siCurrCluster = 0;
-
-            // compute distance info from LOD 0
-            std::vector<std::unique_ptr<std::thread>> apThreads(kiMaxThreads);
-            for(uint32_t iThread = 0; iThread < kiMaxThreads; iThread++)
-            {
-                apThreads[iThread] = std::make_unique<std::thread>(
-                    [&aaaMeshClusterDistanceInfo,
-                     aaMeshClusters,
-                     iNumProcessClusters,
-                     iLODLevel]()
-                    {
-                        for(;;)
-                        {
-                            uint32_t iCluster = siCurrCluster.fetch_add(1);
-                            if(iCluster >= iNumProcessClusters)
-                            {
-                                return;
-                            }
-
-                            auto const& meshCluster = aaMeshClusters[iLODLevel][iCluster];
-                            for(uint32_t iUpperCluster = 0; iUpperCluster < static_cast<uint32_t>(aaaMeshClusterDistanceInfo[iLODLevel][iCluster].size()); iUpperCluster++)
-                            {
-                                auto const& upperMeshCluster = aaMeshClusters[0][iUpperCluster];
-                                float fDistance = length(upperMeshCluster.mCenter - meshCluster.mCenter);
-                                aaaMeshClusterDistanceInfo[iLODLevel][iCluster][iUpperCluster].miClusterLOD0 = iUpperCluster;
-                                aaaMeshClusterDistanceInfo[iLODLevel][iCluster][iUpperCluster].mfDistance = fDistance;
-                            }
-
-                            std::sort(
-                                aaaMeshClusterDistanceInfo[iLODLevel][iCluster].begin(),
-                                aaaMeshClusterDistanceInfo[iLODLevel][iCluster].end(),
-                                [](MeshClusterDistanceInfo& info0, MeshClusterDistanceInfo& info1)
-                                {
-                                    return info0.mfDistance < info1.mfDistance;
-                                }
-                            );
-                        }
-                    });
-            }
-
-            for(uint32_t iThread = 0; iThread < kiMaxThreads; iThread++)
-            {
-                if(apThreads[iThread]->joinable())
+            aaiClosestClustersLOD0[iLODLevel].resize(iNumProcessClusters * iNumUpperClustersToCheck);
+
+            parallelFor(
+                iNumProcessClusters,
+                64,
+                [&aaiClosestClustersLOD0,
+                 &aaMeshClusters,
+                 &clusterCenterTreeLOD0,
+                 iNumUpperClustersToCheck,
+                 iLODLevel](uint32_t iCluster, uint32_t /*iSlot*/)
                 {
-                    apThreads[iThread]->join();
-                }
-            }
+                    float afDistances[kiNumUpperClustersToCheck];
+                    uint32_t iNumFound = getNearestPointsSquared(
+                        aaiClosestClustersLOD0[iLODLevel].data() + iCluster * iNumUpperClustersToCheck,
+                        afDistances,
+                        clusterCenterTreeLOD0,
+                        aaMeshClusters[iLODLevel][iCluster].mCenter,
+                        iNumUpperClustersToCheck);
+                    assert(iNumFound == iNumUpperClustersToCheck);
+                });
         }
 
         iElapsedSeconds = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::high_resolution_clock::now() - start).count();
-        DEBUG_PRINTF("Took %lld seconds to get the shortest distance from LOD 0\n", iElapsedSeconds);
+        DEBUG_PRINTF("Took %" PRIu64 " seconds to get the shortest distance from LOD 0\n", iElapsedSeconds);
 
         start = std::chrono::high_resolution_clock::now();
 
-        uint32_t const kiNumUpperClustersToCheck = 3;
+        // one triangle bvh per LOD 0 cluster for the surface error, shared by every cluster that checks against it
+        std::vector<TriangleBVH> aClusterBVHsLOD0;
+        if(bSurfaceError)
+        {
+            aClusterBVHsLOD0.resize(aaMeshClusters[0].size());
+            parallelFor(
+                static_cast<uint32_t>(aaMeshClusters[0].size()),
+                16,
+                [&aClusterBVHsLOD0,
+                 &aaMeshClusters](uint32_t iClusterLOD0, uint32_t /*iSlot*/)
+                {
+                    auto const& meshClusterLOD0 = aaMeshClusters[0][iClusterLOD0];
+                    float3 const* pClusterVertexPositionsLOD0 = reinterpret_cast<float3 const*>(vertexPositionBuffer.data() + meshClusterLOD0.miVertexPositionStartArrayAddress * sizeof(float3));
+                    uint32_t const* piClusterPositionIndicesLOD0 = reinterpret_cast<uint32_t const*>(trianglePositionIndexBuffer.data() + meshClusterLOD0.miTrianglePositionIndexArrayAddress * sizeof(uint32_t));
+
+                    std::vector<float3> aTriangleVertexPositionsLOD0(meshClusterLOD0.miNumTrianglePositionIndices);
+                    for(uint32_t iTriVert = 0; iTriVert < static_cast<uint32_t>(aTriangleVertexPositionsLOD0.size()); iTriVert++)
+                    {
+                        aTriangleVertexPositionsLOD0[iTriVert] = pClusterVertexPositionsLOD0[piClusterPositionIndicesLOD0[iTriVert]];
+                    }
+                    buildTriangleBVH(aClusterBVHsLOD0[iClusterLOD0], aTriangleVertexPositionsLOD0);
+                });
+        }
 
         struct ClosestVertexInfo
         {
@@ -1788,6 +1425,14 @@ DEBUG_PRINTF("\n************\n\ntook total %lld seconds for lod %d\n\n**********
             float3              mVertexPositionLOD0;
         };
 
+        // per worker scratch for the surface error: cluster vertices, the closest points per LOD 0 cluster and the closest overall
+        uint32_t iNumWorkers = getNumTaskWorkers();
+        std::vector<std::vector<float3>> aaSurfaceVertexPositions(iNumWorkers);
+        std::vector<std::vector<float>> aafSurfaceDistances(iNumWorkers);
+        std::vector<std::vector<float3>> aaSurfacePositions(iNumWorkers);
+        std::vector<std::vector<float>> aafClosestSurfaceDistances(iNumWorkers);
+        std::vector<std::vector<float3>> aaClosestSurfacePositions(iNumWorkers);
+
         auto start = std::chrono::high_resolution_clock::now();
         for(uint32_t iLODLevel = 0; iLODLevel < iNumLODLevels; iLODLevel++)
         {
@@ -1795,6 +1440,78 @@ DEBUG_PRINTF("\n************\n\ntook total %lld seconds for lod %d\n\n**********
             aaMaxErrorPositionsFromLOD0[iLODLevel].resize(aaMeshClusters[iLODLevel].size());
             aafClusterAverageDistanceFromLOD0[iLODLevel].resize(aaMeshClusters[iLODLevel].size());
             uint32_t iNumClusters = static_cast<uint32_t>(aaMeshClusters[iLODLevel].size());
+
+            // surface error is cpu only, the clusters run in parallel and each checks its vertices against its closest LOD 0 clusters' bvhs
+            if(bSurfaceError && iLODLevel > 0)
+            {
+                parallelFor(
+                    iNumClusters,
+                    4,
+                    [&aafClusterDistancesFromLOD0,
+                     &aaMaxErrorPositionsFromLOD0,
+                     &aafClusterAverageDistanceFromLOD0,
+                     &aaSurfaceVertexPositions,
+                     &aafSurfaceDistances,
+                     &aaSurfacePositions,
+                     &aafClosestSurfaceDistances,
+                     &aaClosestSurfacePositions,
+                     &aaMeshClusters,
+                     &aaiClosestClustersLOD0,
+                     &aClusterBVHsLOD0,
+                     iNumUpperClustersToCheck,
+                     iLODLevel](uint32_t iCluster, uint32_t iSlot)
+                    {
+                        auto& aClusterVertexPositions = aaSurfaceVertexPositions[iSlot];
+                        auto& afDistances = aafSurfaceDistances[iSlot];
+                        auto& aPositions = aaSurfacePositions[iSlot];
+                        auto& afClosestDistances = aafClosestSurfaceDistances[iSlot];
+                        auto& aClosestPositions = aaClosestSurfacePositions[iSlot];
+
+                        auto const& meshCluster = aaMeshClusters[iLODLevel][iCluster];
+                        float3 const* pClusterVertexPositions = reinterpret_cast<float3 const*>(vertexPositionBuffer.data() + meshCluster.miVertexPositionStartArrayAddress * sizeof(float3));
+                        aClusterVertexPositions.assign(pClusterVertexPositions, pClusterVertexPositions + meshCluster.miNumVertexPositions);
+                        afClosestDistances.assign(meshCluster.miNumVertexPositions, 1.0e+10f);
+                        aClosestPositions.assign(aClusterVertexPositions.begin(), aClusterVertexPositions.end());
+
+                        // closest points on the LOD 0 triangles, not tied to a LOD 0 vertex
+                        for(uint32_t iUpperCluster = 0; iUpperCluster < iNumUpperClustersToCheck; iUpperCluster++)
+                        {
+                            uint32_t iUpperClusterIndex = aaiClosestClustersLOD0[iLODLevel][iCluster * iNumUpperClustersToCheck + iUpperCluster];
+                            getClosestSurfaceDistancesCPU(
+                                afDistances,
+                                aPositions,
+                                aClusterVertexPositions,
+                                aClusterBVHsLOD0[iUpperClusterIndex]);
+
+                            for(uint32_t i = 0; i < meshCluster.miNumVertexPositions; i++)
+                            {
+                                if(afDistances[i] < afClosestDistances[i])
+                                {
+                                    afClosestDistances[i] = afDistances[i];
+                                    aClosestPositions[i] = aPositions[i];
+                                }
+                            }
+                        }
+
+                        // largest of the closest distances is the cluster's error
+                        uint32_t iLargestDistanceVertex = 0;
+                        for(uint32_t i = 1; i < meshCluster.miNumVertexPositions; i++)
+                        {
+                            if(afClosestDistances[i] > afClosestDistances[iLargestDistanceVertex])
+                            {
+                                iLargestDistanceVertex = i;
+                            }
+                        }
+
+                        aafClusterAverageDistanceFromLOD0[iLODLevel][iCluster] = afClosestDistances[iLargestDistanceVertex];
+                        aafClusterDistancesFromLOD0[iLODLevel][iCluster] = afClosestDistances[iLargestDistanceVertex];
+                        aaMaxErrorPositionsFromLOD0[iLODLevel][iCluster].first = aClusterVertexPositions[iLargestDistanceVertex];
+                        aaMaxErrorPositionsFromLOD0[iLODLevel][iCluster].second = aClosestPositions[iLargestDistanceVertex];
+                    });
+
+                continue;
+            }
+
             for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
             {
                 if(iLODLevel == 0)
@@ -1840,9 +1557,9 @@ DEBUG_PRINTF("\n************\n\ntook total %lld seconds for lod %d\n\n**********
                 }
 
                 // use the top given number of closest LOD 0 clusters 
-                for(uint32_t iUpperCluster = 0; iUpperCluster < kiNumUpperClustersToCheck; iUpperCluster++)
+                for(uint32_t iUpperCluster = 0; iUpperCluster < iNumUpperClustersToCheck; iUpperCluster++)
                 {
-                    uint32_t iUpperClusterIndex = aaaMeshClusterDistanceInfo[iLODLevel][iCluster][iUpperCluster].miClusterLOD0;
+                    uint32_t iUpperClusterIndex = aaiClosestClustersLOD0[iLODLevel][iCluster * iNumUpperClustersToCheck + iUpperCluster];
 
                     auto const& meshClusterLOD0 = aaMeshClusters[0][iUpperClusterIndex];
 
@@ -1868,7 +1585,8 @@ DEBUG_PRINTF("\n************\n\ntook total %lld seconds for lod %d\n\n**********
                     // get the vertex distances from LOD 0
                     std::vector<float> afClosestDistances(meshClusterLOD0.miNumVertexPositions);
                     std::vector<uint32_t> aiClosestVertexPositions(meshClusterLOD0.miNumVertexPositions);
-                    getShortestVertexDistancesCUDA(
+
+                    getComputeBackend().mpfnGetShortestVertexDistances(
                         afClosestDistances,
                         aiClosestVertexPositions,
                         aClusterVertexPositions,
@@ -1910,7 +1628,7 @@ DEBUG_PRINTF("\n************\n\ntook total %lld seconds for lod %d\n\n**********
                 uint64_t iMilliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(end - start0).count();
                 if(iCluster % 1000 == 0)
                 {
-                    DEBUG_PRINTF("took %lld ms (total: %lld sec) seconds to compute the shortest distance to LOD 0 for cluster %d (%d) of lod %d\n",
+                    DEBUG_PRINTF("took %" PRIu64 " ms (total: %" PRIu64 " sec) seconds to compute the shortest distance to LOD 0 for cluster %d (%d) of lod %d\n",
                         iMilliseconds,
                         iSeconds,
                         iCluster,
@@ -1926,7 +1644,7 @@ DEBUG_PRINTF("\n************\n\ntook total %lld seconds for lod %d\n\n**********
     }   // cuda version of cluster vertex mapping and error terms
 
     iElapsedSeconds = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::high_resolution_clock::now() - start).count();
-    DEBUG_PRINTF("Took %lld seconds to get distances from current LOD to LOD 0\n", iElapsedSeconds);
+    DEBUG_PRINTF("Took %" PRIu64 " seconds to get distances from current LOD to LOD 0\n", iElapsedSeconds);
 
     // make sure LOD always have larger error value than LOD - 1
     for(uint32_t iLODLevel = 1; iLODLevel < iNumLODLevels; iLODLevel++)
@@ -2050,7 +1768,7 @@ DEBUG_PRINTF("\n************\n\ntook total %lld seconds for lod %d\n\n**********
     }
 
     // error values for the last cluster
-    for(uint32_t iCluster = 0; iCluster < static_cast<uint32_t>(aaClusterVertexPositions.size()); iCluster++)
+    for(uint32_t iCluster = 0; iCluster < getNumClusters(clusters); iCluster++)
     {
         uint32_t iClusterGroup = iCluster / 2;
         if(iCluster < aafClusterGroupErrors[iNumLODLevels - 1].size())
@@ -2145,45 +1863,9 @@ DEBUG_PRINTF("\n************\n\ntook total %lld seconds for lod %d\n\n**********
             aTotalMaxClusterDistancePositionFromLOD0);
 
         std::vector<ClusterGroupTreeNode> aClusterGroupNodes;
-        for(auto const& node : aClusterNodes)
-        {
-            uint32_t iClusterGroupAddress = node.miClusterGroupAddress;
-            uint32_t iLODLevel = node.miLevel;
-            auto iter = std::find_if(
-                aClusterGroupNodes.begin(),
-                aClusterGroupNodes.end(),
-                [iClusterGroupAddress,
-                iLODLevel](ClusterGroupTreeNode const& checkNode)
-                {
-                    return checkNode.miClusterGroupAddress == iClusterGroupAddress && checkNode.miLevel == iLODLevel;
-                });
-
-            if(iter == aClusterGroupNodes.end())
-            {
-                ClusterGroupTreeNode groupNode;
-                groupNode.miClusterGroupAddress = node.miClusterGroupAddress;
-                groupNode.maiClusterAddress[groupNode.miNumChildClusters] = node.miClusterAddress;
-                groupNode.miLevel = node.miLevel;
-                ++groupNode.miNumChildClusters;
-
-                aClusterGroupNodes.push_back(groupNode);
-            }
-            else
-            {
-                iter->maiClusterAddress[iter->miNumChildClusters] = node.miClusterAddress;
-                ++iter->miNumChildClusters;
-            }
-
-        }
-
-        std::sort(
-            aClusterGroupNodes.begin(),
-            aClusterGroupNodes.end(),
-            [](ClusterGroupTreeNode const& left, ClusterGroupTreeNode const& right)
-            {
-                return left.miClusterGroupAddress < right.miClusterGroupAddress;
-            }
-        );
+        createClusterGroupTreeNodes(
+            aClusterGroupNodes,
+            aClusterNodes);
 
         std::ostringstream binaryOutputFolderPath;
         {
@@ -2246,7 +1928,9 @@ DEBUG_PRINTF("\n************\n\ntook total %lld seconds for lod %d\n\n**********
             apTotalMeshClusters,
             binaryOutputFolderPath.str() + "mesh-cluster-data.bin");
 
-        saveMeshClusterTriangleData(
+        MeshClusterTriangleData meshClusterTriangleData;
+        buildMeshClusterTriangleData(
+            meshClusterTriangleData,
             vertexPositionBuffer,
             vertexNormalBuffer,
             vertexUVBuffer,
@@ -2254,43 +1938,226 @@ DEBUG_PRINTF("\n************\n\ntook total %lld seconds for lod %d\n\n**********
             triangleNormalIndexBuffer,
             triangleUVIndexBuffer,
             apTotalMeshClusters,
-            binaryOutputFolderPath.str() + "mesh-cluster-triangle-vertex-index-data.bin",
+            true);
+
+        // streaming pages of compressed vertices, the page table says which pages a cluster group and its parents need
+        MeshClusterPageData meshClusterPageData;
+        bool bPagesBuilt = false;
+        if(bExportPages)
+        {
+            bPagesBuilt = buildMeshClusterPages(
+                meshClusterPageData,
+                meshClusterTriangleData,
+                apTotalMeshClusterGroups,
+                iPageSize,
+                true);
+            if(!bPagesBuilt)
+            {
+                DEBUG_PRINTF("!!! a cluster doesn't fit in a %d byte page, no pages exported !!!\n", iPageSize);
+            }
+        }
+
+        if(bPagesBuilt)
+        {
+            for(uint32_t iCluster = 0; iCluster < static_cast<uint32_t>(apTotalMeshClusters.size()); iCluster++)
+            {
+                MeshClusterPageLocation const& location = meshClusterPageData.maClusterLocations[iCluster];
+                assert(location.miPage < meshClusterPageData.miNumPages);
+
+                uint8_t const* pcPage = meshClusterPageData.macPages.data() + static_cast<uint64_t>(location.miPage) * meshClusterPageData.miPageSize;
+                MeshClusterPageCluster const* pPageCluster = reinterpret_cast<MeshClusterPageCluster const*>(pcPage + sizeof(MeshClusterPageHeader)) + location.miPageCluster;
+                assert(pPageCluster->miCluster == iCluster);
+                assert(memcmp(
+                    pcPage + pPageCluster->miVertexDataOffset,
+                    meshClusterTriangleData.maCompressedVertices.data() + meshClusterTriangleData.maiVertexOffsets[iCluster],
+                    pPageCluster->miNumVertices * sizeof(CompressedMeshVertexFormat)) == 0);
+                assert(memcmp(
+                    pcPage + pPageCluster->miIndexDataOffset,
+                    meshClusterTriangleData.macIndices.data() + meshClusterTriangleData.maiIndexOffsets[iCluster] * meshClusterTriangleData.miIndexSize,
+                    pPageCluster->miNumIndices * meshClusterTriangleData.miIndexSize) == 0);
+            }
+
+            // every cluster a group can draw is in its pages or in its dependency pages
+            for(auto const* pClusterGroup : apTotalMeshClusterGroups)
+            {
+                MeshClusterGroupPages const& groupPages = meshClusterPageData.maGroupPages[pClusterGroup->miIndex];
+                auto piPagesStart = meshClusterPageData.maiPageList.begin() + groupPages.miFirstPage;
+                auto piPagesEnd = piPagesStart + groupPages.miNumPages;
+                auto piDependencyPagesStart = meshClusterPageData.maiPageList.begin() + groupPages.miFirstDependencyPage;
+                auto piDependencyPagesEnd = piDependencyPagesStart + groupPages.miNumDependencyPages;
+                for(uint32_t iMIP = 0; iMIP < pClusterGroup->miNumMIPS; iMIP++)
+                {
+                    for(uint32_t i = 0; i < std::min(pClusterGroup->maiNumClusters[iMIP], static_cast<uint32_t>(MAX_CLUSTERS_IN_GROUP)); i++)
+                    {
+                        uint32_t iPage = meshClusterPageData.maClusterLocations[pClusterGroup->maiClusters[iMIP][i]].miPage;
+                        assert(std::find(piPagesStart, piPagesEnd, iPage) != piPagesEnd || (iMIP > 0 && std::find(piDependencyPagesStart, piDependencyPagesEnd, iPage) != piDependencyPagesEnd));
+                    }
+                }
+            }
+        }
+
+        saveMeshClusterTriangleData(
+            meshClusterTriangleData,
+            std::string(""),
             binaryOutputFolderPath.str() + "mesh-cluster-triangle-vertex-data.bin",
-            binaryOutputFolderPath.str() + "mesh-cluster-triangle-index-data.bin");
+            binaryOutputFolderPath.str() + "mesh-cluster-triangle-index-data.bin",
+            binaryOutputFolderPath.str() + "mesh-cluster-triangle-compressed-vertex-data.bin");
+
+        // everything above in one archive, sections are used in place once it's mapped
+        {
+            std::vector<MeshCluster> aArchiveMeshClusters(apTotalMeshClusters.size());
+            for(uint32_t i = 0; i < static_cast<uint32_t>(apTotalMeshClusters.size()); i++)
+            {
+                aArchiveMeshClusters[i] = *apTotalMeshClusters[i];
+            }
+
+            std::vector<ClusterArchiveSectionData> aArchiveSections;
+            aArchiveSections.push_back(getClusterArchiveSectionData(CLUSTER_ARCHIVE_SECTION_CLUSTER_GROUP_TREE_NODES, aClusterGroupNodes));
+            aArchiveSections.push_back(getClusterArchiveSectionData(CLUSTER_ARCHIVE_SECTION_CLUSTER_TREE_NODES, aClusterNodes));
+            aArchiveSections.push_back(getClusterArchiveSectionData(CLUSTER_ARCHIVE_SECTION_MESH_CLUSTERS, aArchiveMeshClusters));
+            // the global buffers are grown by doubling, only the used part up to the running offsets goes in
+            aArchiveSections.push_back({ CLUSTER_ARCHIVE_SECTION_VERTEX_POSITIONS, sizeof(float3), giTotalVertexPositionDataOffset, vertexPositionBuffer.data() });
+            aArchiveSections.push_back({ CLUSTER_ARCHIVE_SECTION_VERTEX_NORMALS, sizeof(float3), giTotalVertexNormalDataOffset, vertexNormalBuffer.data() });
+            aArchiveSections.push_back({ CLUSTER_ARCHIVE_SECTION_VERTEX_UVS, sizeof(float2), giTotalVertexUVDataOffset, vertexUVBuffer.data() });
+            aArchiveSections.push_back({ CLUSTER_ARCHIVE_SECTION_TRIANGLE_POSITION_INDICES, sizeof(uint32_t), giTotalTrianglePositionIndexDataOffset, trianglePositionIndexBuffer.data() });
+            aArchiveSections.push_back({ CLUSTER_ARCHIVE_SECTION_TRIANGLE_NORMAL_INDICES, sizeof(uint32_t), giTotalTriangleNormalIndexDataOffset, triangleNormalIndexBuffer.data() });
+            aArchiveSections.push_back({ CLUSTER_ARCHIVE_SECTION_TRIANGLE_UV_INDICES, sizeof(uint32_t), giTotalTriangleUVIndexDataOffset, triangleUVIndexBuffer.data() });
+            aArchiveSections.push_back(getClusterArchiveSectionData(CLUSTER_ARCHIVE_SECTION_CLUSTER_NUM_VERTICES, meshClusterTriangleData.maiNumClusterVertices));
+            aArchiveSections.push_back(getClusterArchiveSectionData(CLUSTER_ARCHIVE_SECTION_CLUSTER_NUM_INDICES, meshClusterTriangleData.maiNumClusterIndices));
+            aArchiveSections.push_back(getClusterArchiveSectionData(CLUSTER_ARCHIVE_SECTION_CLUSTER_VERTEX_OFFSETS, meshClusterTriangleData.maiVertexOffsets));
+            aArchiveSections.push_back(getClusterArchiveSectionData(CLUSTER_ARCHIVE_SECTION_CLUSTER_INDEX_OFFSETS, meshClusterTriangleData.maiIndexOffsets));
+            // unified full-precision vertices are the drawable copy, the compressed ones only ship inside the pages
+            aArchiveSections.push_back(getClusterArchiveSectionData(CLUSTER_ARCHIVE_SECTION_CLUSTER_VERTICES, meshClusterTriangleData.maVertices));
+            aArchiveSections.push_back({ CLUSTER_ARCHIVE_SECTION_CLUSTER_INDICES, meshClusterTriangleData.miIndexSize, meshClusterTriangleData.macIndices.size() / meshClusterTriangleData.miIndexSize, meshClusterTriangleData.macIndices.data() });
+            if(bPagesBuilt)
+            {
+                aArchiveSections.push_back({ CLUSTER_ARCHIVE_SECTION_CLUSTER_PAGES, meshClusterPageData.miPageSize, meshClusterPageData.miNumPages, meshClusterPageData.macPages.data() });
+                aArchiveSections.push_back(getClusterArchiveSectionData(CLUSTER_ARCHIVE_SECTION_CLUSTER_GROUP_PAGES, meshClusterPageData.maGroupPages));
+                aArchiveSections.push_back(getClusterArchiveSectionData(CLUSTER_ARCHIVE_SECTION_CLUSTER_PAGE_LIST, meshClusterPageData.maiPageList));
+                aArchiveSections.push_back(getClusterArchiveSectionData(CLUSTER_ARCHIVE_SECTION_CLUSTER_PAGE_LOCATIONS, meshClusterPageData.maClusterLocations));
+            }
+            saveClusterArchive(
+                binaryOutputFolderPath.str() + "cluster-archive.bin",
+                aArchiveSections);
+
+            ClusterArchive archive;
+            bool bMapped = mapClusterArchive(
+                archive,
+                binaryOutputFolderPath.str() + "cluster-archive.bin");
+            assert(bMapped);
+            for(auto const& sectionData : aArchiveSections)
+            {
+                ClusterArchiveSection const* pSection = findClusterArchiveSection(archive, sectionData.miType);
+                assert(pSection != nullptr);
+                assert(pSection->miOffset % CLUSTER_ARCHIVE_SECTION_ALIGNMENT == 0);
+                assert(pSection->miNumElements == sectionData.miNumElements);
+                assert(memcmp(archive.mpcData + pSection->miOffset, sectionData.mpData, pSection->miSize) == 0);
+            }
+            unmapClusterArchive(archive);
+        }
         
         uint64_t iElapsedSeconds = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::high_resolution_clock::now() - start).count();
-        DEBUG_PRINTF("Took %lld seconds to save out cluster files\n", iElapsedSeconds);
+        DEBUG_PRINTF("Took %" PRIu64 " seconds to save out cluster files\n", iElapsedSeconds);
 
         {
             std::vector<std::vector<ConvertedMeshVertexFormat>> aaVertices;
             std::vector<std::vector<uint32_t>> aaiTriangleVertexIndices;
             
-            std::vector<uint32_t> aiNumClusterVertices;
-            std::vector<uint32_t> aiNumClusterIndices;
-            std::vector<uint64_t> aiVertexBufferArrayOffsets;
-            std::vector<uint64_t> aiIndexBufferArrayOffset;
-            loadMeshClusterTriangleDataTableOfContent(
-                aiNumClusterVertices,
-                aiNumClusterIndices,
-                aiVertexBufferArrayOffsets,
-                aiIndexBufferArrayOffset,
+            // the chunk reader loads the table of content, the cluster counts and the index size come from it
+            MeshClusterChunkReader chunkReader;
+            bool bOpened = openMeshClusterChunkReader(
+                chunkReader,
                 binaryOutputFolderPath.str() + "mesh-cluster-triangle-vertex-data.bin",
-                binaryOutputFolderPath.str() + "mesh-cluster-triangle-index-data.bin");
+                binaryOutputFolderPath.str() + "mesh-cluster-triangle-index-data.bin",
+                sizeof(ConvertedMeshVertexFormat));
+            assert(bOpened);
+
+            uint32_t iNumChunkClusters = static_cast<uint32_t>(chunkReader.maiNumClusterVertices.size());
+            uint32_t iIndexSize = chunkReader.miIndexSize;
+            std::vector<uint32_t> aiChunkClusters(iNumChunkClusters);
+            for(uint32_t i = 0; i < iNumChunkClusters; i++)
+            {
+                aiChunkClusters[i] = i;
+            }
+
+            // each callback copies its cluster out of the read buffer into the cluster's own slot
+            aaVertices.resize(iNumChunkClusters);
+            aaiTriangleVertexIndices.resize(iNumChunkClusters);
+            {
+                TaskCounter chunkCounter;
+                readMeshClusterChunks(
+                    chunkCounter,
+                    chunkReader,
+                    aiChunkClusters,
+                    [&aaVertices,
+                    &aaiTriangleVertexIndices,
+                    iIndexSize](MeshClusterChunk const& chunk)
+                    {
+                        std::vector<ConvertedMeshVertexFormat>& aVertices = aaVertices[chunk.miCluster];
+                        aVertices.resize(chunk.miVertexDataSize / sizeof(ConvertedMeshVertexFormat));
+                        memcpy(aVertices.data(), chunk.mpcVertexData, chunk.miVertexDataSize);
+
+                        std::vector<uint32_t>& aiIndices = aaiTriangleVertexIndices[chunk.miCluster];
+                        aiIndices.resize(chunk.miIndexDataSize / iIndexSize);
+                        if(iIndexSize == sizeof(uint8_t))
+                        {
+                            std::copy(chunk.mpcIndexData, chunk.mpcIndexData + chunk.miIndexDataSize, aiIndices.begin());
+                        }
+                        else
+                        {
+                            memcpy(aiIndices.data(), chunk.mpcIndexData, chunk.miIndexDataSize);
+                        }
+                    });
+                waitForTasks(chunkCounter);
+                closeMeshClusterChunkReader(chunkReader);
+            }
 
-            aaVertices.resize(aiNumClusterIndices.size());
-            aaiTriangleVertexIndices.resize(aiNumClusterIndices.size());
-            for(uint32_t i = 0; i < aiNumClusterIndices.size(); i++)
+            // compressed vertices decode to within the format's error bounds, checked straight out of the read buffer
             {
-                loadMeshClusterTriangleDataChunk(
-                    aaVertices[i],
-                    aaiTriangleVertexIndices[i],
-                    binaryOutputFolderPath.str() + "mesh-cluster-triangle-vertex-data.bin",
+                MeshClusterChunkReader compressedChunkReader;
+                bOpened = openMeshClusterChunkReader(
+                    compressedChunkReader,
+                    binaryOutputFolderPath.str() + "mesh-cluster-triangle-compressed-vertex-data.bin",
                     binaryOutputFolderPath.str() + "mesh-cluster-triangle-index-data.bin",
-                    aiNumClusterVertices,
-                    aiNumClusterIndices,
-                    aiVertexBufferArrayOffsets,
-                    aiIndexBufferArrayOffset,
-                    i);
+                    sizeof(CompressedMeshVertexFormat));
+                assert(bOpened);
+                assert(compressedChunkReader.maiNumClusterVertices == chunkReader.maiNumClusterVertices);
+
+                TaskCounter chunkCounter;
+                readMeshClusterChunks(
+                    chunkCounter,
+                    compressedChunkReader,
+                    aiChunkClusters,
+                    [&aaVertices,
+                    &aaiTriangleVertexIndices,
+                    &apTotalMeshClusters,
+                    iIndexSize](MeshClusterChunk const& chunk)
+                    {
+                        uint32_t i = chunk.miCluster;
+                        MeshCluster const* pMeshCluster = apTotalMeshClusters[i];
+                        CompressedMeshVertexFormat const* aCompressedVertices = reinterpret_cast<CompressedMeshVertexFormat const*>(chunk.mpcVertexData);
+                        uint32_t iNumVertices = static_cast<uint32_t>(chunk.miVertexDataSize / sizeof(CompressedMeshVertexFormat));
+                        assert(iNumVertices == aaVertices[i].size());
+                        assert(chunk.miIndexDataSize == aaiTriangleVertexIndices[i].size() * iIndexSize);
+                        for(uint32_t iIndex = 0; iIndex < static_cast<uint32_t>(aaiTriangleVertexIndices[i].size()); iIndex++)
+                        {
+                            uint32_t iDecodedIndex = (iIndexSize == sizeof(uint8_t)) ? chunk.mpcIndexData[iIndex] : reinterpret_cast<uint32_t const*>(chunk.mpcIndexData)[iIndex];
+                            assert(iDecodedIndex == aaiTriangleVertexIndices[i][iIndex]);
+                        }
+
+                        float3 maxPositionError = (pMeshCluster->mMaxBounds - pMeshCluster->mMinBounds) * (1.0f / 65535.0f) + float3(1.0e-5f, 1.0e-5f, 1.0e-5f);
+                        for(uint32_t iV = 0; iV < iNumVertices; iV++)
+                        {
+                            ConvertedMeshVertexFormat decodedVertex = decodeCompressedMeshVertex(aCompressedVertices[iV], pMeshCluster->mMinBounds, pMeshCluster->mMaxBounds);
+                            float3 positionDiff = float3(decodedVertex.mPosition) - float3(aaVertices[i][iV].mPosition);
+                            assert(fabsf(positionDiff.x) <= maxPositionError.x && fabsf(positionDiff.y) <= maxPositionError.y && fabsf(positionDiff.z) <= maxPositionError.z);
+                            assert(length(float3(aaVertices[i][iV].mNormal)) < 0.5f || dot(float3(decodedVertex.mNormal), normalize(float3(aaVertices[i][iV].mNormal))) >= 0.9999f);
+                            assert(fabsf(decodedVertex.mUV.x - aaVertices[i][iV].mUV.x) <= fabsf(aaVertices[i][iV].mUV.x) * (1.0f / 2048.0f) + 1.0e-7f);
+                            assert(fabsf(decodedVertex.mUV.y - aaVertices[i][iV].mUV.y) <= fabsf(aaVertices[i][iV].mUV.y) * (1.0f / 2048.0f) + 1.0e-7f);
+                        }
+                    });
+                waitForTasks(chunkCounter);
+                closeMeshClusterChunkReader(compressedChunkReader);
             }
 
             // verify data
@@ -2377,25 +2244,14 @@ void buildClusterGroups(
     std::vector<std::vector<uint32_t>>& aaiClusterGroupTriangleNormalIndices,
     std::vector<std::vector<uint32_t>>& aaiClusterGroupTriangleUVIndices,
     std::vector<uint32_t>& aiClusterGroupMap,
-    std::vector<std::vector<float3>> const& aaClusterVertexPositions,
-    std::vector<std::vector<float3>> const& aaClusterVertexNormals,
-    std::vector<std::vector<float2>> const& aaClusterVertexUVs,
-    std::vector<std::vector<uint32_t>> const& aaiClusterTrianglePositionIndices,
-    std::vector<std::vector<uint32_t>> const& aaiClusterTriangleNormalIndices,
-    std::vector<std::vector<uint32_t>> const& aaiClusterTriangleUVIndices,
+    ClusterStore const& clusters,
     uint32_t iNumClusterGroups,
     uint32_t iNumClusters,
     uint32_t iLODLevel,
-    std::string const& meshClusterOutputName,
+    std::vector<uint32_t> const& aiClusterGroups,
     std::string const& homeDirectory,
     std::string const& meshModelName)
 {
-    for(uint32_t iCluster = 0; iCluster < static_cast<uint32_t>(aaClusterVertexPositions.size()); iCluster++)
-    {
-        assert(aaiClusterTrianglePositionIndices[iCluster].size() == aaiClusterTriangleNormalIndices[iCluster].size());
-        assert(aaiClusterTrianglePositionIndices[iCluster].size() == aaiClusterTriangleUVIndices[iCluster].size());
-    }
-
     aaClusterGroupVertexPositions.resize(iNumClusterGroups);
     aaiClusterGroupTrianglePositionIndices.resize(iNumClusterGroups);
 
@@ -2411,32 +2267,26 @@ void buildClusterGroups(
     if(iNumClusterGroups > 1)
     {
         // place clusters into the groups specified by metis
-        std::ostringstream clusterGroupPartitionFilePath;
-        clusterGroupPartitionFilePath << meshClusterOutputName << ".part.";
-        clusterGroupPartitionFilePath << iNumClusterGroups;
-
-        std::vector<uint32_t> aiClusterGroups;
-        readMetisClusterFile(aiClusterGroups, clusterGroupPartitionFilePath.str());
-
-        assert(aiClusterGroups.size() == aaClusterVertexPositions.size());
-        for(uint32_t iCluster = 0; iCluster < static_cast<uint32_t>(aaClusterVertexPositions.size()); iCluster++)
+        assert(aiClusterGroups.size() == getNumClusters(clusters));
+        for(uint32_t iCluster = 0; iCluster < getNumClusters(clusters); iCluster++)
         {
             uint32_t iClusterGroup = aiClusterGroups[iCluster];
+            ClusterView cluster = getClusterView(clusters, iCluster);
 
             aaClusterGroupVertexPositions[iClusterGroup].insert(
                 aaClusterGroupVertexPositions[iClusterGroup].end(),
-                aaClusterVertexPositions[iCluster].begin(),
-                aaClusterVertexPositions[iCluster].end());
+                cluster.mVertexPositions.begin(),
+                cluster.mVertexPositions.end());
 
             aaClusterGroupVertexNormals[iClusterGroup].insert(
                 aaClusterGroupVertexNormals[iClusterGroup].end(),
-                aaClusterVertexNormals[iCluster].begin(),
-                aaClusterVertexNormals[iCluster].end());
+                cluster.mVertexNormals.begin(),
+                cluster.mVertexNormals.end());
 
             aaClusterGroupVertexUVs[iClusterGroup].insert(
                 aaClusterGroupVertexUVs[iClusterGroup].end(),
-                aaClusterVertexUVs[iCluster].begin(),
-                aaClusterVertexUVs[iCluster].end());
+                cluster.mVertexUVs.begin(),
+                cluster.mVertexUVs.end());
 
             aiClusterGroupMap[iCluster] = iClusterGroup;
         }
@@ -2445,185 +2295,140 @@ void buildClusterGroups(
     {
         for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
         {
+            ClusterView cluster = getClusterView(clusters, iCluster);
+
             aaClusterGroupVertexPositions[0].insert(
                 aaClusterGroupVertexPositions[0].end(),
-                aaClusterVertexPositions[iCluster].begin(),
-                aaClusterVertexPositions[iCluster].end());
+                cluster.mVertexPositions.begin(),
+                cluster.mVertexPositions.end());
 
             aaClusterGroupVertexNormals[0].insert(
                 aaClusterGroupVertexNormals[0].end(),
-                aaClusterVertexNormals[iCluster].begin(),
-                aaClusterVertexNormals[iCluster].end());
+                cluster.mVertexNormals.begin(),
+                cluster.mVertexNormals.end());
 
             aaClusterGroupVertexUVs[0].insert(
                 aaClusterGroupVertexUVs[0].end(),
-                aaClusterVertexUVs[iCluster].begin(),
-                aaClusterVertexUVs[iCluster].end());
+                cluster.mVertexUVs.begin(),
+                cluster.mVertexUVs.end());
 
             aiClusterGroupMap[iCluster] = 0;
         }
     }
 
-    for(uint32_t iCluster = 0; iCluster < static_cast<uint32_t>(aaClusterVertexPositions.size()); iCluster++)
-    {
-        assert(aaiClusterTrianglePositionIndices[iCluster].size() == aaiClusterTriangleNormalIndices[iCluster].size());
-        assert(aaiClusterTrianglePositionIndices[iCluster].size() == aaiClusterTriangleUVIndices[iCluster].size());
-    }
-
     static float const kfEqualityThreshold = 1.0e-8f;
+    static float const kfHashCellSize = 1.0e-4f;
 
-    // POSITIONS: remap cluster triangle indices into cluster group's own indices
-    std::vector<uint32_t> aiDiscardTris;
-    for(uint32_t iCluster = 0; iCluster < static_cast<uint32_t>(aaClusterVertexPositions.size()); iCluster++)
+    // clusters of each group in ascending order, triangles are added to the group in this order
+    std::vector<std::vector<uint32_t>> aaiGroupClusters(iNumClusterGroups);
+    for(uint32_t iCluster = 0; iCluster < getNumClusters(clusters); iCluster++)
     {
-        uint32_t iClusterGroup = aiClusterGroupMap[iCluster];
-        for(int32_t iTri = 0; iTri < static_cast<int32_t>(aaiClusterTrianglePositionIndices[iCluster].size()); iTri += 3)
-        {
-            // position
-            uint32_t iOrigPos0 = aaiClusterTrianglePositionIndices[iCluster][iTri];
-            uint32_t iOrigPos1 = aaiClusterTrianglePositionIndices[iCluster][iTri + 1];
-            uint32_t iOrigPos2 = aaiClusterTrianglePositionIndices[iCluster][iTri + 2];
-
-            float3 const& position0 = aaClusterVertexPositions[iCluster][iOrigPos0];
-            float3 const& position1 = aaClusterVertexPositions[iCluster][iOrigPos1];
-            float3 const& position2 = aaClusterVertexPositions[iCluster][iOrigPos2];
-
-            auto posIter0 = std::find_if(
-                aaClusterGroupVertexPositions[iClusterGroup].begin(),
-                aaClusterGroupVertexPositions[iClusterGroup].end(),
-                [position0](float3 const& checkPosition)
-                {
-                    return (length(checkPosition - position0) <= kfEqualityThreshold);
-                });
-            assert(posIter0 != aaClusterGroupVertexPositions[iClusterGroup].end());
-            uint32_t iRemapPos0 = static_cast<uint32_t>(std::distance(aaClusterGroupVertexPositions[iClusterGroup].begin(), posIter0));
-
-            auto posIter1 = std::find_if(
-                aaClusterGroupVertexPositions[iClusterGroup].begin(),
-                aaClusterGroupVertexPositions[iClusterGroup].end(),
-                [position1](float3 const& checkPosition)
-                {
-                    return (length(checkPosition - position1) <= kfEqualityThreshold);
-                });
-            assert(posIter1 != aaClusterGroupVertexPositions[iClusterGroup].end());
-            uint32_t iRemapPos1 = static_cast<uint32_t>(std::distance(aaClusterGroupVertexPositions[iClusterGroup].begin(), posIter1));
-
-            auto posIter2 = std::find_if(
-                aaClusterGroupVertexPositions[iClusterGroup].begin(),
-                aaClusterGroupVertexPositions[iClusterGroup].end(),
-                [position2](float3 const& checkPosition)
-                {
-                    return (length(checkPosition - position2) <= kfEqualityThreshold);
-                });
-            assert(posIter2 != aaClusterGroupVertexPositions[iClusterGroup].end());
-            uint32_t iRemapPos2 = static_cast<uint32_t>(std::distance(aaClusterGroupVertexPositions[iClusterGroup].begin(), posIter2));
-
-            // normal
-            uint32_t iOrigNormal0 = aaiClusterTriangleNormalIndices[iCluster][iTri];
-            uint32_t iOrigNormal1 = aaiClusterTriangleNormalIndices[iCluster][iTri + 1];
-            uint32_t iOrigNormal2 = aaiClusterTriangleNormalIndices[iCluster][iTri + 2];
-
-            float3 const& normal0 = aaClusterVertexNormals[iCluster][iOrigNormal0];
-            float3 const& normal1 = aaClusterVertexNormals[iCluster][iOrigNormal1];
-            float3 const& normal2 = aaClusterVertexNormals[iCluster][iOrigNormal2];
-
-            auto normalIter0 = std::find_if(
-                aaClusterGroupVertexNormals[iClusterGroup].begin(),
-                aaClusterGroupVertexNormals[iClusterGroup].end(),
-                [normal0](float3 const& checkNormal)
-                {
-                    return (length(checkNormal - normal0) <= kfEqualityThreshold);
-                });
-            assert(normalIter0 != aaClusterGroupVertexNormals[iClusterGroup].end());
-            uint32_t iRemapNormal0 = static_cast<uint32_t>(std::distance(aaClusterGroupVertexNormals[iClusterGroup].begin(), normalIter0));
-
-            auto normalIter1 = std::find_if(
-                aaClusterGroupVertexNormals[iClusterGroup].begin(),
-                aaClusterGroupVertexNormals[iClusterGroup].end(),
-                [normal1](float3 const& checkNormal)
-                {
-                    return (length(checkNormal - normal1) <= kfEqualityThreshold);
-                });
-            assert(normalIter1 != aaClusterGroupVertexNormals[iClusterGroup].end());
-            uint32_t iRemapNormal1 = static_cast<uint32_t>(std::distance(aaClusterGroupVertexNormals[iClusterGroup].begin(), normalIter1));
-
-            auto normalIter2 = std::find_if(
-                aaClusterGroupVertexNormals[iClusterGroup].begin(),
-                aaClusterGroupVertexNormals[iClusterGroup].end(),
-                [normal2](float3 const& checkNormal)
-                {
-                    return (length(checkNormal - normal2) <= kfEqualityThreshold);
-                });
-            assert(normalIter2 != aaClusterGroupVertexNormals[iClusterGroup].end());
-            uint32_t iRemapNormal2 = static_cast<uint32_t>(std::distance(aaClusterGroupVertexNormals[iClusterGroup].begin(), normalIter2));
-
-            // uv
-            uint32_t iOrigUV0 = aaiClusterTriangleUVIndices[iCluster][iTri];
-            uint32_t iOrigUV1 = aaiClusterTriangleUVIndices[iCluster][iTri + 1];
-            uint32_t iOrigUV2 = aaiClusterTriangleUVIndices[iCluster][iTri + 2];
-
-            float2 const& uv0 = aaClusterVertexUVs[iCluster][iOrigUV0];
-            float2 const& uv1 = aaClusterVertexUVs[iCluster][iOrigUV1];
-            float2 const& uv2 = aaClusterVertexUVs[iCluster][iOrigUV2];
-
-            auto uvIter0 = std::find_if(
-                aaClusterGroupVertexUVs[iClusterGroup].begin(),
-                aaClusterGroupVertexUVs[iClusterGroup].end(),
-                [uv0](float2 const& checkUV)
-                {
-                    return (length(checkUV - uv0) <= kfEqualityThreshold);
-                });
-            assert(uvIter0 != aaClusterGroupVertexUVs[iClusterGroup].end());
-            uint32_t iRemapUV0 = static_cast<uint32_t>(std::distance(aaClusterGroupVertexUVs[iClusterGroup].begin(), uvIter0));
-
-            // uv
-            auto uvIter1 = std::find_if(
-                aaClusterGroupVertexUVs[iClusterGroup].begin(),
-                aaClusterGroupVertexUVs[iClusterGroup].end(),
-                [uv1](float2 const& checkUV)
-                {
-                    return (length(checkUV - uv1) <= kfEqualityThreshold);
-                });
-            assert(uvIter1 != aaClusterGroupVertexUVs[iClusterGroup].end());
-            uint32_t iRemapUV1 = static_cast<uint32_t>(std::distance(aaClusterGroupVertexUVs[iClusterGroup].begin(), uvIter1));
-
-            auto uvIter2 = std::find_if(
-                aaClusterGroupVertexUVs[iClusterGroup].begin(),
-                aaClusterGroupVertexUVs[iClusterGroup].end(),
-                [uv2](float2 const& checkUV)
-                {
-                    return (length(checkUV - uv2) <= kfEqualityThreshold);
-                });
-            assert(uvIter2 != aaClusterGroupVertexUVs[iClusterGroup].end());
-            uint32_t iRemapUV2 = static_cast<uint32_t>(std::distance(aaClusterGroupVertexUVs[iClusterGroup].begin(), uvIter2));
+        aaiGroupClusters[aiClusterGroupMap[iCluster]].push_back(iCluster);
+    }
 
-            if(iRemapPos0 != iRemapPos1 && iRemapPos0 != iRemapPos2 && iRemapPos1 != iRemapPos2)
+    // remap cluster triangle indices into cluster group's own indices, each group is independent
+    // per worker hash scratch
+    uint32_t iNumWorkers = getNumTaskWorkers();
+    std::vector<std::vector<std::pair<uint64_t, uint32_t>>> aaPositionHash(iNumWorkers);
+    std::vector<std::vector<std::pair<uint64_t, uint32_t>>> aaNormalHash(iNumWorkers);
+    std::vector<std::vector<std::pair<uint64_t, uint32_t>>> aaUVHash(iNumWorkers);
+    std::vector<std::vector<float3>> aaGroupUVs(iNumWorkers);
+    parallelFor(
+        iNumClusterGroups,
+        1,
+        [&aaPositionHash,
+        &aaNormalHash,
+        &aaUVHash,
+        &aaGroupUVs,
+        &aaiGroupClusters,
+        &aaClusterGroupVertexPositions,
+        &aaClusterGroupVertexNormals,
+        &aaClusterGroupVertexUVs,
+        &aaiClusterGroupTrianglePositionIndices,
+        &aaiClusterGroupTriangleNormalIndices,
+        &aaiClusterGroupTriangleUVIndices,
+        &clusters](uint32_t iClusterGroup, uint32_t iSlot)
+        {
+            auto& aPositionHash = aaPositionHash[iSlot];
+            auto& aNormalHash = aaNormalHash[iSlot];
+            auto& aUVHash = aaUVHash[iSlot];
+            auto& aGroupUVs = aaGroupUVs[iSlot];
+
+            auto const& aGroupVertexPositions = aaClusterGroupVertexPositions[iClusterGroup];
+            auto const& aGroupVertexNormals = aaClusterGroupVertexNormals[iClusterGroup];
+            auto const& aGroupVertexUVs = aaClusterGroupVertexUVs[iClusterGroup];
+
+            // uvs are hashed as float3 with z = 0
+            aGroupUVs.resize(aGroupVertexUVs.size());
+            for(uint32_t i = 0; i < static_cast<uint32_t>(aGroupVertexUVs.size()); i++)
             {
-                aaiClusterGroupTrianglePositionIndices[iClusterGroup].push_back(iRemapPos0);
-                aaiClusterGroupTrianglePositionIndices[iClusterGroup].push_back(iRemapPos1);
-                aaiClusterGroupTrianglePositionIndices[iClusterGroup].push_back(iRemapPos2);
-
-                aaiClusterGroupTriangleNormalIndices[iClusterGroup].push_back(iRemapNormal0);
-                aaiClusterGroupTriangleNormalIndices[iClusterGroup].push_back(iRemapNormal1);
-                aaiClusterGroupTriangleNormalIndices[iClusterGroup].push_back(iRemapNormal2);
+                aGroupUVs[i] = float3(aGroupVertexUVs[i].x, aGroupVertexUVs[i].y, 0.0f);
+            }
 
-                aaiClusterGroupTriangleUVIndices[iClusterGroup].push_back(iRemapUV0);
-                aaiClusterGroupTriangleUVIndices[iClusterGroup].push_back(iRemapUV1);
-                aaiClusterGroupTriangleUVIndices[iClusterGroup].push_back(iRemapUV2);
+            float fPositionCellSize = getSpatialHashCellSize(aGroupVertexPositions.data(), static_cast<uint32_t>(aGroupVertexPositions.size()), kfHashCellSize);
+            float fNormalCellSize = getSpatialHashCellSize(aGroupVertexNormals.data(), static_cast<uint32_t>(aGroupVertexNormals.size()), kfHashCellSize);
+            float fUVCellSize = getSpatialHashCellSize(aGroupUVs.data(), static_cast<uint32_t>(aGroupUVs.size()), kfHashCellSize);
+            buildSpatialHashIndex(aPositionHash, aGroupVertexPositions.data(), static_cast<uint32_t>(aGroupVertexPositions.size()), fPositionCellSize);
+            buildSpatialHashIndex(aNormalHash, aGroupVertexNormals.data(), static_cast<uint32_t>(aGroupVertexNormals.size()), fNormalCellSize);
+            buildSpatialHashIndex(aUVHash, aGroupUVs.data(), static_cast<uint32_t>(aGroupUVs.size()), fUVCellSize);
 
-                //if(iClusterGroup == 1)
-                //{
-                //    DEBUG_PRINTF("cluster group %d add tri %d position remap (%d, %d, %d)\n", iClusterGroup, iTri, iRemap0, iRemap1, iRemap2);
-                //}
-            }
-            else
+            for(auto const& iCluster : aaiGroupClusters[iClusterGroup])
             {
-                aiDiscardTris.push_back(iTri);
-            }
+                ClusterView cluster = getClusterView(clusters, iCluster);
+                auto const& aiTrianglePositionIndices = cluster.maiTrianglePositionIndices;
+                auto const& aiTriangleNormalIndices = cluster.maiTriangleNormalIndices;
+                auto const& aiTriangleUVIndices = cluster.maiTriangleUVIndices;
+                for(uint32_t iTri = 0; iTri < aiTrianglePositionIndices.size(); iTri += 3)
+                {
+                    // first matching position, normal, and uv in the cluster group for each corner
+                    uint32_t aiRemapPos[3];
+                    uint32_t aiRemapNormal[3];
+                    uint32_t aiRemapUV[3];
+                    for(uint32_t j = 0; j < 3; j++)
+                    {
+                        float3 const& position = cluster.mVertexPositions[aiTrianglePositionIndices[iTri + j]];
+                        aiRemapPos[j] = findSpatialHashMatch(
+                            aPositionHash,
+                            aGroupVertexPositions.data(),
+                            position,
+                            fPositionCellSize,
+                            kfEqualityThreshold);
+                        assert(aiRemapPos[j] != UINT32_MAX);
+
+                        float3 const& normal = cluster.mVertexNormals[aiTriangleNormalIndices[iTri + j]];
+                        aiRemapNormal[j] = findSpatialHashMatch(
+                            aNormalHash,
+                            aGroupVertexNormals.data(),
+                            normal,
+                            fNormalCellSize,
+                            kfEqualityThreshold);
+                        assert(aiRemapNormal[j] != UINT32_MAX);
+
+                        float2 const& uv = cluster.mVertexUVs[aiTriangleUVIndices[iTri + j]];
+                        aiRemapUV[j] = findSpatialHashMatch(
+                            aUVHash,
+                            aGroupUVs.data(),
+                            float3(uv.x, uv.y, 0.0f),
+                            fUVCellSize,
+                            kfEqualityThreshold);
+                        assert(aiRemapUV[j] != UINT32_MAX);
+                    }
+
+                    // skip degenerate triangles
+                    if(aiRemapPos[0] != aiRemapPos[1] && aiRemapPos[0] != aiRemapPos[2] && aiRemapPos[1] != aiRemapPos[2])
+                    {
+                        for(uint32_t j = 0; j < 3; j++)
+                        {
+                            aaiClusterGroupTrianglePositionIndices[iClusterGroup].push_back(aiRemapPos[j]);
+                            aaiClusterGroupTriangleNormalIndices[iClusterGroup].push_back(aiRemapNormal[j]);
+                            aaiClusterGroupTriangleUVIndices[iClusterGroup].push_back(aiRemapUV[j]);
+                        }
+                    }
 
-        }   // for tri in cluster
+                }   // for tri in cluster
 
-    }   // for cluster = 0 to num clusters
+            }   // for cluster in group
+        });
 
     //DEBUG_PRINTF("\n****\n");
 
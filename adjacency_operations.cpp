@@ -2,6 +2,12 @@
 #include "adjacency_operations.h"
 
 #include "LogPrint.h"
+#include "task_scheduler.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cinttypes>
 
 
 /*
@@ -104,4 +110,229 @@ void buildAdjacencyList(
 
         fclose(fp);
     }
-}
\ No newline at end of file
+}
+
+/*
+**
+*/
+void buildClusterAdjacencyGraph(
+    std::vector<uint32_t>& aiAdjacencyStart,
+    std::vector<uint32_t>& aiAdjacency,
+    std::vector<uint32_t>& aiAdjacencyWeights,
+    ClusterStore const& clusters,
+    std::vector<std::vector<uint32_t>> const& aaiClusterBoundaryVertices,
+    float fMaxDistance)
+{
+    struct BoundaryVertexEntry
+    {
+        uint64_t        miKey;
+        uint32_t        miCluster;
+        float3          mPosition;
+    };
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    uint32_t iNumClusters = getNumClusters(clusters);
+    assert(aaiClusterBoundaryVertices.size() == iNumClusters);
+
+    // cell size is at least the max distance, any matching vertex is within the 3x3x3 neighboring cells
+    float fCellSize = fMaxDistance;
+    float const fMaxDistanceSquared = fMaxDistance * fMaxDistance;
+
+    // spatial hash of all the boundary vertices, sorted by key so each cell is a contiguous range
+    std::vector<BoundaryVertexEntry> aBoundaryVertexEntries;
+    {
+        uint32_t iNumBoundaryVertices = 0;
+        for(auto const& aiBoundaryVertices : aaiClusterBoundaryVertices)
+        {
+            iNumBoundaryVertices += static_cast<uint32_t>(aiBoundaryVertices.size());
+        }
+        aBoundaryVertexEntries.reserve(iNumBoundaryVertices);
+
+        std::vector<float3> aBoundaryVertexPositions;
+        aBoundaryVertexPositions.reserve(iNumBoundaryVertices);
+
+        for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
+        {
+            ClusterArrayView<float3> aVertexPositions = getClusterView(clusters, iCluster).mVertexPositions;
+            for(auto const& iVertex : aaiClusterBoundaryVertices[iCluster])
+            {
+                BoundaryVertexEntry entry;
+                entry.miCluster = iCluster;
+                entry.mPosition = aVertexPositions[iVertex];
+                aBoundaryVertexEntries.push_back(entry);
+                aBoundaryVertexPositions.push_back(entry.mPosition);
+            }
+        }
+
+        // keep the cell coordinates in range for small max distances
+        fCellSize = getSpatialHashCellSize(
+            aBoundaryVertexPositions.data(),
+            static_cast<uint32_t>(aBoundaryVertexPositions.size()),
+            fMaxDistance);
+        for(auto& entry : aBoundaryVertexEntries)
+        {
+            entry.miKey = getSpatialHashKey(getSpatialHashCell(entry.mPosition, fCellSize));
+        }
+
+        std::sort(
+            aBoundaryVertexEntries.begin(),
+            aBoundaryVertexEntries.end(),
+            [](BoundaryVertexEntry const& left, BoundaryVertexEntry const& right)
+            {
+                return (left.miKey == right.miKey) ? left.miCluster < right.miCluster : left.miKey < right.miKey;
+            });
+    }
+
+    // (adjacent cluster, number of shared boundary vertices) for each cluster, only adjacent clusters with larger index are recorded
+    // each cluster's list is written by one thread only so no locking is needed
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> aaAdjacentClusterCounts(iNumClusters);
+
+    // per worker count of shared vertices with the other clusters, only touched entries are reset
+    uint32_t iNumWorkers = getNumTaskWorkers();
+    std::vector<std::vector<uint32_t>> aaiSharedVertexCounts(iNumWorkers);
+    std::vector<std::vector<uint32_t>> aaiTouchedClusters(iNumWorkers);
+    std::vector<std::vector<uint32_t>> aaiVertexAdjacentClusters(iNumWorkers);
+    parallelFor(
+        iNumClusters,
+        1,
+        [&aaAdjacentClusterCounts,
+        &aaiSharedVertexCounts,
+        &aaiTouchedClusters,
+        &aaiVertexAdjacentClusters,
+        &aBoundaryVertexEntries,
+        &clusters,
+        &aaiClusterBoundaryVertices,
+        iNumClusters,
+        fCellSize,
+        fMaxDistanceSquared](uint32_t iCluster, uint32_t iSlot)
+        {
+            auto& aiSharedVertexCounts = aaiSharedVertexCounts[iSlot];
+            auto& aiTouchedClusters = aaiTouchedClusters[iSlot];
+            auto& aiVertexAdjacentClusters = aaiVertexAdjacentClusters[iSlot];
+            if(aiSharedVertexCounts.empty())
+            {
+                aiSharedVertexCounts.assign(iNumClusters, 0);
+            }
+
+            aiTouchedClusters.clear();
+            ClusterArrayView<float3> aVertexPositions = getClusterView(clusters, iCluster).mVertexPositions;
+            for(auto const& iVertex : aaiClusterBoundaryVertices[iCluster])
+            {
+                float3 const& position = aVertexPositions[iVertex];
+                int3 cell = getSpatialHashCell(position, fCellSize);
+
+                // clusters with a boundary vertex at this position, each only counted once per vertex
+                aiVertexAdjacentClusters.clear();
+                for(int32_t iZ = -1; iZ <= 1; iZ++)
+                {
+                    for(int32_t iY = -1; iY <= 1; iY++)
+                    {
+                        for(int32_t iX = -1; iX <= 1; iX++)
+                        {
+                            uint64_t iKey = getSpatialHashKey(int3(cell.x + iX, cell.y + iY, cell.z + iZ));
+                            auto iter = std::lower_bound(
+                                aBoundaryVertexEntries.begin(),
+                                aBoundaryVertexEntries.end(),
+                                iKey,
+                                [](BoundaryVertexEntry const& entry, uint64_t iCheckKey)
+                                {
+                                    return entry.miKey < iCheckKey;
+                                });
+                            for(; iter != aBoundaryVertexEntries.end() && iter->miKey == iKey; ++iter)
+                            {
+                                if(iter->miCluster <= iCluster)
+                                {
+                                    continue;
+                                }
+
+                                if(lengthSquared(iter->mPosition - position) <= fMaxDistanceSquared)
+                                {
+                                    if(std::find(aiVertexAdjacentClusters.begin(), aiVertexAdjacentClusters.end(), iter->miCluster) == aiVertexAdjacentClusters.end())
+                                    {
+                                        aiVertexAdjacentClusters.push_back(iter->miCluster);
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }   // for neighbor cells
+
+                for(auto const& iAdjacentCluster : aiVertexAdjacentClusters)
+                {
+                    if(aiSharedVertexCounts[iAdjacentCluster] == 0)
+                    {
+                        aiTouchedClusters.push_back(iAdjacentCluster);
+                    }
+                    aiSharedVertexCounts[iAdjacentCluster] += 1;
+                }
+
+            }   // for boundary vertex in cluster
+
+            auto& aAdjacentClusterCounts = aaAdjacentClusterCounts[iCluster];
+            aAdjacentClusterCounts.reserve(aiTouchedClusters.size());
+            for(auto const& iAdjacentCluster : aiTouchedClusters)
+            {
+                aAdjacentClusterCounts.push_back(std::make_pair(iAdjacentCluster, aiSharedVertexCounts[iAdjacentCluster]));
+                aiSharedVertexCounts[iAdjacentCluster] = 0;
+            }
+        });
+
+    // merge into symmetric CSR graph, count the degrees first and then fill in
+    aiAdjacencyStart.assign(iNumClusters + 1, 0);
+    for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
+    {
+        for(auto const& adjacentClusterCount : aaAdjacentClusterCounts[iCluster])
+        {
+            aiAdjacencyStart[iCluster + 1] += 1;
+            aiAdjacencyStart[adjacentClusterCount.first + 1] += 1;
+        }
+    }
+    for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
+    {
+        aiAdjacencyStart[iCluster + 1] += aiAdjacencyStart[iCluster];
+    }
+
+    uint32_t iNumEdgeEntries = aiAdjacencyStart[iNumClusters];
+    aiAdjacency.resize(iNumEdgeEntries);
+    aiAdjacencyWeights.resize(iNumEdgeEntries);
+    std::vector<uint32_t> aiCurrOffsets(aiAdjacencyStart.begin(), aiAdjacencyStart.end() - 1);
+    for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
+    {
+        for(auto const& adjacentClusterCount : aaAdjacentClusterCounts[iCluster])
+        {
+            uint32_t iAdjacentCluster = adjacentClusterCount.first;
+            uint32_t iWeight = adjacentClusterCount.second;
+
+            aiAdjacency[aiCurrOffsets[iCluster]] = iAdjacentCluster;
+            aiAdjacencyWeights[aiCurrOffsets[iCluster]] = iWeight;
+            ++aiCurrOffsets[iCluster];
+
+            aiAdjacency[aiCurrOffsets[iAdjacentCluster]] = iCluster;
+            aiAdjacencyWeights[aiCurrOffsets[iAdjacentCluster]] = iWeight;
+            ++aiCurrOffsets[iAdjacentCluster];
+        }
+    }
+
+    // keep adjacent clusters in ascending order
+    std::vector<std::pair<uint32_t, uint32_t>> aSortedEdges;
+    for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
+    {
+        uint32_t iStart = aiAdjacencyStart[iCluster];
+        uint32_t iEnd = aiAdjacencyStart[iCluster + 1];
+        aSortedEdges.clear();
+        for(uint32_t i = iStart; i < iEnd; i++)
+        {
+            aSortedEdges.push_back(std::make_pair(aiAdjacency[i], aiAdjacencyWeights[i]));
+        }
+        std::sort(aSortedEdges.begin(), aSortedEdges.end());
+        for(uint32_t i = iStart; i < iEnd; i++)
+        {
+            aiAdjacency[i] = aSortedEdges[i - iStart].first;
+            aiAdjacencyWeights[i] = aSortedEdges[i - iStart].second;
+        }
+    }
+
+    uint64_t iMilliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start).count();
+    DEBUG_PRINTF("took %" PRIu64 " milliseconds to build adjacency graph for %d clusters (%d edges)\n", iMilliseconds, iNumClusters, iNumEdgeEntries / 2);
+}
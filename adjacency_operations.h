@@ -3,6 +3,9 @@
 #include <string>
 #include <vector>
 
+#include "vec.h"
+#include "cluster_store.h"
+
 /*
 **
 */
@@ -12,4 +15,15 @@ void buildAdjacencyList(
     std::vector<tinyobj::material_t>& aMaterials,
     std::vector<std::vector<uint32_t>>& aaiAdjacencyList,
     std::string const& outputFilePath,
-    std::string const& fullOBJFilePath);
\ No newline at end of file
+    std::string const& fullOBJFilePath);
+
+/*
+**
+*/
+void buildClusterAdjacencyGraph(
+    std::vector<uint32_t>& aiAdjacencyStart,
+    std::vector<uint32_t>& aiAdjacency,
+    std::vector<uint32_t>& aiAdjacencyWeights,
+    ClusterStore const& clusters,
+    std::vector<std::vector<uint32_t>> const& aaiClusterBoundaryVertices,
+    float fMaxDistance);
@@ -1,125 +1,17 @@
 #include "boundary_operations.h"
-#include "test.h"
+#include "connectivity_operations.h"
+#include "compute_backend.h"
 #include "LogPrint.h"
+#include "task_scheduler.h"
 
+#include <atomic>
 #include <cassert>
+#include <memory>
 #include <mutex>
+#include <thread>
 
 std::mutex gMutex;
 
-/*
-**
-*/
-void getBoundaryEdges(
-    std::vector<BoundaryEdgeInfo>& aBoundaryEdges,
-    std::vector<std::vector<float3>>const& aaClusterGroupVertexPositions,
-    std::vector<std::vector<float3>>const& aaClusterGroupVertexNormals,
-    std::vector<std::vector<float2>>const& aaClusterGroupVertexUVs,
-    std::vector<std::vector<uint32_t>>const& aaiClusterGroupTrianglePositionIndices,
-    std::vector<std::vector<uint32_t>>const& aaiClusterGroupTriangleNormalIndices,
-    std::vector<std::vector<uint32_t>>const& aaiClusterGroupTriangleUVIndices)
-{
-    std::vector<std::vector<uint32_t>> aaiBoundaryTriangles(aaiClusterGroupTrianglePositionIndices.size());
-    for(uint32_t iClusterGroup = 0; iClusterGroup < static_cast<uint32_t>(aaiClusterGroupTrianglePositionIndices.size()); iClusterGroup++)
-    {
-        std::vector<uint32_t> aiBoundaryTriangles;
-        auto const& aiClusterGroupTrianglePositionIndices = aaiClusterGroupTrianglePositionIndices[iClusterGroup];
-        for(uint32_t iTri = 0; iTri < static_cast<uint32_t>(aiClusterGroupTrianglePositionIndices.size()); iTri += 3)
-        {
-            bool abHasAdjacentEdges[3] = { false, false, false };
-            for(uint32_t iEdge = 0; iEdge < 3; iEdge++)
-            {
-                // position index of the edge
-                uint32_t iPos0 = 0, iPos1 = 1;
-                if(iEdge == 1)
-                {
-                    iPos1 = 2;
-                }
-                else if(iEdge == 2)
-                {
-                    iPos0 = 1;
-                    iPos1 = 2;
-                }
-
-                // check other triangles
-                for(uint32_t iCheckTri = 0; iCheckTri < static_cast<uint32_t>(aiClusterGroupTrianglePositionIndices.size()); iCheckTri += 3)
-                {
-                    if(iTri == iCheckTri)
-                    {
-                        continue;
-                    }
-
-                    uint32_t iNumSamePos = 0;
-                    for(uint32_t j = 0; j < 3; j++)
-                    {
-                        if(aiClusterGroupTrianglePositionIndices[iTri + iPos0] == aiClusterGroupTrianglePositionIndices[iCheckTri + j] ||
-                            aiClusterGroupTrianglePositionIndices[iTri + iPos1] == aiClusterGroupTrianglePositionIndices[iCheckTri + j])
-                        {
-                            ++iNumSamePos;
-                        }
-                    }
-
-                    // shared edge -> >= 2 shared vertex positions
-                    if(iNumSamePos >= 2)
-                    {
-                        abHasAdjacentEdges[iEdge] = true;
-                        break;
-                    }
-
-                }   // for check triangle in cluster
-            }
-
-            // add boundary edges
-            {
-                if(abHasAdjacentEdges[0] == false)
-                {
-                    BoundaryEdgeInfo edgeInfo;
-                    edgeInfo.miClusterGroup = iClusterGroup;
-                    edgeInfo.miPos0 = aiClusterGroupTrianglePositionIndices[iTri];
-                    edgeInfo.miPos1 = aiClusterGroupTrianglePositionIndices[iTri + 1];
-                    edgeInfo.mPos0 = aaClusterGroupVertexPositions[iClusterGroup][edgeInfo.miPos0];
-                    edgeInfo.mPos1 = aaClusterGroupVertexPositions[iClusterGroup][edgeInfo.miPos1];
-                    aBoundaryEdges.push_back(edgeInfo);
-                }
-
-                if(abHasAdjacentEdges[1] == false)
-                {
-                    BoundaryEdgeInfo edgeInfo;
-                    edgeInfo.miClusterGroup = iClusterGroup;
-                    edgeInfo.miPos0 = aiClusterGroupTrianglePositionIndices[iTri];
-                    edgeInfo.miPos1 = aiClusterGroupTrianglePositionIndices[iTri + 2];
-                    edgeInfo.mPos0 = aaClusterGroupVertexPositions[iClusterGroup][edgeInfo.miPos0];
-                    edgeInfo.mPos1 = aaClusterGroupVertexPositions[iClusterGroup][edgeInfo.miPos1];
-                    aBoundaryEdges.push_back(edgeInfo);
-                }
-
-                if(abHasAdjacentEdges[2] == false)
-                {
-                    BoundaryEdgeInfo edgeInfo;
-                    edgeInfo.miClusterGroup = iClusterGroup;
-                    edgeInfo.miPos0 = aiClusterGroupTrianglePositionIndices[iTri + 1];
-                    edgeInfo.miPos1 = aiClusterGroupTrianglePositionIndices[iTri + 2];
-                    edgeInfo.mPos0 = aaClusterGroupVertexPositions[iClusterGroup][edgeInfo.miPos0];
-                    edgeInfo.mPos1 = aaClusterGroupVertexPositions[iClusterGroup][edgeInfo.miPos1];
-                    aBoundaryEdges.push_back(edgeInfo);
-                }
-
-            }   // add boundary edges
-
-            if(abHasAdjacentEdges[0] == false || abHasAdjacentEdges[1] == false || abHasAdjacentEdges[2] == false)
-            {
-                aaiBoundaryTriangles[iClusterGroup].push_back(iTri);
-            }
-
-        }   // for triangle in cluster
-
-    }   // for cluster group
-
-    int iDebug = 1;
-
-}   // get boundary edges
-
-
 /*
 **
 */
@@ -227,7 +119,7 @@ void getClusterGroupBoundaryVertices(
             //        aaClusterGroupVertexPositions[3][iVertex].z);
             //}
 
-            getClusterGroupBoundaryVerticesCUDA2(
+            getComputeBackend().mpfnGetClusterGroupBoundaryVertices2(
                 aaiClusterGroupBoundaryVertices,
                 aaClusterGroupVertexPositions);
 
@@ -443,121 +335,6 @@ void checkClusterGroupBoundaryVertices(
     }   // for tri = 0 to num triangles in cluster group
 }
 
-/*
-**
-*/
-void getInnerEdgesAndVertices(
-    std::vector<std::vector<uint32_t>>& aaiValidClusterGroupEdges,
-    std::vector<std::vector<std::pair<uint32_t, uint32_t>>>& aaValidClusterGroupEdgePairs,
-    std::vector<std::map<uint32_t, uint32_t>>& aaValidVertices,
-    std::vector<std::vector<uint32_t>>& aaiClusterGroupTriWithEdges,
-    std::vector<std::vector<std::pair<uint32_t, uint32_t>>>& aaClusterGroupEdges,
-    std::vector<std::vector<uint32_t>> const& aaiClusterGroupTriangles,
-    std::vector<std::vector<uint32_t>> const& aaiClusterGroupNonBoundaryVertices,
-    uint32_t const& iNumClusterGroups)
-{
-    for(uint32_t iClusterGroup = 0; iClusterGroup < iNumClusterGroups; iClusterGroup++)
-    {
-        for(uint32_t iTri = 0; iTri < static_cast<uint32_t>(aaiClusterGroupTriangles[iClusterGroup].size()); iTri += 3)
-        {
-            uint32_t iV0 = aaiClusterGroupTriangles[iClusterGroup][iTri];
-            uint32_t iV1 = aaiClusterGroupTriangles[iClusterGroup][iTri + 1];
-            uint32_t iV2 = aaiClusterGroupTriangles[iClusterGroup][iTri + 2];
-
-            //if(iV0 == iV1 || iV0 == iV2 || iV1 == iV2)
-            //{
-            //    continue;
-            //}
-
-            assert(iV0 != iV1);
-            assert(iV0 != iV2);
-            assert(iV1 != iV2);
-
-            bool bValid0 = (std::find(aaiClusterGroupNonBoundaryVertices[iClusterGroup].begin(), aaiClusterGroupNonBoundaryVertices[iClusterGroup].end(), iV0) != aaiClusterGroupNonBoundaryVertices[iClusterGroup].end());
-            bool bValid1 = (std::find(aaiClusterGroupNonBoundaryVertices[iClusterGroup].begin(), aaiClusterGroupNonBoundaryVertices[iClusterGroup].end(), iV1) != aaiClusterGroupNonBoundaryVertices[iClusterGroup].end());
-            bool bValid2 = (std::find(aaiClusterGroupNonBoundaryVertices[iClusterGroup].begin(), aaiClusterGroupNonBoundaryVertices[iClusterGroup].end(), iV2) != aaiClusterGroupNonBoundaryVertices[iClusterGroup].end());
-
-            aaClusterGroupEdges[iClusterGroup].push_back(std::make_pair(iV0, iV1));
-            aaClusterGroupEdges[iClusterGroup].push_back(std::make_pair(iV0, iV2));
-            aaClusterGroupEdges[iClusterGroup].push_back(std::make_pair(iV1, iV2));
-
-            if(bValid0)
-            {
-                auto pair0 = std::make_pair(iV0, iV1);
-                auto iter0 = std::find_if(
-                    aaValidClusterGroupEdgePairs[iClusterGroup].begin(),
-                    aaValidClusterGroupEdgePairs[iClusterGroup].end(),
-                    [pair0](std::pair<uint32_t, uint32_t> const& checkPair)
-                    {
-                        return (checkPair.first == pair0.first && checkPair.second == pair0.second) || (checkPair.first == pair0.second && checkPair.second == pair0.first);
-                    });
-                if(iter0 == aaValidClusterGroupEdgePairs[iClusterGroup].end())
-                {
-                    aaiValidClusterGroupEdges[iClusterGroup].push_back(iV0);
-                    aaiValidClusterGroupEdges[iClusterGroup].push_back(iV1);
-
-                    aaValidClusterGroupEdgePairs[iClusterGroup].push_back(pair0);
-
-                    assert(pair0.first != pair0.second);
-
-                    // save the triangle index containing this edge
-                    aaiClusterGroupTriWithEdges[iClusterGroup].push_back(iTri);
-                }
-
-                auto pair1 = std::make_pair(iV0, iV2);
-                auto iter1 = std::find_if(
-                    aaValidClusterGroupEdgePairs[iClusterGroup].begin(),
-                    aaValidClusterGroupEdgePairs[iClusterGroup].end(),
-                    [pair1](std::pair<uint32_t, uint32_t> const& checkPair)
-                    {
-                        return (checkPair.first == pair1.first && checkPair.second == pair1.second) || (checkPair.first == pair1.second && checkPair.second == pair1.first);
-                    });
-                if(iter1 == aaValidClusterGroupEdgePairs[iClusterGroup].end())
-                {
-                    aaiValidClusterGroupEdges[iClusterGroup].push_back(iV0);
-                    aaiValidClusterGroupEdges[iClusterGroup].push_back(iV2);
-
-                    aaValidClusterGroupEdgePairs[iClusterGroup].push_back(pair1);
-
-                    assert(pair1.first != pair1.second);
-
-                    // save the triangle index containing this edge
-                    aaiClusterGroupTriWithEdges[iClusterGroup].push_back(iTri);
-                }
-            }
-
-            if(bValid1 || bValid2)
-            {
-                auto pair2 = std::make_pair(iV1, iV2);
-                auto iter = std::find_if(
-                    aaValidClusterGroupEdgePairs[iClusterGroup].begin(),
-                    aaValidClusterGroupEdgePairs[iClusterGroup].end(),
-                    [pair2](std::pair<uint32_t, uint32_t> const& checkPair)
-                    {
-                        return (checkPair.first == pair2.first && checkPair.second == pair2.second) || (checkPair.first == pair2.second && checkPair.second == pair2.first);
-                    });
-                if(iter == aaValidClusterGroupEdgePairs[iClusterGroup].end())
-                {
-                    aaiValidClusterGroupEdges[iClusterGroup].push_back(iV1);
-                    aaiValidClusterGroupEdges[iClusterGroup].push_back(iV2);
-
-                    aaValidClusterGroupEdgePairs[iClusterGroup].push_back(pair2);
-
-                    assert(pair2.first != pair2.second);
-                }
-
-                // save the triangle index containing this edge
-                aaiClusterGroupTriWithEdges[iClusterGroup].push_back(iTri);
-            }
-
-            aaValidVertices[iClusterGroup][iV0] = (bValid0 == true) ? 1 : 0;
-            aaValidVertices[iClusterGroup][iV1] = (bValid1 == true) ? 1 : 0;
-            aaValidVertices[iClusterGroup][iV2] = (bValid2 == true) ? 1 : 0;
-
-        }
-    }
-}
-
 /*
 **
 */
@@ -594,113 +371,166 @@ void printDebugMeshes(
 /*
 **
 */
-void getBoundaryAndNonBoundaryVertices(
-    std::vector<std::vector<uint32_t>>& aaiBoundaryVertices,
-    std::vector<std::vector<uint32_t>>& aaiNonBoundaryVertices,
-    std::vector<std::vector<float3>> const& aaVertexPositions,
-    std::vector<std::vector<uint32_t>> const& aaiTrianglePositionIndices)
+void getTopology(
+    std::vector<uint32_t>& aiBoundaryVertices,
+    std::vector<uint32_t>& aiNonBoundaryVertices,
+    std::vector<std::pair<uint32_t, uint32_t>>* paInnerEdges,
+    std::vector<BoundaryEdgeInfo>* paBoundaryEdges,
+    ClusterArrayView<float3> const& aVertexPositions,
+    ClusterArrayView<uint32_t> const& aiTrianglePositionIndices,
+    uint32_t iPartition)
 {
-    aaiBoundaryVertices.resize(aaVertexPositions.size());
-    aaiNonBoundaryVertices.resize(aaVertexPositions.size());
-    for(uint32_t iPartition = 0; iPartition < static_cast<uint32_t>(aaVertexPositions.size()); iPartition++)
+    // edge -> number of triangles sharing it, edges only used by one triangle are on the boundary
+    MeshConnectivity connectivity;
+    buildMeshConnectivity(
+        connectivity,
+        aiTrianglePositionIndices.data(),
+        aiTrianglePositionIndices.size(),
+        aVertexPositions.size());
+
+    std::vector<uint8_t> aiBoundaryVertexFlags(aVertexPositions.size(), 0);
+    for(uint32_t iEdge = 0; iEdge < static_cast<uint32_t>(connectivity.maEdges.size()); iEdge++)
     {
-        auto const& aiPartitionTrianglePositionIndices = aaiTrianglePositionIndices[iPartition];
-        uint32_t iNumTrianglePositionIndices = static_cast<uint32_t>(aiPartitionTrianglePositionIndices.size());
-        std::vector<uint32_t> aiBoundaryVertexFlags(aaVertexPositions[iPartition].size());
-        for(uint32_t iTri = 0; iTri < iNumTrianglePositionIndices; iTri += 3)
+        if(connectivity.maiEdgeTriangleCounts[iEdge] < 2)
         {
-            uint32_t aiSameEdge[3] = { 0, 0, 0 };
-            uint32_t iNumSameEdges = 0;
-            for(uint32_t iCheckTri = 0; iCheckTri < iNumTrianglePositionIndices; iCheckTri += 3)
-            {
-                if(iCheckTri == iTri)
-                {
-                    continue;
-                }
-
-                // record same position
-                uint32_t iNumSamePos = 0;
-                uint32_t aiSamePos[3] = { 0, 0, 0 };
-                for(uint32_t i = 0; i < 3; i++)
-                {
-                    for(uint32_t j = 0; j < 3; j++)
-                    {
-                        if(aiPartitionTrianglePositionIndices[iTri + i] == aiPartitionTrianglePositionIndices[iCheckTri + j])
-                        {
-                            ++iNumSamePos;
-                            aiSamePos[i] = 1;
-                            break;
-                        }
-                    }
-                }
-
-                // record same edge
-                if(iNumSamePos >= 2)
-                {
-                    if(aiSamePos[0] == 1 && aiSamePos[1] == 1)
-                    {
-                        aiSameEdge[0] = 1;
-                        ++iNumSameEdges;
-                    }
-
-                    if(aiSamePos[0] == 1 && aiSamePos[2] == 1)
-                    {
-                        aiSameEdge[1] = 1;
-                        ++iNumSameEdges;
-                    }
-
-                    if(aiSamePos[1] == 1 && aiSamePos[2] == 1)
-                    {
-                        aiSameEdge[2] = 1;
-                        ++iNumSameEdges;
-                    }
-                }
+            aiBoundaryVertexFlags[connectivity.maEdges[iEdge].first] = 1;
+            aiBoundaryVertexFlags[connectivity.maEdges[iEdge].second] = 1;
+        }
+    }
 
-                if(iNumSameEdges >= 3)
-                {
-                    break;
-                }
+    for(uint32_t i = 0; i < static_cast<uint32_t>(aiBoundaryVertexFlags.size()); i++)
+    {
+        if(aiBoundaryVertexFlags[i] > 0)
+        {
+            aiBoundaryVertices.push_back(i);
+        }
+        else
+        {
+            aiNonBoundaryVertices.push_back(i);
+        }
+    }
 
-            }       // for check tri = 0 to num triangles
+    if(paInnerEdges == nullptr && paBoundaryEdges == nullptr)
+    {
+        return;
+    }
 
-            // set boundary vertex flags based on found same edges
-            if(aiSameEdge[0] == 0)
+    // boundary edges in triangle order, inner edges are the unique non-boundary edges touching a non-boundary vertex
+    std::vector<uint8_t> aiAddedEdges(connectivity.maEdges.size(), 0);
+    for(uint32_t iTri = 0; iTri < static_cast<uint32_t>(aiTrianglePositionIndices.size()); iTri += 3)
+    {
+        uint32_t const aiEdgePos0[3] = { aiTrianglePositionIndices[iTri], aiTrianglePositionIndices[iTri], aiTrianglePositionIndices[iTri + 1] };
+        uint32_t const aiEdgePos1[3] = { aiTrianglePositionIndices[iTri + 1], aiTrianglePositionIndices[iTri + 2], aiTrianglePositionIndices[iTri + 2] };
+        for(uint32_t iTriEdge = 0; iTriEdge < 3; iTriEdge++)
+        {
+            uint32_t iPos0 = aiEdgePos0[iTriEdge];
+            uint32_t iPos1 = aiEdgePos1[iTriEdge];
+            uint32_t iEdge = getConnectivityEdge(connectivity, iPos0, iPos1);
+            if(iEdge == UINT32_MAX)
             {
-                aiBoundaryVertexFlags[aiPartitionTrianglePositionIndices[iTri]] = 1;
-                aiBoundaryVertexFlags[aiPartitionTrianglePositionIndices[iTri + 1]] = 1;
+                continue;
             }
 
-            if(aiSameEdge[1] == 0)
+            if(connectivity.maiEdgeTriangleCounts[iEdge] < 2)
             {
-                aiBoundaryVertexFlags[aiPartitionTrianglePositionIndices[iTri]] = 1;
-                aiBoundaryVertexFlags[aiPartitionTrianglePositionIndices[iTri + 2]] = 1;
+                if(paBoundaryEdges)
+                {
+                    paBoundaryEdges->emplace_back(
+                        iPartition,
+                        iPos0,
+                        iPos1,
+                        aVertexPositions[iPos0],
+                        aVertexPositions[iPos1]);
+                }
+                continue;
             }
 
-            if(aiSameEdge[2] == 0)
+            // (v0, v1) and (v0, v2) need v0 to be non-boundary, (v1, v2) needs either one
+            bool bValid = (iTriEdge < 2) ?
+                (aiBoundaryVertexFlags[iPos0] == 0) :
+                (aiBoundaryVertexFlags[iPos0] == 0 || aiBoundaryVertexFlags[iPos1] == 0);
+            if(paInnerEdges && bValid && aiAddedEdges[iEdge] == 0)
             {
-                aiBoundaryVertexFlags[aiPartitionTrianglePositionIndices[iTri + 1]] = 1;
-                aiBoundaryVertexFlags[aiPartitionTrianglePositionIndices[iTri + 2]] = 1;
+                aiAddedEdges[iEdge] = 1;
+                paInnerEdges->push_back(std::make_pair(iPos0, iPos1));
             }
 
-        }   // for tri = 0 to num triangles
+        }   // for triangle edge = 0 to 3
 
-        // check for valid flag on boundary vertices
-        for(uint32_t i = 0; i < static_cast<uint32_t>(aiBoundaryVertexFlags.size()); i++)
+    }   // for tri = 0 to num triangles
+}
+
+/*
+**
+*/
+void getBoundaryAndNonBoundaryVertices(
+    std::vector<std::vector<uint32_t>>& aaiBoundaryVertices,
+    std::vector<std::vector<uint32_t>>& aaiNonBoundaryVertices,
+    ClusterStore const& clusters)
+{
+    uint32_t iNumPartitions = getNumClusters(clusters);
+    aaiBoundaryVertices.resize(iNumPartitions);
+    aaiNonBoundaryVertices.resize(iNumPartitions);
+
+    parallelFor(
+        iNumPartitions,
+        1,
+        [&aaiBoundaryVertices,
+        &aaiNonBoundaryVertices,
+        &clusters](uint32_t iPartition, uint32_t /*iSlot*/)
         {
-            if(aiBoundaryVertexFlags[i] > 0)
-            {
-                aaiBoundaryVertices[iPartition].push_back(i);
-            }
-            else
-            {
-                aaiNonBoundaryVertices[iPartition].push_back(i);
-            }
-        }
+            ClusterView cluster = getClusterView(clusters, iPartition);
+            getTopology(
+                aaiBoundaryVertices[iPartition],
+                aaiNonBoundaryVertices[iPartition],
+                nullptr,
+                nullptr,
+                cluster.mVertexPositions,
+                cluster.maiTrianglePositionIndices,
+                iPartition);
+        });
+}
 
-        //printDebugMeshes(
-        //    aaiBoundaryVertices,
-        //    aaiNonBoundaryVertices,
-        //    aaVertexPositions,
-        //    iPartition);
+/*
+**
+*/
+void getClusterGroupTopology(
+    std::vector<std::vector<uint32_t>>& aaiClusterGroupBoundaryVertices,
+    std::vector<std::vector<uint32_t>>& aaiClusterGroupNonBoundaryVertices,
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>>& aaClusterGroupInnerEdges,
+    std::vector<BoundaryEdgeInfo>& aBoundaryEdges,
+    std::vector<std::vector<float3>> const& aaClusterGroupVertexPositions,
+    std::vector<std::vector<uint32_t>> const& aaiClusterGroupTrianglePositionIndices)
+{
+    uint32_t iNumClusterGroups = static_cast<uint32_t>(aaClusterGroupVertexPositions.size());
+    aaiClusterGroupBoundaryVertices.resize(iNumClusterGroups);
+    aaiClusterGroupNonBoundaryVertices.resize(iNumClusterGroups);
+    aaClusterGroupInnerEdges.resize(iNumClusterGroups);
+    std::vector<std::vector<BoundaryEdgeInfo>> aaClusterGroupBoundaryEdges(iNumClusterGroups);
+
+    parallelFor(
+        iNumClusterGroups,
+        1,
+        [&aaiClusterGroupBoundaryVertices,
+        &aaiClusterGroupNonBoundaryVertices,
+        &aaClusterGroupInnerEdges,
+        &aaClusterGroupBoundaryEdges,
+        &aaClusterGroupVertexPositions,
+        &aaiClusterGroupTrianglePositionIndices](uint32_t iClusterGroup, uint32_t /*iSlot*/)
+        {
+            getTopology(
+                aaiClusterGroupBoundaryVertices[iClusterGroup],
+                aaiClusterGroupNonBoundaryVertices[iClusterGroup],
+                &aaClusterGroupInnerEdges[iClusterGroup],
+                &aaClusterGroupBoundaryEdges[iClusterGroup],
+                getArrayView(aaClusterGroupVertexPositions[iClusterGroup]),
+                getArrayView(aaiClusterGroupTrianglePositionIndices[iClusterGroup]),
+                iClusterGroup);
+        });
+
+    // boundary edges in cluster group order
+    for(auto const& aClusterGroupBoundaryEdges : aaClusterGroupBoundaryEdges)
+    {
+        aBoundaryEdges.insert(aBoundaryEdges.end(), aClusterGroupBoundaryEdges.begin(), aClusterGroupBoundaryEdges.end());
     }
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <map>
 #include <vector>
 #include "vec.h"
+#include "cluster_store.h"
 
 
 struct BoundaryEdgeInfo
@@ -31,33 +32,22 @@ struct BoundaryEdgeInfo
 };
 
 
-void getBoundaryEdges(
-    std::vector<BoundaryEdgeInfo>& aBoundaryEdges,
-    std::vector<std::vector<float3>>const& aaClusterGroupVertexPositions,
-    std::vector<std::vector<float3>>const& aaClusterGroupVertexNormals,
-    std::vector<std::vector<float2>>const& aaClusterGroupVertexUVs,
-    std::vector<std::vector<uint32_t>>const& aaiClusterGroupTrianglePositionIndices,
-    std::vector<std::vector<uint32_t>>const& aaiClusterGroupTriangleNormalIndices,
-    std::vector<std::vector<uint32_t>>const& aaiClusterGroupTriangleUVIndices);
-
 void getClusterGroupBoundaryVertices(
     std::vector<std::vector<uint32_t>>& aaiClusterGroupBoundaryVertices,
     std::vector<std::vector<uint32_t>>& aaiClusterGroupNonBoundaryVertices,
     std::vector<std::vector<float3>> const& aaClusterGroupVertexPositions,
     uint32_t const& iNumClusterGroups);
 
-void getInnerEdgesAndVertices(
-    std::vector<std::vector<uint32_t>>& aaiValidClusterGroupEdges,
-    std::vector<std::vector<std::pair<uint32_t, uint32_t>>>& aaValidClusterGroupEdgePairs,
-    std::vector<std::map<uint32_t, uint32_t>>& aaValidVertices,
-    std::vector<std::vector<uint32_t>>& aaiClusterGroupTriWithEdges,
-    std::vector<std::vector<std::pair<uint32_t, uint32_t>>>& aaClusterGroupEdges,
-    std::vector<std::vector<uint32_t>> const& aaiClusterGroupTriangles,
-    std::vector<std::vector<uint32_t>> const& aaiClusterGroupNonBoundaryVertices,
-    uint32_t const& iNumClusterGroups);
-
 void getBoundaryAndNonBoundaryVertices(
     std::vector<std::vector<uint32_t>>& aaiBoundaryVertices,
     std::vector<std::vector<uint32_t>>& aaiNonBoundaryVertices,
-    std::vector<std::vector<float3>> const& aaVertexPositions,
-    std::vector<std::vector<uint32_t>> const& aaiTrianglePositionIndices);
\ No newline at end of file
+    ClusterStore const& clusters);
+
+// boundary vertices, non-boundary vertices, collapsible inner edges and boundary edges of each cluster group in one pass over its edges
+void getClusterGroupTopology(
+    std::vector<std::vector<uint32_t>>& aaiClusterGroupBoundaryVertices,
+    std::vector<std::vector<uint32_t>>& aaiClusterGroupNonBoundaryVertices,
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>>& aaClusterGroupInnerEdges,
+    std::vector<BoundaryEdgeInfo>& aBoundaryEdges,
+    std::vector<std::vector<float3>> const& aaClusterGroupVertexPositions,
+    std::vector<std::vector<uint32_t>> const& aaiClusterGroupTrianglePositionIndices);
\ No newline at end of file
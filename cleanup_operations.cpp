@@ -215,7 +215,7 @@ uint32_t cleanupClusters(
     return iMergedIntoCluster;
 }
 
-#include "test.h"
+#include "compute_backend.h"
 
 /*
 **
@@ -236,7 +236,7 @@ void cleanupClusters2(
     uint32_t const kiEvenOutNumTriangles = 32;
 
     std::vector<std::vector<std::pair<uint32_t, uint32_t>>> aaiAdjacentEdgeClusters;
-    buildClusterEdgeAdjacencyCUDA2(
+    getComputeBackend().mpfnBuildClusterEdgeAdjacency2(
         aaiAdjacentEdgeClusters,
         aaClusterVertexPositions,
         aaiClusterTrianglePositionIndices);
@@ -447,73 +447,22 @@ void cleanupClusters2(
     }
 
     // get rid of cluster with size <= 0
-    for(;;)
+    auto removeEmpty = [](auto& aaClusterData)
     {
-        bool bDone = true;
-        for(uint32_t i = 0; i < aaClusterVertexPositions.size(); i++)
-        {
-            if(aaClusterVertexPositions[i].size() <= 0)
-            {
-                aaClusterVertexPositions.erase(aaClusterVertexPositions.begin() + i);
-
-                bDone = false;
-                break;
-            }
-        }
-
-        for(uint32_t i = 0; i < aaClusterVertexNormals.size(); i++)
-        {
-            if(aaClusterVertexNormals[i].size() <= 0)
-            {
-                aaClusterVertexNormals.erase(aaClusterVertexNormals.begin() + i);
-                bDone = false;
-                break;
-            }
-        }
-
-        for(uint32_t i = 0; i < aaClusterVertexUVs.size(); i++)
-        {
-            if(aaClusterVertexUVs[i].size() <= 0)
-            {
-                aaClusterVertexUVs.erase(aaClusterVertexUVs.begin() + i);
-                bDone = false;
-                break;
-            }
-        }
-
-        for(uint32_t i = 0; i < aaiClusterTrianglePositionIndices.size(); i++)
-        {
-            if(aaiClusterTrianglePositionIndices[i].size() <= 0)
-            {
-                aaiClusterTrianglePositionIndices.erase(aaiClusterTrianglePositionIndices.begin() + i);
-                bDone = false;
-                break;
-            }
-        }
-
-        for(uint32_t i = 0; i < aaiClusterTriangleNormalIndices.size(); i++)
-        {
-            if(aaiClusterTriangleNormalIndices[i].size() <= 0)
-            {
-                aaiClusterTriangleNormalIndices.erase(aaiClusterTriangleNormalIndices.begin() + i);
-                bDone = false;
-                break;
-            }
-        }
-
-        for(uint32_t i = 0; i < aaiClusterTriangleUVIndices.size(); i++)
-        {
-            if(aaiClusterTriangleUVIndices[i].size() <= 0)
-            {
-                aaiClusterTriangleUVIndices.erase(aaiClusterTriangleUVIndices.begin() + i);
-                bDone = false;
-                break;
-            }
-        }
-
-        if(bDone)
-        {
-            break;
-        }
-    }
+        aaClusterData.erase(
+            std::remove_if(
+                aaClusterData.begin(),
+                aaClusterData.end(),
+                [](auto const& aClusterData)
+                {
+                    return aClusterData.size() <= 0;
+                }),
+            aaClusterData.end());
+    };
+    removeEmpty(aaClusterVertexPositions);
+    removeEmpty(aaClusterVertexNormals);
+    removeEmpty(aaClusterVertexUVs);
+    removeEmpty(aaiClusterTrianglePositionIndices);
+    removeEmpty(aaiClusterTriangleNormalIndices);
+    removeEmpty(aaiClusterTriangleUVIndices);
 }
\ No newline at end of file
@@ -0,0 +1,209 @@
+#include "cluster_archive.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _MSC_VER
+
+/*
+**
+*/
+static uint64_t alignSectionOffset(uint64_t iOffset)
+{
+    return (iOffset + CLUSTER_ARCHIVE_SECTION_ALIGNMENT - 1) & ~static_cast<uint64_t>(CLUSTER_ARCHIVE_SECTION_ALIGNMENT - 1);
+}
+
+/*
+**
+*/
+void saveClusterArchive(
+    std::string const& outputFilePath,
+    std::vector<ClusterArchiveSectionData> const& aSections)
+{
+    // table of content first, every section starts on its own aligned offset
+    uint32_t iNumSections = static_cast<uint32_t>(aSections.size());
+    std::vector<ClusterArchiveSection> aTableOfContent(iNumSections);
+    uint64_t iCurrOffset = alignSectionOffset(sizeof(ClusterArchiveHeader) + iNumSections * sizeof(ClusterArchiveSection));
+    for(uint32_t iSection = 0; iSection < iNumSections; iSection++)
+    {
+        ClusterArchiveSectionData const& sectionData = aSections[iSection];
+        ClusterArchiveSection& section = aTableOfContent[iSection];
+        section.miType = sectionData.miType;
+        section.miElementSize = sectionData.miElementSize;
+        section.miNumElements = sectionData.miNumElements;
+        section.miOffset = iCurrOffset;
+        section.miSize = sectionData.miNumElements * sectionData.miElementSize;
+
+        iCurrOffset = alignSectionOffset(iCurrOffset + section.miSize);
+    }
+
+    ClusterArchiveHeader header;
+    header.miMagic = CLUSTER_ARCHIVE_MAGIC;
+    header.miVersion = CLUSTER_ARCHIVE_VERSION;
+    header.miNumSections = iNumSections;
+    header.miSectionAlignment = CLUSTER_ARCHIVE_SECTION_ALIGNMENT;
+    header.miFileSize = iCurrOffset;
+
+    // sections are written straight from their data, padding comes from a zeroed block
+    std::vector<uint8_t> acPadding(CLUSTER_ARCHIVE_SECTION_ALIGNMENT, 0);
+    FILE* fp = fopen(outputFilePath.c_str(), "wb");
+    fwrite(&header, sizeof(ClusterArchiveHeader), 1, fp);
+    fwrite(aTableOfContent.data(), sizeof(ClusterArchiveSection), aTableOfContent.size(), fp);
+    uint64_t iFileOffset = sizeof(ClusterArchiveHeader) + iNumSections * sizeof(ClusterArchiveSection);
+    for(uint32_t iSection = 0; iSection < iNumSections; iSection++)
+    {
+        ClusterArchiveSection const& section = aTableOfContent[iSection];
+        fwrite(acPadding.data(), sizeof(char), section.miOffset - iFileOffset, fp);
+        fwrite(aSections[iSection].mpData, sizeof(char), section.miSize, fp);
+        iFileOffset = section.miOffset + section.miSize;
+    }
+    fwrite(acPadding.data(), sizeof(char), header.miFileSize - iFileOffset, fp);
+    fclose(fp);
+}
+
+/*
+**
+*/
+bool mapClusterArchive(
+    ClusterArchive& archive,
+    std::string const& filePath)
+{
+    assert(archive.mpcData == nullptr);
+
+#if defined(_MSC_VER)
+    HANDLE hFile = CreateFileA(
+        filePath.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr);
+    if(hFile == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(hFile, &fileSize);
+    HANDLE hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* pData = (hMapping != nullptr) ? MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if(pData == nullptr)
+    {
+        if(hMapping != nullptr)
+        {
+            CloseHandle(hMapping);
+        }
+        CloseHandle(hFile);
+        return false;
+    }
+
+    archive.mpcData = reinterpret_cast<uint8_t const*>(pData);
+    archive.miSize = static_cast<uint64_t>(fileSize.QuadPart);
+    archive.mpFileHandle = hFile;
+    archive.mpMappingHandle = hMapping;
+#else
+    int iFile = open(filePath.c_str(), O_RDONLY);
+    if(iFile < 0)
+    {
+        return false;
+    }
+
+    struct stat fileStat;
+    fstat(iFile, &fileStat);
+    void* pData = (fileStat.st_size > 0) ? mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, iFile, 0) : MAP_FAILED;
+    close(iFile);
+    if(pData == MAP_FAILED)
+    {
+        return false;
+    }
+
+    archive.mpcData = reinterpret_cast<uint8_t const*>(pData);
+    archive.miSize = static_cast<uint64_t>(fileStat.st_size);
+#endif // _MSC_VER
+
+    // header and table of content have to match the file before any section is handed out
+    bool bValid = (archive.miSize >= sizeof(ClusterArchiveHeader));
+    ClusterArchiveHeader const* pHeader = reinterpret_cast<ClusterArchiveHeader const*>(archive.mpcData);
+    bValid = bValid &&
+        pHeader->miMagic == CLUSTER_ARCHIVE_MAGIC &&
+        pHeader->miVersion <= CLUSTER_ARCHIVE_VERSION &&
+        pHeader->miSectionAlignment != 0 &&
+        pHeader->miFileSize == archive.miSize &&
+        sizeof(ClusterArchiveHeader) + pHeader->miNumSections * sizeof(ClusterArchiveSection) <= archive.miSize;
+    if(bValid)
+    {
+        ClusterArchiveSection const* aSections = reinterpret_cast<ClusterArchiveSection const*>(archive.mpcData + sizeof(ClusterArchiveHeader));
+        for(uint32_t iSection = 0; iSection < pHeader->miNumSections; iSection++)
+        {
+            // compared without sums or products that could wrap around on a corrupt table of content
+            ClusterArchiveSection const& section = aSections[iSection];
+            bValid = bValid &&
+                section.miOffset % pHeader->miSectionAlignment == 0 &&
+                (section.miElementSize == 0 || section.miNumElements <= UINT64_MAX / section.miElementSize) &&
+                section.miSize == section.miNumElements * section.miElementSize &&
+                section.miOffset <= archive.miSize &&
+                section.miSize <= archive.miSize - section.miOffset;
+        }
+    }
+
+    if(!bValid)
+    {
+        unmapClusterArchive(archive);
+    }
+
+    return bValid;
+}
+
+/*
+**
+*/
+void unmapClusterArchive(ClusterArchive& archive)
+{
+    if(archive.mpcData == nullptr)
+    {
+        return;
+    }
+
+#if defined(_MSC_VER)
+    UnmapViewOfFile(archive.mpcData);
+    CloseHandle(reinterpret_cast<HANDLE>(archive.mpMappingHandle));
+    CloseHandle(reinterpret_cast<HANDLE>(archive.mpFileHandle));
+#else
+    munmap(const_cast<uint8_t*>(archive.mpcData), static_cast<size_t>(archive.miSize));
+#endif // _MSC_VER
+
+    archive.mpcData = nullptr;
+    archive.miSize = 0;
+    archive.mpFileHandle = nullptr;
+    archive.mpMappingHandle = nullptr;
+}
+
+/*
+**
+*/
+ClusterArchiveSection const* findClusterArchiveSection(
+    ClusterArchive const& archive,
+    uint32_t iType)
+{
+    assert(archive.mpcData != nullptr);
+
+    ClusterArchiveHeader const* pHeader = reinterpret_cast<ClusterArchiveHeader const*>(archive.mpcData);
+    ClusterArchiveSection const* aSections = reinterpret_cast<ClusterArchiveSection const*>(archive.mpcData + sizeof(ClusterArchiveHeader));
+    for(uint32_t iSection = 0; iSection < pHeader->miNumSections; iSection++)
+    {
+        if(aSections[iSection].miType == iType)
+        {
+            return &aSections[iSection];
+        }
+    }
+
+    return nullptr;
+}
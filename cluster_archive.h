@@ -0,0 +1,129 @@
+#pragma once
+
+#include <assert.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#define CLUSTER_ARCHIVE_MAGIC                   0x4843434d          // "MCCH"
+#define CLUSTER_ARCHIVE_VERSION                 1
+#define CLUSTER_ARCHIVE_SECTION_ALIGNMENT       4096
+
+enum ClusterArchiveSectionType
+{
+    CLUSTER_ARCHIVE_SECTION_CLUSTER_GROUP_TREE_NODES = 0,
+    CLUSTER_ARCHIVE_SECTION_CLUSTER_TREE_NODES,
+    CLUSTER_ARCHIVE_SECTION_MESH_CLUSTERS,
+
+    CLUSTER_ARCHIVE_SECTION_VERTEX_POSITIONS,
+    CLUSTER_ARCHIVE_SECTION_VERTEX_NORMALS,
+    CLUSTER_ARCHIVE_SECTION_VERTEX_UVS,
+    CLUSTER_ARCHIVE_SECTION_TRIANGLE_POSITION_INDICES,
+    CLUSTER_ARCHIVE_SECTION_TRIANGLE_NORMAL_INDICES,
+    CLUSTER_ARCHIVE_SECTION_TRIANGLE_UV_INDICES,
+
+    CLUSTER_ARCHIVE_SECTION_CLUSTER_NUM_VERTICES,
+    CLUSTER_ARCHIVE_SECTION_CLUSTER_NUM_INDICES,
+    CLUSTER_ARCHIVE_SECTION_CLUSTER_VERTEX_OFFSETS,
+    CLUSTER_ARCHIVE_SECTION_CLUSTER_INDEX_OFFSETS,
+    CLUSTER_ARCHIVE_SECTION_CLUSTER_VERTICES,
+    CLUSTER_ARCHIVE_SECTION_CLUSTER_COMPRESSED_VERTICES,        // no longer written, kept so the later types keep their values
+    CLUSTER_ARCHIVE_SECTION_CLUSTER_INDICES,
+
+    CLUSTER_ARCHIVE_SECTION_CLUSTER_PAGES,
+    CLUSTER_ARCHIVE_SECTION_CLUSTER_GROUP_PAGES,
+    CLUSTER_ARCHIVE_SECTION_CLUSTER_PAGE_LIST,
+    CLUSTER_ARCHIVE_SECTION_CLUSTER_PAGE_LOCATIONS,
+
+    NUM_CLUSTER_ARCHIVE_SECTIONS,
+};
+
+// start of the file, the table of content follows right after it
+struct ClusterArchiveHeader
+{
+    uint32_t        miMagic;
+    uint32_t        miVersion;
+    uint32_t        miNumSections;
+    uint32_t        miSectionAlignment;
+    uint64_t        miFileSize;
+};
+
+// table of content entry, offset is from the start of the file and a multiple of the section alignment
+//      sections are arrays of plain structs, readers look them up by type and skip the types they don't know
+struct ClusterArchiveSection
+{
+    uint32_t        miType;
+    uint32_t        miElementSize;
+    uint64_t        miNumElements;
+    uint64_t        miOffset;
+    uint64_t        miSize;
+};
+
+// section to write, data is num elements * element size bytes
+struct ClusterArchiveSectionData
+{
+    uint32_t        miType;
+    uint32_t        miElementSize;
+    uint64_t        miNumElements;
+    void const*     mpData;
+};
+
+// read-only view of a mapped archive file, release it with unmapClusterArchive()
+struct ClusterArchive
+{
+    uint8_t const*      mpcData = nullptr;
+    uint64_t            miSize = 0;
+    void*               mpFileHandle = nullptr;
+    void*               mpMappingHandle = nullptr;
+
+    ClusterArchive() = default;
+    ClusterArchive(ClusterArchive const&) = delete;
+    ClusterArchive& operator = (ClusterArchive const&) = delete;
+};
+
+/*
+**
+*/
+template<typename T>
+inline ClusterArchiveSectionData getClusterArchiveSectionData(
+    uint32_t iType,
+    std::vector<T> const& aData)
+{
+    return ClusterArchiveSectionData{ iType, static_cast<uint32_t>(sizeof(T)), static_cast<uint64_t>(aData.size()), aData.data() };
+}
+
+void saveClusterArchive(
+    std::string const& outputFilePath,
+    std::vector<ClusterArchiveSectionData> const& aSections);
+
+bool mapClusterArchive(
+    ClusterArchive& archive,
+    std::string const& filePath);
+
+void unmapClusterArchive(ClusterArchive& archive);
+
+ClusterArchiveSection const* findClusterArchiveSection(
+    ClusterArchive const& archive,
+    uint32_t iType);
+
+/*
+**  pointer into the mapped file, nullptr with 0 elements when the archive doesn't have the section
+*/
+template<typename T>
+inline T const* getClusterArchiveSectionElements(
+    uint64_t& iNumElements,
+    ClusterArchive const& archive,
+    uint32_t iType)
+{
+    ClusterArchiveSection const* pSection = findClusterArchiveSection(archive, iType);
+    if(pSection == nullptr)
+    {
+        iNumElements = 0;
+        return nullptr;
+    }
+
+    assert(pSection->miElementSize == sizeof(T));
+    iNumElements = pSection->miNumElements;
+    return reinterpret_cast<T const*>(archive.mpcData + pSection->miOffset);
+}
@@ -0,0 +1,228 @@
+#include "cluster_chunk_reader.h"
+#include "mesh_cluster.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include <algorithm>
+
+#if defined(_MSC_VER)
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif // _MSC_VER
+
+/*
+**
+*/
+static intptr_t openReadFile(std::string const& filePath)
+{
+#if defined(_MSC_VER)
+    HANDLE hFile = CreateFileA(
+        filePath.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr);
+    return (hFile == INVALID_HANDLE_VALUE) ? -1 : reinterpret_cast<intptr_t>(hFile);
+#else
+    return static_cast<intptr_t>(open(filePath.c_str(), O_RDONLY));
+#endif // _MSC_VER
+}
+
+/*
+**
+*/
+static void closeReadFile(intptr_t iFile)
+{
+    if(iFile == -1)
+    {
+        return;
+    }
+
+#if defined(_MSC_VER)
+    CloseHandle(reinterpret_cast<HANDLE>(iFile));
+#else
+    close(static_cast<int>(iFile));
+#endif // _MSC_VER
+}
+
+/*
+**  positional read, leaves the file position alone so it's safe to call from several threads on the same file
+*/
+static void readFileRange(
+    void* pDest,
+    intptr_t iFile,
+    uint64_t iOffset,
+    uint64_t iSize)
+{
+    uint8_t* pcDest = reinterpret_cast<uint8_t*>(pDest);
+    while(iSize > 0)
+    {
+#if defined(_MSC_VER)
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = static_cast<DWORD>(iOffset & 0xffffffff);
+        overlapped.OffsetHigh = static_cast<DWORD>(iOffset >> 32);
+        DWORD iNumBytesRead = 0;
+        DWORD iNumBytesToRead = static_cast<DWORD>(std::min(iSize, static_cast<uint64_t>(1u << 30)));
+        BOOL bRead = ReadFile(reinterpret_cast<HANDLE>(iFile), pcDest, iNumBytesToRead, &iNumBytesRead, &overlapped);
+        assert(bRead && iNumBytesRead > 0);
+        if(!bRead || iNumBytesRead == 0)
+        {
+            break;
+        }
+        uint64_t iNumRead = iNumBytesRead;
+#else
+        ssize_t iNumBytesRead = pread(static_cast<int>(iFile), pcDest, static_cast<size_t>(iSize), static_cast<off_t>(iOffset));
+        assert(iNumBytesRead > 0);
+        if(iNumBytesRead <= 0)
+        {
+            break;
+        }
+        uint64_t iNumRead = static_cast<uint64_t>(iNumBytesRead);
+#endif // _MSC_VER
+
+        pcDest += iNumRead;
+        iOffset += iNumRead;
+        iSize -= iNumRead;
+    }
+}
+
+/*
+**
+*/
+bool openMeshClusterChunkReader(
+    MeshClusterChunkReader& reader,
+    std::string const& vertexDataFilePath,
+    std::string const& indexDataFilePath,
+    uint32_t iVertexSize)
+{
+    assert(reader.miVertexFile == -1 && reader.miIndexFile == -1);
+
+    reader.miVertexFile = openReadFile(vertexDataFilePath);
+    reader.miIndexFile = openReadFile(indexDataFilePath);
+    if(reader.miVertexFile == -1 || reader.miIndexFile == -1)
+    {
+        closeMeshClusterChunkReader(reader);
+        return false;
+    }
+
+    loadMeshClusterTriangleDataTableOfContent(
+        reader.maiNumClusterVertices,
+        reader.maiNumClusterIndices,
+        reader.maiVertexBufferArrayOffsets,
+        reader.maiIndexBufferArrayOffsets,
+        reader.miIndexSize,
+        vertexDataFilePath,
+        indexDataFilePath);
+
+    // both files start with the cluster count and one count per cluster
+    reader.miVertexSize = iVertexSize;
+    reader.miVertexDataStart = sizeof(uint32_t) + sizeof(uint32_t) * reader.maiNumClusterVertices.size();
+    reader.miIndexDataStart = sizeof(uint32_t) + sizeof(uint32_t) * reader.maiNumClusterIndices.size();
+
+    return true;
+}
+
+/*
+**
+*/
+void closeMeshClusterChunkReader(MeshClusterChunkReader& reader)
+{
+    closeReadFile(reader.miVertexFile);
+    closeReadFile(reader.miIndexFile);
+    reader.miVertexFile = -1;
+    reader.miIndexFile = -1;
+}
+
+/*
+**
+*/
+void readMeshClusterChunks(
+    TaskCounter& counter,
+    MeshClusterChunkReader const& reader,
+    std::vector<uint32_t> const& aiClusters,
+    std::function<void(MeshClusterChunk const&)> const& callback,
+    uint64_t iMaxReadSize)
+{
+    assert(reader.miVertexFile != -1 && reader.miIndexFile != -1);
+
+    // clusters are stored in index order, consecutive cluster indices are consecutive ranges in both files
+    uint32_t iNumClusters = static_cast<uint32_t>(aiClusters.size());
+    std::vector<uint32_t> aiSortedClusters(aiClusters);
+    std::sort(aiSortedClusters.begin(), aiSortedClusters.end());
+    assert(iNumClusters == 0 || aiSortedClusters.back() < reader.maiNumClusterVertices.size());
+
+    uint32_t iRunStart = 0;
+    while(iRunStart < iNumClusters)
+    {
+        // grow the run while the next cluster follows the last one and the reads stay under the max size
+        uint32_t iFirstCluster = aiSortedClusters[iRunStart];
+        uint32_t iRunEnd = iRunStart + 1;
+        while(iRunEnd < iNumClusters)
+        {
+            uint32_t iNextCluster = aiSortedClusters[iRunEnd];
+            if(iNextCluster != aiSortedClusters[iRunEnd - 1] + 1)
+            {
+                break;
+            }
+
+            uint64_t iVertexReadSize = (reader.maiVertexBufferArrayOffsets[iNextCluster] + reader.maiNumClusterVertices[iNextCluster] - reader.maiVertexBufferArrayOffsets[iFirstCluster]) * reader.miVertexSize;
+            uint64_t iIndexReadSize = (reader.maiIndexBufferArrayOffsets[iNextCluster] + reader.maiNumClusterIndices[iNextCluster] - reader.maiIndexBufferArrayOffsets[iFirstCluster]) * reader.miIndexSize;
+            if(iVertexReadSize > iMaxReadSize || iIndexReadSize > iMaxReadSize)
+            {
+                break;
+            }
+
+            ++iRunEnd;
+        }
+
+        uint32_t iNumRunClusters = iRunEnd - iRunStart;
+        uint32_t iLastCluster = aiSortedClusters[iRunEnd - 1];
+        submitTask(
+            counter,
+            [&reader,
+            callback,
+            iNumRunClusters,
+            iFirstCluster,
+            iLastCluster]()
+            {
+                uint64_t iVertexStart = reader.maiVertexBufferArrayOffsets[iFirstCluster];
+                uint64_t iIndexStart = reader.maiIndexBufferArrayOffsets[iFirstCluster];
+                uint64_t iVertexReadSize = (reader.maiVertexBufferArrayOffsets[iLastCluster] + reader.maiNumClusterVertices[iLastCluster] - iVertexStart) * reader.miVertexSize;
+                uint64_t iIndexReadSize = (reader.maiIndexBufferArrayOffsets[iLastCluster] + reader.maiNumClusterIndices[iLastCluster] - iIndexStart) * reader.miIndexSize;
+
+                std::vector<uint8_t> acVertexData(iVertexReadSize);
+                std::vector<uint8_t> acIndexData(iIndexReadSize);
+                readFileRange(
+                    acVertexData.data(),
+                    reader.miVertexFile,
+                    reader.miVertexDataStart + iVertexStart * reader.miVertexSize,
+                    iVertexReadSize);
+                readFileRange(
+                    acIndexData.data(),
+                    reader.miIndexFile,
+                    reader.miIndexDataStart + iIndexStart * reader.miIndexSize,
+                    iIndexReadSize);
+
+                for(uint32_t i = 0; i < iNumRunClusters; i++)
+                {
+                    uint32_t iCluster = iFirstCluster + i;
+
+                    MeshClusterChunk chunk;
+                    chunk.miCluster = iCluster;
+                    chunk.mpcVertexData = acVertexData.data() + (reader.maiVertexBufferArrayOffsets[iCluster] - iVertexStart) * reader.miVertexSize;
+                    chunk.miVertexDataSize = static_cast<uint64_t>(reader.maiNumClusterVertices[iCluster]) * reader.miVertexSize;
+                    chunk.mpcIndexData = acIndexData.data() + (reader.maiIndexBufferArrayOffsets[iCluster] - iIndexStart) * reader.miIndexSize;
+                    chunk.miIndexDataSize = static_cast<uint64_t>(reader.maiNumClusterIndices[iCluster]) * reader.miIndexSize;
+                    callback(chunk);
+                }
+            });
+
+        iRunStart = iRunEnd;
+    }
+}
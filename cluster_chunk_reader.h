@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "task_scheduler.h"
+
+// keeps the vertex and index data files written by saveMeshClusterTriangleData() open for positional reads
+//      vertex size is sizeof(ConvertedMeshVertexFormat) for the vertex data file, sizeof(CompressedMeshVertexFormat) for the compressed one
+//      reads don't move a file position, so any number of them can run at the same time
+struct MeshClusterChunkReader
+{
+    intptr_t                    miVertexFile = -1;
+    intptr_t                    miIndexFile = -1;
+
+    uint32_t                    miVertexSize = 0;
+    uint32_t                    miIndexSize = 0;
+    uint64_t                    miVertexDataStart = 0;
+    uint64_t                    miIndexDataStart = 0;
+
+    std::vector<uint32_t>       maiNumClusterVertices;
+    std::vector<uint32_t>       maiNumClusterIndices;
+    std::vector<uint64_t>       maiVertexBufferArrayOffsets;
+    std::vector<uint64_t>       maiIndexBufferArrayOffsets;
+
+    MeshClusterChunkReader() = default;
+    MeshClusterChunkReader(MeshClusterChunkReader const&) = delete;
+    MeshClusterChunkReader& operator = (MeshClusterChunkReader const&) = delete;
+};
+
+// one cluster's vertex and index data as stored in the files, pointing into the buffer of the read it came in with
+struct MeshClusterChunk
+{
+    uint32_t                    miCluster = UINT32_MAX;
+    uint8_t const*              mpcVertexData = nullptr;
+    uint64_t                    miVertexDataSize = 0;
+    uint8_t const*              mpcIndexData = nullptr;
+    uint64_t                    miIndexDataSize = 0;
+};
+
+bool openMeshClusterChunkReader(
+    MeshClusterChunkReader& reader,
+    std::string const& vertexDataFilePath,
+    std::string const& indexDataFilePath,
+    uint32_t iVertexSize);
+
+void closeMeshClusterChunkReader(MeshClusterChunkReader& reader);
+
+/*
+**  clusters next to each other in the files are read together, up to iMaxReadSize bytes per file and read
+**  reads are submitted to the task scheduler, callback(chunk) runs on the reading thread once per cluster in aiClusters
+**  chunk data is only valid during the callback, it's released as soon as the callbacks of its read return
+**  waitForTasks(counter) returns once all the clusters are read and their callbacks have returned
+*/
+void readMeshClusterChunks(
+    TaskCounter& counter,
+    MeshClusterChunkReader const& reader,
+    std::vector<uint32_t> const& aiClusters,
+    std::function<void(MeshClusterChunk const&)> const& callback,
+    uint64_t iMaxReadSize = (1 << 20));
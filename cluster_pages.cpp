@@ -0,0 +1,278 @@
+#include "cluster_pages.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include <algorithm>
+#include <iterator>
+
+/*
+**
+*/
+static uint32_t alignPageOffset(uint32_t iOffset)
+{
+    return (iOffset + 15) & ~15u;
+}
+
+/*
+**
+*/
+bool buildMeshClusterPages(
+    MeshClusterPageData& pageData,
+    MeshClusterTriangleData const& triangleData,
+    std::vector<MeshClusterGroup*> const& apMeshClusterGroups,
+    uint32_t iPageSize,
+    bool bCompressedVertices)
+{
+    assert(!bCompressedVertices || triangleData.maCompressedVertices.size() == triangleData.maVertices.size());
+
+    uint32_t iNumClusters = static_cast<uint32_t>(triangleData.maiNumClusterVertices.size());
+    pageData.miPageSize = iPageSize;
+    pageData.miVertexSize = bCompressedVertices ? sizeof(CompressedMeshVertexFormat) : sizeof(ConvertedMeshVertexFormat);
+    pageData.miIndexSize = triangleData.miIndexSize;
+
+    uint32_t iNumGroups = 0;
+    for(auto const* pGroup : apMeshClusterGroups)
+    {
+        iNumGroups = std::max(iNumGroups, pGroup->miIndex + 1);
+    }
+
+    // coarsest LOD first, the runtime always keeps those resident
+    std::vector<MeshClusterGroup const*> apSortedGroups(apMeshClusterGroups.begin(), apMeshClusterGroups.end());
+    std::sort(
+        apSortedGroups.begin(),
+        apSortedGroups.end(),
+        [](MeshClusterGroup const* pLeft, MeshClusterGroup const* pRight)
+        {
+            return (pLeft->miLODLevel != pRight->miLODLevel) ? pLeft->miLODLevel > pRight->miLODLevel : pLeft->miIndex < pRight->miIndex;
+        });
+
+    auto forEachGroupCluster = [iNumClusters](
+        MeshClusterGroup const& group,
+        uint32_t iMIP,
+        auto const& func)
+    {
+        if(iMIP >= group.miNumMIPS || iMIP >= MAX_MIP_LEVELS)
+        {
+            return;
+        }
+
+        uint32_t iNumGroupClusters = std::min(group.maiNumClusters[iMIP], static_cast<uint32_t>(MAX_CLUSTERS_IN_GROUP));
+        for(uint32_t i = 0; i < iNumGroupClusters; i++)
+        {
+            if(group.maiClusters[iMIP][i] < iNumClusters)
+            {
+                func(group.maiClusters[iMIP][i]);
+            }
+        }
+    };
+
+    // runs of clusters stored together, one per group with the clusters no earlier group has taken
+    std::vector<uint32_t> aiClusterOwnerGroup(iNumClusters, UINT32_MAX);
+    std::vector<uint32_t> aiClusterOrder;
+    std::vector<uint32_t> aiRunStart;
+    aiClusterOrder.reserve(iNumClusters);
+    for(auto const* pGroup : apSortedGroups)
+    {
+        aiRunStart.push_back(static_cast<uint32_t>(aiClusterOrder.size()));
+        for(uint32_t iMIP = 0; iMIP < MAX_MIP_LEVELS; iMIP++)
+        {
+            forEachGroupCluster(
+                *pGroup,
+                iMIP,
+                [&aiClusterOwnerGroup,
+                &aiClusterOrder,
+                pGroup](uint32_t iCluster)
+                {
+                    if(aiClusterOwnerGroup[iCluster] == UINT32_MAX)
+                    {
+                        aiClusterOwnerGroup[iCluster] = pGroup->miIndex;
+                        aiClusterOrder.push_back(iCluster);
+                    }
+                });
+        }
+    }
+
+    // clusters without a group still get stored, in one run at the end
+    aiRunStart.push_back(static_cast<uint32_t>(aiClusterOrder.size()));
+    for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
+    {
+        if(aiClusterOwnerGroup[iCluster] == UINT32_MAX)
+        {
+            aiClusterOrder.push_back(iCluster);
+        }
+    }
+    aiRunStart.push_back(static_cast<uint32_t>(aiClusterOrder.size()));
+
+    // page holds its header, the cluster table, then each cluster's vertices and indices
+    auto getClusterDataSize = [&triangleData,
+        &pageData](uint32_t iCluster)
+    {
+        return alignPageOffset(triangleData.maiNumClusterVertices[iCluster] * pageData.miVertexSize) + alignPageOffset(triangleData.maiNumClusterIndices[iCluster] * pageData.miIndexSize);
+    };
+
+    auto fitsInPage = [iPageSize](
+        uint32_t iNumPageClusters,
+        uint32_t iPageClusterDataSize)
+    {
+        return alignPageOffset(static_cast<uint32_t>(sizeof(MeshClusterPageHeader) + iNumPageClusters * sizeof(MeshClusterPageCluster))) + iPageClusterDataSize <= iPageSize;
+    };
+
+    // a cluster can't be split across pages, the page size has to hold the largest one on its own
+    for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
+    {
+        if(!fitsInPage(1, getClusterDataSize(iCluster)))
+        {
+            pageData = MeshClusterPageData();
+            return false;
+        }
+    }
+
+    // a group's run starts on a new page when it would fit in one there but not in what's left of the current page
+    std::vector<std::vector<uint32_t>> aaiPageClusters;
+    uint32_t iCurrPageDataSize = 0;
+    for(uint32_t iRun = 0; iRun + 1 < static_cast<uint32_t>(aiRunStart.size()); iRun++)
+    {
+        uint32_t iRunDataSize = 0;
+        for(uint32_t i = aiRunStart[iRun]; i < aiRunStart[iRun + 1]; i++)
+        {
+            iRunDataSize += getClusterDataSize(aiClusterOrder[i]);
+        }
+        uint32_t iNumRunClusters = aiRunStart[iRun + 1] - aiRunStart[iRun];
+        if(iNumRunClusters == 0)
+        {
+            continue;
+        }
+
+        if(!aaiPageClusters.empty() &&
+            !fitsInPage(static_cast<uint32_t>(aaiPageClusters.back().size()) + iNumRunClusters, iCurrPageDataSize + iRunDataSize) &&
+            fitsInPage(iNumRunClusters, iRunDataSize))
+        {
+            aaiPageClusters.emplace_back();
+            iCurrPageDataSize = 0;
+        }
+
+        for(uint32_t i = aiRunStart[iRun]; i < aiRunStart[iRun + 1]; i++)
+        {
+            uint32_t iCluster = aiClusterOrder[i];
+            uint32_t iClusterDataSize = getClusterDataSize(iCluster);
+            if(aaiPageClusters.empty() || !fitsInPage(static_cast<uint32_t>(aaiPageClusters.back().size()) + 1, iCurrPageDataSize + iClusterDataSize))
+            {
+                aaiPageClusters.emplace_back();
+                iCurrPageDataSize = 0;
+            }
+            assert(fitsInPage(static_cast<uint32_t>(aaiPageClusters.back().size()) + 1, iCurrPageDataSize + iClusterDataSize));
+
+            aaiPageClusters.back().push_back(iCluster);
+            iCurrPageDataSize += iClusterDataSize;
+        }
+    }
+
+    // fill the pages
+    uint8_t const* pcVertexData = bCompressedVertices ?
+        reinterpret_cast<uint8_t const*>(triangleData.maCompressedVertices.data()) :
+        reinterpret_cast<uint8_t const*>(triangleData.maVertices.data());
+    pageData.miNumPages = static_cast<uint32_t>(aaiPageClusters.size());
+    pageData.macPages.assign(static_cast<uint64_t>(pageData.miNumPages) * iPageSize, 0);
+    pageData.maClusterLocations.assign(iNumClusters, MeshClusterPageLocation{ UINT32_MAX, UINT32_MAX });
+    for(uint32_t iPage = 0; iPage < pageData.miNumPages; iPage++)
+    {
+        std::vector<uint32_t> const& aiPageClusters = aaiPageClusters[iPage];
+        uint8_t* pcPage = pageData.macPages.data() + static_cast<uint64_t>(iPage) * iPageSize;
+        MeshClusterPageHeader* pHeader = reinterpret_cast<MeshClusterPageHeader*>(pcPage);
+        MeshClusterPageCluster* aPageClusters = reinterpret_cast<MeshClusterPageCluster*>(pcPage + sizeof(MeshClusterPageHeader));
+
+        uint32_t iDataOffset = alignPageOffset(static_cast<uint32_t>(sizeof(MeshClusterPageHeader) + aiPageClusters.size() * sizeof(MeshClusterPageCluster)));
+        for(uint32_t iPageCluster = 0; iPageCluster < static_cast<uint32_t>(aiPageClusters.size()); iPageCluster++)
+        {
+            uint32_t iCluster = aiPageClusters[iPageCluster];
+            uint32_t iVertexDataSize = triangleData.maiNumClusterVertices[iCluster] * pageData.miVertexSize;
+            uint32_t iIndexDataSize = triangleData.maiNumClusterIndices[iCluster] * pageData.miIndexSize;
+
+            MeshClusterPageCluster& pageCluster = aPageClusters[iPageCluster];
+            pageCluster.miCluster = iCluster;
+            pageCluster.miNumVertices = triangleData.maiNumClusterVertices[iCluster];
+            pageCluster.miNumIndices = triangleData.maiNumClusterIndices[iCluster];
+            pageCluster.miVertexDataOffset = iDataOffset;
+            pageCluster.miIndexDataOffset = iDataOffset + alignPageOffset(iVertexDataSize);
+
+            memcpy(
+                pcPage + pageCluster.miVertexDataOffset,
+                pcVertexData + triangleData.maiVertexOffsets[iCluster] * pageData.miVertexSize,
+                iVertexDataSize);
+            memcpy(
+                pcPage + pageCluster.miIndexDataOffset,
+                triangleData.macIndices.data() + triangleData.maiIndexOffsets[iCluster] * pageData.miIndexSize,
+                iIndexDataSize);
+
+            iDataOffset = pageCluster.miIndexDataOffset + alignPageOffset(iIndexDataSize);
+            pageData.maClusterLocations[iCluster] = MeshClusterPageLocation{ iPage, iPageCluster };
+        }
+
+        pHeader->miNumClusters = static_cast<uint32_t>(aiPageClusters.size());
+        pHeader->miDataSize = iDataOffset;
+        assert(iDataOffset <= iPageSize);
+    }
+
+    // group pages hold its MIP 0 clusters and whatever it stored, the dependencies are the other pages its MIP 1 clusters are in
+    std::vector<std::vector<uint32_t>> aaiGroupPages(iNumGroups);
+    std::vector<std::vector<uint32_t>> aaiGroupDependencyPages(iNumGroups);
+    for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
+    {
+        if(aiClusterOwnerGroup[iCluster] != UINT32_MAX)
+        {
+            aaiGroupPages[aiClusterOwnerGroup[iCluster]].push_back(pageData.maClusterLocations[iCluster].miPage);
+        }
+    }
+    for(auto const* pGroup : apMeshClusterGroups)
+    {
+        std::vector<uint32_t>& aiPages = aaiGroupPages[pGroup->miIndex];
+        std::vector<uint32_t>& aiDependencyPages = aaiGroupDependencyPages[pGroup->miIndex];
+        forEachGroupCluster(
+            *pGroup,
+            0,
+            [&aiPages,
+            &pageData](uint32_t iCluster)
+            {
+                aiPages.push_back(pageData.maClusterLocations[iCluster].miPage);
+            });
+        forEachGroupCluster(
+            *pGroup,
+            1,
+            [&aiDependencyPages,
+            &pageData](uint32_t iCluster)
+            {
+                aiDependencyPages.push_back(pageData.maClusterLocations[iCluster].miPage);
+            });
+
+        std::sort(aiPages.begin(), aiPages.end());
+        aiPages.erase(std::unique(aiPages.begin(), aiPages.end()), aiPages.end());
+        std::sort(aiDependencyPages.begin(), aiDependencyPages.end());
+        aiDependencyPages.erase(std::unique(aiDependencyPages.begin(), aiDependencyPages.end()), aiDependencyPages.end());
+
+        std::vector<uint32_t> aiOtherPages;
+        std::set_difference(
+            aiDependencyPages.begin(),
+            aiDependencyPages.end(),
+            aiPages.begin(),
+            aiPages.end(),
+            std::back_inserter(aiOtherPages));
+        aiDependencyPages.swap(aiOtherPages);
+    }
+
+    pageData.maGroupPages.assign(iNumGroups, MeshClusterGroupPages{ 0, 0, 0, 0 });
+    pageData.maiPageList.clear();
+    for(uint32_t iGroup = 0; iGroup < iNumGroups; iGroup++)
+    {
+        MeshClusterGroupPages& groupPages = pageData.maGroupPages[iGroup];
+        groupPages.miFirstPage = static_cast<uint32_t>(pageData.maiPageList.size());
+        groupPages.miNumPages = static_cast<uint32_t>(aaiGroupPages[iGroup].size());
+        pageData.maiPageList.insert(pageData.maiPageList.end(), aaiGroupPages[iGroup].begin(), aaiGroupPages[iGroup].end());
+
+        groupPages.miFirstDependencyPage = static_cast<uint32_t>(pageData.maiPageList.size());
+        groupPages.miNumDependencyPages = static_cast<uint32_t>(aaiGroupDependencyPages[iGroup].size());
+        pageData.maiPageList.insert(pageData.maiPageList.end(), aaiGroupDependencyPages[iGroup].begin(), aaiGroupDependencyPages[iGroup].end());
+    }
+
+    return true;
+}
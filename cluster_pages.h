@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "mesh_cluster.h"
+
+#define MESH_CLUSTER_PAGE_SIZE          (128 * 1024)
+
+// start of every page, the page's cluster table follows it
+struct MeshClusterPageHeader
+{
+    uint32_t        miNumClusters;
+    uint32_t        miDataSize;
+};
+
+// vertex and index data offsets are in bytes from the start of the page, 16 byte aligned
+struct MeshClusterPageCluster
+{
+    uint32_t        miCluster;
+    uint32_t        miNumVertices;
+    uint32_t        miNumIndices;
+    uint32_t        miVertexDataOffset;
+    uint32_t        miIndexDataOffset;
+};
+
+// runs of the page list, pages the group's clusters are in and pages of its parent groups holding its MIP 1 clusters
+struct MeshClusterGroupPages
+{
+    uint32_t        miFirstPage;
+    uint32_t        miNumPages;
+    uint32_t        miFirstDependencyPage;
+    uint32_t        miNumDependencyPages;
+};
+
+struct MeshClusterPageLocation
+{
+    uint32_t        miPage;
+    uint32_t        miPageCluster;
+};
+
+// clusters packed into fixed size pages, coarsest LOD first and one cluster group after the other within a LOD
+//      every cluster is stored once, with the first group listing it in that order
+//          a group's MIP 0 clusters are its own, its MIP 1 clusters are the MIP 0 clusters of the parent groups one LOD up
+//      group pages are indexed by MeshClusterGroup::miIndex, cluster locations by MeshCluster::miIndex
+struct MeshClusterPageData
+{
+    uint32_t                                miPageSize = MESH_CLUSTER_PAGE_SIZE;
+    uint32_t                                miVertexSize = 0;
+    uint32_t                                miIndexSize = 0;
+    uint32_t                                miNumPages = 0;
+
+    std::vector<uint8_t>                    macPages;
+    std::vector<MeshClusterGroupPages>      maGroupPages;
+    std::vector<uint32_t>                   maiPageList;
+    std::vector<MeshClusterPageLocation>    maClusterLocations;
+};
+
+// returns false and leaves the page data empty when a cluster doesn't fit in a page of the given size on its own
+bool buildMeshClusterPages(
+    MeshClusterPageData& pageData,
+    MeshClusterTriangleData const& triangleData,
+    std::vector<MeshClusterGroup*> const& apMeshClusterGroups,
+    uint32_t iPageSize,
+    bool bCompressedVertices);
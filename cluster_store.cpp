@@ -0,0 +1,346 @@
+#include "cluster_store.h"
+
+#include <algorithm>
+#include <cassert>
+
+/*
+**
+*/
+template<typename T>
+ClusterArrayView<T> getPoolView(
+    std::vector<T> const& aPool,
+    std::vector<uint32_t> const& aiStart,
+    uint32_t iCluster)
+{
+    ClusterArrayView<T> view;
+    view.mpData = aPool.data() + aiStart[iCluster];
+    view.miSize = aiStart[iCluster + 1] - aiStart[iCluster];
+
+    return view;
+}
+
+/*
+**
+*/
+template<typename T>
+void appendPool(
+    std::vector<T>& aPool,
+    std::vector<uint32_t>& aiStart,
+    T const* pData,
+    uint32_t iSize)
+{
+    aPool.insert(aPool.end(), pData, pData + iSize);
+    aiStart.push_back(static_cast<uint32_t>(aPool.size()));
+}
+
+/*
+**
+*/
+static void initClusterStoreStarts(ClusterStore& store)
+{
+    // empty and moved-from stores have no start entries yet
+    if(store.maiTriangleIndexStart.empty())
+    {
+        store.maiVertexPositionStart.assign(1, 0);
+        store.maiVertexNormalStart.assign(1, 0);
+        store.maiVertexUVStart.assign(1, 0);
+        store.maiTriangleIndexStart.assign(1, 0);
+    }
+}
+
+/*
+**
+*/
+uint32_t getNumClusters(ClusterStore const& store)
+{
+    return store.maiTriangleIndexStart.empty() ? 0 : static_cast<uint32_t>(store.maiTriangleIndexStart.size() - 1);
+}
+
+/*
+**
+*/
+ClusterView getClusterView(
+    ClusterStore const& store,
+    uint32_t iCluster)
+{
+    assert(iCluster < getNumClusters(store));
+
+    ClusterView view;
+    view.mVertexPositions = getPoolView(store.maVertexPositions, store.maiVertexPositionStart, iCluster);
+    view.mVertexNormals = getPoolView(store.maVertexNormals, store.maiVertexNormalStart, iCluster);
+    view.mVertexUVs = getPoolView(store.maVertexUVs, store.maiVertexUVStart, iCluster);
+    view.maiTrianglePositionIndices = getPoolView(store.maiTrianglePositionIndices, store.maiTriangleIndexStart, iCluster);
+    view.maiTriangleNormalIndices = getPoolView(store.maiTriangleNormalIndices, store.maiTriangleIndexStart, iCluster);
+    view.maiTriangleUVIndices = getPoolView(store.maiTriangleUVIndices, store.maiTriangleIndexStart, iCluster);
+
+    return view;
+}
+
+/*
+**
+*/
+void reserveClusterStore(
+    ClusterStore& store,
+    uint32_t iNumClusters,
+    uint32_t iNumVertices,
+    uint32_t iNumTriangleIndices)
+{
+    store.maVertexPositions.reserve(iNumVertices);
+    store.maVertexNormals.reserve(iNumVertices);
+    store.maVertexUVs.reserve(iNumVertices);
+    store.maiTrianglePositionIndices.reserve(iNumTriangleIndices);
+    store.maiTriangleNormalIndices.reserve(iNumTriangleIndices);
+    store.maiTriangleUVIndices.reserve(iNumTriangleIndices);
+
+    store.maiVertexPositionStart.reserve(iNumClusters + 1);
+    store.maiVertexNormalStart.reserve(iNumClusters + 1);
+    store.maiVertexUVStart.reserve(iNumClusters + 1);
+    store.maiTriangleIndexStart.reserve(iNumClusters + 1);
+}
+
+/*
+**
+*/
+void clearClusterStore(ClusterStore& store)
+{
+    // release the pools too, the next LOD level is about half the size
+    store = ClusterStore();
+}
+
+/*
+**
+*/
+void appendCluster(
+    ClusterStore& store,
+    std::vector<float3> const& aVertexPositions,
+    std::vector<float3> const& aVertexNormals,
+    std::vector<float2> const& aVertexUVs,
+    std::vector<uint32_t> const& aiTrianglePositionIndices,
+    std::vector<uint32_t> const& aiTriangleNormalIndices,
+    std::vector<uint32_t> const& aiTriangleUVIndices)
+{
+    ClusterView cluster;
+    cluster.mVertexPositions = getArrayView(aVertexPositions);
+    cluster.mVertexNormals = getArrayView(aVertexNormals);
+    cluster.mVertexUVs = getArrayView(aVertexUVs);
+    cluster.maiTrianglePositionIndices = getArrayView(aiTrianglePositionIndices);
+    cluster.maiTriangleNormalIndices = getArrayView(aiTriangleNormalIndices);
+    cluster.maiTriangleUVIndices = getArrayView(aiTriangleUVIndices);
+
+    appendCluster(store, cluster);
+}
+
+/*
+**
+*/
+void appendCluster(
+    ClusterStore& store,
+    ClusterView const& cluster)
+{
+    assert(cluster.maiTrianglePositionIndices.size() == cluster.maiTriangleNormalIndices.size());
+    assert(cluster.maiTrianglePositionIndices.size() == cluster.maiTriangleUVIndices.size());
+
+    initClusterStoreStarts(store);
+
+    appendPool(store.maVertexPositions, store.maiVertexPositionStart, cluster.mVertexPositions.data(), cluster.mVertexPositions.size());
+    appendPool(store.maVertexNormals, store.maiVertexNormalStart, cluster.mVertexNormals.data(), cluster.mVertexNormals.size());
+    appendPool(store.maVertexUVs, store.maiVertexUVStart, cluster.mVertexUVs.data(), cluster.mVertexUVs.size());
+
+    store.maiTrianglePositionIndices.insert(store.maiTrianglePositionIndices.end(), cluster.maiTrianglePositionIndices.begin(), cluster.maiTrianglePositionIndices.end());
+    store.maiTriangleNormalIndices.insert(store.maiTriangleNormalIndices.end(), cluster.maiTriangleNormalIndices.begin(), cluster.maiTriangleNormalIndices.end());
+    store.maiTriangleUVIndices.insert(store.maiTriangleUVIndices.end(), cluster.maiTriangleUVIndices.begin(), cluster.maiTriangleUVIndices.end());
+    store.maiTriangleIndexStart.push_back(static_cast<uint32_t>(store.maiTrianglePositionIndices.size()));
+}
+
+/*
+**
+*/
+void appendClusters(
+    ClusterStore& store,
+    ClusterStore const& srcStore)
+{
+    uint32_t iNumSrcClusters = getNumClusters(srcStore);
+    if(iNumSrcClusters == 0)
+    {
+        return;
+    }
+
+    initClusterStoreStarts(store);
+
+    // triangle indices are cluster local, only the start offsets need rebasing
+    auto appendStarts = [](std::vector<uint32_t>& aiStart, std::vector<uint32_t> const& aiSrcStart)
+    {
+        uint32_t iBase = aiStart.back();
+        for(uint32_t i = 1; i < static_cast<uint32_t>(aiSrcStart.size()); i++)
+        {
+            aiStart.push_back(iBase + aiSrcStart[i]);
+        }
+    };
+    appendStarts(store.maiVertexPositionStart, srcStore.maiVertexPositionStart);
+    appendStarts(store.maiVertexNormalStart, srcStore.maiVertexNormalStart);
+    appendStarts(store.maiVertexUVStart, srcStore.maiVertexUVStart);
+    appendStarts(store.maiTriangleIndexStart, srcStore.maiTriangleIndexStart);
+
+    store.maVertexPositions.insert(store.maVertexPositions.end(), srcStore.maVertexPositions.begin(), srcStore.maVertexPositions.end());
+    store.maVertexNormals.insert(store.maVertexNormals.end(), srcStore.maVertexNormals.begin(), srcStore.maVertexNormals.end());
+    store.maVertexUVs.insert(store.maVertexUVs.end(), srcStore.maVertexUVs.begin(), srcStore.maVertexUVs.end());
+    store.maiTrianglePositionIndices.insert(store.maiTrianglePositionIndices.end(), srcStore.maiTrianglePositionIndices.begin(), srcStore.maiTrianglePositionIndices.end());
+    store.maiTriangleNormalIndices.insert(store.maiTriangleNormalIndices.end(), srcStore.maiTriangleNormalIndices.begin(), srcStore.maiTriangleNormalIndices.end());
+    store.maiTriangleUVIndices.insert(store.maiTriangleUVIndices.end(), srcStore.maiTriangleUVIndices.begin(), srcStore.maiTriangleUVIndices.end());
+}
+
+/*
+**
+*/
+void appendClusters(
+    ClusterStore& store,
+    std::vector<std::vector<float3>> const& aaClusterVertexPositions,
+    std::vector<std::vector<float3>> const& aaClusterVertexNormals,
+    std::vector<std::vector<float2>> const& aaClusterVertexUVs,
+    std::vector<std::vector<uint32_t>> const& aaiClusterTrianglePositionIndices,
+    std::vector<std::vector<uint32_t>> const& aaiClusterTriangleNormalIndices,
+    std::vector<std::vector<uint32_t>> const& aaiClusterTriangleUVIndices)
+{
+    uint32_t iNumClusters = static_cast<uint32_t>(aaClusterVertexPositions.size());
+    uint32_t iNumVertices = 0, iNumTriangleIndices = 0;
+    for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
+    {
+        iNumVertices += static_cast<uint32_t>(aaClusterVertexPositions[iCluster].size());
+        iNumTriangleIndices += static_cast<uint32_t>(aaiClusterTrianglePositionIndices[iCluster].size());
+    }
+    reserveClusterStore(
+        store,
+        getNumClusters(store) + iNumClusters,
+        static_cast<uint32_t>(store.maVertexPositions.size()) + iNumVertices,
+        static_cast<uint32_t>(store.maiTrianglePositionIndices.size()) + iNumTriangleIndices);
+
+    for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
+    {
+        appendCluster(
+            store,
+            aaClusterVertexPositions[iCluster],
+            aaClusterVertexNormals[iCluster],
+            aaClusterVertexUVs[iCluster],
+            aaiClusterTrianglePositionIndices[iCluster],
+            aaiClusterTriangleNormalIndices[iCluster],
+            aaiClusterTriangleUVIndices[iCluster]);
+    }
+}
+
+/*
+**
+*/
+uint32_t removeEmptyClusters(ClusterStore& store)
+{
+    uint32_t iNumClusters = getNumClusters(store);
+
+    // compact in place, the write position never passes the read position
+    uint32_t iNumKept = 0;
+    uint32_t iPositionWrite = 0, iNormalWrite = 0, iUVWrite = 0, iIndexWrite = 0;
+    for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
+    {
+        uint32_t iPositionStart = store.maiVertexPositionStart[iCluster], iPositionEnd = store.maiVertexPositionStart[iCluster + 1];
+        uint32_t iNormalStart = store.maiVertexNormalStart[iCluster], iNormalEnd = store.maiVertexNormalStart[iCluster + 1];
+        uint32_t iUVStart = store.maiVertexUVStart[iCluster], iUVEnd = store.maiVertexUVStart[iCluster + 1];
+        uint32_t iIndexStart = store.maiTriangleIndexStart[iCluster], iIndexEnd = store.maiTriangleIndexStart[iCluster + 1];
+        if(iPositionEnd == iPositionStart)
+        {
+            continue;
+        }
+
+        std::copy(store.maVertexPositions.begin() + iPositionStart, store.maVertexPositions.begin() + iPositionEnd, store.maVertexPositions.begin() + iPositionWrite);
+        std::copy(store.maVertexNormals.begin() + iNormalStart, store.maVertexNormals.begin() + iNormalEnd, store.maVertexNormals.begin() + iNormalWrite);
+        std::copy(store.maVertexUVs.begin() + iUVStart, store.maVertexUVs.begin() + iUVEnd, store.maVertexUVs.begin() + iUVWrite);
+        std::copy(store.maiTrianglePositionIndices.begin() + iIndexStart, store.maiTrianglePositionIndices.begin() + iIndexEnd, store.maiTrianglePositionIndices.begin() + iIndexWrite);
+        std::copy(store.maiTriangleNormalIndices.begin() + iIndexStart, store.maiTriangleNormalIndices.begin() + iIndexEnd, store.maiTriangleNormalIndices.begin() + iIndexWrite);
+        std::copy(store.maiTriangleUVIndices.begin() + iIndexStart, store.maiTriangleUVIndices.begin() + iIndexEnd, store.maiTriangleUVIndices.begin() + iIndexWrite);
+
+        // starts of the kept cluster are written after its source range has been read
+        store.maiVertexPositionStart[iNumKept] = iPositionWrite;
+        store.maiVertexNormalStart[iNumKept] = iNormalWrite;
+        store.maiVertexUVStart[iNumKept] = iUVWrite;
+        store.maiTriangleIndexStart[iNumKept] = iIndexWrite;
+
+        iPositionWrite += iPositionEnd - iPositionStart;
+        iNormalWrite += iNormalEnd - iNormalStart;
+        iUVWrite += iUVEnd - iUVStart;
+        iIndexWrite += iIndexEnd - iIndexStart;
+        ++iNumKept;
+    }
+
+    if(iNumKept == iNumClusters)
+    {
+        return 0;
+    }
+
+    store.maVertexPositions.resize(iPositionWrite);
+    store.maVertexNormals.resize(iNormalWrite);
+    store.maVertexUVs.resize(iUVWrite);
+    store.maiTrianglePositionIndices.resize(iIndexWrite);
+    store.maiTriangleNormalIndices.resize(iIndexWrite);
+    store.maiTriangleUVIndices.resize(iIndexWrite);
+
+    store.maiVertexPositionStart.resize(iNumKept + 1);
+    store.maiVertexNormalStart.resize(iNumKept + 1);
+    store.maiVertexUVStart.resize(iNumKept + 1);
+    store.maiTriangleIndexStart.resize(iNumKept + 1);
+    store.maiVertexPositionStart[iNumKept] = iPositionWrite;
+    store.maiVertexNormalStart[iNumKept] = iNormalWrite;
+    store.maiVertexUVStart[iNumKept] = iUVWrite;
+    store.maiTriangleIndexStart[iNumKept] = iIndexWrite;
+
+    return iNumClusters - iNumKept;
+}
+
+/*
+**
+*/
+uint32_t removeDegenerateClusterTriangles(
+    ClusterStore& store,
+    float fMinEdgeLength)
+{
+    uint32_t iNumClusters = getNumClusters(store);
+
+    // triangles with repeated position indices or an edge shorter than the min length are dropped, vertices are kept
+    uint32_t iNumRemoved = 0;
+    uint32_t iIndexWrite = 0;
+    for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
+    {
+        float3 const* aVertexPositions = store.maVertexPositions.data() + store.maiVertexPositionStart[iCluster];
+        uint32_t iIndexStart = store.maiTriangleIndexStart[iCluster];
+        uint32_t iIndexEnd = store.maiTriangleIndexStart[iCluster + 1];
+        store.maiTriangleIndexStart[iCluster] = iIndexWrite;
+        for(uint32_t iTri = iIndexStart; iTri < iIndexEnd; iTri += 3)
+        {
+            uint32_t iPos0 = store.maiTrianglePositionIndices[iTri];
+            uint32_t iPos1 = store.maiTrianglePositionIndices[iTri + 1];
+            uint32_t iPos2 = store.maiTrianglePositionIndices[iTri + 2];
+            if(iPos0 == iPos1 || iPos0 == iPos2 || iPos1 == iPos2 ||
+               length(aVertexPositions[iPos1] - aVertexPositions[iPos0]) < fMinEdgeLength ||
+               length(aVertexPositions[iPos2] - aVertexPositions[iPos0]) < fMinEdgeLength ||
+               length(aVertexPositions[iPos1] - aVertexPositions[iPos2]) < fMinEdgeLength)
+            {
+                ++iNumRemoved;
+                continue;
+            }
+
+            for(uint32_t j = 0; j < 3; j++)
+            {
+                store.maiTrianglePositionIndices[iIndexWrite + j] = store.maiTrianglePositionIndices[iTri + j];
+                store.maiTriangleNormalIndices[iIndexWrite + j] = store.maiTriangleNormalIndices[iTri + j];
+                store.maiTriangleUVIndices[iIndexWrite + j] = store.maiTriangleUVIndices[iTri + j];
+            }
+            iIndexWrite += 3;
+        }
+    }
+
+    if(iNumClusters > 0)
+    {
+        store.maiTriangleIndexStart[iNumClusters] = iIndexWrite;
+        store.maiTrianglePositionIndices.resize(iIndexWrite);
+        store.maiTriangleNormalIndices.resize(iIndexWrite);
+        store.maiTriangleUVIndices.resize(iIndexWrite);
+    }
+
+    return iNumRemoved;
+}
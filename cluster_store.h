@@ -0,0 +1,112 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "vec.h"
+
+// read-only run of one cluster's elements inside a ClusterStore pool
+template<typename T>
+struct ClusterArrayView
+{
+    T const*        mpData = nullptr;
+    uint32_t        miSize = 0;
+
+    T const* data() const { return mpData; }
+    uint32_t size() const { return miSize; }
+    bool empty() const { return miSize == 0; }
+    T const* begin() const { return mpData; }
+    T const* end() const { return mpData + miSize; }
+    T const& operator [] (uint32_t iIndex) const { return mpData[iIndex]; }
+};
+
+/*
+**
+*/
+template<typename T>
+inline ClusterArrayView<T> getArrayView(std::vector<T> const& a)
+{
+    return ClusterArrayView<T>{ a.data(), static_cast<uint32_t>(a.size()) };
+}
+
+struct ClusterView
+{
+    ClusterArrayView<float3>        mVertexPositions;
+    ClusterArrayView<float3>        mVertexNormals;
+    ClusterArrayView<float2>        mVertexUVs;
+    ClusterArrayView<uint32_t>      maiTrianglePositionIndices;
+    ClusterArrayView<uint32_t>      maiTriangleNormalIndices;
+    ClusterArrayView<uint32_t>      maiTriangleUVIndices;
+};
+
+// clusters of one LOD level, one contiguous pool per attribute
+//      cluster i owns [start[i], start[i + 1]) of each pool, triangle indices are local to the cluster
+//      the three index streams have the same length per cluster and share maiTriangleIndexStart
+//      move-only, pass it by reference and use getClusterView() to read a cluster
+struct ClusterStore
+{
+    std::vector<float3>             maVertexPositions;
+    std::vector<float3>             maVertexNormals;
+    std::vector<float2>             maVertexUVs;
+    std::vector<uint32_t>           maiTrianglePositionIndices;
+    std::vector<uint32_t>           maiTriangleNormalIndices;
+    std::vector<uint32_t>           maiTriangleUVIndices;
+
+    std::vector<uint32_t>           maiVertexPositionStart;
+    std::vector<uint32_t>           maiVertexNormalStart;
+    std::vector<uint32_t>           maiVertexUVStart;
+    std::vector<uint32_t>           maiTriangleIndexStart;
+
+    ClusterStore() = default;
+    ClusterStore(ClusterStore const&) = delete;
+    ClusterStore& operator = (ClusterStore const&) = delete;
+    ClusterStore(ClusterStore&&) = default;
+    ClusterStore& operator = (ClusterStore&&) = default;
+};
+
+uint32_t getNumClusters(ClusterStore const& store);
+
+ClusterView getClusterView(
+    ClusterStore const& store,
+    uint32_t iCluster);
+
+void reserveClusterStore(
+    ClusterStore& store,
+    uint32_t iNumClusters,
+    uint32_t iNumVertices,
+    uint32_t iNumTriangleIndices);
+
+void clearClusterStore(ClusterStore& store);
+
+void appendCluster(
+    ClusterStore& store,
+    std::vector<float3> const& aVertexPositions,
+    std::vector<float3> const& aVertexNormals,
+    std::vector<float2> const& aVertexUVs,
+    std::vector<uint32_t> const& aiTrianglePositionIndices,
+    std::vector<uint32_t> const& aiTriangleNormalIndices,
+    std::vector<uint32_t> const& aiTriangleUVIndices);
+
+void appendCluster(
+    ClusterStore& store,
+    ClusterView const& cluster);
+
+void appendClusters(
+    ClusterStore& store,
+    ClusterStore const& srcStore);
+
+void appendClusters(
+    ClusterStore& store,
+    std::vector<std::vector<float3>> const& aaClusterVertexPositions,
+    std::vector<std::vector<float3>> const& aaClusterVertexNormals,
+    std::vector<std::vector<float2>> const& aaClusterVertexUVs,
+    std::vector<std::vector<uint32_t>> const& aaiClusterTrianglePositionIndices,
+    std::vector<std::vector<uint32_t>> const& aaiClusterTriangleNormalIndices,
+    std::vector<std::vector<uint32_t>> const& aaiClusterTriangleUVIndices);
+
+uint32_t removeEmptyClusters(ClusterStore& store);
+
+uint32_t removeDegenerateClusterTriangles(
+    ClusterStore& store,
+    float fMinEdgeLength);
@@ -125,6 +125,23 @@ void createTreeNodes2(
         iCurrTotalClusters += static_cast<uint32_t>(aaMeshClusterGroups[iLOD].size());
     }
 
+    // cluster index to cluster, the first LOD with the index wins
+    std::vector<MeshCluster const*> apClustersByIndex;
+    for(uint32_t i = 0; i < static_cast<uint32_t>(aaMeshClusters.size()); i++)
+    {
+        for(auto const& meshCluster : aaMeshClusters[i])
+        {
+            if(meshCluster.miIndex >= static_cast<uint32_t>(apClustersByIndex.size()))
+            {
+                apClustersByIndex.resize(meshCluster.miIndex + 1, nullptr);
+            }
+            if(apClustersByIndex[meshCluster.miIndex] == nullptr)
+            {
+                apClustersByIndex[meshCluster.miIndex] = &meshCluster;
+            }
+        }
+    }
+
     uint32_t iCurrLevel = iNumLODLevels;
     for(int32_t iLODLevel = static_cast<int32_t>(iNumLODLevels - 1); iLODLevel >= 0; iLODLevel--)
     {
@@ -185,23 +202,13 @@ void createTreeNodes2(
                     float4 normalCone = float4(0.0f, 0.0f, 0.0f, 0.0f);
                     float3 minBounds = float3(0.0f, 0.0f, 0.0f);
                     float3 maxBounds = float3(0.0f, 0.0f, 0.0f);
-                    for(uint32_t i = 0; i < static_cast<uint32_t>(aaMeshClusters.size()); i++)
+                    MeshCluster const* pMeshCluster = (iClusterID < static_cast<uint32_t>(apClustersByIndex.size())) ? apClustersByIndex[iClusterID] : nullptr;
+                    if(pMeshCluster != nullptr)
                     {
-                        auto iter = std::find_if(
-                            aaMeshClusters[i].begin(),
-                            aaMeshClusters[i].end(),
-                            [iClusterID](MeshCluster const& checkMeshCluster)
-                            {
-                                return checkMeshCluster.miIndex == iClusterID;
-                            });
-                        if(iter != aaMeshClusters[i].end())
-                        {
-                            fAverageDistanceFromLOD0 = iter->mfAverageDistanceFromLOD0;
-                            normalCone = iter->mNormalCone;
-                            minBounds = iter->mMaxBounds;
-                            maxBounds = iter->mMinBounds;
-                            break;
-                        }
+                        fAverageDistanceFromLOD0 = pMeshCluster->mfAverageDistanceFromLOD0;
+                        normalCone = pMeshCluster->mNormalCone;
+                        minBounds = pMeshCluster->mMinBounds;
+                        maxBounds = pMeshCluster->mMaxBounds;
                     }
                     assert(fAverageDistanceFromLOD0 != FLT_MAX);
                     node.mfAverageDistanceFromLOD0 = fAverageDistanceFromLOD0;
@@ -220,63 +227,129 @@ void createTreeNodes2(
 
     }   // for LOD = num lod levels to 0
 
-    // set parents
+    // cluster address to the first node created for it
     uint32_t iNumNodes = static_cast<uint32_t>(aNodes.size());
+    uint32_t iNumClusterAddresses = 0;
+    for(auto const& node : aNodes)
+    {
+        iNumClusterAddresses = std::max(iNumClusterAddresses, node.miClusterAddress + 1);
+    }
+    std::vector<uint32_t> aiClusterNodes(iNumClusterAddresses, UINT32_MAX);
+    for(uint32_t i = 0; i < iNumNodes; i++)
+    {
+        if(aiClusterNodes[aNodes[i].miClusterAddress] == UINT32_MAX)
+        {
+            aiClusterNodes[aNodes[i].miClusterAddress] = i;
+        }
+    }
+
+    // set parents
     for(uint32_t i = 0; i < iNumNodes; i++)
     {
         auto& node = aNodes[i];
         for(uint32_t j = 0; j < node.miNumChildren; j++)
         {
             uint32_t iChildAddress = node.maiChildrenAddress[j];
-            auto childIter = std::find_if(
-                aNodes.begin(),
-                aNodes.end(),
-                [iChildAddress](ClusterTreeNode const& checkNode)
-                {
-                    return checkNode.miClusterAddress == iChildAddress;
-                }
-            );
-            assert(childIter != aNodes.end());
+            assert(iChildAddress < iNumClusterAddresses && aiClusterNodes[iChildAddress] != UINT32_MAX);
+            if(iChildAddress >= iNumClusterAddresses || aiClusterNodes[iChildAddress] == UINT32_MAX)
+            {
+                continue;
+            }
 
-            //assert(childIter->miNumParents < MAX_CLUSTER_TREE_NODE_PARENTS);
-            if(childIter->miNumParents < MAX_CLUSTER_TREE_NODE_PARENTS)
+            auto& childNode = aNodes[aiClusterNodes[iChildAddress]];
+
+            //assert(childNode.miNumParents < MAX_CLUSTER_TREE_NODE_PARENTS);
+            if(childNode.miNumParents < MAX_CLUSTER_TREE_NODE_PARENTS)
             {
-                childIter->maiParentAddress[childIter->miNumParents] = node.miClusterAddress;
-                ++childIter->miNumParents;
+                childNode.maiParentAddress[childNode.miNumParents] = node.miClusterAddress;
+                ++childNode.miNumParents;
             }
         }
     }
 
-    std::sort(
-        aNodes.begin(),
-        aNodes.end(),
-        [](ClusterTreeNode const& nodeLeft, ClusterTreeNode const& nodeRight)
+    // order by cluster address, counting sort keeps nodes of the same address in creation order
+    {
+        std::vector<uint32_t> aiAddressStart(iNumClusterAddresses + 1, 0);
+        for(auto const& node : aNodes)
+        {
+            ++aiAddressStart[node.miClusterAddress + 1];
+        }
+        for(uint32_t i = 0; i < iNumClusterAddresses; i++)
+        {
+            aiAddressStart[i + 1] += aiAddressStart[i];
+        }
+
+        std::vector<ClusterTreeNode> aSortedNodes(iNumNodes);
+        for(auto const& node : aNodes)
         {
-            return nodeLeft.miClusterAddress < nodeRight.miClusterAddress;
+            aSortedNodes[aiAddressStart[node.miClusterAddress]++] = node;
         }
-    );
+        aNodes.swap(aSortedNodes);
+    }
 
     // make sure the average distance error of LOD n is smaller than LOD n + 1
     std::vector<float> afMaxAverageErrorDistanceLOD(iNumLODLevels + 1);
-    for(uint32_t iLODLevel = 0; iLODLevel < iNumLODLevels + 1; iLODLevel++)
+    for(auto const& node : aNodes)
     {
-        for(auto const& node : aNodes)
+        if(node.miLevel < iNumLODLevels + 1)
         {
-            if(node.miLevel == iLODLevel)
-            {
-                afMaxAverageErrorDistanceLOD[iLODLevel] = maxf(afMaxAverageErrorDistanceLOD[iLODLevel], node.mfAverageDistanceFromLOD0);
-            }
+            afMaxAverageErrorDistanceLOD[node.miLevel] = maxf(afMaxAverageErrorDistanceLOD[node.miLevel], node.mfAverageDistanceFromLOD0);
         }
     }
 
-    for(uint32_t iLODLevel = 1; iLODLevel < iNumLODLevels + 1; iLODLevel++)
+    for(auto& node : aNodes)
     {
-        for(auto& node : aNodes)
+        if(node.miLevel >= 1 && node.miLevel < iNumLODLevels + 1 && node.mfAverageDistanceFromLOD0 < afMaxAverageErrorDistanceLOD[node.miLevel - 1])
         {
-            if(node.miLevel == iLODLevel && node.mfAverageDistanceFromLOD0 < afMaxAverageErrorDistanceLOD[iLODLevel - 1])
-            {
-                node.mfAverageDistanceFromLOD0 = afMaxAverageErrorDistanceLOD[iLODLevel - 1];
-            }
+            node.mfAverageDistanceFromLOD0 = afMaxAverageErrorDistanceLOD[node.miLevel - 1];
+        }
+    }
+}
+
+/*
+**  one group node per (cluster group address, level) of the cluster nodes, in cluster group address order
+*/
+void createClusterGroupTreeNodes(
+    std::vector<ClusterGroupTreeNode>& aClusterGroupNodes,
+    std::vector<ClusterTreeNode> const& aClusterNodes)
+{
+    uint32_t iNumClusterGroupAddresses = 0;
+    uint32_t iNumLevels = 0;
+    for(auto const& node : aClusterNodes)
+    {
+        iNumClusterGroupAddresses = std::max(iNumClusterGroupAddresses, node.miClusterGroupAddress + 1);
+        iNumLevels = std::max(iNumLevels, node.miLevel + 1);
+    }
+
+    // (cluster group address, level) to group node, filled in cluster node order
+    std::vector<uint32_t> aiGroupNodes(static_cast<size_t>(iNumClusterGroupAddresses) * iNumLevels, UINT32_MAX);
+    std::vector<ClusterGroupTreeNode> aGroupNodes;
+    for(auto const& node : aClusterNodes)
+    {
+        uint32_t& iGroupNode = aiGroupNodes[static_cast<size_t>(node.miClusterGroupAddress) * iNumLevels + node.miLevel];
+        if(iGroupNode == UINT32_MAX)
+        {
+            iGroupNode = static_cast<uint32_t>(aGroupNodes.size());
+            ClusterGroupTreeNode groupNode;
+            groupNode.miClusterGroupAddress = node.miClusterGroupAddress;
+            groupNode.miLevel = node.miLevel;
+            aGroupNodes.push_back(groupNode);
+        }
+
+        ClusterGroupTreeNode& groupNode = aGroupNodes[iGroupNode];
+        assert(groupNode.miNumChildClusters < MAX_CLUSTER_TREE_NODE_CHILDREN);
+        groupNode.maiClusterAddress[groupNode.miNumChildClusters] = node.miClusterAddress;
+        ++groupNode.miNumChildClusters;
+    }
+
+    // walking the table in address order sorts the group nodes, lower levels first within an address
+    aClusterGroupNodes.clear();
+    aClusterGroupNodes.reserve(aGroupNodes.size());
+    for(uint32_t iGroupNode : aiGroupNodes)
+    {
+        if(iGroupNode != UINT32_MAX)
+        {
+            aClusterGroupNodes.push_back(aGroupNodes[iGroupNode]);
         }
     }
 }
@@ -79,6 +79,10 @@ void createTreeNodes2(
     std::vector<std::vector<MeshCluster>> const& aaMeshClusters,
     std::vector<std::pair<float3, float3>> const& aTotalMaxClusterDistancePositionFromLOD0);
 
+void createClusterGroupTreeNodes(
+    std::vector<ClusterGroupTreeNode>& aClusterGroupNodes,
+    std::vector<ClusterTreeNode> const& aClusterNodes);
+
 void saveClusterGroupTreeNodes(
     std::string const& outputFilePath,
     std::vector<ClusterGroupTreeNode> const& aClusterGroupNodes);
@@ -0,0 +1,294 @@
+#include "compute_backend.h"
+#include "test_cpu.h"
+#include "LogPrint.h"
+
+#if defined(USE_CUDA)
+#include "test.h"
+#endif // USE_CUDA
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+static ComputeBackend const gCPUComputeBackend =
+{
+    checkClusterGroupBoundaryVerticesCPU,
+    buildClusterAdjacencyCPU,
+    getClusterGroupBoundaryVerticesCPU,
+    computeEdgeCollapseInfoCPU,
+    getShortestVertexDistancesCPU,
+    buildClusterEdgeAdjacencyCPU,
+    buildClusterEdgeAdjacencyCPU2,
+    getSortedEdgeAdjacentClustersCPU,
+    getProjectVertexDistancesCPU,
+    getClusterGroupBoundaryVerticesCPU2,
+};
+
+#if defined(USE_CUDA)
+static ComputeBackend const gCUDAComputeBackend =
+{
+    checkClusterGroupBoundaryVerticesCUDA,
+    buildClusterAdjacencyCUDA,
+    getClusterGroupBoundaryVerticesCUDA,
+    computeEdgeCollapseInfoCUDA,
+    getShortestVertexDistancesCUDA,
+    buildClusterEdgeAdjacencyCUDA,
+    buildClusterEdgeAdjacencyCUDA2,
+    getSortedEdgeAdjacentClustersCUDA,
+    getProjectVertexDistancesCUDA,
+    getClusterGroupBoundaryVerticesCUDA2,
+};
+#endif // USE_CUDA
+
+static ComputeBackendType gComputeBackendType = COMPUTE_BACKEND_CPU;
+static ComputeBackend const* gpComputeBackend = &gCPUComputeBackend;
+
+/*
+**
+*/
+bool isComputeBackendAvailable(ComputeBackendType type)
+{
+    if(type == COMPUTE_BACKEND_CPU)
+    {
+        return true;
+    }
+
+#if defined(USE_CUDA)
+    if(type == COMPUTE_BACKEND_CUDA)
+    {
+        static bool const sbHasDevice = isCUDADeviceAvailable();
+        return sbHasDevice;
+    }
+#endif // USE_CUDA
+
+    return false;
+}
+
+/*
+**
+*/
+ComputeBackendType getDefaultComputeBackendType()
+{
+    // MESH_COMPUTE_BACKEND=cpu or cuda, otherwise cuda when there's a device
+    char const* szBackend = getenv("MESH_COMPUTE_BACKEND");
+    if(szBackend != nullptr && strcmp(szBackend, "cpu") == 0)
+    {
+        return COMPUTE_BACKEND_CPU;
+    }
+
+    if(szBackend != nullptr && strcmp(szBackend, "cuda") == 0 && !isComputeBackendAvailable(COMPUTE_BACKEND_CUDA))
+    {
+        DEBUG_PRINTF("cuda compute backend requested but not available, using cpu\n");
+    }
+
+    return isComputeBackendAvailable(COMPUTE_BACKEND_CUDA) ? COMPUTE_BACKEND_CUDA : COMPUTE_BACKEND_CPU;
+}
+
+/*
+**
+*/
+void setComputeBackend(ComputeBackendType type)
+{
+    if(!isComputeBackendAvailable(type))
+    {
+        DEBUG_PRINTF("compute backend %d not available, using cpu\n", type);
+        type = COMPUTE_BACKEND_CPU;
+    }
+
+    gComputeBackendType = type;
+    gpComputeBackend = &gCPUComputeBackend;
+#if defined(USE_CUDA)
+    if(type == COMPUTE_BACKEND_CUDA)
+    {
+        gpComputeBackend = &gCUDAComputeBackend;
+    }
+#endif // USE_CUDA
+
+    DEBUG_PRINTF("using %s compute backend\n", (type == COMPUTE_BACKEND_CUDA) ? "cuda" : "cpu");
+}
+
+/*
+**
+*/
+ComputeBackendType getComputeBackendType()
+{
+    return gComputeBackendType;
+}
+
+/*
+**
+*/
+ComputeBackend const& getComputeBackend()
+{
+    return *gpComputeBackend;
+}
+
+/*
+**
+*/
+void buildBenchmarkClusters(
+    std::vector<std::vector<vec3>>& aaClusterVertexPositions,
+    std::vector<std::vector<uint32_t>>& aaiClusterTrianglePositionIndices,
+    uint32_t iNumClusters)
+{
+    // wavy height field cut into square tiles of 8 x 8 quads, tiles share the positions along their borders
+    uint32_t const kiTileSize = 8;
+    uint32_t iNumTilesX = static_cast<uint32_t>(ceilf(sqrtf(static_cast<float>(iNumClusters))));
+    aaClusterVertexPositions.resize(iNumClusters);
+    aaiClusterTrianglePositionIndices.resize(iNumClusters);
+    for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
+    {
+        uint32_t iTileX = iCluster % iNumTilesX;
+        uint32_t iTileY = iCluster / iNumTilesX;
+
+        auto& aVertexPositions = aaClusterVertexPositions[iCluster];
+        aVertexPositions.clear();
+        for(uint32_t iY = 0; iY <= kiTileSize; iY++)
+        {
+            for(uint32_t iX = 0; iX <= kiTileSize; iX++)
+            {
+                float fX = static_cast<float>(iTileX * kiTileSize + iX) * 0.1f;
+                float fY = static_cast<float>(iTileY * kiTileSize + iY) * 0.1f;
+                aVertexPositions.push_back(vec3(fX, fY, sinf(fX * 3.0f) * cosf(fY * 2.0f) * 0.2f));
+            }
+        }
+
+        auto& aiTrianglePositionIndices = aaiClusterTrianglePositionIndices[iCluster];
+        aiTrianglePositionIndices.clear();
+        for(uint32_t iY = 0; iY < kiTileSize; iY++)
+        {
+            for(uint32_t iX = 0; iX < kiTileSize; iX++)
+            {
+                uint32_t iV0 = iY * (kiTileSize + 1) + iX;
+                uint32_t iV1 = iV0 + 1;
+                uint32_t iV2 = iV0 + kiTileSize + 1;
+                uint32_t iV3 = iV2 + 1;
+
+                aiTrianglePositionIndices.push_back(iV0);
+                aiTrianglePositionIndices.push_back(iV1);
+                aiTrianglePositionIndices.push_back(iV3);
+
+                aiTrianglePositionIndices.push_back(iV0);
+                aiTrianglePositionIndices.push_back(iV3);
+                aiTrianglePositionIndices.push_back(iV2);
+            }
+        }
+    }
+}
+
+/*
+**
+*/
+void benchmarkComputeBackends(uint32_t iNumClusters)
+{
+    std::vector<std::vector<vec3>> aaClusterVertexPositions;
+    std::vector<std::vector<uint32_t>> aaiClusterTrianglePositionIndices;
+    buildBenchmarkClusters(
+        aaClusterVertexPositions,
+        aaiClusterTrianglePositionIndices,
+        iNumClusters);
+
+    uint32_t iNumTotalVertices = 0;
+    for(auto const& aVertexPositions : aaClusterVertexPositions)
+    {
+        iNumTotalVertices += static_cast<uint32_t>(aVertexPositions.size());
+    }
+
+    // outputs of each backend, compared against the cpu results
+    std::vector<std::vector<uint32_t>> aaaiBoundaryVertices[NUM_COMPUTE_BACKENDS];
+    std::vector<std::vector<uint32_t>> aaaiNumAdjacentVertices[NUM_COMPUTE_BACKENDS];
+    std::vector<std::vector<uint32_t>> aaaiSortedClusters[NUM_COMPUTE_BACKENDS];
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> aaaAdjacentEdgeClusters[NUM_COMPUTE_BACKENDS];
+    std::vector<float> aafClosestDistances[NUM_COMPUTE_BACKENDS];
+    std::vector<uint32_t> aaiClosestVertices[NUM_COMPUTE_BACKENDS];
+
+    DEBUG_PRINTF("compute backend benchmark, %d clusters, %d vertices\n",
+        iNumClusters,
+        iNumTotalVertices);
+
+    ComputeBackendType savedType = getComputeBackendType();
+    for(uint32_t iType = 0; iType < NUM_COMPUTE_BACKENDS; iType++)
+    {
+        ComputeBackendType type = static_cast<ComputeBackendType>(iType);
+        if(!isComputeBackendAvailable(type))
+        {
+            DEBUG_PRINTF("\t%s: not available\n", (type == COMPUTE_BACKEND_CUDA) ? "cuda" : "cpu");
+            continue;
+        }
+
+        setComputeBackend(type);
+        ComputeBackend const& backend = getComputeBackend();
+        char const* szName = (type == COMPUTE_BACKEND_CUDA) ? "cuda" : "cpu";
+
+        auto start = std::chrono::high_resolution_clock::now();
+        backend.mpfnGetClusterGroupBoundaryVertices2(
+            aaaiBoundaryVertices[iType],
+            aaClusterVertexPositions);
+        auto end = std::chrono::high_resolution_clock::now();
+        DEBUG_PRINTF("\t%s getClusterGroupBoundaryVertices2: %lld ms\n", szName, static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()));
+
+        start = std::chrono::high_resolution_clock::now();
+        backend.mpfnBuildClusterAdjacency(
+            aaaiNumAdjacentVertices[iType],
+            aaClusterVertexPositions,
+            true);
+        end = std::chrono::high_resolution_clock::now();
+        DEBUG_PRINTF("\t%s buildClusterAdjacency: %lld ms\n", szName, static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()));
+
+        start = std::chrono::high_resolution_clock::now();
+        backend.mpfnBuildClusterEdgeAdjacency2(
+            aaaAdjacentEdgeClusters[iType],
+            aaClusterVertexPositions,
+            aaiClusterTrianglePositionIndices);
+        end = std::chrono::high_resolution_clock::now();
+        DEBUG_PRINTF("\t%s buildClusterEdgeAdjacency2: %lld ms\n", szName, static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()));
+
+        start = std::chrono::high_resolution_clock::now();
+        backend.mpfnGetSortedEdgeAdjacentClusters(
+            aaaiSortedClusters[iType],
+            aaClusterVertexPositions);
+        end = std::chrono::high_resolution_clock::now();
+        DEBUG_PRINTF("\t%s getSortedEdgeAdjacentClusters: %lld ms\n", szName, static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()));
+
+        // closest vertices of each shifted cluster to its neighboring cluster, same sizes as the simplification error lookups
+        start = std::chrono::high_resolution_clock::now();
+        aafClosestDistances[iType].clear();
+        aaiClosestVertices[iType].clear();
+        std::vector<float> afClusterClosestDistances;
+        std::vector<uint32_t> aiClusterClosestVertices;
+        std::vector<vec3> aShiftedVertexPositions;
+        for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
+        {
+            aShiftedVertexPositions = aaClusterVertexPositions[iCluster];
+            for(auto& position : aShiftedVertexPositions)
+            {
+                position += vec3(0.031f, 0.017f, 0.005f);
+            }
+
+            backend.mpfnGetShortestVertexDistances(
+                afClusterClosestDistances,
+                aiClusterClosestVertices,
+                aShiftedVertexPositions,
+                aaClusterVertexPositions[(iCluster + 1) % iNumClusters]);
+            aafClosestDistances[iType].insert(aafClosestDistances[iType].end(), afClusterClosestDistances.begin(), afClusterClosestDistances.end());
+            aaiClosestVertices[iType].insert(aaiClosestVertices[iType].end(), aiClusterClosestVertices.begin(), aiClusterClosestVertices.end());
+        }
+        end = std::chrono::high_resolution_clock::now();
+        DEBUG_PRINTF("\t%s getShortestVertexDistances: %lld ms\n", szName, static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()));
+
+        if(iType != COMPUTE_BACKEND_CPU)
+        {
+            // same definition of the results on both backends, the sort order of equally distant clusters is backend specific
+            DEBUG_PRINTF("\t%s matches cpu: boundary vertices %d, cluster adjacency %d, edge adjacency %d, closest vertices %d\n",
+                szName,
+                aaaiBoundaryVertices[iType] == aaaiBoundaryVertices[COMPUTE_BACKEND_CPU],
+                aaaiNumAdjacentVertices[iType] == aaaiNumAdjacentVertices[COMPUTE_BACKEND_CPU],
+                aaaAdjacentEdgeClusters[iType] == aaaAdjacentEdgeClusters[COMPUTE_BACKEND_CPU],
+                aaiClosestVertices[iType] == aaiClosestVertices[COMPUTE_BACKEND_CPU]);
+        }
+
+    }   // for type = 0 to num compute backends
+
+    setComputeBackend(savedType);
+}
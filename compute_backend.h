@@ -0,0 +1,85 @@
+#pragma once
+
+#include <vector>
+
+#include "vec.h"
+
+enum ComputeBackendType
+{
+    COMPUTE_BACKEND_CPU = 0,
+    COMPUTE_BACKEND_CUDA,
+
+    NUM_COMPUTE_BACKENDS,
+};
+
+// entry points of test.h, filled with the cpu or cuda versions by setComputeBackend()
+//      cuda versions are only available when built with USE_CUDA and a device is present
+struct ComputeBackend
+{
+    void (*mpfnCheckClusterGroupBoundaryVertices)(
+        std::vector<std::vector<uint32_t>>& aaiClusterGroupBoundaryVertices,
+        std::vector<std::vector<vec3>> const& aaClusterGroupVertexPositions,
+        std::vector<std::vector<uint32_t>> const& aaiClusterGroupTrianglePositionIndices);
+
+    void (*mpfnBuildClusterAdjacency)(
+        std::vector<std::vector<uint32_t>>& aaiNumAdjacentVertices,
+        std::vector<std::vector<vec3>> const& aaVertexPositions,
+        bool bOnlyEdgeAdjacent);
+
+    void (*mpfnGetClusterGroupBoundaryVertices)(
+        std::vector<std::vector<uint32_t>>& aaiClusterGroupBoundaryVertices,
+        std::vector<std::vector<vec3>> const& aaClusterGroupVertexPositions);
+
+    void (*mpfnComputeEdgeCollapseInfo)(
+        std::vector<float>& afCollapseCosts,
+        std::vector<vec3>& aOptimalVertexPositions,
+        std::vector<vec3>& aOptimalVertexNormals,
+        std::vector<vec2>& aOptimalVertexUVs,
+        std::vector<std::pair<uint32_t, uint32_t>>& aEdges,
+        std::vector<vec3> const& aClusterGroupVertexPositions,
+        std::vector<vec3> const& aClusterGroupVertexNormals,
+        std::vector<vec2> const& aClusterGroupVertexUVs,
+        std::vector<std::pair<uint32_t, uint32_t>> const& aiValidClusterGroupEdgePairs,
+        std::vector<uint32_t> const& aiClusterGroupNonBoundaryVertices,
+        std::vector<uint32_t> const& aiClusterGroupTrianglePositionIndices,
+        std::vector<uint32_t> const& aiClusterGroupTriangleNormalIndices,
+        std::vector<uint32_t> const& aiClusterGroupTriangleUVIndices);
+
+    void (*mpfnGetShortestVertexDistances)(
+        std::vector<float>& afClosestDistances,
+        std::vector<uint32_t>& aiClosestVertexPositionIndices,
+        std::vector<vec3> const& aVertexPositions0,
+        std::vector<vec3> const& aVertexPositions1);
+
+    void (*mpfnBuildClusterEdgeAdjacency)(
+        std::vector<std::vector<uint32_t>>& aaiAdjacentEdgeClusters,
+        std::vector<std::vector<vec3>> const& aaVertexPositions,
+        std::vector<std::vector<uint32_t>> const& aaiVertexPositionIndices);
+
+    void (*mpfnBuildClusterEdgeAdjacency2)(
+        std::vector<std::vector<std::pair<uint32_t, uint32_t>>>& aaiAdjacentEdgeClusters,
+        std::vector<std::vector<vec3>> const& aaVertexPositions,
+        std::vector<std::vector<uint32_t>> const& aaiVertexPositionIndices);
+
+    void (*mpfnGetSortedEdgeAdjacentClusters)(
+        std::vector<std::vector<uint32_t>>& aaiSortedAdjacentEdgeClusters,
+        std::vector<std::vector<vec3>> const& aaVertexPositions);
+
+    void (*mpfnGetProjectVertexDistances)(
+        std::vector<vec3>& aProjectedPositions,
+        std::vector<vec3> const& aTriangleVertexPositions0,
+        std::vector<vec3> const& aTriangleVertexPositions1);
+
+    void (*mpfnGetClusterGroupBoundaryVertices2)(
+        std::vector<std::vector<uint32_t>>& aaiClusterGroupBoundaryVertices,
+        std::vector<std::vector<vec3>> const& aaClusterGroupVertexPositions);
+};
+
+bool isComputeBackendAvailable(ComputeBackendType type);
+ComputeBackendType getDefaultComputeBackendType();
+
+void setComputeBackend(ComputeBackendType type);
+ComputeBackendType getComputeBackendType();
+ComputeBackend const& getComputeBackend();
+
+void benchmarkComputeBackends(uint32_t iNumClusters);
@@ -0,0 +1,264 @@
+#include "connectivity_operations.h"
+
+#include <algorithm>
+#include <cassert>
+
+/*
+**
+*/
+inline uint64_t getConnectivityEdgeKey(uint32_t iPos0, uint32_t iPos1)
+{
+    uint32_t iMin = std::min(iPos0, iPos1);
+    uint32_t iMax = std::max(iPos0, iPos1);
+    return (static_cast<uint64_t>(iMin) << 32) | static_cast<uint64_t>(iMax);
+}
+
+/*
+**
+*/
+void buildMeshConnectivity(
+    MeshConnectivity& connectivity,
+    std::vector<uint32_t> const& aiTrianglePositionIndices,
+    uint32_t iNumVertices)
+{
+    buildMeshConnectivity(
+        connectivity,
+        aiTrianglePositionIndices.data(),
+        static_cast<uint32_t>(aiTrianglePositionIndices.size()),
+        iNumVertices);
+}
+
+/*
+**
+*/
+void buildMeshConnectivity(
+    MeshConnectivity& connectivity,
+    uint32_t const* paiTrianglePositionIndices,
+    uint32_t iNumTrianglePositionIndices,
+    uint32_t iNumVertices)
+{
+    uint32_t iNumTriangles = iNumTrianglePositionIndices / 3;
+
+    // vertex -> corner rings, corners are added in triangle order
+    connectivity.maiVertexRingStart.assign(iNumVertices, 0);
+    connectivity.maiVertexRingCount.assign(iNumVertices, 0);
+    for(uint32_t iCorner = 0; iCorner < iNumTriangles * 3; iCorner++)
+    {
+        assert(paiTrianglePositionIndices[iCorner] < iNumVertices);
+        ++connectivity.maiVertexRingCount[paiTrianglePositionIndices[iCorner]];
+    }
+
+    uint32_t iStart = 0;
+    for(uint32_t iVertex = 0; iVertex < iNumVertices; iVertex++)
+    {
+        connectivity.maiVertexRingStart[iVertex] = iStart;
+        iStart += connectivity.maiVertexRingCount[iVertex];
+    }
+
+    std::vector<uint32_t> aiVertexFill(iNumVertices, 0);
+    connectivity.maiCorners.resize(iNumTriangles * 3);
+    for(uint32_t iCorner = 0; iCorner < iNumTriangles * 3; iCorner++)
+    {
+        uint32_t iVertex = paiTrianglePositionIndices[iCorner];
+        connectivity.maiCorners[connectivity.maiVertexRingStart[iVertex] + aiVertexFill[iVertex]] = iCorner;
+        ++aiVertexFill[iVertex];
+    }
+
+    connectivity.maiTriangleAlive.assign(iNumTriangles, 1);
+    connectivity.miNumAliveTriangles = iNumTriangles;
+
+    // unique edges with the number of triangles sharing them
+    connectivity.maEdges.clear();
+    connectivity.maiEdgeTriangleCounts.clear();
+    connectivity.maEdgeIndices.clear();
+    connectivity.maEdgeIndices.reserve(iNumTriangles * 2);
+    for(uint32_t iTri = 0; iTri < iNumTriangles; iTri++)
+    {
+        uint32_t const* paiTri = paiTrianglePositionIndices + iTri * 3;
+        uint32_t const aiEdgePos0[3] = { paiTri[0], paiTri[0], paiTri[1] };
+        uint32_t const aiEdgePos1[3] = { paiTri[1], paiTri[2], paiTri[2] };
+        for(uint32_t iEdge = 0; iEdge < 3; iEdge++)
+        {
+            if(aiEdgePos0[iEdge] == aiEdgePos1[iEdge])
+            {
+                continue;
+            }
+
+            uint64_t iKey = getConnectivityEdgeKey(aiEdgePos0[iEdge], aiEdgePos1[iEdge]);
+            auto iter = connectivity.maEdgeIndices.find(iKey);
+            if(iter == connectivity.maEdgeIndices.end())
+            {
+                connectivity.maEdgeIndices[iKey] = static_cast<uint32_t>(connectivity.maEdges.size());
+                connectivity.maEdges.push_back(std::make_pair(
+                    std::min(aiEdgePos0[iEdge], aiEdgePos1[iEdge]),
+                    std::max(aiEdgePos0[iEdge], aiEdgePos1[iEdge])));
+                connectivity.maiEdgeTriangleCounts.push_back(1);
+            }
+            else
+            {
+                ++connectivity.maiEdgeTriangleCounts[iter->second];
+            }
+
+        }   // for edge = 0 to 3
+
+    }   // for tri = 0 to num triangles
+}
+
+/*
+**
+*/
+uint32_t getConnectivityEdge(
+    MeshConnectivity const& connectivity,
+    uint32_t iPos0,
+    uint32_t iPos1)
+{
+    auto iter = connectivity.maEdgeIndices.find(getConnectivityEdgeKey(iPos0, iPos1));
+    return (iter == connectivity.maEdgeIndices.end()) ? UINT32_MAX : iter->second;
+}
+
+/*
+**
+*/
+uint32_t getConnectivityEdgeTriangleCount(
+    MeshConnectivity const& connectivity,
+    uint32_t iPos0,
+    uint32_t iPos1)
+{
+    uint32_t iEdge = getConnectivityEdge(connectivity, iPos0, iPos1);
+    return (iEdge == UINT32_MAX) ? 0 : connectivity.maiEdgeTriangleCounts[iEdge];
+}
+
+/*
+**
+*/
+uint32_t findConnectivityEdgeTriangle(
+    MeshConnectivity const& connectivity,
+    std::vector<uint32_t> const& aiTrianglePositionIndices,
+    uint32_t iPos0,
+    uint32_t iPos1)
+{
+    uint32_t iStart = connectivity.maiVertexRingStart[iPos0];
+    uint32_t iEnd = iStart + connectivity.maiVertexRingCount[iPos0];
+    for(uint32_t i = iStart; i < iEnd; i++)
+    {
+        uint32_t iTri = connectivity.maiCorners[i] / 3;
+        if(connectivity.maiTriangleAlive[iTri] == 0)
+        {
+            continue;
+        }
+
+        if(aiTrianglePositionIndices[iTri * 3] == iPos1 ||
+            aiTrianglePositionIndices[iTri * 3 + 1] == iPos1 ||
+            aiTrianglePositionIndices[iTri * 3 + 2] == iPos1)
+        {
+            return iTri;
+        }
+    }
+
+    return UINT32_MAX;
+}
+
+/*
+**
+*/
+uint32_t contractConnectivityEdge(
+    MeshConnectivity& connectivity,
+    std::vector<uint32_t>& aiTrianglePositionIndices,
+    uint32_t iPos0,
+    uint32_t iPos1,
+    uint32_t iNewPos)
+{
+    if(iNewPos >= static_cast<uint32_t>(connectivity.maiVertexRingStart.size()))
+    {
+        connectivity.maiVertexRingStart.resize(iNewPos + 1, 0);
+        connectivity.maiVertexRingCount.resize(iNewPos + 1, 0);
+    }
+
+    // ring of the new vertex is the surviving corners of both contracted vertices, appended at the end of the corner list
+    uint32_t iNumRemoved = 0;
+    uint32_t iNewRingStart = static_cast<uint32_t>(connectivity.maiCorners.size());
+    uint32_t const aiContractedVertices[2] = { iPos0, iPos1 };
+    for(uint32_t iEdgeVertex = 0; iEdgeVertex < 2; iEdgeVertex++)
+    {
+        uint32_t iVertex = aiContractedVertices[iEdgeVertex];
+        uint32_t iStart = connectivity.maiVertexRingStart[iVertex];
+        uint32_t iEnd = iStart + connectivity.maiVertexRingCount[iVertex];
+        for(uint32_t i = iStart; i < iEnd; i++)
+        {
+            uint32_t iCorner = connectivity.maiCorners[i];
+            uint32_t iTri = iCorner / 3;
+            if(connectivity.maiTriangleAlive[iTri] == 0)
+            {
+                continue;
+            }
+
+            // triangle containing the edge collapses
+            uint32_t iNumMatches = 0;
+            for(uint32_t j = 0; j < 3; j++)
+            {
+                uint32_t iTriPos = aiTrianglePositionIndices[iTri * 3 + j];
+                if(iTriPos == iPos0 || iTriPos == iPos1)
+                {
+                    ++iNumMatches;
+                }
+            }
+
+            if(iNumMatches >= 2)
+            {
+                connectivity.maiTriangleAlive[iTri] = 0;
+                --connectivity.miNumAliveTriangles;
+                ++iNumRemoved;
+                continue;
+            }
+
+            aiTrianglePositionIndices[iCorner] = iNewPos;
+            connectivity.maiCorners.push_back(iCorner);
+        }
+
+        connectivity.maiVertexRingCount[iVertex] = 0;
+
+    }   // for edge vertex = 0 to 2
+
+    connectivity.maiVertexRingStart[iNewPos] = iNewRingStart;
+    connectivity.maiVertexRingCount[iNewPos] = static_cast<uint32_t>(connectivity.maiCorners.size()) - iNewRingStart;
+
+    return iNumRemoved;
+}
+
+/*
+**
+*/
+void compactConnectivityTriangles(
+    MeshConnectivity& connectivity,
+    std::vector<uint32_t>& aiTrianglePositionIndices,
+    std::vector<uint32_t>& aiTriangleNormalIndices,
+    std::vector<uint32_t>& aiTriangleUVIndices)
+{
+    uint32_t iNumTriangles = static_cast<uint32_t>(connectivity.maiTriangleAlive.size());
+    uint32_t iDest = 0;
+    for(uint32_t iTri = 0; iTri < iNumTriangles; iTri++)
+    {
+        if(connectivity.maiTriangleAlive[iTri] == 0)
+        {
+            continue;
+        }
+
+        for(uint32_t j = 0; j < 3; j++)
+        {
+            aiTrianglePositionIndices[iDest * 3 + j] = aiTrianglePositionIndices[iTri * 3 + j];
+            aiTriangleNormalIndices[iDest * 3 + j] = aiTriangleNormalIndices[iTri * 3 + j];
+            aiTriangleUVIndices[iDest * 3 + j] = aiTriangleUVIndices[iTri * 3 + j];
+        }
+        ++iDest;
+    }
+
+    aiTrianglePositionIndices.resize(iDest * 3);
+    aiTriangleNormalIndices.resize(iDest * 3);
+    aiTriangleUVIndices.resize(iDest * 3);
+
+    // corner indices changed, rebuild
+    buildMeshConnectivity(
+        connectivity,
+        aiTrianglePositionIndices,
+        static_cast<uint32_t>(connectivity.maiVertexRingStart.size()));
+}
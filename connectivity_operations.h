@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+// connectivity of a cluster/cluster group's triangles given as position indices
+//      corner = triangle * 3 + vertex within triangle, triangle = corner / 3
+//      vertex rings are ranges into the flat corner list, contracted vertices get a new range appended at the end
+//      removed triangles are flagged and stay in the index list until compactConnectivityTriangles() is called
+//      edges are unique undirected (min, max) position index pairs with the number of triangles sharing them, built on creation
+struct MeshConnectivity
+{
+    std::vector<uint32_t>                           maiCorners;
+    std::vector<uint32_t>                           maiVertexRingStart;
+    std::vector<uint32_t>                           maiVertexRingCount;
+    std::vector<uint8_t>                            maiTriangleAlive;
+    uint32_t                                        miNumAliveTriangles;
+
+    std::vector<std::pair<uint32_t, uint32_t>>      maEdges;
+    std::vector<uint32_t>                           maiEdgeTriangleCounts;
+    std::unordered_map<uint64_t, uint32_t>          maEdgeIndices;
+};
+
+void buildMeshConnectivity(
+    MeshConnectivity& connectivity,
+    std::vector<uint32_t> const& aiTrianglePositionIndices,
+    uint32_t iNumVertices);
+
+// same as above for index lists that live inside a larger pool, like a ClusterStore cluster
+void buildMeshConnectivity(
+    MeshConnectivity& connectivity,
+    uint32_t const* paiTrianglePositionIndices,
+    uint32_t iNumTrianglePositionIndices,
+    uint32_t iNumVertices);
+
+uint32_t getConnectivityEdge(
+    MeshConnectivity const& connectivity,
+    uint32_t iPos0,
+    uint32_t iPos1);
+
+uint32_t getConnectivityEdgeTriangleCount(
+    MeshConnectivity const& connectivity,
+    uint32_t iPos0,
+    uint32_t iPos1);
+
+uint32_t findConnectivityEdgeTriangle(
+    MeshConnectivity const& connectivity,
+    std::vector<uint32_t> const& aiTrianglePositionIndices,
+    uint32_t iPos0,
+    uint32_t iPos1);
+
+uint32_t contractConnectivityEdge(
+    MeshConnectivity& connectivity,
+    std::vector<uint32_t>& aiTrianglePositionIndices,
+    uint32_t iPos0,
+    uint32_t iPos1,
+    uint32_t iNewPos);
+
+void compactConnectivityTriangles(
+    MeshConnectivity& connectivity,
+    std::vector<uint32_t>& aiTrianglePositionIndices,
+    std::vector<uint32_t>& aiTriangleNormalIndices,
+    std::vector<uint32_t>& aiTriangleUVIndices);
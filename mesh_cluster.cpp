@@ -1,4 +1,5 @@
 #include "mesh_cluster.h"
+#include "task_scheduler.h"
 #include <algorithm>
 #include <assert.h>
 
@@ -153,7 +154,194 @@ void saveMeshClusterData(
 /*
 **
 */
-void saveMeshClusterTriangleData(
+static uint16_t quantizeUNorm16(
+    float fValue,
+    float fMin,
+    float fMax)
+{
+    float fExtent = fMax - fMin;
+    float fPct = (fExtent > 0.0f) ? (fValue - fMin) / fExtent : 0.0f;
+    fPct = std::min(std::max(fPct, 0.0f), 1.0f);
+
+    return static_cast<uint16_t>(fPct * 65535.0f + 0.5f);
+}
+
+/*
+**
+*/
+static float dequantizeUNorm16(
+    uint16_t iValue,
+    float fMin,
+    float fMax)
+{
+    return fMin + (fMax - fMin) * (static_cast<float>(iValue) / 65535.0f);
+}
+
+/*
+**
+*/
+static int16_t quantizeSNorm16(float fValue)
+{
+    fValue = std::min(std::max(fValue, -1.0f), 1.0f);
+    return static_cast<int16_t>(roundf(fValue * 32767.0f));
+}
+
+/*
+**
+*/
+static uint16_t floatToHalf(float fValue)
+{
+    uint32_t iBits = 0;
+    memcpy(&iBits, &fValue, sizeof(float));
+
+    uint32_t iSign = (iBits >> 16) & 0x8000;
+    uint32_t iFloatExponent = (iBits >> 23) & 0xff;
+    uint32_t iMantissa = iBits & 0x7fffff;
+
+    // inf and nan
+    if(iFloatExponent == 0xff)
+    {
+        return static_cast<uint16_t>(iSign | 0x7c00 | ((iMantissa != 0) ? 0x200 : 0));
+    }
+
+    int32_t iExponent = static_cast<int32_t>(iFloatExponent) - 127 + 15;
+    if(iExponent >= 31)
+    {
+        return static_cast<uint16_t>(iSign | 0x7c00);
+    }
+
+    // denormal, round to nearest even on the shifted out bits
+    if(iExponent <= 0)
+    {
+        if(iExponent < -10)
+        {
+            return static_cast<uint16_t>(iSign);
+        }
+
+        iMantissa |= 0x800000;
+        uint32_t iShift = static_cast<uint32_t>(14 - iExponent);
+        uint32_t iHalfMantissa = iMantissa >> iShift;
+        uint32_t iRest = iMantissa & ((1u << iShift) - 1);
+        uint32_t iHalfway = 1u << (iShift - 1);
+        if(iRest > iHalfway || (iRest == iHalfway && (iHalfMantissa & 1)))
+        {
+            ++iHalfMantissa;
+        }
+
+        return static_cast<uint16_t>(iSign | iHalfMantissa);
+    }
+
+    // rounding up can carry into the exponent, that's still the right value
+    uint32_t iHalf = iSign | (static_cast<uint32_t>(iExponent) << 10) | (iMantissa >> 13);
+    uint32_t iRest = iMantissa & 0x1fff;
+    if(iRest > 0x1000 || (iRest == 0x1000 && (iHalf & 1)))
+    {
+        ++iHalf;
+    }
+
+    return static_cast<uint16_t>(iHalf);
+}
+
+/*
+**
+*/
+static float halfToFloat(uint16_t iHalf)
+{
+    uint32_t iSign = (static_cast<uint32_t>(iHalf) & 0x8000) << 16;
+    uint32_t iExponent = (iHalf >> 10) & 0x1f;
+    uint32_t iMantissa = iHalf & 0x3ff;
+
+    uint32_t iBits = 0;
+    if(iExponent == 0)
+    {
+        // zero and denormal, mantissa * 2^-24
+        float fValue = static_cast<float>(iMantissa) * (1.0f / 16777216.0f);
+        return (iSign != 0) ? -fValue : fValue;
+    }
+    else if(iExponent == 31)
+    {
+        iBits = iSign | 0x7f800000 | (iMantissa << 13);
+    }
+    else
+    {
+        iBits = iSign | ((iExponent - 15 + 127) << 23) | (iMantissa << 13);
+    }
+
+    float fRet = 0.0f;
+    memcpy(&fRet, &iBits, sizeof(float));
+    return fRet;
+}
+
+/*
+**
+*/
+CompressedMeshVertexFormat encodeCompressedMeshVertex(
+    MeshVertexFormat const& vertex,
+    float3 const& minBounds,
+    float3 const& maxBounds)
+{
+    CompressedMeshVertexFormat ret;
+    ret.maiPosition[0] = quantizeUNorm16(vertex.mPosition.x, minBounds.x, maxBounds.x);
+    ret.maiPosition[1] = quantizeUNorm16(vertex.mPosition.y, minBounds.y, maxBounds.y);
+    ret.maiPosition[2] = quantizeUNorm16(vertex.mPosition.z, minBounds.z, maxBounds.z);
+    ret.miPadding = 0;
+
+    // project onto the octahedron and fold the lower half over the diagonals
+    float3 const& normal = vertex.mNormal;
+    float fL1Length = fabsf(normal.x) + fabsf(normal.y) + fabsf(normal.z);
+    float fX = (fL1Length > 0.0f) ? normal.x / fL1Length : 0.0f;
+    float fY = (fL1Length > 0.0f) ? normal.y / fL1Length : 0.0f;
+    if(normal.z < 0.0f)
+    {
+        float fFoldedX = (1.0f - fabsf(fY)) * ((fX >= 0.0f) ? 1.0f : -1.0f);
+        float fFoldedY = (1.0f - fabsf(fX)) * ((fY >= 0.0f) ? 1.0f : -1.0f);
+        fX = fFoldedX;
+        fY = fFoldedY;
+    }
+    ret.maiNormal[0] = quantizeSNorm16(fX);
+    ret.maiNormal[1] = quantizeSNorm16(fY);
+
+    ret.maiUV[0] = floatToHalf(vertex.mUV.x);
+    ret.maiUV[1] = floatToHalf(vertex.mUV.y);
+
+    return ret;
+}
+
+/*
+**
+*/
+ConvertedMeshVertexFormat decodeCompressedMeshVertex(
+    CompressedMeshVertexFormat const& vertex,
+    float3 const& minBounds,
+    float3 const& maxBounds)
+{
+    float3 position(
+        dequantizeUNorm16(vertex.maiPosition[0], minBounds.x, maxBounds.x),
+        dequantizeUNorm16(vertex.maiPosition[1], minBounds.y, maxBounds.y),
+        dequantizeUNorm16(vertex.maiPosition[2], minBounds.z, maxBounds.z));
+
+    float fX = std::max(static_cast<float>(vertex.maiNormal[0]) / 32767.0f, -1.0f);
+    float fY = std::max(static_cast<float>(vertex.maiNormal[1]) / 32767.0f, -1.0f);
+    float fZ = 1.0f - fabsf(fX) - fabsf(fY);
+    if(fZ < 0.0f)
+    {
+        float fUnfoldedX = (1.0f - fabsf(fY)) * ((fX >= 0.0f) ? 1.0f : -1.0f);
+        float fUnfoldedY = (1.0f - fabsf(fX)) * ((fY >= 0.0f) ? 1.0f : -1.0f);
+        fX = fUnfoldedX;
+        fY = fUnfoldedY;
+    }
+    float3 normal = normalize(float3(fX, fY, fZ));
+
+    float2 uv(halfToFloat(vertex.maiUV[0]), halfToFloat(vertex.maiUV[1]));
+
+    return ConvertedMeshVertexFormat(position, normal, uv);
+}
+
+/*
+**
+*/
+void buildMeshClusterTriangleData(
+    MeshClusterTriangleData& triangleData,
     std::vector<uint8_t> const& aVertexPositionBuffer,
     std::vector<uint8_t> const& aVertexNormalBuffer,
     std::vector<uint8_t> const& aVertexUVBuffer,
@@ -161,9 +349,7 @@ void saveMeshClusterTriangleData(
     std::vector<uint8_t> const& aiTriangleNormalIndexBuffer,
     std::vector<uint8_t> const& aiTriangleUVIndexBuffer,
     std::vector<MeshCluster*> const& apMeshClusters,
-    std::string const& outputFilePath,
-    std::string const& outputVertexDataFilePath,
-    std::string const& outputIndexDataFilePath)
+    bool bCompressedVertices)
 {
     std::vector<MeshCluster*> apSortedMeshClusters = apMeshClusters;
     std::sort(
@@ -175,294 +361,230 @@ void saveMeshClusterTriangleData(
         }
     );
     
-    std::vector<std::vector<MeshVertexFormat>> aaClusterVertices;
-    std::vector<std::vector<uint32_t>> aaiClusterVertexIndices;
-    for(auto const& pMeshCluster : apSortedMeshClusters)
-    {
-        std::vector<float3> aClusterVertexPositions(pMeshCluster->miNumVertexPositions);
-        memcpy(
-            aClusterVertexPositions.data(),
-            aVertexPositionBuffer.data() + pMeshCluster->miVertexPositionStartArrayAddress * sizeof(float3),
-            pMeshCluster->miNumVertexPositions * sizeof(float3));
-
-        std::vector<float3> aClusterVertexNormals(pMeshCluster->miNumVertexNormals);
-        memcpy(
-            aClusterVertexNormals.data(),
-            aVertexNormalBuffer.data() + pMeshCluster->miVertexNormalStartArrayAddress * sizeof(float3),
-            pMeshCluster->miNumVertexNormals * sizeof(float3));
+    // each cluster converts into its own slot, the unified vertices are found through a hash of their exact bits
+    uint32_t iNumMeshClusters = static_cast<uint32_t>(apSortedMeshClusters.size());
+    std::vector<std::vector<MeshVertexFormat>> aaClusterVertices(iNumMeshClusters);
+    std::vector<std::vector<uint32_t>> aaiClusterVertexIndices(iNumMeshClusters);
+    std::vector<std::vector<uint32_t>> aaiVertexHashTables(getNumTaskWorkers());
+    parallelFor(
+        iNumMeshClusters,
+        16,
+        [&apSortedMeshClusters,
+        &aaClusterVertices,
+        &aaiClusterVertexIndices,
+        &aaiVertexHashTables,
+        &aVertexPositionBuffer,
+        &aVertexNormalBuffer,
+        &aVertexUVBuffer,
+        &aiTrianglePositionIndexBuffer,
+        &aiTriangleNormalIndexBuffer,
+        &aiTriangleUVIndexBuffer](uint32_t iMeshCluster, uint32_t iSlot)
+        {
+            MeshCluster const* pMeshCluster = apSortedMeshClusters[iMeshCluster];
+
+            float3 const* aClusterVertexPositions = reinterpret_cast<float3 const*>(aVertexPositionBuffer.data() + pMeshCluster->miVertexPositionStartArrayAddress * sizeof(float3));
+            float3 const* aClusterVertexNormals = reinterpret_cast<float3 const*>(aVertexNormalBuffer.data() + pMeshCluster->miVertexNormalStartArrayAddress * sizeof(float3));
+            float2 const* aClusterVertexUVs = reinterpret_cast<float2 const*>(aVertexUVBuffer.data() + pMeshCluster->miVertexUVStartArrayAddress * sizeof(float2));
+            uint32_t const* aClusterPositionIndices = reinterpret_cast<uint32_t const*>(aiTrianglePositionIndexBuffer.data() + pMeshCluster->miTrianglePositionIndexArrayAddress * sizeof(uint32_t));
+            uint32_t const* aClusterNormalIndices = reinterpret_cast<uint32_t const*>(aiTriangleNormalIndexBuffer.data() + pMeshCluster->miTriangleNormalIndexArrayAddress * sizeof(uint32_t));
+            uint32_t const* aClusterUVIndices = reinterpret_cast<uint32_t const*>(aiTriangleUVIndexBuffer.data() + pMeshCluster->miTriangleUVIndexArrayAddress * sizeof(uint32_t));
+
+            // open addressing, at least twice the number of triangle corners
+            uint32_t iNumCorners = pMeshCluster->miNumTrianglePositionIndices;
+            uint32_t iHashTableSize = 16;
+            while(iHashTableSize < iNumCorners * 2)
+            {
+                iHashTableSize <<= 1;
+            }
+            std::vector<uint32_t>& aiHashTable = aaiVertexHashTables[iSlot];
+            aiHashTable.assign(iHashTableSize, UINT32_MAX);
+
+            std::vector<MeshVertexFormat>& aVertices = aaClusterVertices[iMeshCluster];
+            std::vector<uint32_t>& aiVertexIndices = aaiClusterVertexIndices[iMeshCluster];
+            aVertices.reserve(iNumCorners);
+            aiVertexIndices.resize(iNumCorners);
+            for(uint32_t iTri = 0; iTri < iNumCorners; iTri += 3)
+            {
+                for(uint32_t i = 0; i < 3; i++)
+                {
+                    uint32_t iPos = aClusterPositionIndices[iTri + i];
+                    assert(iPos < pMeshCluster->miNumVertexPositions);
 
-        std::vector<float2> aClusterVertexUVs(pMeshCluster->miNumVertexUVs);
-        memcpy(
-            aClusterVertexUVs.data(),
-            aVertexUVBuffer.data() + pMeshCluster->miVertexUVStartArrayAddress * sizeof(float2),
-            pMeshCluster->miNumVertexUVs * sizeof(float2));
+                    uint32_t iNorm = aClusterNormalIndices[iTri + i];
+                    assert(iNorm < pMeshCluster->miNumVertexNormals);
 
-        std::vector<uint32_t> aClusterPositionIndices(pMeshCluster->miNumTrianglePositionIndices);
-        memcpy(
-            aClusterPositionIndices.data(),
-            aiTrianglePositionIndexBuffer.data() + pMeshCluster->miTrianglePositionIndexArrayAddress * sizeof(uint32_t),
-            pMeshCluster->miNumTrianglePositionIndices * sizeof(uint32_t));
+                    uint32_t iUV = aClusterUVIndices[iTri + i];
+                    assert(iUV < pMeshCluster->miNumVertexUVs);
 
-        std::vector<uint32_t> aClusterNormalIndices(pMeshCluster->miNumTriangleNormalIndices);
-        memcpy(
-            aClusterNormalIndices.data(),
-            aiTriangleNormalIndexBuffer.data() + pMeshCluster->miTriangleNormalIndexArrayAddress * sizeof(uint32_t),
-            pMeshCluster->miNumTriangleNormalIndices * sizeof(uint32_t));
+                    MeshVertexFormat vertex(aClusterVertexPositions[iPos], aClusterVertexNormals[iNorm], aClusterVertexUVs[iUV]);
 
-        std::vector<uint32_t> aClusterUVIndices(pMeshCluster->miNumTriangleUVIndices);
-        memcpy(
-            aClusterUVIndices.data(),
-            aiTriangleUVIndexBuffer.data() + pMeshCluster->miTriangleUVIndexArrayAddress * sizeof(uint32_t),
-            pMeshCluster->miNumTriangleUVIndices * sizeof(uint32_t));
-
-        std::vector<MeshVertexFormat> aVertices;
-        std::vector<uint32_t> aiVertexIndices;
-        for(uint32_t iTri = 0; iTri < pMeshCluster->miNumTrianglePositionIndices; iTri += 3)
-        {
-            for(uint32_t i = 0; i < 3; i++)
-            {
-                uint32_t iPos = aClusterPositionIndices[iTri + i];
-                assert(iPos < aClusterVertexPositions.size());
-                float3 const& pos = aClusterVertexPositions[iPos];
-
-                uint32_t iNorm = aClusterNormalIndices[iTri + i];
-                assert(iNorm < aClusterVertexNormals.size());
-                float3 const& norm = aClusterVertexNormals[iNorm];
-
-                uint32_t iUV = aClusterUVIndices[iTri + i];
-                assert(iUV < aClusterVertexUVs.size());
-                float2 const& uv = aClusterVertexUVs[iUV];
-
-                auto existIter = std::find_if(
-                    aVertices.begin(),
-                    aVertices.end(),
-                    [pos, norm, uv](MeshVertexFormat const& v)
+                    // fnv-1a over the 8 floats
+                    uint32_t aiBits[sizeof(MeshVertexFormat) / sizeof(uint32_t)];
+                    memcpy(aiBits, &vertex, sizeof(MeshVertexFormat));
+                    uint32_t iHash = 2166136261u;
+                    for(auto const& iBits : aiBits)
                     {
-                        return
-                            lengthSquared(v.mPosition - pos) <= 1.0e-8f &&
-                            lengthSquared(v.mNormal - norm) <= 1.0e-8f &&
-                            lengthSquared(v.mUV - uv) <= 1.0e-8f;
+                        iHash = (iHash ^ iBits) * 16777619u;
                     }
-                );
 
-                if(existIter != aVertices.end())
-                {
-                    uint32_t iVertexIndex = static_cast<uint32_t>(std::distance(aVertices.begin(), existIter));
-                    aiVertexIndices.push_back(iVertexIndex);
-                }
-                else
-                {
-                    aVertices.emplace_back(pos, norm, uv);
-                    aiVertexIndices.push_back(static_cast<uint32_t>(aVertices.size() - 1));
-                }
-
-            }   // for i = 0 to 3
+                    uint32_t iBucket = iHash & (iHashTableSize - 1);
+                    while(aiHashTable[iBucket] != UINT32_MAX && memcmp(&aVertices[aiHashTable[iBucket]], &vertex, sizeof(MeshVertexFormat)) != 0)
+                    {
+                        iBucket = (iBucket + 1) & (iHashTableSize - 1);
+                    }
 
-        }   // for tri = 0 to num triangles
+                    if(aiHashTable[iBucket] == UINT32_MAX)
+                    {
+                        aiHashTable[iBucket] = static_cast<uint32_t>(aVertices.size());
+                        aVertices.push_back(vertex);
+                    }
+                    aiVertexIndices[iTri + i] = aiHashTable[iBucket];
 
-        aaClusterVertices.push_back(aVertices);
-        aaiClusterVertexIndices.push_back(aiVertexIndices);
+                }   // for i = 0 to 3
 
-    }   // for cluster to all clusters
+            }   // for tri = 0 to num triangles
+        });
 
-    uint64_t iTotalSize = 0;
-    for(auto const& aClusterVertices : aaClusterVertices)
+    // cluster local indices fit in a byte unless a cluster has more than 256 vertices
+    triangleData.maiNumClusterVertices.resize(iNumMeshClusters);
+    triangleData.maiNumClusterIndices.resize(iNumMeshClusters);
+    triangleData.maiVertexOffsets.assign(iNumMeshClusters + 1, 0);
+    triangleData.maiIndexOffsets.assign(iNumMeshClusters + 1, 0);
+    uint32_t iMaxClusterVertices = 0;
+    for(uint32_t i = 0; i < iNumMeshClusters; i++)
     {
-        iTotalSize += (aClusterVertices.size() * sizeof(MeshVertexFormat));
+        triangleData.maiNumClusterVertices[i] = static_cast<uint32_t>(aaClusterVertices[i].size());
+        triangleData.maiNumClusterIndices[i] = static_cast<uint32_t>(aaiClusterVertexIndices[i].size());
+        triangleData.maiVertexOffsets[i + 1] = triangleData.maiVertexOffsets[i] + aaClusterVertices[i].size();
+        triangleData.maiIndexOffsets[i + 1] = triangleData.maiIndexOffsets[i] + aaiClusterVertexIndices[i].size();
+        iMaxClusterVertices = std::max(iMaxClusterVertices, triangleData.maiNumClusterVertices[i]);
     }
 
-    for(auto const& aiClusterVertexIndices : aaiClusterVertexIndices)
-    {
-        iTotalSize += (aiClusterVertexIndices.size() * sizeof(uint32_t));
-    }
-
-    {
-        // vertex buffer
+    bool bPackedIndices = (iMaxClusterVertices <= 256);
+    triangleData.miIndexSize = bPackedIndices ? sizeof(uint8_t) : sizeof(uint32_t);
+    triangleData.maVertices.resize(triangleData.maiVertexOffsets[iNumMeshClusters]);
+    triangleData.maCompressedVertices.resize(bCompressedVertices ? triangleData.maiVertexOffsets[iNumMeshClusters] : 0);
+    triangleData.macIndices.resize(triangleData.maiIndexOffsets[iNumMeshClusters] * triangleData.miIndexSize);
+
+    // every cluster's slice is known, fill them in parallel
+    ConvertedMeshVertexFormat* pVertexData = triangleData.maVertices.data();
+    CompressedMeshVertexFormat* pCompressedVertexData = bCompressedVertices ? triangleData.maCompressedVertices.data() : nullptr;
+    uint8_t* pcIndexData = triangleData.macIndices.data();
+    std::vector<uint64_t> const& aiVertexOffsets = triangleData.maiVertexOffsets;
+    std::vector<uint64_t> const& aiIndexOffsets = triangleData.maiIndexOffsets;
+    parallelFor(
+        iNumMeshClusters,
+        64,
+        [&apSortedMeshClusters,
+        &aaClusterVertices,
+        &aaiClusterVertexIndices,
+        &aiVertexOffsets,
+        &aiIndexOffsets,
+        pVertexData,
+        pcIndexData,
+        pCompressedVertexData,
+        bPackedIndices](uint32_t iMeshCluster, uint32_t /*iSlot*/)
         {
-#if 0
-            std::vector<uint8_t> acVertexBufferFileContent((aaClusterVertices.size() + 1) * sizeof(uint32_t));
-            uint64_t iStartAddress = reinterpret_cast<uint64_t>(acVertexBufferFileContent.data());
-            uint32_t* piData = reinterpret_cast<uint32_t*>(acVertexBufferFileContent.data());
-            *piData++ = static_cast<uint32_t>(aaClusterVertices.size());
-            for(uint32_t i = 0; i < static_cast<uint32_t>(aaClusterVertices.size()); i++)
+            ConvertedMeshVertexFormat* pClusterVertexData = pVertexData + aiVertexOffsets[iMeshCluster];
+            for(auto const& vertex : aaClusterVertices[iMeshCluster])
             {
-                *piData++ = static_cast<uint32_t>(aaClusterVertices[i].size());
-            }
-            uint32_t iDataOffset = static_cast<uint32_t>(acVertexBufferFileContent.size());
-            MeshVertexFormat* pVertexData = reinterpret_cast<MeshVertexFormat*>(piData);
-            for(uint32_t i = 0; i < static_cast<uint32_t>(aaClusterVertices.size()); i++)
-            {
-                uint32_t iSize = static_cast<uint32_t>(aaClusterVertices[i].size() * sizeof(MeshVertexFormat));
-                acVertexBufferFileContent.resize(acVertexBufferFileContent.size() + iSize);
-                iStartAddress = reinterpret_cast<uint64_t>(acVertexBufferFileContent.data());
-                pVertexData = reinterpret_cast<MeshVertexFormat*>(acVertexBufferFileContent.data() + iDataOffset);
-
-                memcpy(
-                    pVertexData,
-                    aaClusterVertices[i].data(),
-                    iSize);
-                iDataOffset += iSize;
+                *pClusterVertexData++ = ConvertedMeshVertexFormat(vertex);
             }
 
-            FILE* fp = fopen(outputVertexDataFilePath.c_str(), "wb");
-            fwrite(acVertexBufferFileContent.data(), sizeof(char), acVertexBufferFileContent.size(), fp);
-            fclose(fp);
-#endif // #if 0
-
-            // CHANGE TO float4, float4, float4 format
+            if(pCompressedVertexData != nullptr)
             {
-                std::vector<uint8_t> acVertexBufferFileContent((aaClusterVertices.size() + 1) * sizeof(uint32_t));
-                uint64_t iStartAddress = reinterpret_cast<uint64_t>(acVertexBufferFileContent.data());
-                uint32_t* piData = reinterpret_cast<uint32_t*>(acVertexBufferFileContent.data());
-                *piData++ = static_cast<uint32_t>(aaClusterVertices.size());
-                ConvertedMeshVertexFormat* pVertexData = reinterpret_cast<ConvertedMeshVertexFormat*>(piData);
-                for(uint32_t i = 0; i < static_cast<uint32_t>(aaClusterVertices.size()); i++)
+                MeshCluster const* pMeshCluster = apSortedMeshClusters[iMeshCluster];
+                CompressedMeshVertexFormat* pClusterCompressedVertexData = pCompressedVertexData + aiVertexOffsets[iMeshCluster];
+                for(auto const& vertex : aaClusterVertices[iMeshCluster])
                 {
-                    *piData++ = static_cast<uint32_t>(aaClusterVertices[i].size());
+                    *pClusterCompressedVertexData++ = encodeCompressedMeshVertex(vertex, pMeshCluster->mMinBounds, pMeshCluster->mMaxBounds);
                 }
-                uint32_t iDataOffset = static_cast<uint32_t>(acVertexBufferFileContent.size());
-                for(uint32_t i = 0; i < static_cast<uint32_t>(aaClusterVertices.size()); i++)
-                {
-                    uint32_t iNumClusterVertices = static_cast<uint32_t>(aaClusterVertices[i].size());
-                    uint32_t iSize = static_cast<uint32_t>(iNumClusterVertices * sizeof(ConvertedMeshVertexFormat));
-                    acVertexBufferFileContent.resize(acVertexBufferFileContent.size() + iSize);
-                    iStartAddress = reinterpret_cast<uint64_t>(acVertexBufferFileContent.data());
-                    pVertexData = reinterpret_cast<ConvertedMeshVertexFormat*>(acVertexBufferFileContent.data() + iDataOffset);
-                    for(uint32_t j = 0; j < iNumClusterVertices; j++)
-                    {
-                        MeshVertexFormat const& vert = aaClusterVertices[i][j];
-                        pVertexData->mPosition = float4(vert.mPosition, 1.0f);
-                        pVertexData->mNormal = float4(vert.mNormal, 1.0f);
-                        pVertexData->mUV = float4(vert.mUV.x, vert.mUV.y, 0.0f, 0.0f);
-                        ++pVertexData;
-
-                        iDataOffset += sizeof(ConvertedMeshVertexFormat);
-                    }
-                }
-
-                FILE* fp = fopen(outputVertexDataFilePath.c_str(), "wb");
-                fwrite(acVertexBufferFileContent.data(), sizeof(char), acVertexBufferFileContent.size(), fp);
-                fclose(fp);
-
-            }   // change to new vertex format
-
-
-            
-        }
+            }
 
-        // index buffer
-        {
-            std::vector<uint8_t> acIndexBufferFileContent((aaiClusterVertexIndices.size() + 1) * sizeof(uint32_t));
-            uint64_t iStartAddress = reinterpret_cast<uint64_t>(acIndexBufferFileContent.data());
-            uint32_t* piData = reinterpret_cast<uint32_t*>(acIndexBufferFileContent.data());
-            *piData++ = static_cast<uint32_t>(aaiClusterVertexIndices.size());
-            for(uint32_t i = 0; i < static_cast<uint32_t>(aaiClusterVertexIndices.size()); i++)
+            if(bPackedIndices)
             {
-                *piData++ = static_cast<uint32_t>(aaiClusterVertexIndices[i].size());
+                uint8_t* pcClusterIndexData = pcIndexData + aiIndexOffsets[iMeshCluster];
+                for(auto const& iIndex : aaiClusterVertexIndices[iMeshCluster])
+                {
+                    *pcClusterIndexData++ = static_cast<uint8_t>(iIndex);
+                }
             }
-            uint32_t iDataOffset = static_cast<uint32_t>(acIndexBufferFileContent.size());
-            for(uint32_t i = 0; i < static_cast<uint32_t>(aaiClusterVertexIndices.size()); i++)
+            else
             {
-                uint32_t iSize = static_cast<uint32_t>(aaiClusterVertexIndices[i].size() * sizeof(uint32_t));
-                acIndexBufferFileContent.resize(acIndexBufferFileContent.size() + iSize);
-                iStartAddress = reinterpret_cast<uint64_t>(acIndexBufferFileContent.data());
-                piData = reinterpret_cast<uint32_t*>(acIndexBufferFileContent.data() + iDataOffset);
-
                 memcpy(
-                    piData,
-                    aaiClusterVertexIndices[i].data(),
-                    iSize);
-                iDataOffset += iSize;
+                    pcIndexData + aiIndexOffsets[iMeshCluster] * sizeof(uint32_t),
+                    aaiClusterVertexIndices[iMeshCluster].data(),
+                    aaiClusterVertexIndices[iMeshCluster].size() * sizeof(uint32_t));
             }
+        });
+}
 
-            FILE* fp = fopen(outputIndexDataFilePath.c_str(), "wb");
-            fwrite(acIndexBufferFileContent.data(), sizeof(char), acIndexBufferFileContent.size(), fp);
-            fclose(fp);
+/*
+**
+*/
+void saveMeshClusterTriangleData(
+    MeshClusterTriangleData const& triangleData,
+    std::string const& outputFilePath,
+    std::string const& outputVertexDataFilePath,
+    std::string const& outputIndexDataFilePath,
+    std::string const& outputCompressedVertexDataFilePath)
+{
+    // file layouts:
+    //      vertex data: num clusters, num vertices per cluster, ConvertedMeshVertexFormat vertices of all the clusters
+    //      index data: num clusters, num indices per cluster, uint32_t or uint8_t indices of all the clusters
+    //      combined (optional): num clusters twice, (num vertices, num indices) per cluster, vertex data then index data
+    //      the index count words of the index data and combined files carry MESH_CLUSTER_PACKED_INDEX_FLAG when the indices are uint8_t
+    uint32_t iNumMeshClusters = static_cast<uint32_t>(triangleData.maiNumClusterVertices.size());
+    uint32_t iIndexFlag = (triangleData.miIndexSize == sizeof(uint8_t)) ? MESH_CLUSTER_PACKED_INDEX_FLAG : 0;
+
+    std::vector<uint32_t> aiVertexHeader(iNumMeshClusters + 1);
+    std::vector<uint32_t> aiIndexHeader(iNumMeshClusters + 1);
+    aiVertexHeader[0] = iNumMeshClusters;
+    aiIndexHeader[0] = iNumMeshClusters | iIndexFlag;
+    memcpy(aiVertexHeader.data() + 1, triangleData.maiNumClusterVertices.data(), iNumMeshClusters * sizeof(uint32_t));
+    memcpy(aiIndexHeader.data() + 1, triangleData.maiNumClusterIndices.data(), iNumMeshClusters * sizeof(uint32_t));
 
-        }   // index buffer
+    {
+        FILE* fp = fopen(outputVertexDataFilePath.c_str(), "wb");
+        fwrite(aiVertexHeader.data(), sizeof(uint32_t), aiVertexHeader.size(), fp);
+        fwrite(triangleData.maVertices.data(), sizeof(ConvertedMeshVertexFormat), triangleData.maVertices.size(), fp);
+        fclose(fp);
     }
 
-
-
-
-    // temp values for now
-    std::vector<uint8_t> acFileContent(aaClusterVertices.size() * 2 * sizeof(uint32_t) + 2 * sizeof(uint32_t));
-    uint64_t iStartAddress = reinterpret_cast<uint64_t>(acFileContent.data());
-    uint32_t* piData = reinterpret_cast<uint32_t*>(acFileContent.data());
-    *piData++ = static_cast<uint32_t>(aaClusterVertices.size());
-    *piData++ = static_cast<uint32_t>(aaiClusterVertexIndices.size());
-    for(uint32_t i = 0; i < static_cast<uint32_t>(aaClusterVertices.size()); i++)
     {
-        *piData++ = static_cast<uint32_t>(aaClusterVertices[i].size());
-        *piData++ = static_cast<uint32_t>(aaiClusterVertexIndices[i].size());
+        FILE* fp = fopen(outputIndexDataFilePath.c_str(), "wb");
+        fwrite(aiIndexHeader.data(), sizeof(uint32_t), aiIndexHeader.size(), fp);
+        fwrite(triangleData.macIndices.data(), sizeof(char), triangleData.macIndices.size(), fp);
+        fclose(fp);
     }
 
-    // vertices
-    uint32_t iDataOffset = static_cast<uint32_t>(acFileContent.size());
-    std::vector<uint32_t> aiVertexDataOffset(aaClusterVertices.size());
-    ConvertedMeshVertexFormat* pVertexData = reinterpret_cast<ConvertedMeshVertexFormat*>(piData);
-    for(uint32_t i = 0; i < static_cast<uint32_t>(aaClusterVertices.size()); i++)
+    // same header as the vertex data
+    if(outputCompressedVertexDataFilePath.length() > 0)
     {
-        uint64_t iCurrDataOffset = reinterpret_cast<uint64_t>(pVertexData) - iStartAddress;
-        assert(iCurrDataOffset <= acFileContent.size() * sizeof(char));
-
-        aiVertexDataOffset[i] = iDataOffset;
-        uint32_t iSize = static_cast<uint32_t>(aaClusterVertices[i].size() * sizeof(ConvertedMeshVertexFormat));
-        acFileContent.resize(acFileContent.size() + iSize);
-        iStartAddress = reinterpret_cast<uint64_t>(acFileContent.data());
-        pVertexData = reinterpret_cast<ConvertedMeshVertexFormat*>(acFileContent.data() + iDataOffset);
-
-        for(uint32_t j = 0; j < static_cast<uint32_t>(aaClusterVertices[i].size()); j++)
-        {
-            pVertexData->mPosition = float4(aaClusterVertices[i][j].mPosition, 1.0f);
-            pVertexData->mNormal = float4(aaClusterVertices[i][j].mNormal, 1.0f);
-            pVertexData->mUV = float4(aaClusterVertices[i][j].mUV.x, aaClusterVertices[i][j].mUV.y, 0.0f, 0.0f);
-            
-            pVertexData += 1;
-            iDataOffset += static_cast<uint32_t>(sizeof(ConvertedMeshVertexFormat));
-        }
-
-        //memcpy(
-        //    pVertexData,
-        //    aaClusterVertices[i].data(),
-        //    iSize);
-        //iDataOffset += iSize;
+        assert(triangleData.maCompressedVertices.size() == triangleData.maVertices.size());
+        FILE* fp = fopen(outputCompressedVertexDataFilePath.c_str(), "wb");
+        fwrite(aiVertexHeader.data(), sizeof(uint32_t), aiVertexHeader.size(), fp);
+        fwrite(triangleData.maCompressedVertices.data(), sizeof(CompressedMeshVertexFormat), triangleData.maCompressedVertices.size(), fp);
+        fclose(fp);
     }
 
-    // vertex indices
-    std::vector<uint32_t> aiVertexIndexOffset(aaiClusterVertexIndices.size());
-    uint32_t* piIndexData = reinterpret_cast<uint32_t*>(acFileContent.data() + iDataOffset);
-    for(uint32_t i = 0; i < static_cast<uint32_t>(aaiClusterVertexIndices.size()); i++)
+    if(outputFilePath.length() > 0)
     {
-        uint64_t iCurrDataOffset = reinterpret_cast<uint64_t>(piIndexData) - iStartAddress;
-        assert(iCurrDataOffset <= acFileContent.size() * sizeof(char));
-
-        aiVertexIndexOffset[i] = iDataOffset;
-        uint32_t iSize = static_cast<uint32_t>(aaiClusterVertexIndices[i].size() * sizeof(uint32_t));
-        acFileContent.resize(acFileContent.size() + iSize);
-        iStartAddress = reinterpret_cast<uint64_t>(acFileContent.data());
-        piIndexData = reinterpret_cast<uint32_t*>(acFileContent.data() + iDataOffset);
+        std::vector<uint32_t> aiHeader(2 + iNumMeshClusters * 2);
+        aiHeader[0] = iNumMeshClusters;
+        aiHeader[1] = iNumMeshClusters | iIndexFlag;
+        for(uint32_t i = 0; i < iNumMeshClusters; i++)
+        {
+            aiHeader[2 + i * 2] = triangleData.maiNumClusterVertices[i];
+            aiHeader[2 + i * 2 + 1] = triangleData.maiNumClusterIndices[i];
+        }
 
-        memcpy(
-            piIndexData,
-            aaiClusterVertexIndices[i].data(),
-            iSize);
-        iDataOffset += iSize;
+        FILE* fp = fopen(outputFilePath.c_str(), "wb");
+        fwrite(aiHeader.data(), sizeof(uint32_t), aiHeader.size(), fp);
+        fwrite(triangleData.maVertices.data(), sizeof(ConvertedMeshVertexFormat), triangleData.maVertices.size(), fp);
+        fwrite(triangleData.macIndices.data(), sizeof(char), triangleData.macIndices.size(), fp);
+        fclose(fp);
     }
-
-    // data offset 
-    //piData = reinterpret_cast<uint32_t*>(acFileContent.data());
-    //piData += 2;
-    //for(uint32_t i = 0; i < aiVertexDataOffset.size(); i++)
-    //{
-    //    *piData++ = aiVertexDataOffset[i];
-    //    *piData++ = aiVertexIndexOffset[i];
-    //}
-
-    FILE* fp = fopen(outputFilePath.c_str(), "wb");
-    fwrite(acFileContent.data(), sizeof(char), acFileContent.size(), fp);
-    fclose(fp);
-
 }
 
 /*
@@ -484,6 +606,8 @@ void loadMeshClusterTriangleData(
     uint32_t* piData = reinterpret_cast<uint32_t*>(acFileContent.data());
     uint32_t iNumClusterVertexList = *piData++;
     uint32_t iNumClusterVertexIndexList = *piData++;
+    bool bPackedIndices = ((iNumClusterVertexIndexList & MESH_CLUSTER_PACKED_INDEX_FLAG) != 0);
+    iNumClusterVertexIndexList &= ~MESH_CLUSTER_PACKED_INDEX_FLAG;
     uint64_t iStartAddress = reinterpret_cast<uint64_t>(acFileContent.data());
 
     aaVertices.resize(iNumClusterVertexList);
@@ -514,14 +638,25 @@ void loadMeshClusterTriangleData(
 
     iCurrDataOffset = reinterpret_cast<uint64_t>(pVertexFormat) - iStartAddress;
 
-    uint32_t* piVertexIndices = reinterpret_cast<uint32_t*>(pVertexFormat);
+    uint8_t const* pcVertexIndices = reinterpret_cast<uint8_t const*>(pVertexFormat);
     for(uint32_t i = 0; i < iNumClusterVertexList; i++)
     {
-        memcpy(
-            aaiTriangleVertexIndices[i].data(),
-            piVertexIndices,
-            aaiTriangleVertexIndices[i].size() * sizeof(uint32_t));
-        piVertexIndices += aaiTriangleVertexIndices[i].size();
+        if(bPackedIndices)
+        {
+            std::copy(
+                pcVertexIndices,
+                pcVertexIndices + aaiTriangleVertexIndices[i].size(),
+                aaiTriangleVertexIndices[i].begin());
+            pcVertexIndices += aaiTriangleVertexIndices[i].size();
+        }
+        else
+        {
+            memcpy(
+                aaiTriangleVertexIndices[i].data(),
+                pcVertexIndices,
+                aaiTriangleVertexIndices[i].size() * sizeof(uint32_t));
+            pcVertexIndices += aaiTriangleVertexIndices[i].size() * sizeof(uint32_t);
+        }
     }
 }
 
@@ -533,6 +668,7 @@ void loadMeshClusterTriangleDataTableOfContent(
     std::vector<uint32_t>& aiNumClusterIndices,
     std::vector<uint64_t>& aiVertexBufferArrayOffsets,
     std::vector<uint64_t>& aiIndexBufferArrayOffset,
+    uint32_t& iIndexSize,
     std::string const& vertexDataFilePath,
     std::string const& indexDataFilePath)
 {
@@ -564,6 +700,8 @@ void loadMeshClusterTriangleDataTableOfContent(
         fread(acContentBuffer.data(), sizeof(char), sizeof(uint32_t), fp);
         uint32_t* piIntData = reinterpret_cast<uint32_t*>(acContentBuffer.data());
         uint32_t iNumClusters = *piIntData++;
+        iIndexSize = (iNumClusters & MESH_CLUSTER_PACKED_INDEX_FLAG) ? sizeof(uint8_t) : sizeof(uint32_t);
+        iNumClusters &= ~MESH_CLUSTER_PACKED_INDEX_FLAG;
         acContentBuffer.resize(sizeof(uint32_t) * iNumClusters * sizeof(uint32_t));
         piIntData = reinterpret_cast<uint32_t*>(acContentBuffer.data() + sizeof(uint32_t));
         fread(piIntData, sizeof(char), sizeof(uint32_t) * iNumClusters, fp);
@@ -582,6 +720,43 @@ void loadMeshClusterTriangleDataTableOfContent(
     }
 }
 
+/*
+**  64 bit offset, fseek takes a long which is 32 bit on windows
+*/
+static void seekFile(
+    FILE* fp,
+    uint64_t iOffset)
+{
+#if defined(_MSC_VER)
+    _fseeki64(fp, static_cast<int64_t>(iOffset), SEEK_SET);
+#else
+    fseeko(fp, static_cast<off_t>(iOffset), SEEK_SET);
+#endif // _MSC_VER
+}
+
+/*
+**
+*/
+void loadMeshClusterTriangleIndexDataChunk(
+    std::vector<uint8_t>& acClusterIndexData,
+    std::string const& indexDataFilePath,
+    std::vector<uint32_t> const& aiNumClusterIndices,
+    std::vector<uint64_t> const& aiIndexBufferArrayOffsets,
+    uint32_t iIndexSize,
+    uint32_t iClusterIndex)
+{
+    assert(iClusterIndex < aiIndexBufferArrayOffsets.size());
+    assert(iIndexSize == sizeof(uint8_t) || iIndexSize == sizeof(uint32_t));
+
+    FILE* fp = fopen(indexDataFilePath.c_str(), "rb");
+    uint64_t iIndexDataBufferSize = aiNumClusterIndices[iClusterIndex] * iIndexSize;
+    uint64_t iStartIndexDataOffset = sizeof(uint32_t) + sizeof(uint32_t) * aiNumClusterIndices.size() + aiIndexBufferArrayOffsets[iClusterIndex] * iIndexSize;
+    acClusterIndexData.resize(iIndexDataBufferSize);
+    seekFile(fp, iStartIndexDataOffset);
+    fread(acClusterIndexData.data(), sizeof(char), iIndexDataBufferSize, fp);
+    fclose(fp);
+}
+
 /*
 **
 */
@@ -594,6 +769,7 @@ void loadMeshClusterTriangleDataChunk(
     std::vector<uint32_t> const& aiNumClusterIndices,
     std::vector<uint64_t> const& aiVertexBufferArrayOffsets,
     std::vector<uint64_t> const& aiIndexBufferArrayOffsets,
+    uint32_t iIndexSize,
     uint32_t iClusterIndex)
 {
     assert(iClusterIndex < aiVertexBufferArrayOffsets.size());
@@ -602,16 +778,77 @@ void loadMeshClusterTriangleDataChunk(
     uint64_t iVertexDataBufferSize = aiNumClusterVertices[iClusterIndex] * sizeof(ConvertedMeshVertexFormat);
     aClusterTriangleVertices.resize(aiNumClusterVertices[iClusterIndex]);
     uint64_t iStartVertexDataOffset = sizeof(uint32_t) + sizeof(uint32_t) * aiNumClusterVertices.size() + aiVertexBufferArrayOffsets[iClusterIndex] * sizeof(ConvertedMeshVertexFormat);
-    fseek(fp, static_cast<long>(iStartVertexDataOffset), SEEK_SET);
+    seekFile(fp, iStartVertexDataOffset);
     fread(aClusterTriangleVertices.data(), sizeof(char), iVertexDataBufferSize, fp);
     fclose(fp);
 
-    fp = fopen(indexDataFilePath.c_str(), "rb");
-    uint64_t iIndexDataBufferSize = aiNumClusterIndices[iClusterIndex] * sizeof(uint32_t);
-    uint64_t iStartIndexDataOffset = sizeof(uint32_t) + sizeof(uint32_t) * aiNumClusterIndices.size() + aiIndexBufferArrayOffsets[iClusterIndex] * sizeof(uint32_t);
+    std::vector<uint8_t> acIndexData;
+    loadMeshClusterTriangleIndexDataChunk(
+        acIndexData,
+        indexDataFilePath,
+        aiNumClusterIndices,
+        aiIndexBufferArrayOffsets,
+        iIndexSize,
+        iClusterIndex);
     aiClusterTriangleVertexIndices.resize(aiNumClusterIndices[iClusterIndex]);
-    fseek(fp, static_cast<long>(iStartIndexDataOffset), SEEK_SET);
-    fread(aiClusterTriangleVertexIndices.data(), sizeof(char), iIndexDataBufferSize, fp);
-    fclose(fp);
+    if(iIndexSize == sizeof(uint8_t))
+    {
+        std::copy(acIndexData.begin(), acIndexData.end(), aiClusterTriangleVertexIndices.begin());
+    }
+    else
+    {
+        memcpy(aiClusterTriangleVertexIndices.data(), acIndexData.data(), acIndexData.size());
+    }
 }
 
+/*
+**
+*/
+void loadCompressedMeshClusterTriangleDataChunk(
+    std::vector<ConvertedMeshVertexFormat>& aClusterTriangleVertices,
+    std::vector<uint32_t>& aiClusterTriangleVertexIndices,
+    std::string const& compressedVertexDataFilePath,
+    std::string const& indexDataFilePath,
+    std::vector<uint32_t> const& aiNumClusterVertices,
+    std::vector<uint32_t> const& aiNumClusterIndices,
+    std::vector<uint64_t> const& aiVertexBufferArrayOffsets,
+    std::vector<uint64_t> const& aiIndexBufferArrayOffsets,
+    uint32_t iIndexSize,
+    float3 const& minBounds,
+    float3 const& maxBounds,
+    uint32_t iClusterIndex)
+{
+    assert(iClusterIndex < aiVertexBufferArrayOffsets.size());
+
+    std::vector<CompressedMeshVertexFormat> aCompressedVertices(aiNumClusterVertices[iClusterIndex]);
+    FILE* fp = fopen(compressedVertexDataFilePath.c_str(), "rb");
+    uint64_t iVertexDataBufferSize = aiNumClusterVertices[iClusterIndex] * sizeof(CompressedMeshVertexFormat);
+    uint64_t iStartVertexDataOffset = sizeof(uint32_t) + sizeof(uint32_t) * aiNumClusterVertices.size() + aiVertexBufferArrayOffsets[iClusterIndex] * sizeof(CompressedMeshVertexFormat);
+    seekFile(fp, iStartVertexDataOffset);
+    fread(aCompressedVertices.data(), sizeof(char), iVertexDataBufferSize, fp);
+    fclose(fp);
+
+    aClusterTriangleVertices.resize(aCompressedVertices.size());
+    for(uint32_t i = 0; i < static_cast<uint32_t>(aCompressedVertices.size()); i++)
+    {
+        aClusterTriangleVertices[i] = decodeCompressedMeshVertex(aCompressedVertices[i], minBounds, maxBounds);
+    }
+
+    std::vector<uint8_t> acIndexData;
+    loadMeshClusterTriangleIndexDataChunk(
+        acIndexData,
+        indexDataFilePath,
+        aiNumClusterIndices,
+        aiIndexBufferArrayOffsets,
+        iIndexSize,
+        iClusterIndex);
+    aiClusterTriangleVertexIndices.resize(aiNumClusterIndices[iClusterIndex]);
+    if(iIndexSize == sizeof(uint8_t))
+    {
+        std::copy(acIndexData.begin(), acIndexData.end(), aiClusterTriangleVertexIndices.begin());
+    }
+    else
+    {
+        memcpy(aiClusterTriangleVertexIndices.data(), acIndexData.data(), acIndexData.size());
+    }
+}
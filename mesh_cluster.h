@@ -9,6 +9,11 @@
 #define MAX_ASSOCIATED_GROUPS       2
 #define MAX_PARENT_CLUSTERS         128
 
+// set on the cluster count of the triangle index data when the cluster local indices are stored as uint8_t
+//      this is an on-disk format change, readers that predate the flag take the flagged word as the cluster count
+//      files with uint32_t indices don't carry the flag and read the same as before
+#define MESH_CLUSTER_PACKED_INDEX_FLAG  0x80000000
+
 /*
 **
 */
@@ -223,7 +228,46 @@ struct ConvertedMeshVertexFormat
     }
 };
 
-void saveMeshClusterTriangleData(
+// 16 byte streamed vertex, decoded with the bounds of the cluster it belongs to
+//      position: 16 bit unorm per axis between the cluster's mMinBounds and mMaxBounds, error <= (max - min) / 131070 per axis plus float rounding
+//      normal: octahedral, 16 bit snorm per component, error < 0.005 degrees
+//      uv: half float, relative error <= 2^-11 for |uv| in [2^-14, 65504], absolute error <= 2^-25 below that
+struct CompressedMeshVertexFormat
+{
+    uint16_t        maiPosition[3];
+    uint16_t        miPadding;
+    int16_t         maiNormal[2];
+    uint16_t        maiUV[2];
+};
+
+CompressedMeshVertexFormat encodeCompressedMeshVertex(
+    MeshVertexFormat const& vertex,
+    float3 const& minBounds,
+    float3 const& maxBounds);
+
+ConvertedMeshVertexFormat decodeCompressedMeshVertex(
+    CompressedMeshVertexFormat const& vertex,
+    float3 const& minBounds,
+    float3 const& maxBounds);
+
+// unified vertices and cluster local indices of all the clusters, ordered by cluster index
+//      cluster i owns [offset[i], offset[i + 1]) of the vertices and of the indices, the offsets are in elements
+//      indices are uint8_t (index size 1) when every cluster has at most 256 vertices, uint32_t otherwise
+//      compressed vertices are empty unless they were asked for
+struct MeshClusterTriangleData
+{
+    std::vector<uint32_t>                       maiNumClusterVertices;
+    std::vector<uint32_t>                       maiNumClusterIndices;
+    std::vector<uint64_t>                       maiVertexOffsets;
+    std::vector<uint64_t>                       maiIndexOffsets;
+    std::vector<ConvertedMeshVertexFormat>      maVertices;
+    std::vector<CompressedMeshVertexFormat>     maCompressedVertices;
+    std::vector<uint8_t>                        macIndices;
+    uint32_t                                    miIndexSize = sizeof(uint32_t);
+};
+
+void buildMeshClusterTriangleData(
+    MeshClusterTriangleData& triangleData,
     std::vector<uint8_t> const& aVertexPositionBuffer,
     std::vector<uint8_t> const& aVertexNormalBuffer,
     std::vector<uint8_t> const& aVertexUVBuffer,
@@ -231,9 +275,17 @@ void saveMeshClusterTriangleData(
     std::vector<uint8_t> const& aiTriangleNormalIndexBuffer,
     std::vector<uint8_t> const& aiTriangleUVIndexBuffer,
     std::vector<MeshCluster*> const& apMeshClusters,
+    bool bCompressedVertices);
+
+// output file path is the combined vertex and index file, it's skipped when empty
+//      compressed vertex data has the same layout as the vertex data file with CompressedMeshVertexFormat vertices, it's skipped when empty
+//      uint8_t indices are flagged with MESH_CLUSTER_PACKED_INDEX_FLAG on the index count word
+void saveMeshClusterTriangleData(
+    MeshClusterTriangleData const& triangleData,
     std::string const& outputFilePath,
     std::string const& outputVertexDataFilePath,
-    std::string const& outputIndexDataFilePath);
+    std::string const& outputIndexDataFilePath,
+    std::string const& outputCompressedVertexDataFilePath);
 
 void loadMeshClusterTriangleData(
     std::string const& filePath,
@@ -245,9 +297,19 @@ void loadMeshClusterTriangleDataTableOfContent(
     std::vector<uint32_t>& aiNumClusterIndices,
     std::vector<uint64_t>& aiVertexBufferArrayOffsets,
     std::vector<uint64_t>& aiIndexBufferArrayOffset,
+    uint32_t& iIndexSize,
     std::string const& vertexDataFilePath,
     std::string const& indexDataFilePath);
 
+// index data as it's stored in the file, iIndexSize bytes per index
+void loadMeshClusterTriangleIndexDataChunk(
+    std::vector<uint8_t>& acClusterIndexData,
+    std::string const& indexDataFilePath,
+    std::vector<uint32_t> const& aiNumClusterIndices,
+    std::vector<uint64_t> const& aiIndexBufferArrayOffsets,
+    uint32_t iIndexSize,
+    uint32_t iClusterIndex);
+
 void loadMeshClusterTriangleDataChunk(
     std::vector<ConvertedMeshVertexFormat>& aClusterTriangleVertices,
     std::vector<uint32_t>& aiClusterTriangleVertexIndices,
@@ -257,5 +319,21 @@ void loadMeshClusterTriangleDataChunk(
     std::vector<uint32_t> const& aiNumClusterIndices,
     std::vector<uint64_t> const& aiVertexBufferArrayOffsets,
     std::vector<uint64_t> const& aiIndexBufferArrayOffsets,
+    uint32_t iIndexSize,
+    uint32_t iClusterIndex);
+
+// the table of content of the vertex data file works for the compressed one too, vertices come back decoded
+void loadCompressedMeshClusterTriangleDataChunk(
+    std::vector<ConvertedMeshVertexFormat>& aClusterTriangleVertices,
+    std::vector<uint32_t>& aiClusterTriangleVertexIndices,
+    std::string const& compressedVertexDataFilePath,
+    std::string const& indexDataFilePath,
+    std::vector<uint32_t> const& aiNumClusterVertices,
+    std::vector<uint32_t> const& aiNumClusterIndices,
+    std::vector<uint64_t> const& aiVertexBufferArrayOffsets,
+    std::vector<uint64_t> const& aiIndexBufferArrayOffsets,
+    uint32_t iIndexSize,
+    float3 const& minBounds,
+    float3 const& maxBounds,
     uint32_t iClusterIndex);
 
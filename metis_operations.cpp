@@ -1,12 +1,18 @@
 #include "tiny_obj_loader.h"
 #include "metis_operations.h"
 
-#include "test.h"
+#define IDXTYPEWIDTH            32
+#define REALTYPEWIDTH           32
+#include "metis.h"
+
+#include "compute_backend.h"
 #include "LogPrint.h"
+#include "task_scheduler.h"
 
-#include <atomic>
+#include <algorithm>
 #include <cassert>
-#include <thread>
+#include <cinttypes>
+#include <chrono>
 
 /*
 **
@@ -380,6 +386,138 @@ void buildMETISMeshFile2(
     fclose(fp);
 }
 
+/*
+**
+*/
+bool partitionMETISMesh(
+    std::vector<uint32_t>& aiElementPartitions,
+    std::vector<uint32_t> const& aiTrianglePositionIndices,
+    uint32_t iNumPartitions,
+    bool bMinimizeVolume,
+    bool bContiguous,
+    int32_t iLoadImbalance)
+{
+    static_assert(sizeof(idx_t) == sizeof(uint32_t), "metis index type needs to be 32 bit");
+
+    uint32_t iNumElements = static_cast<uint32_t>(aiTrianglePositionIndices.size() / 3);
+    aiElementPartitions.resize(iNumElements);
+    if(iNumPartitions <= 1 || iNumElements == 0)
+    {
+        std::fill(aiElementPartitions.begin(), aiElementPartitions.end(), 0);
+        return true;
+    }
+
+    uint32_t iNumNodes = 0;
+    for(auto const& iIndex : aiTrianglePositionIndices)
+    {
+        iNumNodes = std::max(iNumNodes, iIndex + 1);
+    }
+
+    // all elements are triangles, element i spans indices [3i, 3i + 3)
+    std::vector<idx_t> aiElementStart(iNumElements + 1);
+    for(uint32_t i = 0; i <= iNumElements; i++)
+    {
+        aiElementStart[i] = static_cast<idx_t>(i * 3);
+    }
+
+    idx_t aiOptions[METIS_NOPTIONS];
+    METIS_SetDefaultOptions(aiOptions);
+    aiOptions[METIS_OPTION_OBJTYPE] = bMinimizeVolume ? METIS_OBJTYPE_VOL : METIS_OBJTYPE_CUT;
+    aiOptions[METIS_OPTION_CONTIG] = bContiguous ? 1 : 0;
+    if(iLoadImbalance > 0)
+    {
+        aiOptions[METIS_OPTION_UFACTOR] = static_cast<idx_t>(iLoadImbalance);
+    }
+
+    idx_t iMetisNumElements = static_cast<idx_t>(iNumElements);
+    idx_t iMetisNumNodes = static_cast<idx_t>(iNumNodes);
+    idx_t iNumCommon = 2;
+    idx_t iMetisNumPartitions = static_cast<idx_t>(iNumPartitions);
+    idx_t iObjectiveValue = 0;
+    std::vector<idx_t> aiNodePartitions(iNumNodes);
+
+    // metis doesn't write to the element index array, the pointers are only non-const in its signature
+    int iRet = METIS_PartMeshDual(
+        &iMetisNumElements,
+        &iMetisNumNodes,
+        aiElementStart.data(),
+        reinterpret_cast<idx_t*>(const_cast<uint32_t*>(aiTrianglePositionIndices.data())),
+        nullptr,
+        nullptr,
+        &iNumCommon,
+        &iMetisNumPartitions,
+        nullptr,
+        aiOptions,
+        &iObjectiveValue,
+        reinterpret_cast<idx_t*>(aiElementPartitions.data()),
+        aiNodePartitions.data());
+
+    // contiguous partitioning fails on meshes with disconnected parts, try again without it
+    if(iRet != METIS_OK && bContiguous)
+    {
+        DEBUG_PRINTF("metis mesh partition failed with contiguous option (%d), retrying without it\n", iRet);
+        return partitionMETISMesh(
+            aiElementPartitions,
+            aiTrianglePositionIndices,
+            iNumPartitions,
+            bMinimizeVolume,
+            false,
+            iLoadImbalance);
+    }
+
+    return (iRet == METIS_OK);
+}
+
+/*
+**
+*/
+bool partitionMETISGraph(
+    std::vector<uint32_t>& aiVertexPartitions,
+    std::vector<uint32_t> const& aiAdjacencyStart,
+    std::vector<uint32_t> const& aiAdjacency,
+    std::vector<uint32_t> const& aiAdjacencyWeights,
+    uint32_t iNumPartitions)
+{
+    static_assert(sizeof(idx_t) == sizeof(uint32_t), "metis index type needs to be 32 bit");
+
+    assert(aiAdjacencyStart.size() > 0);
+    assert(aiAdjacency.size() == aiAdjacencyWeights.size());
+
+    uint32_t iNumVertices = static_cast<uint32_t>(aiAdjacencyStart.size() - 1);
+    aiVertexPartitions.resize(iNumVertices);
+    if(iNumPartitions <= 1 || iNumVertices == 0)
+    {
+        std::fill(aiVertexPartitions.begin(), aiVertexPartitions.end(), 0);
+        return true;
+    }
+
+    idx_t aiOptions[METIS_NOPTIONS];
+    METIS_SetDefaultOptions(aiOptions);
+
+    idx_t iMetisNumVertices = static_cast<idx_t>(iNumVertices);
+    idx_t iNumConstraints = 1;
+    idx_t iMetisNumPartitions = static_cast<idx_t>(iNumPartitions);
+    idx_t iEdgeCut = 0;
+
+    // metis doesn't write to the graph arrays, the pointers are only non-const in its signature
+    int iRet = METIS_PartGraphKway(
+        &iMetisNumVertices,
+        &iNumConstraints,
+        reinterpret_cast<idx_t*>(const_cast<uint32_t*>(aiAdjacencyStart.data())),
+        reinterpret_cast<idx_t*>(const_cast<uint32_t*>(aiAdjacency.data())),
+        nullptr,
+        nullptr,
+        reinterpret_cast<idx_t*>(const_cast<uint32_t*>(aiAdjacencyWeights.data())),
+        &iMetisNumPartitions,
+        nullptr,
+        nullptr,
+        aiOptions,
+        &iEdgeCut,
+        reinterpret_cast<idx_t*>(aiVertexPartitions.data()));
+
+    return (iRet == METIS_OK);
+}
+
 /*
 **
 */
@@ -423,110 +561,85 @@ void buildMETISGraphFile(
     if(bUseCUDA)
     {
         auto start0 = std::chrono::high_resolution_clock::now();
-        buildClusterAdjacencyCUDA(
+        getComputeBackend().mpfnBuildClusterAdjacency(
             aaiNumAdjacentVertices,
             aaVertexPositions,
             bOnlyEdgeAdjacent);
         auto end0 = std::chrono::high_resolution_clock::now();
         uint64_t iSeconds0 = std::chrono::duration_cast<std::chrono::seconds>(end0 - start0).count();
-        DEBUG_PRINTF("took %lld seconds to build all cluster adjacency list\n", iSeconds0);
+        DEBUG_PRINTF("took %" PRIu64 " seconds to build all cluster adjacency list\n", iSeconds0);
     }
     else
     {
-        uint32_t const kiMaxThreads = 8;
-        std::unique_ptr<std::thread> apThreads[kiMaxThreads];
-        std::atomic<uint32_t> iCurrCluster{ 0 };
-        for(uint32_t iThread = 0; iThread < kiMaxThreads; iThread++)
-        {
-            apThreads[iThread] = std::make_unique<std::thread>(
-                [&iCurrCluster,
-                &aaiNumAdjacentVertices,
-                aaVertexPositions,
-                iNumClusters,
-                start,
-                bOnlyEdgeAdjacent,
-                iThread]()
-                {
-                    for(;;)
-                    {
-                        auto start0 = std::chrono::high_resolution_clock::now();
-
-                        uint32_t iThreadCluster = iCurrCluster.fetch_add(1);
-                        if(iThreadCluster >= iNumClusters)
-                        {
-                            break;
-                        }
+        parallelFor(
+            iNumClusters,
+            1,
+            [&aaiNumAdjacentVertices,
+            &aaVertexPositions,
+            iNumClusters,
+            start,
+            bOnlyEdgeAdjacent](uint32_t iThreadCluster, uint32_t iSlot)
+            {
+                auto start0 = std::chrono::high_resolution_clock::now();
 
-                        std::vector<float3> const& aVertexPositions = aaVertexPositions[iThreadCluster];
-                        float3 const* paVertexPositions = aaVertexPositions[iThreadCluster].data();
+                std::vector<float3> const& aVertexPositions = aaVertexPositions[iThreadCluster];
+                float3 const* paVertexPositions = aaVertexPositions[iThreadCluster].data();
 
-                        uint32_t iNumVertexPositions = static_cast<uint32_t>(aaVertexPositions[iThreadCluster].size());
-                        for(uint32_t iCheckCluster = iThreadCluster + 1; iCheckCluster < iNumClusters; iCheckCluster++)
-                        {
-                            uint32_t iNumAdjacentVertices = 0;
-                            std::vector<float3> const& aCheckVertexPositions = aaVertexPositions[iCheckCluster];
-                            float3 const* paCheckVertexPositions = aaVertexPositions[iCheckCluster].data();
+                uint32_t iNumVertexPositions = static_cast<uint32_t>(aaVertexPositions[iThreadCluster].size());
+                for(uint32_t iCheckCluster = iThreadCluster + 1; iCheckCluster < iNumClusters; iCheckCluster++)
+                {
+                    uint32_t iNumAdjacentVertices = 0;
+                    std::vector<float3> const& aCheckVertexPositions = aaVertexPositions[iCheckCluster];
+                    float3 const* paCheckVertexPositions = aaVertexPositions[iCheckCluster].data();
 
-                            uint32_t iNumCheckVertexPositions = static_cast<uint32_t>(aCheckVertexPositions.size());
+                    uint32_t iNumCheckVertexPositions = static_cast<uint32_t>(aCheckVertexPositions.size());
 
-                            for(uint32_t iVert = 0; iVert < iNumVertexPositions; iVert++)
+                    for(uint32_t iVert = 0; iVert < iNumVertexPositions; iVert++)
+                    {
+                        for(uint32_t iCheckVert = 0; iCheckVert < iNumCheckVertexPositions; iCheckVert++)
+                        {
+                            //float fLength = lengthSquared(aVertexPositions[iVert] - aCheckVertexPositions[iCheckVert]);
+                            float fLength = lengthSquared(paVertexPositions[iVert] - paCheckVertexPositions[iCheckVert]);
+                            if(fLength <= 1.0e-8f)
                             {
-                                for(uint32_t iCheckVert = 0; iCheckVert < iNumCheckVertexPositions; iCheckVert++)
+                                if(bOnlyEdgeAdjacent && iNumAdjacentVertices >= 2)
                                 {
-                                    //float fLength = lengthSquared(aVertexPositions[iVert] - aCheckVertexPositions[iCheckVert]);
-                                    float fLength = lengthSquared(paVertexPositions[iVert] - paCheckVertexPositions[iCheckVert]);
-                                    if(fLength <= 1.0e-8f)
-                                    {
-                                        if(bOnlyEdgeAdjacent && iNumAdjacentVertices >= 2)
-                                        {
-                                            break;
-                                        }
-                                        else
-                                        {
-                                            ++iNumAdjacentVertices;
-                                            break;
-                                        }
-
-                                        //++iNumAdjacentVertices;
-                                        //break;
-                                    }
+                                    break;
+                                }
+                                else
+                                {
+                                    ++iNumAdjacentVertices;
+                                    break;
                                 }
-                            }
 
-                            aaiNumAdjacentVertices[iThreadCluster][iCheckCluster] = iNumAdjacentVertices;
-                            aaiNumAdjacentVertices[iCheckCluster][iThreadCluster] = iNumAdjacentVertices;
+                                //++iNumAdjacentVertices;
+                                //break;
+                            }
+                        }
+                    }
 
-                        }   // for check cluster = cluster + 1 to num clusters
+                    aaiNumAdjacentVertices[iThreadCluster][iCheckCluster] = iNumAdjacentVertices;
+                    aaiNumAdjacentVertices[iCheckCluster][iThreadCluster] = iNumAdjacentVertices;
 
-                        auto end = std::chrono::high_resolution_clock::now();
-                        uint64_t iMilliSeconds = std::chrono::duration_cast<std::chrono::milliseconds>(end - start0).count();
-                        uint64_t iSeconds = std::chrono::duration_cast<std::chrono::seconds>(end - start).count();
-                        if(iCurrCluster % 100 == 0)
-                        {
-                            DEBUG_PRINTF("thread %d took %lld milliseconds (total %lld seconds) to build adjacency for cluster %d out of %d\n",
-                                iThread,
-                                iMilliSeconds,
-                                iSeconds,
-                                iCurrCluster.load(),
-                                iNumClusters);
-                        }
+                }   // for check cluster = cluster + 1 to num clusters
 
-                    }   // for ;;
+                auto end = std::chrono::high_resolution_clock::now();
+                uint64_t iMilliSeconds = std::chrono::duration_cast<std::chrono::milliseconds>(end - start0).count();
+                uint64_t iSeconds = std::chrono::duration_cast<std::chrono::seconds>(end - start).count();
+                if(iThreadCluster % 100 == 0)
+                {
+                    DEBUG_PRINTF("worker slot %d took %" PRIu64 " milliseconds (total %" PRIu64 " seconds) to build adjacency for cluster %d out of %d\n",
+                        iSlot,
+                        iMilliSeconds,
+                        iSeconds,
+                        iThreadCluster,
+                        iNumClusters);
                 }
-            );
-        }
-
-        for(uint32_t iThread = 0; iThread < kiMaxThreads; iThread++)
-        {
-            if(apThreads[iThread]->joinable())
-            {
-                apThreads[iThread]->join();
-            }
-        }
+            });
 
         auto end = std::chrono::high_resolution_clock::now();
         uint64_t iSeconds = std::chrono::duration_cast<std::chrono::seconds>(end - start).count();
-        DEBUG_PRINTF("took %lld seconds to build all cluster adjacency list\n", iSeconds);
+        DEBUG_PRINTF("took %" PRIu64 " seconds to build all cluster adjacency list\n", iSeconds);
 
     }   // bUseCUDA
 
@@ -591,7 +704,7 @@ void buildMETISGraphFile(
         uint64_t iMilliSeconds = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
         if(iCluster % 100 == 0)
         {
-            DEBUG_PRINTF("took %d milliseconds to build adjacency for cluster %d out of %d\n", iMilliSeconds, iCluster, iNumClusters);
+            DEBUG_PRINTF("took %" PRIu64 " milliseconds to build adjacency for cluster %d out of %d\n", iMilliSeconds, iCluster, iNumClusters);
         }
 
     }   // for cluster = 0 to num clusters
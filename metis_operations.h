@@ -31,6 +31,23 @@ void buildMETISMeshFile2(
     std::string const& outputFilePath,
     std::vector<uint32_t> const& aiTrianglePositionIndices);
 
+// partition triangles (elements sharing an edge are adjacent) in memory, returns the partition for each triangle
+bool partitionMETISMesh(
+    std::vector<uint32_t>& aiElementPartitions,
+    std::vector<uint32_t> const& aiTrianglePositionIndices,
+    uint32_t iNumPartitions,
+    bool bMinimizeVolume,
+    bool bContiguous,
+    int32_t iLoadImbalance);
+
+// partition graph given in CSR form (adjacency start offsets, adjacent vertices, edge weights), returns the partition for each vertex
+bool partitionMETISGraph(
+    std::vector<uint32_t>& aiVertexPartitions,
+    std::vector<uint32_t> const& aiAdjacencyStart,
+    std::vector<uint32_t> const& aiAdjacency,
+    std::vector<uint32_t> const& aiAdjacencyWeights,
+    uint32_t iNumPartitions);
+
 void buildMETISGraphFile(
     std::string const& outputFilePath,
     std::vector<std::vector<float3>> const& aaVertexPositions,
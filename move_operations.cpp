@@ -1,11 +1,14 @@
 #include "move_operations.h"
 #include <assert.h>
 
+#include <algorithm>
+#include <deque>
 #include <sstream>
 #include <map>
 
 #include "obj_helper.h"
 #include "LogPrint.h"
+#include "utils.h"
 
 /*
 **
@@ -132,638 +135,385 @@ void addTriangle(
 /*
 **
 */
-bool moveTriangles(
+void rebalanceClusters(
     std::vector<std::vector<float3>>& aaVertexPositions,
     std::vector<std::vector<float3>>& aaVertexNormals,
     std::vector<std::vector<float2>>& aaVertexUVs,
     std::vector<std::vector<uint32_t>>& aaiVertexPositionIndices,
     std::vector<std::vector<uint32_t>>& aaiVertexNormalIndices,
     std::vector<std::vector<uint32_t>>& aaiVertexUVIndices,
-    uint32_t iSrcCluster,
-    uint32_t iMaxTriangleVertexCount)
+    uint32_t iMaxTriangleVertexCount,
+    uint32_t iMinTriangleVertexCount)
 {
-    std::vector<std::vector<float3>> aaNewVertexPositions(2);
-    std::vector<std::vector<float3>> aaNewVertexNormals(2);
-    std::vector<std::vector<float2>> aaNewVertexUVs(2);
-    std::vector<std::vector<uint32_t>> aaiNewVertexPositionIndices(2);
-    std::vector<std::vector<uint32_t>> aaiNewVertexNormalIndices(2);
-    std::vector<std::vector<uint32_t>> aaiNewVertexUVIndices(2);
-
-    assert(aaiVertexPositionIndices[iSrcCluster].size() > iMaxTriangleVertexCount);
-    uint32_t iVerticesToMove = static_cast<uint32_t>(aaiVertexPositionIndices[iSrcCluster].size()) - iMaxTriangleVertexCount;
-    uint32_t iFinishDestClusterSize = static_cast<uint32_t>(aaNewVertexPositions[0].size()) + iVerticesToMove;
-
-    std::vector<uint32_t> aiSharedEdge(aaiVertexPositionIndices[iSrcCluster].size());
-    
-    uint32_t iNumAddedTriangleVertices = 0;
-    uint32_t iDestCluster = 0;
-    for(iDestCluster = 0; iDestCluster < static_cast<uint32_t>(aaiVertexPositionIndices.size() + 1); iDestCluster++)
+    // same squared distance addTriangle uses to share vertices
+    float const kfWeldDistance = sqrtf(1.0e-7f);
+
+    uint32_t const kiMaxTriangles = iMaxTriangleVertexCount / 3;
+    uint32_t const kiMinTriangles = iMinTriangleVertexCount / 3;
+    uint32_t iNumClusters = static_cast<uint32_t>(aaiVertexPositionIndices.size());
+
+    // all the positions, triangles remember the cluster and index offset they came from
+    std::vector<uint32_t> aiPositionStart(iNumClusters + 1, 0);
+    std::vector<uint32_t> aiTriangleSrcCluster;
+    std::vector<uint32_t> aiTriangleSrcOffset;
+    for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
     {
-        if(iDestCluster == iSrcCluster)
+        aiPositionStart[iCluster + 1] = aiPositionStart[iCluster] + static_cast<uint32_t>(aaVertexPositions[iCluster].size());
+        for(uint32_t iTri = 0; iTri < static_cast<uint32_t>(aaiVertexPositionIndices[iCluster].size()); iTri += 3)
         {
-            continue;
+            aiTriangleSrcCluster.push_back(iCluster);
+            aiTriangleSrcOffset.push_back(iTri);
         }
+    }
+    uint32_t iNumPositions = aiPositionStart[iNumClusters];
+    uint32_t iNumTriangles = static_cast<uint32_t>(aiTriangleSrcCluster.size());
 
-        if(iDestCluster == aaiVertexPositionIndices.size())
-        {
-            // need new list 
-
-            aaVertexPositions.push_back(std::vector<float3>());
-            aaVertexNormals.push_back(std::vector<float3>());
-            aaVertexUVs.push_back(std::vector<float2>());
-            aaiVertexPositionIndices.push_back(std::vector<uint32_t>());
-            aaiVertexNormalIndices.push_back(std::vector<uint32_t>());
-            aaiVertexUVIndices.push_back(std::vector<uint32_t>());
-
-            iDestCluster = static_cast<uint32_t>(aaVertexPositions.size() - 1);
-
-            // add first triangle
-            aaNewVertexPositions[0].push_back(aaVertexPositions[iSrcCluster][aaiVertexPositionIndices[iSrcCluster][0]]);
-            aaNewVertexPositions[0].push_back(aaVertexPositions[iSrcCluster][aaiVertexPositionIndices[iSrcCluster][1]]);
-            aaNewVertexPositions[0].push_back(aaVertexPositions[iSrcCluster][aaiVertexPositionIndices[iSrcCluster][2]]);
-
-            aaNewVertexNormals[0].push_back(aaVertexNormals[iSrcCluster][aaiVertexNormalIndices[iSrcCluster][0]]);
-            aaNewVertexNormals[0].push_back(aaVertexNormals[iSrcCluster][aaiVertexNormalIndices[iSrcCluster][1]]);
-            aaNewVertexNormals[0].push_back(aaVertexNormals[iSrcCluster][aaiVertexNormalIndices[iSrcCluster][2]]);
-
-            aaNewVertexUVs[0].push_back(aaVertexUVs[iSrcCluster][aaiVertexUVIndices[iSrcCluster][0]]);
-            aaNewVertexUVs[0].push_back(aaVertexUVs[iSrcCluster][aaiVertexUVIndices[iSrcCluster][1]]);
-            aaNewVertexUVs[0].push_back(aaVertexUVs[iSrcCluster][aaiVertexUVIndices[iSrcCluster][2]]);
-
-            aaiNewVertexPositionIndices[0].push_back(0);
-            aaiNewVertexPositionIndices[0].push_back(1);
-            aaiNewVertexPositionIndices[0].push_back(2);
-
-            aaiNewVertexNormalIndices[0].push_back(0);
-            aaiNewVertexNormalIndices[0].push_back(1);
-            aaiNewVertexNormalIndices[0].push_back(2);
+    std::vector<float3> aAllPositions;
+    aAllPositions.reserve(iNumPositions);
+    for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
+    {
+        aAllPositions.insert(aAllPositions.end(), aaVertexPositions[iCluster].begin(), aaVertexPositions[iCluster].end());
+    }
 
-            aaiNewVertexUVIndices[0].push_back(0);
-            aaiNewVertexUVIndices[0].push_back(1);
-            aaiNewVertexUVIndices[0].push_back(2);
-        }
-        else if(aaiVertexPositionIndices[iDestCluster].size() + iVerticesToMove <= iMaxTriangleVertexCount)
+    // weld the positions so the triangles of different clusters see each other
+    std::vector<uint32_t> aiWeldedPositions(iNumPositions);
+    {
+        std::vector<std::pair<uint64_t, uint32_t>> aKeyIndices;
+        float fCellSize = getSpatialHashCellSize(aAllPositions.data(), iNumPositions, kfWeldDistance);
+        buildSpatialHashIndex(
+            aKeyIndices,
+            aAllPositions.data(),
+            iNumPositions,
+            fCellSize);
+        for(uint32_t iPos = 0; iPos < iNumPositions; iPos++)
         {
-            aaNewVertexPositions[0].insert(aaNewVertexPositions[0].end(), aaVertexPositions[iDestCluster].begin(), aaVertexPositions[iDestCluster].end());
-            aaNewVertexNormals[0].insert(aaNewVertexNormals[0].end(), aaVertexNormals[iDestCluster].begin(), aaVertexNormals[iDestCluster].end());
-            aaNewVertexUVs[0].insert(aaNewVertexUVs[0].end(), aaVertexUVs[iDestCluster].begin(), aaVertexUVs[iDestCluster].end());
+            aiWeldedPositions[iPos] = findSpatialHashMatch(
+                aKeyIndices,
+                aAllPositions.data(),
+                aAllPositions[iPos],
+                fCellSize,
+                kfWeldDistance);
+        }
+    }
 
-            aaiNewVertexPositionIndices[0].insert(aaiNewVertexPositionIndices[0].end(), aaiVertexPositionIndices[iDestCluster].begin(), aaiVertexPositionIndices[iDestCluster].end());
-            aaiNewVertexNormalIndices[0].insert(aaiNewVertexNormalIndices[0].end(), aaiVertexNormalIndices[iDestCluster].begin(), aaiVertexNormalIndices[iDestCluster].end());
-            aaiNewVertexUVIndices[0].insert(aaiNewVertexUVIndices[0].end(), aaiVertexUVIndices[iDestCluster].begin(), aaiVertexUVIndices[iDestCluster].end());
+    // triangles touching each welded position
+    std::vector<uint32_t> aiTrianglePositions(iNumTriangles * 3);
+    std::vector<uint32_t> aiPositionTriangleStart(iNumPositions + 1, 0);
+    std::vector<uint32_t> aiPositionTriangles(iNumTriangles * 3);
+    for(uint32_t iTriangle = 0; iTriangle < iNumTriangles; iTriangle++)
+    {
+        uint32_t iCluster = aiTriangleSrcCluster[iTriangle];
+        for(uint32_t i = 0; i < 3; i++)
+        {
+            uint32_t iPos = aiWeldedPositions[aiPositionStart[iCluster] + aaiVertexPositionIndices[iCluster][aiTriangleSrcOffset[iTriangle] + i]];
+            aiTrianglePositions[iTriangle * 3 + i] = iPos;
+            aiPositionTriangleStart[iPos + 1] += 1;
         }
-        else
+    }
+    for(uint32_t iPos = 0; iPos < iNumPositions; iPos++)
+    {
+        aiPositionTriangleStart[iPos + 1] += aiPositionTriangleStart[iPos];
+    }
+    {
+        std::vector<uint32_t> aiFill(aiPositionTriangleStart.begin(), aiPositionTriangleStart.end() - 1);
+        for(uint32_t i = 0; i < iNumTriangles * 3; i++)
         {
-            if(iDestCluster >= static_cast<uint32_t>(aaiVertexPositionIndices.size()) - 1)
-            {
-                aaVertexPositions.push_back(std::vector<float3>());
-                aaVertexNormals.push_back(std::vector<float3>());
-                aaVertexUVs.push_back(std::vector<float2>());
-                aaiVertexPositionIndices.push_back(std::vector<uint32_t>());
-                aaiVertexNormalIndices.push_back(std::vector<uint32_t>());
-                aaiVertexUVIndices.push_back(std::vector<uint32_t>());
-
-                iDestCluster = static_cast<uint32_t>(aaVertexPositions.size() - 1);
-
-                // add first triangle
-                aaNewVertexPositions[0].push_back(aaVertexPositions[iSrcCluster][aaiVertexPositionIndices[iSrcCluster][0]]);
-                aaNewVertexPositions[0].push_back(aaVertexPositions[iSrcCluster][aaiVertexPositionIndices[iSrcCluster][1]]);
-                aaNewVertexPositions[0].push_back(aaVertexPositions[iSrcCluster][aaiVertexPositionIndices[iSrcCluster][2]]);
-
-                aaNewVertexNormals[0].push_back(aaVertexNormals[iSrcCluster][aaiVertexNormalIndices[iSrcCluster][0]]);
-                aaNewVertexNormals[0].push_back(aaVertexNormals[iSrcCluster][aaiVertexNormalIndices[iSrcCluster][1]]);
-                aaNewVertexNormals[0].push_back(aaVertexNormals[iSrcCluster][aaiVertexNormalIndices[iSrcCluster][2]]);
-
-                aaNewVertexUVs[0].push_back(aaVertexUVs[iSrcCluster][aaiVertexUVIndices[iSrcCluster][0]]);
-                aaNewVertexUVs[0].push_back(aaVertexUVs[iSrcCluster][aaiVertexUVIndices[iSrcCluster][1]]);
-                aaNewVertexUVs[0].push_back(aaVertexUVs[iSrcCluster][aaiVertexUVIndices[iSrcCluster][2]]);
-
-                aaiNewVertexPositionIndices[0].push_back(0);
-                aaiNewVertexPositionIndices[0].push_back(1);
-                aaiNewVertexPositionIndices[0].push_back(2);
-
-                aaiNewVertexNormalIndices[0].push_back(0);
-                aaiNewVertexNormalIndices[0].push_back(1);
-                aaiNewVertexNormalIndices[0].push_back(2);
-
-                aaiNewVertexUVIndices[0].push_back(0);
-                aaiNewVertexUVIndices[0].push_back(1);
-                aaiNewVertexUVIndices[0].push_back(2);
-            }
+            aiPositionTriangles[aiFill[aiTrianglePositions[i]]++] = i / 3;
         }
+    }
 
-        memset(aiSharedEdge.data(), 0, aiSharedEdge.size() * sizeof(uint32_t));
+    // current owner of each triangle and the triangles of each cluster
+    std::vector<uint32_t> aiTriangleClusters(aiTriangleSrcCluster);
+    std::vector<std::vector<uint32_t>> aaiClusterTriangles(iNumClusters);
+    for(uint32_t iTriangle = 0; iTriangle < iNumTriangles; iTriangle++)
+    {
+        aaiClusterTriangles[aiTriangleClusters[iTriangle]].push_back(iTriangle);
+    }
 
-        // check for adjacent edge and add to new cluster if found
-        iNumAddedTriangleVertices = 0;
-        bool bResetLoop = false;
-        uint32_t iNumTrianglesToCheck = static_cast<uint32_t>(aaiNewVertexPositionIndices[0].size());
-        for(uint32_t iTri = 0; iTri < iNumTrianglesToCheck; iTri += 3)
+    std::vector<uint32_t> aiClusterChanged(iNumClusters, 0);
+    std::vector<uint32_t> aiClusterQueued(iNumClusters, 0);
+    std::deque<uint32_t> aiWorklist;
+    auto queueCluster = [&aaiClusterTriangles,
+        &aiClusterQueued,
+        &aiWorklist,
+        kiMaxTriangles,
+        kiMinTriangles](uint32_t iCluster)
+    {
+        uint32_t iNumClusterTriangles = static_cast<uint32_t>(aaiClusterTriangles[iCluster].size());
+        bool bOutOfRange = (iNumClusterTriangles > kiMaxTriangles) || (iNumClusterTriangles > 0 && iNumClusterTriangles <= kiMinTriangles);
+        if(bOutOfRange && aiClusterQueued[iCluster] == 0)
         {
-            if(bResetLoop)
-            {
-                iTri = 0;
-                bResetLoop = false;
-            }
-
-            if(iNumAddedTriangleVertices >= iFinishDestClusterSize)
-            {
-                break;
-            }
+            aiClusterQueued[iCluster] = 1;
+            aiWorklist.push_back(iCluster);
+        }
+    };
 
-            for(uint32_t iCheckTri = 0; iCheckTri < static_cast<uint32_t>(aaiVertexPositionIndices[iSrcCluster].size()); iCheckTri += 3)
+    // clusters sharing positions with the given cluster, with the number of shared triangle corners
+    std::vector<std::pair<uint32_t, uint32_t>> aNeighborClusters;
+    auto getNeighborClusters = [&aaiClusterTriangles,
+        &aiTriangleClusters,
+        &aiTrianglePositions,
+        &aiPositionTriangleStart,
+        &aiPositionTriangles,
+        &aNeighborClusters](uint32_t iCluster)
+    {
+        aNeighborClusters.clear();
+        for(auto const& iTriangle : aaiClusterTriangles[iCluster])
+        {
+            for(uint32_t i = 0; i < 3; i++)
             {
-                if(iNumAddedTriangleVertices >= iFinishDestClusterSize)
-                {
-                    break;
-                }
-
-                if(aiSharedEdge[iCheckTri] == 1)
+                uint32_t iPos = aiTrianglePositions[iTriangle * 3 + i];
+                for(uint32_t j = aiPositionTriangleStart[iPos]; j < aiPositionTriangleStart[iPos + 1]; j++)
                 {
-                    continue;
-                }
-
-                float3 aSamePos[32];
-                uint32_t iNumSamePos = 0;
-                for(uint32_t i = 0; i < 3; i++)
-                {
-                    uint32_t iPos = aaiNewVertexPositionIndices[0][iTri + i];
-                    float3 const& pos = aaNewVertexPositions[0][iPos];
-                    for(uint32_t j = 0; j < 3; j++)
+                    uint32_t iNeighborCluster = aiTriangleClusters[aiPositionTriangles[j]];
+                    if(iNeighborCluster == iCluster)
                     {
-                        uint32_t iCheckPos = aaiVertexPositionIndices[iSrcCluster][iCheckTri + j];
-                        float3 const& checkPos = aaVertexPositions[iSrcCluster][iCheckPos];
-                        if(lengthSquared(checkPos - pos) <= 1.0e-7f)
+                        continue;
+                    }
+
+                    auto iter = std::find_if(
+                        aNeighborClusters.begin(),
+                        aNeighborClusters.end(),
+                        [iNeighborCluster](std::pair<uint32_t, uint32_t> const& neighbor)
                         {
-                            if(iNumSamePos < 3)
-                            {
-                                aSamePos[iNumSamePos++] = checkPos;
-                            }
-                        }
+                            return neighbor.first == iNeighborCluster;
+                        });
+                    if(iter == aNeighborClusters.end())
+                    {
+                        aNeighborClusters.push_back(std::make_pair(iNeighborCluster, 1u));
+                    }
+                    else
+                    {
+                        iter->second += 1;
                     }
                 }
+            }
+        }
+    };
 
-                // shared an edge, add to cluster
-                if(iNumSamePos >= 1)
-                {
-                    addTriangle(
-                        aaNewVertexPositions,
-                        aaNewVertexNormals,
-                        aaNewVertexUVs,
-                        aaiNewVertexPositionIndices,
-                        aaiNewVertexNormalIndices,
-                        aaiNewVertexUVIndices,
-                        aaVertexPositions,
-                        aaVertexNormals,
-                        aaVertexUVs,
-                        aaiVertexPositionIndices,
-                        aaiVertexNormalIndices,
-                        aaiVertexUVIndices,
-                        iSrcCluster,
-                        iCheckTri,
-                        0);
-
-                    aiSharedEdge[iCheckTri] = 1;
-                    bResetLoop = true;
-
-                    iNumTrianglesToCheck = static_cast<uint32_t>(aaiNewVertexPositionIndices[0].size());
-                    iNumAddedTriangleVertices += 3;
-
-                }   // if shared an edge
-
-            }   // for check tri = 0 to num src position indices
-
-
-        }   // for tri = 0 to num dest position indices
-
-        // add the rest of the src cluster triangles
-        if(iNumAddedTriangleVertices >= iFinishDestClusterSize)
+    // neighbor with the most shared corners that can take the triangles
+    auto getDestCluster = [&aaiClusterTriangles,
+        &aNeighborClusters,
+        kiMaxTriangles](uint32_t iNumTrianglesToMove)
+    {
+        uint32_t iDestCluster = UINT32_MAX;
+        uint32_t iMostShared = 0;
+        for(auto const& neighbor : aNeighborClusters)
         {
-            for(uint32_t i = 0; i < static_cast<uint32_t>(aaiVertexPositionIndices[iSrcCluster].size()); i += 3)
+            if(aaiClusterTriangles[neighbor.first].size() + iNumTrianglesToMove <= kiMaxTriangles &&
+               (neighbor.second > iMostShared || (neighbor.second == iMostShared && neighbor.first < iDestCluster)))
             {
-                if(aiSharedEdge[i] == 0)
-                {
-                    addTriangle(
-                        aaNewVertexPositions,
-                        aaNewVertexNormals,
-                        aaNewVertexUVs,
-                        aaiNewVertexPositionIndices,
-                        aaiNewVertexNormalIndices,
-                        aaiNewVertexUVIndices,
-                        aaVertexPositions,
-                        aaVertexNormals,
-                        aaVertexUVs,
-                        aaiVertexPositionIndices,
-                        aaiVertexNormalIndices,
-                        aaiVertexUVIndices,
-                        iSrcCluster,
-                        i,
-                        1);
-                }
-
-            }   // add reset of the src cluster triangle
-            
-            break;
+                iDestCluster = neighbor.first;
+                iMostShared = neighbor.second;
+            }
         }
-        else
-        {
-            aaNewVertexPositions[0].clear();
-            aaNewVertexNormals[0].clear();
-            aaNewVertexUVs[0].clear();
 
-            aaiNewVertexPositionIndices[0].clear();
-            aaiNewVertexNormalIndices[0].clear();
-            aaiNewVertexUVIndices[0].clear();
+        return iDestCluster;
+    };
 
-            iNumAddedTriangleVertices = 0;
+    // move up to the given number of source cluster triangles reachable from the seeds through shared positions
+    std::vector<uint32_t> aiTriangleVisited(iNumTriangles, 0);
+    uint32_t iVisitStamp = 0;
+    std::vector<uint32_t> aiQueue;
+    auto growRegion = [&aaiClusterTriangles,
+        &aiTriangleClusters,
+        &aiTrianglePositions,
+        &aiPositionTriangleStart,
+        &aiPositionTriangles,
+        &aiTriangleVisited,
+        &iVisitStamp,
+        &aiQueue](
+            uint32_t iSrcCluster,
+            uint32_t iDestCluster,
+            uint32_t iNumTrianglesToMove)
+    {
+        // the queue holds the seeds
+        ++iVisitStamp;
+        for(auto const& iTriangle : aiQueue)
+        {
+            aiTriangleVisited[iTriangle] = iVisitStamp;
         }
 
-    }   // for dest cluster = 0 to num clusters
-
-    // copy to destination cluster
-    aaVertexPositions[iDestCluster] = aaNewVertexPositions[0];
-    aaVertexNormals[iDestCluster] = aaNewVertexNormals[0];
-    aaVertexUVs[iDestCluster] = aaNewVertexUVs[0];
-
-    aaiVertexPositionIndices[iDestCluster] = aaiNewVertexPositionIndices[0];
-    aaiVertexNormalIndices[iDestCluster] = aaiNewVertexNormalIndices[0];
-    aaiVertexUVIndices[iDestCluster] = aaiNewVertexUVIndices[0];
-
-    // copy to source cluster
-    aaVertexPositions[iSrcCluster] = aaNewVertexPositions[1];
-    aaVertexNormals[iSrcCluster] = aaNewVertexNormals[1];
-    aaVertexUVs[iSrcCluster] = aaNewVertexUVs[1];
+        uint32_t iNumMoved = 0;
+        for(uint32_t iQueue = 0; iQueue < static_cast<uint32_t>(aiQueue.size()) && iNumMoved < iNumTrianglesToMove; iQueue++)
+        {
+            uint32_t iTriangle = aiQueue[iQueue];
+            aiTriangleClusters[iTriangle] = iDestCluster;
+            aaiClusterTriangles[iDestCluster].push_back(iTriangle);
+            ++iNumMoved;
 
-    aaiVertexPositionIndices[iSrcCluster] = aaiNewVertexPositionIndices[1];
-    aaiVertexNormalIndices[iSrcCluster] = aaiNewVertexNormalIndices[1];
-    aaiVertexUVIndices[iSrcCluster] = aaiNewVertexUVIndices[1];
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                uint32_t iPos = aiTrianglePositions[iTriangle * 3 + i];
+                for(uint32_t j = aiPositionTriangleStart[iPos]; j < aiPositionTriangleStart[iPos + 1]; j++)
+                {
+                    uint32_t iNeighborTriangle = aiPositionTriangles[j];
+                    if(aiTriangleClusters[iNeighborTriangle] == iSrcCluster && aiTriangleVisited[iNeighborTriangle] != iVisitStamp)
+                    {
+                        aiTriangleVisited[iNeighborTriangle] = iVisitStamp;
+                        aiQueue.push_back(iNeighborTriangle);
+                    }
+                }
+            }
+        }
 
-    DEBUG_PRINTF("move %d triangle vertices from cluster %d to cluster %d\n", 
-        iNumAddedTriangleVertices, 
-        iSrcCluster, 
-        iDestCluster);
+        // drop the moved triangles from the source cluster
+        auto& aiSrcTriangles = aaiClusterTriangles[iSrcCluster];
+        aiSrcTriangles.erase(
+            std::remove_if(
+                aiSrcTriangles.begin(),
+                aiSrcTriangles.end(),
+                [&aiTriangleClusters, iSrcCluster](uint32_t iTriangle)
+                {
+                    return aiTriangleClusters[iTriangle] != iSrcCluster;
+                }),
+            aiSrcTriangles.end());
 
-    assert(aaiVertexPositionIndices.size() == aaiVertexNormalIndices.size());
+        return iNumMoved;
+    };
 
-#if 0
-    for(uint32_t i = 0; i < static_cast<uint32_t>(aaNewVertexPositions.size()); i++)
+    for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
     {
-        assert(aaiVertexPositionIndices[i].size() == aaiVertexNormalIndices[i].size());
-        assert(aaiVertexPositionIndices[i].size() == aaiVertexUVIndices[i].size());
-        
-        std::ostringstream clusterName;
-        clusterName << "cleaned-cluster" << i;
-
-        std::ostringstream outputClusterFilePath;
-        outputClusterFilePath << "c:\\Users\\Dingwings\\demo-models\\debug-output\\" << clusterName.str() << ".obj";
-
-        writeOBJFile(
-            aaNewVertexPositions[i],
-            aaNewVertexNormals[i],
-            aaNewVertexUVs[i],
-            aaiNewVertexPositionIndices[i],
-            aaiNewVertexNormalIndices[i],
-            aaiNewVertexUVIndices[i],
-            outputClusterFilePath.str(),
-            clusterName.str());
+        queueCluster(iCluster);
     }
-#endif // #if 0
 
-    return iNumAddedTriangleVertices > 0;
-}
-
-/*
-**
-*/
-void getCandidateClusters(
-    std::vector<std::vector<float3>> aaVertexPositionsCopy,
-    std::vector<std::vector<float3>> aaVertexNormalsCopy,
-    std::vector<std::vector<float2>> aaVertexUVsCopy,
-    std::vector<std::vector<uint32_t>> aaiVertexPositionIndicesCopy,
-    std::vector<std::vector<uint32_t>> aaiVertexNormalIndicesCopy,
-    std::vector<std::vector<uint32_t>> aaiVertexUVIndicesCopy,
-    std::vector<std::vector<float3>> const& aaVertexPositions,
-    std::vector<std::vector<float3>> const& aaVertexNormals,
-    std::vector<std::vector<float2>> const& aaVertexUVs,
-    std::vector<std::vector<uint32_t>> const& aaiVertexPositionIndices,
-    std::vector<std::vector<uint32_t>> const& aaiVertexNormalIndices,
-    std::vector<std::vector<uint32_t>> const& aaiVertexUVIndices,
-    uint32_t iSrcCluster,
-    uint32_t kiMaxTriangleVertices)
-{
-    struct DestClusterInfo
+    // only the clusters touched by a move are checked again
+    while(!aiWorklist.empty())
     {
-        uint32_t        miIndex;
-        uint32_t        miNumPositionIndices;
-        uint32_t        miNumSharedPositions;
-        std::vector<std::pair<uint32_t, uint32_t>>  maSharedTriangles;
-    };
+        uint32_t iSrcCluster = aiWorklist.front();
+        aiWorklist.pop_front();
+        aiClusterQueued[iSrcCluster] = 0;
 
-    std::map<uint32_t, DestClusterInfo> aCandidateDestClusters;
-    for(uint32_t iMergeTri = 0; iMergeTri < static_cast<uint32_t>(aaiVertexPositionIndices[iSrcCluster].size()); iMergeTri += 3)
-    {
-        for(uint32_t iDestCluster = 0; iDestCluster < static_cast<uint32_t>(aaiVertexPositionIndices.size()); iDestCluster++)
+        uint32_t iNumSrcTriangles = static_cast<uint32_t>(aaiClusterTriangles[iSrcCluster].size());
+        getNeighborClusters(iSrcCluster);
+        if(iNumSrcTriangles > kiMaxTriangles)
         {
-            if(iDestCluster == iSrcCluster)
+            // move the extra triangles to a neighbor that has room, growing from the shared border
+            uint32_t iNumTrianglesToMove = iNumSrcTriangles - kiMaxTriangles;
+            uint32_t iNumMoved = 0;
+            uint32_t iDestCluster = getDestCluster(iNumTrianglesToMove);
+            if(iDestCluster != UINT32_MAX)
             {
-                continue;
-            }
-
-            if(aaiVertexPositionIndicesCopy[iDestCluster].size() <= kiMaxTriangleVertices - aaiVertexPositionIndices[iSrcCluster].size())
-            {
-                for(uint32_t iCheckTri = 0; iCheckTri < static_cast<uint32_t>(aaiVertexPositionIndicesCopy[iDestCluster].size()); iCheckTri += 3)
+                aiQueue.clear();
+                for(auto const& iTriangle : aaiClusterTriangles[iSrcCluster])
                 {
-                    // check same position
-                    float3 aSamePos[32];
-                    uint32_t iNumSamePos = 0;
                     for(uint32_t i = 0; i < 3; i++)
                     {
-                        uint32_t iPos = aaiVertexPositionIndices[iSrcCluster][iMergeTri + i];
-                        float3 const& pos = aaVertexPositions[iSrcCluster][iPos];
-                        for(uint32_t j = 0; j < 3; j++)
-                        {
-                            uint32_t iCheckPos = aaiVertexPositionIndicesCopy[iDestCluster][iCheckTri + j];
-                            float3 const& checkPos = aaVertexPositionsCopy[iDestCluster][iCheckPos];
-                            if(lengthSquared(checkPos - pos) <= 1.0e-9f)
+                        uint32_t iPos = aiTrianglePositions[iTriangle * 3 + i];
+                        auto iter = std::find_if(
+                            aiPositionTriangles.begin() + aiPositionTriangleStart[iPos],
+                            aiPositionTriangles.begin() + aiPositionTriangleStart[iPos + 1],
+                            [&aiTriangleClusters, iDestCluster](uint32_t iCheckTriangle)
                             {
-                                if(iNumSamePos < 3)
-                                {
-                                    aSamePos[iNumSamePos++] = checkPos;
-                                }
-                            }
-                        }
-                    }
-
-                    // share at least an edge
-                    if(iNumSamePos >= 2)
-                    {
-                        if(aCandidateDestClusters.find(iDestCluster) == aCandidateDestClusters.end())
-                        {
-                            DestClusterInfo destClusterInfo;
-                            destClusterInfo.miIndex = iDestCluster;
-                            destClusterInfo.miNumPositionIndices = static_cast<uint32_t>(aaiVertexPositionIndicesCopy[iDestCluster].size());
-                            destClusterInfo.miNumSharedPositions = iNumSamePos;
-                            destClusterInfo.maSharedTriangles.push_back(std::make_pair(iMergeTri, iCheckTri));
-                            aCandidateDestClusters[iDestCluster] = destClusterInfo;
-                        }
-                        else
+                                return aiTriangleClusters[iCheckTriangle] == iDestCluster;
+                            });
+                        if(iter != aiPositionTriangles.begin() + aiPositionTriangleStart[iPos + 1])
                         {
-                            // add shared triangle and update shared position if > before
-                            if(aCandidateDestClusters[iDestCluster].miNumSharedPositions < iNumSamePos)
-                            {
-                                aCandidateDestClusters[iDestCluster].miNumSharedPositions = iNumSamePos;
-                            }
-                            aCandidateDestClusters[iDestCluster].maSharedTriangles.push_back(std::make_pair(iMergeTri, iCheckTri));
+                            aiQueue.push_back(iTriangle);
+                            break;
                         }
                     }
                 }
-            }
-        }
-    }
 
-    if(aCandidateDestClusters.size() > 0)
-    {
-        int iDebug = 1;
-    }
-}
+                iNumMoved = growRegion(iSrcCluster, iDestCluster, iNumTrianglesToMove);
+                aiClusterChanged[iDestCluster] = 1;
+                queueCluster(iDestCluster);
+            }
 
-/*
-**
-*/
-bool mergeTriangles(
-    std::vector<std::vector<float3>>& aaVertexPositions,
-    std::vector<std::vector<float3>>& aaVertexNormals,
-    std::vector<std::vector<float2>>& aaVertexUVs,
-    std::vector<std::vector<uint32_t>>& aaiVertexPositionIndices,
-    std::vector<std::vector<uint32_t>>& aaiVertexNormalIndices,
-    std::vector<std::vector<uint32_t>>& aaiVertexUVIndices,
-    uint32_t iSrcCluster)
-{
-    //DEBUG_PRINTF("try to merge cluster %d size: %d\n", iSrcCluster, aaiVertexPositionIndices.size());
-
-    std::vector<uint32_t> aiMerged(aaiVertexPositionIndices[iSrcCluster].size() / 3);
-    memset(aiMerged.data(), 0, aiMerged.size() * sizeof(uint32_t));
-
-    std::vector<std::vector<float3>> aaVertexPositionsCopy = aaVertexPositions;
-    std::vector<std::vector<float3>> aaVertexNormalsCopy = aaVertexNormals;
-    std::vector<std::vector<float2>> aaVertexUVsCopy = aaVertexUVs;
-    std::vector<std::vector<uint32_t>> aaiVertexPositionIndicesCopy = aaiVertexPositionIndices;
-    std::vector<std::vector<uint32_t>> aaiVertexNormalIndicesCopy = aaiVertexNormalIndices;
-    std::vector<std::vector<uint32_t>> aaiVertexUVIndicesCopy = aaiVertexUVIndices;
-
-    uint32_t const kiMaxTriangleVertices = 128 * 3;
-    uint32_t iDestCluster = 0;
-
-    //getCandidateClusters(
-    //    aaVertexPositionsCopy,
-    //    aaVertexNormalsCopy,
-    //    aaVertexUVsCopy,
-    //    aaiVertexPositionIndicesCopy,
-    //    aaiVertexNormalIndicesCopy,
-    //    aaiVertexUVIndicesCopy,
-    //    aaVertexPositions,
-    //    aaVertexNormals,
-    //    aaVertexUVs,
-    //    aaiVertexPositionIndices,
-    //    aaiVertexNormalIndices,
-    //    aaiVertexUVIndices,
-    //    iSrcCluster,
-    //    kiMaxTriangleVertices);
-
-    for(uint32_t iLoop = 0; iLoop < 100; iLoop++)
-    {
-        for(uint32_t iMergeTri = 0; iMergeTri < static_cast<uint32_t>(aaiVertexPositionIndices[iSrcCluster].size()); iMergeTri += 3)
-        {
-            for(iDestCluster = 0; iDestCluster < static_cast<uint32_t>(aaiVertexPositionIndices.size()); iDestCluster++)
+            // no neighbor had room, the rest goes into a new cluster
+            if(iNumMoved < iNumTrianglesToMove)
             {
-                if(iDestCluster == iSrcCluster)
+                uint32_t iNewCluster = iNumClusters++;
+                aaiClusterTriangles.emplace_back();
+                aiClusterChanged.push_back(1);
+                aiClusterQueued.push_back(0);
+                while(iNumMoved < iNumTrianglesToMove)
                 {
-                    continue;
+                    aiQueue.clear();
+                    aiQueue.push_back(aaiClusterTriangles[iSrcCluster].front());
+                    iNumMoved += growRegion(iSrcCluster, iNewCluster, iNumTrianglesToMove - iNumMoved);
                 }
+                queueCluster(iNewCluster);
+            }
 
-                if(aaiVertexPositionIndicesCopy[iDestCluster].size() <= kiMaxTriangleVertices - aaiVertexPositionIndices[iSrcCluster].size())
+            aiClusterChanged[iSrcCluster] = 1;
+        }
+        else if(iNumSrcTriangles > 0 && iNumSrcTriangles <= kiMinTriangles)
+        {
+            // merge the whole cluster into a neighbor, left as is if none of them has room
+            uint32_t iDestCluster = getDestCluster(iNumSrcTriangles);
+            if(iDestCluster != UINT32_MAX)
+            {
+                for(auto const& iTriangle : aaiClusterTriangles[iSrcCluster])
                 {
-                    for(uint32_t iCheckTri = 0; iCheckTri < static_cast<uint32_t>(aaiVertexPositionIndicesCopy[iDestCluster].size()); iCheckTri += 3)
-                    {
-                        float3 aSamePos[32];
-                        uint32_t iNumSamePos = 0;
-                        for(uint32_t i = 0; i < 3; i++)
-                        {
-                            uint32_t iPos = aaiVertexPositionIndices[iSrcCluster][iMergeTri + i];
-                            float3 const& pos = aaVertexPositions[iSrcCluster][iPos];
-                            for(uint32_t j = 0; j < 3; j++)
-                            {
-                                uint32_t iCheckPos = aaiVertexPositionIndicesCopy[iDestCluster][iCheckTri + j];
-                                float3 const& checkPos = aaVertexPositionsCopy[iDestCluster][iCheckPos];
-                                if(lengthSquared(checkPos - pos) <= 1.0e-9f)
-                                {
-                                    if(iNumSamePos < 3)
-                                    {
-                                        aSamePos[iNumSamePos++] = checkPos;
-                                    }
-                                }
-                            }
-                        }
-
-                        float3 aAddedPos[3];
-                        uint32_t aiAddedIndices[3];
-                        if(iNumSamePos >= 1)
-                        {
-                            for(uint32_t i = 0; i < 3; i++)
-                            {
-                                // position
-                                {
-                                    uint32_t iIndex = UINT32_MAX;
-                                    uint32_t iPos = aaiVertexPositionIndices[iSrcCluster][iMergeTri + i];
-                                    float3 const& pos = aaVertexPositions[iSrcCluster][iPos];
-                                    auto iter = std::find_if(
-                                        aaVertexPositionsCopy[iDestCluster].begin(),
-                                        aaVertexPositionsCopy[iDestCluster].end(),
-                                        [pos](float3 const& checkPos)
-                                        {
-                                            return lengthSquared(pos - checkPos) <= 1.0e-7f;
-                                        });
-                                    if(iter == aaVertexPositionsCopy[iDestCluster].end())
-                                    {
-                                        aaVertexPositionsCopy[iDestCluster].push_back(pos);
-                                        aAddedPos[i] = pos;
-                                        iIndex = static_cast<uint32_t>(aaVertexPositionsCopy[iDestCluster].size() - 1);
-                                    }
-                                    else
-                                    {
-                                        iIndex = static_cast<uint32_t>(std::distance(aaVertexPositionsCopy[iDestCluster].begin(), iter));
-                                        aAddedPos[i] = aaVertexPositionsCopy[iDestCluster][iIndex];
-                                    }
-                                    assert(iIndex != UINT32_MAX);
-                                    assert(iIndex <= aaVertexPositionsCopy[iDestCluster].size());
-                                    aaiVertexPositionIndicesCopy[iDestCluster].push_back(iIndex);
-                                    aiAddedIndices[i] = iIndex;
-                                }
-
-                                // normal
-                                {
-                                    uint32_t iIndex = UINT32_MAX;
-                                    uint32_t iPos = aaiVertexNormalIndices[iSrcCluster][iMergeTri + i];
-                                    float3 const& pos = aaVertexNormals[iSrcCluster][iPos];
-                                    auto iter = std::find_if(
-                                        aaVertexNormalsCopy[iDestCluster].begin(),
-                                        aaVertexNormalsCopy[iDestCluster].end(),
-                                        [pos](float3 const& checkPos)
-                                        {
-                                            return lengthSquared(pos - checkPos) <= 1.0e-7f;
-                                        });
-                                    if(iter == aaVertexNormalsCopy[iDestCluster].end())
-                                    {
-                                        aaVertexNormalsCopy[iDestCluster].push_back(pos);
-                                        iIndex = static_cast<uint32_t>(aaVertexNormalsCopy[iDestCluster].size() - 1);
-                                    }
-                                    else
-                                    {
-                                        iIndex = static_cast<uint32_t>(std::distance(aaVertexNormalsCopy[iDestCluster].begin(), iter));
-                                    }
-                                    assert(iIndex != UINT32_MAX);
-                                    assert(iIndex <= aaVertexNormalsCopy[iDestCluster].size());
-                                    aaiVertexNormalIndicesCopy[iDestCluster].push_back(iIndex);
-                                }
-
-                                // uv
-                                {
-                                    uint32_t iIndex = UINT32_MAX;
-                                    uint32_t iPos = aaiVertexUVIndices[iSrcCluster][iMergeTri + i];
-                                    float2 const& pos = aaVertexUVs[iSrcCluster][iPos];
-                                    auto iter = std::find_if(
-                                        aaVertexUVsCopy[iDestCluster].begin(),
-                                        aaVertexUVsCopy[iDestCluster].end(),
-                                        [pos](float2 const& checkPos)
-                                        {
-                                            return lengthSquared(pos - checkPos) <= 1.0e-7f;
-                                        });
-                                    if(iter == aaVertexUVsCopy[iDestCluster].end())
-                                    {
-                                        aaVertexUVsCopy[iDestCluster].push_back(pos);
-                                        iIndex = static_cast<uint32_t>(aaVertexUVsCopy[iDestCluster].size() - 1);
-                                    }
-                                    else
-                                    {
-                                        iIndex = static_cast<uint32_t>(std::distance(aaVertexUVsCopy[iDestCluster].begin(), iter));
-                                    }
-                                    assert(iIndex != UINT32_MAX);
-                                    assert(iIndex <= aaVertexUVsCopy[iDestCluster].size());
-                                    aaiVertexUVIndicesCopy[iDestCluster].push_back(iIndex);
-
-                                }
-
-                            }   // for i = 0 to 3
-
-                            //DEBUG_PRINTF("merge triangleID %d from cluster %d to cluster %d triangle (%d, %d, %d)\n",
-                            //    iMergeTri / 3,
-                            //    iSrcCluster,
-                            //    iDestCluster,
-                            //    aiAddedIndices[0],
-                            //    aiAddedIndices[1],
-                            //    aiAddedIndices[2]);
-
-                            aiMerged[iMergeTri / 3] = 1;
-                            break;
-
-                        }   // if share edge
-
-                    }   // for check tri = 0 to num dest triangles
-
-                    if(aiMerged[iMergeTri / 3])
-                    {
-                        break;
-                    }
-
-                }   // if dest cluster can hold the triangles
+                    aiTriangleClusters[iTriangle] = iDestCluster;
+                    aaiClusterTriangles[iDestCluster].push_back(iTriangle);
+                }
+                aaiClusterTriangles[iSrcCluster].clear();
 
-            }   // for dest cluster to num clusters
+                aiClusterChanged[iSrcCluster] = 1;
+                aiClusterChanged[iDestCluster] = 1;
+                queueCluster(iDestCluster);
+            }
+        }
 
-            //if(aiMerged[iMergeTri / 3] == 0)
-            //{
-            //    DEBUG_PRINTF("did not merge triangleID %d\n", iMergeTri / 3);
-            //}
+    }   // while worklist is not empty
 
-        }   // for tri = 0 to num src triangles
-        
-        // check if merged all the triangles
-        auto iter = std::find(aiMerged.begin(), aiMerged.end(), 0);
-        if(iter == aiMerged.end())
+    // re-build the changed clusters from the original triangles, the rest are kept as is
+    std::vector<std::vector<float3>> aaNewVertexPositions(iNumClusters);
+    std::vector<std::vector<float3>> aaNewVertexNormals(iNumClusters);
+    std::vector<std::vector<float2>> aaNewVertexUVs(iNumClusters);
+    std::vector<std::vector<uint32_t>> aaiNewVertexPositionIndices(iNumClusters);
+    std::vector<std::vector<uint32_t>> aaiNewVertexNormalIndices(iNumClusters);
+    std::vector<std::vector<uint32_t>> aaiNewVertexUVIndices(iNumClusters);
+    for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
+    {
+        if(aiClusterChanged[iCluster] == 0)
         {
-            break;
+            continue;
         }
 
-        int iDebug = 1;
-
-    }   // for loop = 0 to 1000
+        for(auto const& iTriangle : aaiClusterTriangles[iCluster])
+        {
+            addTriangle(
+                aaNewVertexPositions,
+                aaNewVertexNormals,
+                aaNewVertexUVs,
+                aaiNewVertexPositionIndices,
+                aaiNewVertexNormalIndices,
+                aaiNewVertexUVIndices,
+                aaVertexPositions,
+                aaVertexNormals,
+                aaVertexUVs,
+                aaiVertexPositionIndices,
+                aaiVertexNormalIndices,
+                aaiVertexUVIndices,
+                aiTriangleSrcCluster[iTriangle],
+                aiTriangleSrcOffset[iTriangle],
+                iCluster);
+        }
+    }
 
-    auto iter = std::find(aiMerged.begin(), aiMerged.end(), 0);
-    if(iter == aiMerged.end())
+    aaVertexPositions.resize(iNumClusters);
+    aaVertexNormals.resize(iNumClusters);
+    aaVertexUVs.resize(iNumClusters);
+    aaiVertexPositionIndices.resize(iNumClusters);
+    aaiVertexNormalIndices.resize(iNumClusters);
+    aaiVertexUVIndices.resize(iNumClusters);
+    for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
     {
-        aaVertexPositionsCopy.erase(aaVertexPositionsCopy.begin() + iSrcCluster);
-        aaVertexNormalsCopy.erase(aaVertexNormalsCopy.begin() + iSrcCluster);
-        aaVertexUVsCopy.erase(aaVertexUVsCopy.begin() + iSrcCluster);
-
-        aaiVertexPositionIndicesCopy.erase(aaiVertexPositionIndicesCopy.begin() + iSrcCluster);
-        aaiVertexNormalIndicesCopy.erase(aaiVertexNormalIndicesCopy.begin() + iSrcCluster);
-        aaiVertexUVIndicesCopy.erase(aaiVertexUVIndicesCopy.begin() + iSrcCluster);
-
-        aaVertexPositions = aaVertexPositionsCopy;
-        aaVertexNormals = aaVertexNormalsCopy;
-        aaVertexUVs = aaVertexUVsCopy;
-
-        aaiVertexPositionIndices = aaiVertexPositionIndicesCopy;
-        aaiVertexNormalIndices = aaiVertexNormalIndicesCopy;
-        aaiVertexUVIndices = aaiVertexUVIndicesCopy;
+        if(aiClusterChanged[iCluster] == 0)
+        {
+            continue;
+        }
 
-        //DEBUG_PRINTF("!!! successfully merged cluster %d\n", iSrcCluster);
-    }
-    else
-    {
-        //DEBUG_PRINTF("!!! did not merge cluster %d\n", iSrcCluster);
+        aaVertexPositions[iCluster] = std::move(aaNewVertexPositions[iCluster]);
+        aaVertexNormals[iCluster] = std::move(aaNewVertexNormals[iCluster]);
+        aaVertexUVs[iCluster] = std::move(aaNewVertexUVs[iCluster]);
+        aaiVertexPositionIndices[iCluster] = std::move(aaiNewVertexPositionIndices[iCluster]);
+        aaiVertexNormalIndices[iCluster] = std::move(aaiNewVertexNormalIndices[iCluster]);
+        aaiVertexUVIndices[iCluster] = std::move(aaiNewVertexUVIndices[iCluster]);
     }
-
-    return (iter == aiMerged.end());
 }
 
 /*
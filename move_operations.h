@@ -3,24 +3,18 @@
 #include "vec.h"
 #include <vector>
 
-bool moveTriangles(
+// moves triangles out of clusters above the max and merges clusters at or below the min into a neighbor
+//      neighbors are found through the shared positions, only the clusters touched by a move are checked again
+//      new clusters are appended, merged clusters are left empty
+void rebalanceClusters(
     std::vector<std::vector<float3>>& aaVertexPositions,
     std::vector<std::vector<float3>>& aaVertexNormals,
     std::vector<std::vector<float2>>& aaVertexUVs,
     std::vector<std::vector<uint32_t>>& aaiVertexPositionIndices,
     std::vector<std::vector<uint32_t>>& aaiVertexNormalIndices,
     std::vector<std::vector<uint32_t>>& aaiVertexUVIndices,
-    uint32_t iSrcCluster,
-    uint32_t iMaxTriangleVertexCount);
-
-bool mergeTriangles(
-    std::vector<std::vector<float3>>& aaVertexPositions,
-    std::vector<std::vector<float3>>& aaVertexNormals,
-    std::vector<std::vector<float2>>& aaVertexUVs,
-    std::vector<std::vector<uint32_t>>& aaiVertexPositionIndices,
-    std::vector<std::vector<uint32_t>>& aaiVertexNormalIndices,
-    std::vector<std::vector<uint32_t>>& aaiVertexUVIndices,
-    uint32_t iSrcCluster);
+    uint32_t iMaxTriangleVertexCount,
+    uint32_t iMinTriangleVertexCount);
 
 void moveVertices(
     std::vector<float3>& aDestClusterVertexPositions,
@@ -77,12 +77,7 @@ void writeOBJFile(
 void writeTotalClusterOBJ(
     std::string const& outputTotalClusterFilePath,
     std::string const& objectName,
-    std::vector<std::vector<float3>> const& aaClusterVertexPositions,
-    std::vector<std::vector<float3>> const& aaClusterVertexNormals,
-    std::vector<std::vector<float2>> const& aaClusterVertexUVs,
-    std::vector<std::vector<uint32_t>> const& aaiClusterTrianglePositionIndices,
-    std::vector<std::vector<uint32_t>> const& aaiClusterTriangleNormalIndices,
-    std::vector<std::vector<uint32_t>> const& aaiClusterTriangleUVIndices)
+    ClusterStore const& clusters)
 {
     uint32_t iNumTotalVertexPositions = 0;
     uint32_t iNumTotalVertexNormals = 0;
@@ -103,9 +98,11 @@ void writeTotalClusterOBJ(
     FILE* fp = fopen(outputTotalClusterFilePath.c_str(), "wb");
     fprintf(fp, "o %s\n", objectName.c_str());
 
-    uint32_t iNumClusters = static_cast<uint32_t>(aaClusterVertexPositions.size());
+    uint32_t iNumClusters = getNumClusters(clusters);
     for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
     {
+        ClusterView cluster = getClusterView(clusters, iCluster);
+
         std::ostringstream objectClusterName;
         objectClusterName << objectName << "-cluster-" << iCluster;
 
@@ -131,51 +128,51 @@ void writeTotalClusterOBJ(
         }
 
         fprintf(fp, "usemtl %s\n", objectClusterMaterialName.str().c_str());
-        fprintf(fp, "# num positions: %d\n", static_cast<uint32_t>(aaClusterVertexPositions[iCluster].size()));
-        for(uint32_t iPos = 0; iPos < static_cast<uint32_t>(aaClusterVertexPositions[iCluster].size()); iPos++)
+        fprintf(fp, "# num positions: %d\n", static_cast<uint32_t>(cluster.mVertexPositions.size()));
+        for(uint32_t iPos = 0; iPos < static_cast<uint32_t>(cluster.mVertexPositions.size()); iPos++)
         {
             fprintf(fp, "v %.4f %.4f %.4f\n",
-                aaClusterVertexPositions[iCluster][iPos].x,
-                aaClusterVertexPositions[iCluster][iPos].y,
-                aaClusterVertexPositions[iCluster][iPos].z);
+                cluster.mVertexPositions[iPos].x,
+                cluster.mVertexPositions[iPos].y,
+                cluster.mVertexPositions[iPos].z);
         }
 
-        fprintf(fp, "# num normals: %d\n", static_cast<uint32_t>(aaClusterVertexNormals[iCluster].size()));
-        for(uint32_t iNorm = 0; iNorm < static_cast<uint32_t>(aaClusterVertexNormals[iCluster].size()); iNorm++)
+        fprintf(fp, "# num normals: %d\n", static_cast<uint32_t>(cluster.mVertexNormals.size()));
+        for(uint32_t iNorm = 0; iNorm < static_cast<uint32_t>(cluster.mVertexNormals.size()); iNorm++)
         {
             fprintf(fp, "vn %.4f %.4f %.4f\n",
-                aaClusterVertexNormals[iCluster][iNorm].x,
-                aaClusterVertexNormals[iCluster][iNorm].y,
-                aaClusterVertexNormals[iCluster][iNorm].z);
+                cluster.mVertexNormals[iNorm].x,
+                cluster.mVertexNormals[iNorm].y,
+                cluster.mVertexNormals[iNorm].z);
         }
 
-        fprintf(fp, "# num uvs: %d\n", static_cast<uint32_t>(aaClusterVertexUVs[iCluster].size()));
-        for(uint32_t iUV = 0; iUV < static_cast<uint32_t>(aaClusterVertexUVs[iCluster].size()); iUV++)
+        fprintf(fp, "# num uvs: %d\n", static_cast<uint32_t>(cluster.mVertexUVs.size()));
+        for(uint32_t iUV = 0; iUV < static_cast<uint32_t>(cluster.mVertexUVs.size()); iUV++)
         {
             fprintf(fp, "vt %.4f %.4f\n",
-                aaClusterVertexUVs[iCluster][iUV].x,
-                aaClusterVertexUVs[iCluster][iUV].y);
+                cluster.mVertexUVs[iUV].x,
+                cluster.mVertexUVs[iUV].y);
         }
 
-        for(uint32_t iTri = 0; iTri < static_cast<uint32_t>(aaiClusterTrianglePositionIndices[iCluster].size()); iTri += 3)
+        for(uint32_t iTri = 0; iTri < static_cast<uint32_t>(cluster.maiTrianglePositionIndices.size()); iTri += 3)
         {
             fprintf(fp, "f %d/%d/%d %d/%d/%d %d/%d/%d\n",
-                aaiClusterTrianglePositionIndices[iCluster][iTri] + iNumTotalVertexPositions + 1,
-                aaiClusterTriangleUVIndices[iCluster][iTri] + iNumTotalVertexUVs + 1,
-                aaiClusterTriangleNormalIndices[iCluster][iTri] + iNumTotalVertexNormals + 1,
+                cluster.maiTrianglePositionIndices[iTri] + iNumTotalVertexPositions + 1,
+                cluster.maiTriangleUVIndices[iTri] + iNumTotalVertexUVs + 1,
+                cluster.maiTriangleNormalIndices[iTri] + iNumTotalVertexNormals + 1,
 
-                aaiClusterTrianglePositionIndices[iCluster][iTri + 1] + iNumTotalVertexPositions + 1,
-                aaiClusterTriangleUVIndices[iCluster][iTri + 1] + iNumTotalVertexUVs + 1,
-                aaiClusterTriangleNormalIndices[iCluster][iTri + 1] + iNumTotalVertexNormals + 1,
+                cluster.maiTrianglePositionIndices[iTri + 1] + iNumTotalVertexPositions + 1,
+                cluster.maiTriangleUVIndices[iTri + 1] + iNumTotalVertexUVs + 1,
+                cluster.maiTriangleNormalIndices[iTri + 1] + iNumTotalVertexNormals + 1,
 
-                aaiClusterTrianglePositionIndices[iCluster][iTri + 2] + iNumTotalVertexPositions + 1,
-                aaiClusterTriangleUVIndices[iCluster][iTri + 2] + iNumTotalVertexUVs + 1,
-                aaiClusterTriangleNormalIndices[iCluster][iTri + 2] + iNumTotalVertexNormals + 1);
+                cluster.maiTrianglePositionIndices[iTri + 2] + iNumTotalVertexPositions + 1,
+                cluster.maiTriangleUVIndices[iTri + 2] + iNumTotalVertexUVs + 1,
+                cluster.maiTriangleNormalIndices[iTri + 2] + iNumTotalVertexNormals + 1);
         }
 
-        iNumTotalVertexPositions += static_cast<uint32_t>(aaClusterVertexPositions[iCluster].size());
-        iNumTotalVertexNormals += static_cast<uint32_t>(aaClusterVertexNormals[iCluster].size());
-        iNumTotalVertexUVs += static_cast<uint32_t>(aaClusterVertexUVs[iCluster].size());
+        iNumTotalVertexPositions += static_cast<uint32_t>(cluster.mVertexPositions.size());
+        iNumTotalVertexNormals += static_cast<uint32_t>(cluster.mVertexNormals.size());
+        iNumTotalVertexUVs += static_cast<uint32_t>(cluster.mVertexUVs.size());
     }
 
     fclose(fp);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "vec.h"
+#include "cluster_store.h"
 #include <string>
 #include <vector>
 
@@ -17,9 +18,4 @@ void writeOBJFile(
 void writeTotalClusterOBJ(
     std::string const& outputTotalClusterFilePath,
     std::string const& objectName,
-    std::vector<std::vector<float3>> const& aaClusterVertexPositions,
-    std::vector<std::vector<float3>> const& aaClusterVertexNormals,
-    std::vector<std::vector<float2>> const& aaClusterVertexUVs,
-    std::vector<std::vector<uint32_t>> const& aaiClusterTrianglePositionIndices,
-    std::vector<std::vector<uint32_t>> const& aaiClusterTriangleNormalIndices,
-    std::vector<std::vector<uint32_t>> const& aaiClusterTriangleUVIndices);
\ No newline at end of file
+    ClusterStore const& clusters);
\ No newline at end of file
@@ -7,6 +7,13 @@
 #include <string>
 #include <vector>
 
+// symmetric quadric, upper triangle of the 4x4 matrix (xx, xy, xz, xw, yy, yz, yw, zz, zw, ww)
+// followed by the sum of the vertex normal to face plane angles and the number of faces, padded for SSE
+struct alignas(16) Quadric
+{
+    float       mafEntries[12];
+};
+
 struct EdgeCollapseInfo
 {
     float3      mOptimalVertexPosition;
@@ -16,7 +23,7 @@ struct EdgeCollapseInfo
 };
 
 void simplifyClusterGroup(
-    std::map<uint32_t, mat4>& aQuadrics,
+    std::vector<Quadric>& aQuadrics,
     std::vector<float3>& aClusterGroupVertexPositions,
     std::vector<float3>& aClusterGroupVertexNormals,
     std::vector<float2>& aClusterGroupVertexUVs,
@@ -0,0 +1,503 @@
+#include "spatial_index.h"
+
+#include <assert.h>
+#include <float.h>
+
+#include <algorithm>
+
+#include <emmintrin.h>
+
+/*
+**
+*/
+static inline float getAxisValue(
+    float3 const& position,
+    uint32_t iAxis)
+{
+    return (iAxis == 0) ? position.x : ((iAxis == 1) ? position.y : position.z);
+}
+
+/*
+**
+*/
+static void buildPointKDTreeNode(
+    PointKDTree& tree,
+    uint32_t iFirstPoint,
+    uint32_t iNumPoints)
+{
+    uint32_t iNode = static_cast<uint32_t>(tree.maNodes.size());
+    tree.maNodes.push_back(PointKDTreeNode{ 0.0f, 0, 0, iFirstPoint, iNumPoints });
+    if(iNumPoints <= POINT_KD_TREE_LEAF_SIZE)
+    {
+        return;
+    }
+
+    // split along the longest side of the points' bounds at the median point
+    float3 minBounds(1.0e+10f, 1.0e+10f, 1.0e+10f);
+    float3 maxBounds(-1.0e+10f, -1.0e+10f, -1.0e+10f);
+    for(uint32_t i = iFirstPoint; i < iFirstPoint + iNumPoints; i++)
+    {
+        float3 const& position = tree.maPositions[tree.maiPoints[i]];
+        minBounds = fminf(minBounds, position);
+        maxBounds = fmaxf(maxBounds, position);
+    }
+    float3 diff = maxBounds - minBounds;
+    uint32_t iAxis = (diff.x >= diff.y && diff.x >= diff.z) ? 0 : ((diff.y >= diff.z) ? 1 : 2);
+
+    uint32_t iNumLeftPoints = iNumPoints / 2;
+    std::nth_element(
+        tree.maiPoints.begin() + iFirstPoint,
+        tree.maiPoints.begin() + iFirstPoint + iNumLeftPoints,
+        tree.maiPoints.begin() + iFirstPoint + iNumPoints,
+        [&tree,
+         iAxis](uint32_t iLeft, uint32_t iRight)
+        {
+            return getAxisValue(tree.maPositions[iLeft], iAxis) < getAxisValue(tree.maPositions[iRight], iAxis);
+        });
+
+    float fSplit = getAxisValue(tree.maPositions[tree.maiPoints[iFirstPoint + iNumLeftPoints]], iAxis);
+    buildPointKDTreeNode(tree, iFirstPoint, iNumLeftPoints);
+    uint32_t iRight = static_cast<uint32_t>(tree.maNodes.size());
+    buildPointKDTreeNode(tree, iFirstPoint + iNumLeftPoints, iNumPoints - iNumLeftPoints);
+
+    PointKDTreeNode& node = tree.maNodes[iNode];
+    node.mfSplit = fSplit;
+    node.miAxis = iAxis;
+    node.miRight = iRight;
+    node.miNumPoints = 0;
+}
+
+/*
+**
+*/
+void buildPointKDTree(
+    PointKDTree& tree,
+    std::vector<float3> const& aPositions)
+{
+    uint32_t iNumPoints = static_cast<uint32_t>(aPositions.size());
+
+    tree.maPositions = aPositions;
+    tree.maiPoints.resize(iNumPoints);
+    for(uint32_t i = 0; i < iNumPoints; i++)
+    {
+        tree.maiPoints[i] = i;
+    }
+
+    tree.maNodes.clear();
+    tree.maNodes.reserve(std::max(1u, (iNumPoints / POINT_KD_TREE_LEAF_SIZE) * 2 + 1));
+    buildPointKDTreeNode(tree, 0, iNumPoints);
+}
+
+/*
+**
+*/
+static inline bool isCloserPoint(float fDistance, uint32_t iPoint, float fCheckDistance, uint32_t iCheckPoint)
+{
+    return (fDistance == fCheckDistance) ? iPoint < iCheckPoint : fDistance < fCheckDistance;
+}
+
+/*
+**  distances are squared while searching, the nearest list is kept sorted by insertion
+*/
+static void getNearestPointsInNode(
+    uint32_t* aiNearest,
+    float* afDistances,
+    uint32_t& iNumFound,
+    PointKDTree const& tree,
+    uint32_t iNode,
+    float3 const& position,
+    uint32_t iNumNearest)
+{
+    PointKDTreeNode const& node = tree.maNodes[iNode];
+    if(node.miNumPoints > 0)
+    {
+        for(uint32_t i = node.miFirstPoint; i < node.miFirstPoint + node.miNumPoints; i++)
+        {
+            uint32_t iPoint = tree.maiPoints[i];
+            // ties go to the smaller point index so the result doesn't depend on the tree layout
+            float fDistance = lengthSquared(tree.maPositions[iPoint] - position);
+            if(iNumFound == iNumNearest && !isCloserPoint(fDistance, iPoint, afDistances[iNumFound - 1], aiNearest[iNumFound - 1]))
+            {
+                continue;
+            }
+
+            uint32_t iInsert = (iNumFound < iNumNearest) ? iNumFound++ : iNumFound - 1;
+            while(iInsert > 0 && isCloserPoint(fDistance, iPoint, afDistances[iInsert - 1], aiNearest[iInsert - 1]))
+            {
+                afDistances[iInsert] = afDistances[iInsert - 1];
+                aiNearest[iInsert] = aiNearest[iInsert - 1];
+                --iInsert;
+            }
+            afDistances[iInsert] = fDistance;
+            aiNearest[iInsert] = iPoint;
+        }
+
+        return;
+    }
+
+    // near side first, the far side only when the split plane is closer than the farthest point found
+    float fDiff = getAxisValue(position, node.miAxis) - node.mfSplit;
+    uint32_t iNearChild = (fDiff < 0.0f) ? iNode + 1 : node.miRight;
+    uint32_t iFarChild = (fDiff < 0.0f) ? node.miRight : iNode + 1;
+    getNearestPointsInNode(aiNearest, afDistances, iNumFound, tree, iNearChild, position, iNumNearest);
+    if(iNumFound < iNumNearest || fDiff * fDiff <= afDistances[iNumFound - 1])
+    {
+        getNearestPointsInNode(aiNearest, afDistances, iNumFound, tree, iFarChild, position, iNumNearest);
+    }
+}
+
+/*
+**
+*/
+uint32_t getNearestPointsSquared(
+    uint32_t* aiNearest,
+    float* afSquaredDistances,
+    PointKDTree const& tree,
+    float3 const& position,
+    uint32_t iNumNearest)
+{
+    if(tree.maiPoints.empty() || iNumNearest == 0)
+    {
+        return 0;
+    }
+
+    uint32_t iNumFound = 0;
+    getNearestPointsInNode(aiNearest, afSquaredDistances, iNumFound, tree, 0, position, iNumNearest);
+
+    return iNumFound;
+}
+
+/*
+**
+*/
+uint32_t getNearestPoints(
+    uint32_t* aiNearest,
+    float* afDistances,
+    PointKDTree const& tree,
+    float3 const& position,
+    uint32_t iNumNearest)
+{
+    uint32_t iNumFound = getNearestPointsSquared(aiNearest, afDistances, tree, position, iNumNearest);
+    for(uint32_t i = 0; i < iNumFound; i++)
+    {
+        afDistances[i] = sqrtf(afDistances[i]);
+    }
+
+    return iNumFound;
+}
+
+/*
+**
+*/
+static void buildTriangleBVHNode(
+    TriangleBVH& bvh,
+    std::vector<uint32_t>& aiTriangles,
+    std::vector<float3> const& aTriangleVertexPositions,
+    std::vector<float3> const& aTriangleCenters,
+    uint32_t iFirstTriangle,
+    uint32_t iNumTriangles)
+{
+    uint32_t iNode = static_cast<uint32_t>(bvh.maNodes.size());
+    bvh.maNodes.push_back(TriangleBVHNode{});
+
+    float3 minBounds(FLT_MAX, FLT_MAX, FLT_MAX);
+    float3 maxBounds(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    float3 minCenterBounds(FLT_MAX, FLT_MAX, FLT_MAX);
+    float3 maxCenterBounds(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for(uint32_t i = iFirstTriangle; i < iFirstTriangle + iNumTriangles; i++)
+    {
+        uint32_t iTriangle = aiTriangles[i];
+        for(uint32_t j = 0; j < 3; j++)
+        {
+            minBounds = fminf(minBounds, aTriangleVertexPositions[iTriangle * 3 + j]);
+            maxBounds = fmaxf(maxBounds, aTriangleVertexPositions[iTriangle * 3 + j]);
+        }
+        minCenterBounds = fminf(minCenterBounds, aTriangleCenters[iTriangle]);
+        maxCenterBounds = fmaxf(maxCenterBounds, aTriangleCenters[iTriangle]);
+    }
+    bvh.maNodes[iNode].mMinBounds = minBounds;
+    bvh.maNodes[iNode].mMaxBounds = maxBounds;
+
+    if(iNumTriangles <= TRIANGLE_BVH_BATCH_SIZE)
+    {
+        // one batch per leaf, slots past the leaf's triangles repeat the last one
+        uint32_t iFirstSlot = static_cast<uint32_t>(bvh.maiTriangles.size());
+        bvh.maiTriangles.resize(iFirstSlot + TRIANGLE_BVH_BATCH_SIZE);
+        bvh.mafBatchData.resize(bvh.mafBatchData.size() + TRIANGLE_BVH_BATCH_SIZE * 9);
+        float* afBatchData = bvh.mafBatchData.data() + (iFirstSlot / TRIANGLE_BVH_BATCH_SIZE) * TRIANGLE_BVH_BATCH_SIZE * 9;
+        for(uint32_t iSlot = 0; iSlot < TRIANGLE_BVH_BATCH_SIZE; iSlot++)
+        {
+            uint32_t iTriangle = aiTriangles[iFirstTriangle + std::min(iSlot, iNumTriangles - 1)];
+            float3 const& pos0 = aTriangleVertexPositions[iTriangle * 3];
+            float3 edge0 = aTriangleVertexPositions[iTriangle * 3 + 1] - pos0;
+            float3 edge1 = aTriangleVertexPositions[iTriangle * 3 + 2] - pos0;
+            float const afValues[9] = { pos0.x, pos0.y, pos0.z, edge0.x, edge0.y, edge0.z, edge1.x, edge1.y, edge1.z };
+            for(uint32_t iRow = 0; iRow < 9; iRow++)
+            {
+                afBatchData[iRow * TRIANGLE_BVH_BATCH_SIZE + iSlot] = afValues[iRow];
+            }
+            bvh.maiTriangles[iFirstSlot + iSlot] = iTriangle;
+        }
+
+        bvh.maNodes[iNode].miRight = 0;
+        bvh.maNodes[iNode].miFirstTriangle = iFirstSlot;
+        bvh.maNodes[iNode].miNumTriangles = iNumTriangles;
+        return;
+    }
+
+    // split at the median triangle center along the longest side of the center bounds
+    float3 diff = maxCenterBounds - minCenterBounds;
+    uint32_t iAxis = (diff.x >= diff.y && diff.x >= diff.z) ? 0 : ((diff.y >= diff.z) ? 1 : 2);
+    uint32_t iNumLeftTriangles = iNumTriangles / 2;
+    std::nth_element(
+        aiTriangles.begin() + iFirstTriangle,
+        aiTriangles.begin() + iFirstTriangle + iNumLeftTriangles,
+        aiTriangles.begin() + iFirstTriangle + iNumTriangles,
+        [&aTriangleCenters,
+         iAxis](uint32_t iLeft, uint32_t iRight)
+        {
+            return getAxisValue(aTriangleCenters[iLeft], iAxis) < getAxisValue(aTriangleCenters[iRight], iAxis);
+        });
+
+    buildTriangleBVHNode(bvh, aiTriangles, aTriangleVertexPositions, aTriangleCenters, iFirstTriangle, iNumLeftTriangles);
+    uint32_t iRight = static_cast<uint32_t>(bvh.maNodes.size());
+    buildTriangleBVHNode(bvh, aiTriangles, aTriangleVertexPositions, aTriangleCenters, iFirstTriangle + iNumLeftTriangles, iNumTriangles - iNumLeftTriangles);
+
+    bvh.maNodes[iNode].miRight = iRight;
+    bvh.maNodes[iNode].miFirstTriangle = 0;
+    bvh.maNodes[iNode].miNumTriangles = 0;
+}
+
+/*
+**
+*/
+void buildTriangleBVH(
+    TriangleBVH& bvh,
+    std::vector<float3> const& aTriangleVertexPositions)
+{
+    assert(aTriangleVertexPositions.size() % 3 == 0);
+    uint32_t iNumTriangles = static_cast<uint32_t>(aTriangleVertexPositions.size() / 3);
+
+    bvh.maNodes.clear();
+    bvh.maiTriangles.clear();
+    bvh.mafBatchData.clear();
+    if(iNumTriangles == 0)
+    {
+        return;
+    }
+
+    std::vector<float3> aTriangleCenters(iNumTriangles);
+    std::vector<uint32_t> aiTriangles(iNumTriangles);
+    for(uint32_t iTriangle = 0; iTriangle < iNumTriangles; iTriangle++)
+    {
+        aTriangleCenters[iTriangle] = (aTriangleVertexPositions[iTriangle * 3] + aTriangleVertexPositions[iTriangle * 3 + 1] + aTriangleVertexPositions[iTriangle * 3 + 2]) / 3.0f;
+        aiTriangles[iTriangle] = iTriangle;
+    }
+
+    uint32_t iNumLeaves = (iNumTriangles + TRIANGLE_BVH_BATCH_SIZE - 1) / TRIANGLE_BVH_BATCH_SIZE * 2;
+    bvh.maNodes.reserve(iNumLeaves * 2);
+    bvh.maiTriangles.reserve(iNumLeaves * TRIANGLE_BVH_BATCH_SIZE);
+    bvh.mafBatchData.reserve(iNumLeaves * TRIANGLE_BVH_BATCH_SIZE * 9);
+    buildTriangleBVHNode(bvh, aiTriangles, aTriangleVertexPositions, aTriangleCenters, 0, iNumTriangles);
+}
+
+/*
+**  squared distance from the position to the node's bounds, 0 inside
+*/
+static inline float getBoundsDistanceSquared(
+    TriangleBVHNode const& node,
+    float3 const& position)
+{
+    float3 diff = fmaxf(fmaxf(node.mMinBounds - position, position - node.mMaxBounds), float3(0.0f, 0.0f, 0.0f));
+    return lengthSquared(diff);
+}
+
+/*
+**  closest points on 4 triangles of a batch, branchless: the projection onto the plane when it's inside the triangle,
+**  otherwise the closest of the 3 edge points, degenerate triangles only use their edges
+*/
+static inline void getClosestPointsOnTriangles4(
+    __m128& distanceSquared,
+    __m128& closestX,
+    __m128& closestY,
+    __m128& closestZ,
+    float const* afBatchData,
+    __m128 const& px,
+    __m128 const& py,
+    __m128 const& pz)
+{
+    __m128 const zero = _mm_setzero_ps();
+    __m128 const one = _mm_set1_ps(1.0f);
+
+    __m128 ax = _mm_loadu_ps(afBatchData);
+    __m128 ay = _mm_loadu_ps(afBatchData + TRIANGLE_BVH_BATCH_SIZE);
+    __m128 az = _mm_loadu_ps(afBatchData + TRIANGLE_BVH_BATCH_SIZE * 2);
+    __m128 abx = _mm_loadu_ps(afBatchData + TRIANGLE_BVH_BATCH_SIZE * 3);
+    __m128 aby = _mm_loadu_ps(afBatchData + TRIANGLE_BVH_BATCH_SIZE * 4);
+    __m128 abz = _mm_loadu_ps(afBatchData + TRIANGLE_BVH_BATCH_SIZE * 5);
+    __m128 acx = _mm_loadu_ps(afBatchData + TRIANGLE_BVH_BATCH_SIZE * 6);
+    __m128 acy = _mm_loadu_ps(afBatchData + TRIANGLE_BVH_BATCH_SIZE * 7);
+    __m128 acz = _mm_loadu_ps(afBatchData + TRIANGLE_BVH_BATCH_SIZE * 8);
+
+    auto dot3 = [](__m128 x0, __m128 y0, __m128 z0, __m128 x1, __m128 y1, __m128 z1)
+    {
+        return _mm_add_ps(_mm_add_ps(_mm_mul_ps(x0, x1), _mm_mul_ps(y0, y1)), _mm_mul_ps(z0, z1));
+    };
+
+    auto select = [](__m128 mask, __m128 a, __m128 b)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    };
+
+    // closest point on segment start + t * dir, zero length segments clamp to the start
+    auto closestOnSegment = [&dot3, &select, &px, &py, &pz, &zero, &one](
+        __m128& outDistanceSquared,
+        __m128& outX,
+        __m128& outY,
+        __m128& outZ,
+        __m128 sx, __m128 sy, __m128 sz,
+        __m128 dx, __m128 dy, __m128 dz)
+    {
+        __m128 lengthSquared = dot3(dx, dy, dz, dx, dy, dz);
+        __m128 t = _mm_div_ps(dot3(_mm_sub_ps(px, sx), _mm_sub_ps(py, sy), _mm_sub_ps(pz, sz), dx, dy, dz), lengthSquared);
+        t = select(_mm_cmpgt_ps(lengthSquared, zero), _mm_min_ps(_mm_max_ps(t, zero), one), zero);
+        outX = _mm_add_ps(sx, _mm_mul_ps(dx, t));
+        outY = _mm_add_ps(sy, _mm_mul_ps(dy, t));
+        outZ = _mm_add_ps(sz, _mm_mul_ps(dz, t));
+        __m128 diffX = _mm_sub_ps(px, outX);
+        __m128 diffY = _mm_sub_ps(py, outY);
+        __m128 diffZ = _mm_sub_ps(pz, outZ);
+        outDistanceSquared = dot3(diffX, diffY, diffZ, diffX, diffY, diffZ);
+    };
+
+    // edges a -> b, a -> c and b -> c
+    __m128 edgeDistanceSquared, edgeX, edgeY, edgeZ;
+    closestOnSegment(distanceSquared, closestX, closestY, closestZ, ax, ay, az, abx, aby, abz);
+    closestOnSegment(edgeDistanceSquared, edgeX, edgeY, edgeZ, ax, ay, az, acx, acy, acz);
+    __m128 closer = _mm_cmplt_ps(edgeDistanceSquared, distanceSquared);
+    distanceSquared = select(closer, edgeDistanceSquared, distanceSquared);
+    closestX = select(closer, edgeX, closestX);
+    closestY = select(closer, edgeY, closestY);
+    closestZ = select(closer, edgeZ, closestZ);
+
+    __m128 bx = _mm_add_ps(ax, abx), by = _mm_add_ps(ay, aby), bz = _mm_add_ps(az, abz);
+    closestOnSegment(edgeDistanceSquared, edgeX, edgeY, edgeZ, bx, by, bz, _mm_sub_ps(acx, abx), _mm_sub_ps(acy, aby), _mm_sub_ps(acz, abz));
+    closer = _mm_cmplt_ps(edgeDistanceSquared, distanceSquared);
+    distanceSquared = select(closer, edgeDistanceSquared, distanceSquared);
+    closestX = select(closer, edgeX, closestX);
+    closestY = select(closer, edgeY, closestY);
+    closestZ = select(closer, edgeZ, closestZ);
+
+    // barycentric coordinates of the projection onto the plane
+    __m128 apx = _mm_sub_ps(px, ax), apy = _mm_sub_ps(py, ay), apz = _mm_sub_ps(pz, az);
+    __m128 d00 = dot3(abx, aby, abz, abx, aby, abz);
+    __m128 d01 = dot3(abx, aby, abz, acx, acy, acz);
+    __m128 d11 = dot3(acx, acy, acz, acx, acy, acz);
+    __m128 d20 = dot3(apx, apy, apz, abx, aby, abz);
+    __m128 d21 = dot3(apx, apy, apz, acx, acy, acz);
+    __m128 denom = _mm_sub_ps(_mm_mul_ps(d00, d11), _mm_mul_ps(d01, d01));
+    __m128 v = _mm_div_ps(_mm_sub_ps(_mm_mul_ps(d11, d20), _mm_mul_ps(d01, d21)), denom);
+    __m128 w = _mm_div_ps(_mm_sub_ps(_mm_mul_ps(d00, d21), _mm_mul_ps(d01, d20)), denom);
+    __m128 inside = _mm_and_ps(
+        _mm_and_ps(_mm_cmpgt_ps(denom, _mm_mul_ps(_mm_mul_ps(d00, d11), _mm_set1_ps(1.0e-12f))), _mm_cmpge_ps(v, zero)),
+        _mm_and_ps(_mm_cmpge_ps(w, zero), _mm_cmple_ps(_mm_add_ps(v, w), one)));
+
+    __m128 planeX = _mm_add_ps(ax, _mm_add_ps(_mm_mul_ps(abx, v), _mm_mul_ps(acx, w)));
+    __m128 planeY = _mm_add_ps(ay, _mm_add_ps(_mm_mul_ps(aby, v), _mm_mul_ps(acy, w)));
+    __m128 planeZ = _mm_add_ps(az, _mm_add_ps(_mm_mul_ps(abz, v), _mm_mul_ps(acz, w)));
+    __m128 diffX = _mm_sub_ps(px, planeX);
+    __m128 diffY = _mm_sub_ps(py, planeY);
+    __m128 diffZ = _mm_sub_ps(pz, planeZ);
+    __m128 planeDistanceSquared = dot3(diffX, diffY, diffZ, diffX, diffY, diffZ);
+    inside = _mm_and_ps(inside, _mm_cmplt_ps(planeDistanceSquared, distanceSquared));
+    distanceSquared = select(inside, planeDistanceSquared, distanceSquared);
+    closestX = select(inside, planeX, closestX);
+    closestY = select(inside, planeY, closestY);
+    closestZ = select(inside, planeZ, closestZ);
+}
+
+/*
+**
+*/
+float getClosestPointOnTriangles(
+    float3& closestPosition,
+    uint32_t& iClosestTriangle,
+    TriangleBVH const& bvh,
+    float3 const& position)
+{
+    float fClosestDistanceSquared = FLT_MAX;
+    iClosestTriangle = UINT32_MAX;
+    if(bvh.maNodes.empty())
+    {
+        return FLT_MAX;
+    }
+
+    __m128 px = _mm_set1_ps(position.x);
+    __m128 py = _mm_set1_ps(position.y);
+    __m128 pz = _mm_set1_ps(position.z);
+
+    // depth first, nearer child first, nodes farther than the closest point so far are skipped
+    uint32_t aiStack[64];
+    float afStackDistances[64];
+    uint32_t iStackSize = 0;
+    aiStack[iStackSize] = 0;
+    afStackDistances[iStackSize] = getBoundsDistanceSquared(bvh.maNodes[0], position);
+    ++iStackSize;
+    while(iStackSize > 0)
+    {
+        --iStackSize;
+        if(afStackDistances[iStackSize] >= fClosestDistanceSquared)
+        {
+            continue;
+        }
+
+        uint32_t iNode = aiStack[iStackSize];
+        TriangleBVHNode const& node = bvh.maNodes[iNode];
+        if(node.miNumTriangles > 0)
+        {
+            float const* afBatchData = bvh.mafBatchData.data() + (node.miFirstTriangle / TRIANGLE_BVH_BATCH_SIZE) * TRIANGLE_BVH_BATCH_SIZE * 9;
+            for(uint32_t iHalf = 0; iHalf < TRIANGLE_BVH_BATCH_SIZE; iHalf += 4)
+            {
+                __m128 distanceSquared, closestX, closestY, closestZ;
+                getClosestPointsOnTriangles4(distanceSquared, closestX, closestY, closestZ, afBatchData + iHalf, px, py, pz);
+
+                float afDistanceSquared[4], afX[4], afY[4], afZ[4];
+                _mm_storeu_ps(afDistanceSquared, distanceSquared);
+                _mm_storeu_ps(afX, closestX);
+                _mm_storeu_ps(afY, closestY);
+                _mm_storeu_ps(afZ, closestZ);
+                for(uint32_t iLane = 0; iLane < 4; iLane++)
+                {
+                    if(afDistanceSquared[iLane] < fClosestDistanceSquared)
+                    {
+                        fClosestDistanceSquared = afDistanceSquared[iLane];
+                        closestPosition = float3(afX[iLane], afY[iLane], afZ[iLane]);
+                        iClosestTriangle = bvh.maiTriangles[node.miFirstTriangle + iHalf + iLane];
+                    }
+                }
+            }
+
+            continue;
+        }
+
+        uint32_t iLeft = iNode + 1;
+        uint32_t iRight = node.miRight;
+        float fLeftDistance = getBoundsDistanceSquared(bvh.maNodes[iLeft], position);
+        float fRightDistance = getBoundsDistanceSquared(bvh.maNodes[iRight], position);
+        if(fLeftDistance < fRightDistance)
+        {
+            std::swap(iLeft, iRight);
+            std::swap(fLeftDistance, fRightDistance);
+        }
+
+        // farther child pushed first so the nearer one is popped next
+        assert(iStackSize + 2 <= 64);
+        aiStack[iStackSize] = iLeft;
+        afStackDistances[iStackSize] = fLeftDistance;
+        aiStack[iStackSize + 1] = iRight;
+        afStackDistances[iStackSize + 1] = fRightDistance;
+        iStackSize += 2;
+    }
+
+    return sqrtf(fClosestDistanceSquared);
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "vec.h"
+
+#define POINT_KD_TREE_LEAF_SIZE         8
+
+// leaf when miNumPoints > 0, interior nodes split their points at mfSplit along miAxis
+//      the left child is always the next node, miRight is the index of the right child
+struct PointKDTreeNode
+{
+    float           mfSplit;
+    uint32_t        miAxis;
+    uint32_t        miRight;
+    uint32_t        miFirstPoint;
+    uint32_t        miNumPoints;
+};
+
+// balanced k-d tree over a point set, point indices refer to the array it was built from
+struct PointKDTree
+{
+    std::vector<PointKDTreeNode>        maNodes;
+    std::vector<uint32_t>               maiPoints;
+    std::vector<float3>                 maPositions;
+};
+
+void buildPointKDTree(
+    PointKDTree& tree,
+    std::vector<float3> const& aPositions);
+
+/*
+**  closest iNumNearest points to the query position, nearest first and equal distances in ascending point index
+**  returns the number of points found, less than asked for only when the tree has fewer points
+*/
+uint32_t getNearestPoints(
+    uint32_t* aiNearest,
+    float* afDistances,
+    PointKDTree const& tree,
+    float3 const& position,
+    uint32_t iNumNearest);
+
+// same as getNearestPoints() with the squared distances, for callers that compare or keep them squared
+uint32_t getNearestPointsSquared(
+    uint32_t* aiNearest,
+    float* afSquaredDistances,
+    PointKDTree const& tree,
+    float3 const& position,
+    uint32_t iNumNearest);
+
+#define TRIANGLE_BVH_BATCH_SIZE         8
+
+// leaf when miNumTriangles > 0, a leaf is one batch of TRIANGLE_BVH_BATCH_SIZE triangle slots starting at miFirstTriangle
+//      the left child is always the next node, miRight is the index of the right child
+struct TriangleBVHNode
+{
+    float3          mMinBounds;
+    uint32_t        miRight;
+    float3          mMaxBounds;
+    uint32_t        miFirstTriangle;
+    uint32_t        miNumTriangles;
+};
+
+// bvh over a triangle list, 3 positions per triangle
+//      batch data is 9 rows of TRIANGLE_BVH_BATCH_SIZE floats per leaf: position 0, edge 0 -> 1 and edge 0 -> 2 as x, y, z streams
+//      unused slots of a leaf repeat its last triangle, maiTriangles gives the input triangle of each slot
+struct TriangleBVH
+{
+    std::vector<TriangleBVHNode>        maNodes;
+    std::vector<uint32_t>               maiTriangles;
+    std::vector<float>                  mafBatchData;
+};
+
+void buildTriangleBVH(
+    TriangleBVH& bvh,
+    std::vector<float3> const& aTriangleVertexPositions);
+
+/*
+**  closest point on any of the triangles to the given position, returns the distance
+**  triangle index is UINT32_MAX and the distance FLT_MAX when the bvh is empty
+*/
+float getClosestPointOnTriangles(
+    float3& closestPosition,
+    uint32_t& iClosestTriangle,
+    TriangleBVH const& bvh,
+    float3 const& position);
@@ -4,14 +4,41 @@
 #include "tiny_obj_loader.h"
 #include "metis_operations.h"
 #include "move_operations.h"
-#include "system_command.h"
 #include "obj_helper.h"
+#include "connectivity_operations.h"
+#include "utils.h"
 
 #include <cassert>
+#include <cfloat>
 #include <filesystem>
 #include <map>
+#include <queue>
 #include <sstream>
 
+// candidate triangle for the partition being grown in splitCluster3()
+struct RegionGrowQueueEntry
+{
+    float           mfScore;
+    uint32_t        miTriangle;
+
+    bool operator > (RegionGrowQueueEntry const& entry) const
+    {
+        return mfScore > entry.mfScore;
+    }
+};
+
+struct RegionSeedQueueEntry
+{
+    uint32_t        miNumClosedEdges;
+    uint32_t        miTriangle;
+
+    // most closed edges on top, ties to the smaller triangle index
+    bool operator < (RegionSeedQueueEntry const& entry) const
+    {
+        return (miNumClosedEdges == entry.miNumClosedEdges) ? miTriangle > entry.miTriangle : miNumClosedEdges < entry.miNumClosedEdges;
+    }
+};
+
 void visitAdjacentTris(
     std::vector<uint32_t>& aiVisitedTris,
     std::vector<std::vector<uint32_t>> const& aaiAdjacentTri,
@@ -1269,16 +1296,59 @@ void splitCluster(
     setPrintOptions(printOptions);
 }
 
+/*
+**  triangle indices into a trimmed vertex list where sources within the max distance of each other are one vertex
+**  trimmed vertices are in order of first use, each one gives the first source index that used it
+*/
+static void getTrimmedTriangleIndices(
+    std::vector<uint32_t>& aiTrimmedTriangleIndices,
+    std::vector<uint32_t>& aiTrimmedSources,
+    std::vector<float3> const& aSourceValues,
+    std::vector<uint32_t> const& aiSourceTriangleIndices,
+    float fMaxDistance)
+{
+    uint32_t iNumSources = static_cast<uint32_t>(aSourceValues.size());
+    float fCellSize = getSpatialHashCellSize(aSourceValues.data(), iNumSources, fMaxDistance);
+    std::vector<std::pair<uint64_t, uint32_t>> aKeyIndices;
+    buildSpatialHashIndex(
+        aKeyIndices,
+        aSourceValues.data(),
+        iNumSources,
+        fCellSize);
+
+    // each source maps through its first match (smallest source index within the max distance) to the trimmed vertex
+    std::vector<uint32_t> aiSourceMatches(iNumSources, UINT32_MAX);
+    std::vector<uint32_t> aiMatchTrimmedIndices(iNumSources, UINT32_MAX);
+    aiTrimmedTriangleIndices.resize(aiSourceTriangleIndices.size());
+    aiTrimmedSources.clear();
+    for(uint32_t i = 0; i < static_cast<uint32_t>(aiSourceTriangleIndices.size()); i++)
+    {
+        uint32_t iSource = aiSourceTriangleIndices[i];
+        if(aiSourceMatches[iSource] == UINT32_MAX)
+        {
+            aiSourceMatches[iSource] = findSpatialHashMatch(
+                aKeyIndices,
+                aSourceValues.data(),
+                aSourceValues[iSource],
+                fCellSize,
+                fMaxDistance);
+        }
+
+        uint32_t iMatch = aiSourceMatches[iSource];
+        if(aiMatchTrimmedIndices[iMatch] == UINT32_MAX)
+        {
+            aiMatchTrimmedIndices[iMatch] = static_cast<uint32_t>(aiTrimmedSources.size());
+            aiTrimmedSources.push_back(iSource);
+        }
+        aiTrimmedTriangleIndices[i] = aiMatchTrimmedIndices[iMatch];
+    }
+}
+
 /*
 **
 */
 void splitClusterGroups(
-    std::vector<std::vector<float3>>& aaClusterVertexPositions,
-    std::vector<std::vector<float3>>& aaClusterVertexNormals,
-    std::vector<std::vector<float2>>& aaClusterVertexUVs,
-    std::vector<std::vector<uint32_t>>& aaiClusterTrianglePositionIndices,
-    std::vector<std::vector<uint32_t>>& aaiClusterTriangleNormalIndices,
-    std::vector<std::vector<uint32_t>>& aaiClusterTriangleUVIndices,
+    ClusterStore& clusters,
     uint32_t& iTotalClusterIndex,
     std::vector<float3> const& aClusterGroupVertexPositions,
     std::vector<float3> const& aClusterGroupVertexNormals,
@@ -1286,84 +1356,24 @@ void splitClusterGroups(
     std::vector<uint32_t> const& aiClusterTrianglePositionIndices,
     std::vector<uint32_t> const& aiClusterTriangleNormalIndices,
     std::vector<uint32_t> const& aiClusterTriangleUVIndices,
-    uint32_t iMaxTrianglesPerCluster,
-    uint32_t iNumSplitClusters,
-    uint32_t iLODLevel,
-    uint32_t iClusterGroup,
-    std::string const& meshModelName,
-    std::string const& homeDirectory)
+    uint32_t iMaxTrianglesPerCluster)
 {
 
     // update cluster group vertex positions and triangles, generate metis mesh file to partition, and output the max partitions of 2 into clusters
 
-    // triangle positions
-    std::vector<float3> aClusterGroupTrianglePositions(aiClusterTrianglePositionIndices.size());
-    for(uint32_t iTri = 0; iTri < static_cast<uint32_t>(aiClusterTrianglePositionIndices.size()); iTri += 3)
-    {
-        uint32_t iPos0 = aiClusterTrianglePositionIndices[iTri];
-        uint32_t iPos1 = aiClusterTrianglePositionIndices[iTri + 1];
-        uint32_t iPos2 = aiClusterTrianglePositionIndices[iTri + 2];
-
-        aClusterGroupTrianglePositions[iTri] = aClusterGroupVertexPositions[iPos0];
-        aClusterGroupTrianglePositions[iTri + 1] = aClusterGroupVertexPositions[iPos1];
-        aClusterGroupTrianglePositions[iTri + 2] = aClusterGroupVertexPositions[iPos2];
-    }
-
-    // triangle normals
-    std::vector<float3> aClusterGroupTriangleNormals(aiClusterTriangleNormalIndices.size());
-    for(uint32_t iTri = 0; iTri < static_cast<uint32_t>(aiClusterTriangleNormalIndices.size()); iTri += 3)
+    // re-build triangle indices, merging positions closer than the threshold
+    std::vector<uint32_t> aiTrianglePositionIndices;
+    std::vector<uint32_t> aiTrimmedPositionSources;
+    getTrimmedTriangleIndices(
+        aiTrianglePositionIndices,
+        aiTrimmedPositionSources,
+        aClusterGroupVertexPositions,
+        aiClusterTrianglePositionIndices,
+        1.0e-8f);
+    std::vector<float3> aTrimmedTotalVertexPositions(aiTrimmedPositionSources.size());
+    for(uint32_t i = 0; i < static_cast<uint32_t>(aiTrimmedPositionSources.size()); i++)
     {
-        uint32_t iNormal0 = aiClusterTriangleNormalIndices[iTri];
-        uint32_t iNormal1 = aiClusterTriangleNormalIndices[iTri + 1];
-        uint32_t iNormal2 = aiClusterTriangleNormalIndices[iTri + 2];
-
-        aClusterGroupTriangleNormals[iTri] = aClusterGroupVertexNormals[iNormal0];
-        aClusterGroupTriangleNormals[iTri + 1] = aClusterGroupVertexNormals[iNormal1];
-        aClusterGroupTriangleNormals[iTri + 2] = aClusterGroupVertexNormals[iNormal2];
-    }
-
-    // triangle uvs
-    std::vector<float2> aClusterGroupTriangleUVs(aiClusterTriangleUVIndices.size());
-    for(uint32_t iTri = 0; iTri < static_cast<uint32_t>(aiClusterTriangleUVIndices.size()); iTri += 3)
-    {
-        uint32_t iUV0 = aiClusterTriangleUVIndices[iTri];
-        uint32_t iUV1 = aiClusterTriangleUVIndices[iTri + 1];
-        uint32_t iUV2 = aiClusterTriangleUVIndices[iTri + 2];
-
-        aClusterGroupTriangleUVs[iTri] = aClusterGroupVertexUVs[iUV0];
-        aClusterGroupTriangleUVs[iTri + 1] = aClusterGroupVertexUVs[iUV1];
-        aClusterGroupTriangleUVs[iTri + 2] = aClusterGroupVertexUVs[iUV2];
-    }
-
-    float const kfDifferenceThreshold = 1.0e-8f;
-
-    // re-build triangle indices
-    std::vector<float3> aTrimmedTotalVertexPositions;
-    std::vector<uint32_t> aiTrianglePositionIndices(aClusterGroupTrianglePositions.size());
-    for(uint32_t i = 0; i < static_cast<uint32_t>(aClusterGroupTrianglePositions.size()); i++)
-    {
-        auto const& vertexPosition = aClusterGroupTrianglePositions[i];
-        auto iter = std::find_if(
-            aTrimmedTotalVertexPositions.begin(),
-            aTrimmedTotalVertexPositions.end(),
-            [vertexPosition,
-            kfDifferenceThreshold](float3 const& checkPos)
-            {
-                return length(checkPos - vertexPosition) < kfDifferenceThreshold;
-            }
-        );
-
-        uint32_t iVertexIndex = static_cast<uint32_t>(aTrimmedTotalVertexPositions.size());
-        if(iter == aTrimmedTotalVertexPositions.end())
-        {
-            aTrimmedTotalVertexPositions.push_back(vertexPosition);
-        }
-        else
-        {
-            iVertexIndex = static_cast<uint32_t>(std::distance(aTrimmedTotalVertexPositions.begin(), iter));
-        }
-
-        aiTrianglePositionIndices[i] = iVertexIndex;
+        aTrimmedTotalVertexPositions[i] = aClusterGroupVertexPositions[aiTrimmedPositionSources[i]];
     }
 
     // check for consistency
@@ -1377,62 +1387,41 @@ void splitClusterGroups(
     }
 
     // re-build triangle normals
-    std::vector<float3> aTrimmedTotalVertexNormals;
-    std::vector<uint32_t> aiTriangleNormalIndices(aClusterGroupTriangleNormals.size());
-    for(uint32_t i = 0; i < static_cast<uint32_t>(aClusterGroupTriangleNormals.size()); i++)
+    std::vector<uint32_t> aiTriangleNormalIndices;
+    std::vector<uint32_t> aiTrimmedNormalSources;
+    getTrimmedTriangleIndices(
+        aiTriangleNormalIndices,
+        aiTrimmedNormalSources,
+        aClusterGroupVertexNormals,
+        aiClusterTriangleNormalIndices,
+        1.0e-5f);
+    std::vector<float3> aTrimmedTotalVertexNormals(aiTrimmedNormalSources.size());
+    for(uint32_t i = 0; i < static_cast<uint32_t>(aiTrimmedNormalSources.size()); i++)
     {
-        auto const& vertexNormal = aClusterGroupTriangleNormals[i];
-        auto iter = std::find_if(
-            aTrimmedTotalVertexNormals.begin(),
-            aTrimmedTotalVertexNormals.end(),
-            [vertexNormal](float3 const& checkPos)
-            {
-                return length(checkPos - vertexNormal) < 1.0e-5f;
-            }
-        );
-
-        uint32_t iVertexIndex = static_cast<uint32_t>(aTrimmedTotalVertexNormals.size());
-        if(iter == aTrimmedTotalVertexNormals.end())
-        {
-            aTrimmedTotalVertexNormals.push_back(vertexNormal);
-        }
-        else
-        {
-            iVertexIndex = static_cast<uint32_t>(std::distance(aTrimmedTotalVertexNormals.begin(), iter));
-        }
-
-        aiTriangleNormalIndices[i] = iVertexIndex;
+        aTrimmedTotalVertexNormals[i] = aClusterGroupVertexNormals[aiTrimmedNormalSources[i]];
     }
 
-    // re-build triangle uvs
-    std::vector<float2> aTrimmedTotalVertexUVs;
-    std::vector<uint32_t> aiTriangleUVIndices(aClusterGroupTriangleUVs.size());
-    for(uint32_t i = 0; i < static_cast<uint32_t>(aClusterGroupTriangleUVs.size()); i++)
+    // re-build triangle uvs, hashed as positions on the z = 0 plane
+    std::vector<float3> aClusterGroupUVPositions(aClusterGroupVertexUVs.size());
+    for(uint32_t i = 0; i < static_cast<uint32_t>(aClusterGroupVertexUVs.size()); i++)
     {
-        auto const& vertexUV = aClusterGroupTriangleUVs[i];
-        auto iter = std::find_if(
-            aTrimmedTotalVertexUVs.begin(),
-            aTrimmedTotalVertexUVs.end(),
-            [vertexUV](float2 const& checkUV)
-            {
-                return length(checkUV - vertexUV) < 1.0e-5f;
-            }
-        );
-
-        uint32_t iVertexIndex = static_cast<uint32_t>(aTrimmedTotalVertexUVs.size());
-        if(iter == aTrimmedTotalVertexUVs.end())
-        {
-            aTrimmedTotalVertexUVs.push_back(vertexUV);
-        }
-        else
-        {
-            iVertexIndex = static_cast<uint32_t>(std::distance(aTrimmedTotalVertexUVs.begin(), iter));
-        }
-
-        aiTriangleUVIndices[i] = iVertexIndex;
+        aClusterGroupUVPositions[i] = float3(aClusterGroupVertexUVs[i].x, aClusterGroupVertexUVs[i].y, 0.0f);
+    }
+    std::vector<uint32_t> aiTriangleUVIndices;
+    std::vector<uint32_t> aiTrimmedUVSources;
+    getTrimmedTriangleIndices(
+        aiTriangleUVIndices,
+        aiTrimmedUVSources,
+        aClusterGroupUVPositions,
+        aiClusterTriangleUVIndices,
+        1.0e-5f);
+    std::vector<float2> aTrimmedTotalVertexUVs(aiTrimmedUVSources.size());
+    for(uint32_t i = 0; i < static_cast<uint32_t>(aiTrimmedUVSources.size()); i++)
+    {
+        aTrimmedTotalVertexUVs[i] = aClusterGroupVertexUVs[aiTrimmedUVSources[i]];
     }
 
-    uint32_t iPrevNumClusters = static_cast<uint32_t>(aaClusterVertexPositions.size());
+    uint32_t iPrevNumClusters = getNumClusters(clusters);
 
     std::vector<std::vector<float3>> aaTempClusterVertexPositions;
     std::vector<std::vector<float3>> aaTempClusterVertexNormals;
@@ -1475,105 +1464,35 @@ void splitClusterGroups(
     }
 
     // move large cluster triangles to smaller ones or merge small cluster triangles to larger clusters
-    {
-        bool bResetLoop = false;
-        for(uint32_t iCheckCluster = 0; iCheckCluster < static_cast<uint32_t>(aaiTempClusterTrianglePositionIndices.size()); iCheckCluster++)
-        {
-            if(bResetLoop)
-            {
-                iCheckCluster = 0;
-                bResetLoop = false;
-            }
-
-            if(aaiTempClusterTrianglePositionIndices[iCheckCluster].size() > 128 * 3)
-            {
-                //for(uint32_t j = 0; j < static_cast<uint32_t>(aaiTempClusterTrianglePositionIndices.size()); j++)
-                //{
-                //    DEBUG_PRINTF("BEFORE moveTriangle cluster %d size: %d\n",
-                //        j,
-                //        static_cast<uint32_t>(aaiTempClusterTrianglePositionIndices[j].size()));
-                //}
-
-                bResetLoop = moveTriangles(
-                    aaTempClusterVertexPositions,
-                    aaTempClusterVertexNormals,
-                    aaTempClusterVertexUVs,
-                    aaiTempClusterTrianglePositionIndices,
-                    aaiTempClusterTriangleNormalIndices,
-                    aaiTempClusterTriangleUVIndices,
-                    iCheckCluster,
-                    128 * 3);
-                if(bResetLoop)
-                {
-                    iCheckCluster = 0;
-                }
-
-                //for(uint32_t j = 0; j < static_cast<uint32_t>(aaiTempClusterTrianglePositionIndices.size()); j++)
-                //{
-                //    DEBUG_PRINTF("AFTER moveTriangles cluster %d size: %d\n",
-                //        j,
-                //        static_cast<uint32_t>(aaiTempClusterTrianglePositionIndices[j].size()));
-                //}
-                //DEBUG_PRINTF("\n");
-            }
-            else if(aaiTempClusterTrianglePositionIndices[iCheckCluster].size() <= 12)
-            {
-                //DEBUG_PRINTF("\n");
-                //for(uint32_t j = 0; j < static_cast<uint32_t>(aaiTempClusterTrianglePositionIndices.size()); j++)
-                //{
-                //    DEBUG_PRINTF("BEFORE mergeTriangles cluster %d size: %d\n",
-                //        j,
-                //        static_cast<uint32_t>(aaiTempClusterTrianglePositionIndices[j].size()));
-                //}
-
-                bResetLoop = mergeTriangles(
-                    aaTempClusterVertexPositions,
-                    aaTempClusterVertexNormals,
-                    aaTempClusterVertexUVs,
-                    aaiTempClusterTrianglePositionIndices,
-                    aaiTempClusterTriangleNormalIndices,
-                    aaiTempClusterTriangleUVIndices,
-                    iCheckCluster);
-                if(bResetLoop)
-                {
-                    iCheckCluster = 0;
-                }
-
-                //for(uint32_t j = 0; j < static_cast<uint32_t>(aaiTempClusterTrianglePositionIndices.size()); j++)
-                //{
-                //    DEBUG_PRINTF("AFTER mergeTriangles cluster %d size: %d\n",
-                //        j,
-                //        static_cast<uint32_t>(aaiTempClusterTrianglePositionIndices[j].size()));
-                //}
-                //DEBUG_PRINTF("\n");
-            }
-        }
-    }
+    rebalanceClusters(
+        aaTempClusterVertexPositions,
+        aaTempClusterVertexNormals,
+        aaTempClusterVertexUVs,
+        aaiTempClusterTrianglePositionIndices,
+        aaiTempClusterTriangleNormalIndices,
+        aaiTempClusterTriangleUVIndices,
+        128 * 3,
+        12);
 
     for(uint32_t i = 0; i < static_cast<uint32_t>(aaTempClusterVertexPositions.size()); i++)
     {
         if(aaTempClusterVertexPositions[i].size() > 0)
         {
-            aaClusterVertexPositions.push_back(aaTempClusterVertexPositions[i]);
-            aaClusterVertexNormals.push_back(aaTempClusterVertexNormals[i]);
-            aaClusterVertexUVs.push_back(aaTempClusterVertexUVs[i]);
-
-            aaiClusterTrianglePositionIndices.push_back(aaiTempClusterTrianglePositionIndices[i]);
-            aaiClusterTriangleNormalIndices.push_back(aaiTempClusterTriangleNormalIndices[i]);
-            aaiClusterTriangleUVIndices.push_back(aaiTempClusterTriangleUVIndices[i]);
+            appendCluster(
+                clusters,
+                aaTempClusterVertexPositions[i],
+                aaTempClusterVertexNormals[i],
+                aaTempClusterVertexUVs[i],
+                aaiTempClusterTrianglePositionIndices[i],
+                aaiTempClusterTriangleNormalIndices[i],
+                aaiTempClusterTriangleUVIndices[i]);
         }
     }
 
     // cluster clean up here...
 
-    uint32_t iCurrNumClusters = static_cast<uint32_t>(aaClusterVertexPositions.size());
+    uint32_t iCurrNumClusters = getNumClusters(clusters);
     iTotalClusterIndex += (iCurrNumClusters - iPrevNumClusters);
-
-    assert(aaClusterVertexPositions.size() == aaClusterVertexNormals.size());
-    assert(aaClusterVertexPositions.size() == aaClusterVertexUVs.size());
-
-    assert(aaiClusterTrianglePositionIndices.size() == aaiClusterTriangleNormalIndices.size());
-    assert(aaiClusterTrianglePositionIndices.size() == aaiClusterTriangleUVIndices.size());
 }
 
 /*
@@ -1600,70 +1519,26 @@ void splitLargeClusters(
 
         if(aaiClusterTrianglePositionIndices[iCluster].size() >= iMaxTrianglesPerCluster)
         {
-            std::ostringstream metisFileFolderPath;
-            {
-                metisFileFolderPath << homeDirectory << "metis\\" << meshModelName << "\\";
-                std::filesystem::path metisFileFolderFileSystemPath(metisFileFolderPath.str());
-                if(!std::filesystem::exists(metisFileFolderFileSystemPath))
-                {
-                    std::filesystem::create_directory(metisFileFolderFileSystemPath);
-                }
-            }
-
-            std::ostringstream outputMetisSplitMeshFilePath;
-            outputMetisSplitMeshFilePath << metisFileFolderPath.str() << "split-cluster";
-            outputMetisSplitMeshFilePath << iCluster << "-lod" << 0 << ".mesh";
-
-            buildMETISMeshFile2(
-                outputMetisSplitMeshFilePath.str(),
-                aaiClusterTrianglePositionIndices[iCluster]);
-
             uint32_t iNumSplitClusters = static_cast<uint32_t>(aaiClusterTrianglePositionIndices[iCluster].size()) / (128 * 3);
             iNumSplitClusters = std::max(iNumSplitClusters, 2u);
-            // exec the mpmetis to generate the initial clusters
-            std::ostringstream metisCommand;
-            metisCommand << "D:\\test\\METIS\\build\\windows\\programs\\Debug\\mpmetis.exe ";
-            metisCommand << outputMetisSplitMeshFilePath.str() << " ";
-            metisCommand << "-gtype=dual ";
-            metisCommand << "-ncommon=2 ";
-            metisCommand << "-objtype=cut ";
-            metisCommand << "-ufactor=60 ";
-            metisCommand << "-contig ";
-            //metisCommand << "-minconn ";
-            //metisCommand << "-niter=20 ";
-            metisCommand << iNumSplitClusters;
-            std::string result = execCommand(metisCommand.str(), false);
-            if(result.find("Metis returned with an error.") != std::string::npos)
-            {
-                metisCommand = std::ostringstream();
-                metisCommand << "D:\\test\\METIS\\build\\windows\\programs\\Debug\\mpmetis.exe ";
-                metisCommand << outputMetisSplitMeshFilePath.str() << " ";
-                metisCommand << "-gtype=dual ";
-                metisCommand << "-ncommon=2 ";
-                metisCommand << "-objtype=cut ";
-                //metisCommand << "-ufactor=600 ";
-                metisCommand << iNumSplitClusters;
-                result = execCommand(metisCommand.str(), false);
-                assert(result.find("Metis returned with an error.") == std::string::npos);
-            }
-
-            std::ostringstream outputSplitPartitionFilePath;
-            outputSplitPartitionFilePath << outputMetisSplitMeshFilePath.str() << ".epart.";
-            outputSplitPartitionFilePath << iNumSplitClusters;
 
-            std::vector<uint32_t> aiClusters;
-            readMetisClusterFile(aiClusters, outputSplitPartitionFilePath.str());
+            // partition the cluster's triangles, same settings as mpmetis -gtype=dual -ncommon=2 -objtype=cut -ufactor=60 -contig
+            std::vector<uint32_t> aiSplitClusters;
+            bool bPartitioned = partitionMETISMesh(
+                aiSplitClusters,
+                aaiClusterTrianglePositionIndices[iCluster],
+                iNumSplitClusters,
+                false,
+                true,
+                60);
+            assert(bPartitioned);
 
             // map of element index (triangle index) to cluster
             std::map<uint32_t, std::vector<uint32_t>> aSplitClusterMap;
+            for(uint32_t i = 0; i < static_cast<uint32_t>(aiSplitClusters.size()); i++)
             {
-                std::vector<uint32_t> aiSplitClusters;
-                readMetisClusterFile(aiSplitClusters, outputSplitPartitionFilePath.str());
-                for(uint32_t i = 0; i < static_cast<uint32_t>(aiSplitClusters.size()); i++)
-                {
-                    uint32_t const& iSplitCluster = aiSplitClusters[i];
-                    aSplitClusterMap[iSplitCluster].push_back(i);
-                }
+                uint32_t const& iSplitCluster = aiSplitClusters[i];
+                aSplitClusterMap[iSplitCluster].push_back(i);
             }
 
             std::vector<std::vector<float3>> aaSplitClusterVertexPositions(iNumSplitClusters);
@@ -1792,12 +1667,6 @@ void splitCluster3(
     uint32_t iOrigCluster,
     uint32_t iMaxTrianglesPerCluster)
 {
-    struct AdjacencyInfo
-    {
-        uint32_t        miNumAdjacentTriangles;
-        uint32_t        maiAdjacentTriangles[64];
-    };
-
     auto const& aClusterVertexPositions = aaClusterVertexPositions[iOrigCluster];
     auto const& aClusterVertexNormals = aaClusterVertexNormals[iOrigCluster];
     auto const& aClusterVertexUVs = aaClusterVertexUVs[iOrigCluster];
@@ -1806,149 +1675,184 @@ void splitCluster3(
     auto const& aiClusterTriangleNormalIndices = aaiClusterTriangleNormalIndices[iOrigCluster];
     auto const& aiClusterTriangleUVIndices = aaiClusterTriangleUVIndices[iOrigCluster];
 
-    //uint32_t aiNumPartitionTriangles[MAX_SPLIT_CLUSTERS];
-    std::vector<uint32_t> aiNumPartitionTriangles;
-
     uint32_t iNumTrianglePositionIndices = static_cast<uint32_t>(aiClusterTrianglePositionIndices.size());
-
-    // build adjacency info for all the triangles
-    std::vector<AdjacencyInfo> aTriangleAdjacencyInfo(iNumTrianglePositionIndices);
-    for(uint32_t iTri = 0; iTri < iNumTrianglePositionIndices; iTri += 3)
+    uint32_t iNumTriangles = iNumTrianglePositionIndices / 3;
+
+    // edge hash and vertex -> corner rings of the cluster's triangles
+    MeshConnectivity connectivity;
+    buildMeshConnectivity(
+        connectivity,
+        aiClusterTrianglePositionIndices,
+        static_cast<uint32_t>(aClusterVertexPositions.size()));
+
+    // triangles sharing an edge, found in the corner ring of the edge's first vertex
+    std::vector<uint32_t> aiAdjacencyStart(iNumTriangles + 1, 0);
+    std::vector<uint32_t> aiAdjacentTriangles;
+    aiAdjacentTriangles.reserve(iNumTriangles * 3);
+    for(uint32_t iTri = 0; iTri < iNumTriangles; iTri++)
     {
-        for(uint32_t iCheckTri = 0; iCheckTri < iNumTrianglePositionIndices; iCheckTri += 3)
+        aiAdjacencyStart[iTri] = static_cast<uint32_t>(aiAdjacentTriangles.size());
+        for(uint32_t iTriEdge = 0; iTriEdge < 3; iTriEdge++)
         {
-            if(iTri == iCheckTri)
+            uint32_t iPos0 = aiClusterTrianglePositionIndices[iTri * 3 + iTriEdge];
+            uint32_t iPos1 = aiClusterTrianglePositionIndices[iTri * 3 + (iTriEdge + 1) % 3];
+            if(iPos0 == iPos1 || getConnectivityEdgeTriangleCount(connectivity, iPos0, iPos1) < 2)
             {
                 continue;
             }
 
-            uint32_t iNumSamePos = 0;
-            for(uint32_t i = 0; i < 3; i++)
+            uint32_t iRingStart = connectivity.maiVertexRingStart[iPos0];
+            uint32_t iRingEnd = iRingStart + connectivity.maiVertexRingCount[iPos0];
+            for(uint32_t iRing = iRingStart; iRing < iRingEnd; iRing++)
             {
-                for(uint32_t j = 0; j < 3; j++)
+                uint32_t iCheckTri = connectivity.maiCorners[iRing] / 3;
+                if(iCheckTri != iTri &&
+                    (aiClusterTrianglePositionIndices[iCheckTri * 3] == iPos1 ||
+                    aiClusterTrianglePositionIndices[iCheckTri * 3 + 1] == iPos1 ||
+                    aiClusterTrianglePositionIndices[iCheckTri * 3 + 2] == iPos1))
                 {
-                    if(aiClusterTrianglePositionIndices[iTri + i] == aiClusterTrianglePositionIndices[iCheckTri + j])
-                    {
-                        ++iNumSamePos;
-                        break;
-                    }
+                    aiAdjacentTriangles.push_back(iCheckTri);
                 }
             }
-
-            if(iNumSamePos > 0)
-            {
-                uint32_t iTriIndex = iTri / 3;
-                uint32_t iCheckTriIndex = iCheckTri / 3;
-
-                assert(iCheckTri < aiClusterTrianglePositionIndices.size());
-
-                aTriangleAdjacencyInfo[iTriIndex].maiAdjacentTriangles[aTriangleAdjacencyInfo[iTriIndex].miNumAdjacentTriangles] = iCheckTriIndex;
-                aTriangleAdjacencyInfo[iTriIndex].miNumAdjacentTriangles += 1;
-            }
         }
     }
+    aiAdjacencyStart[iNumTriangles] = static_cast<uint32_t>(aiAdjacentTriangles.size());
 
-    //std::vector<std::vector<uint32_t>> aaiClusterTriangles(MAX_SPLIT_CLUSTERS);
-    //for(uint32_t i = 0; i < aaiClusterTriangles.size(); i++)
-    //{
-    //    aaiClusterTriangles[i].resize(1024);
-    //}
-    std::vector<std::vector<uint32_t>> aaiClusterTriangles;
-
-    uint32_t iNumTotalTriAdded = 0;
-    uint32_t iSplitClusterID = 0;
+    // triangle centroids and the average edge length, used to weigh distance against shared edges
+    std::vector<float3> aTriangleCentroids(iNumTriangles);
+    float fAverageEdgeLength = 0.0f;
+    for(uint32_t iTri = 0; iTri < iNumTriangles; iTri++)
+    {
+        float3 const& pos0 = aClusterVertexPositions[aiClusterTrianglePositionIndices[iTri * 3]];
+        float3 const& pos1 = aClusterVertexPositions[aiClusterTrianglePositionIndices[iTri * 3 + 1]];
+        float3 const& pos2 = aClusterVertexPositions[aiClusterTrianglePositionIndices[iTri * 3 + 2]];
+        aTriangleCentroids[iTri] = (pos0 + pos1 + pos2) / 3.0f;
+        fAverageEdgeLength += length(pos1 - pos0) + length(pos2 - pos0) + length(pos2 - pos1);
+    }
+    fAverageEdgeLength /= static_cast<float>(std::max(iNumTriangles * 3, 1u));
 
     uint32_t iNumClusters = uint32_t(ceilf(float(iNumTrianglePositionIndices) / float(iMaxTrianglesPerCluster)));
-    uint32_t iNumTrianglesPerCluster = uint32_t(ceilf(float(iNumTrianglePositionIndices) / float(iNumClusters))) / 3;
+    uint32_t iNumTrianglesPerCluster = uint32_t(ceilf(float(iNumTrianglePositionIndices) / float(std::max(iNumClusters, 1u)))) / 3;
+    iNumTrianglesPerCluster = std::max(iNumTrianglesPerCluster, 1u);
 
-    std::vector<uint32_t> aiAdded(1 << 16);
-    memset(aiAdded.data(), 0, sizeof(uint32_t) * (1 << 16));
-    uint32_t iPartition = 0;
-    for(iPartition = 0;; iPartition++)
+    // grow one partition at a time, always adding the edge-adjacent candidate closest to the partition's centroid
+    // each edge shared with the partition pulls a candidate forward by an average edge length, this fills in notches first
+    // a candidate is pushed again each time its shared edge count goes up, entries of already assigned triangles are skipped when popped
+    std::vector<std::vector<uint32_t>> aaiClusterTriangles;
+    std::vector<uint32_t> aiTrianglePartitions(iNumTriangles, UINT32_MAX);
+    std::vector<uint32_t> aiNumSharedEdges(iNumTriangles, 0);
+    std::vector<uint32_t> aiNumClosedEdges(iNumTriangles, 0);
+    std::priority_queue<RegionSeedQueueEntry> seedQueue;
+    for(uint32_t iTri = 0; iTri < iNumTriangles; iTri++)
     {
-        //assert(iPartition < MAX_SPLIT_CLUSTERS);
-
-        //aiNumPartitionTriangles[iPartition] = 0;
-        aiNumPartitionTriangles.push_back(0);
-
-        iSplitClusterID += iPartition;
-        if(iNumTotalTriAdded >= iNumTrianglePositionIndices / 3)
+        aiNumClosedEdges[iTri] = 3 - std::min(aiAdjacencyStart[iTri + 1] - aiAdjacencyStart[iTri], 3u);
+        seedQueue.push({ aiNumClosedEdges[iTri], iTri });
+    }
+    std::vector<uint32_t> aiTouchedTriangles;
+    std::priority_queue<RegionGrowQueueEntry, std::vector<RegionGrowQueueEntry>, std::greater<RegionGrowQueueEntry>> candidateQueue;
+    uint32_t iNumTotalTriAdded = 0;
+    while(iNumTotalTriAdded < iNumTriangles)
+    {
+        // seed with the unassigned triangle with the most edges on the mesh boundary or against finished partitions, starting in a corner of what's left avoids thin left over strips
+        // the seed queue gets a new entry whenever a closed edge count goes up, entries of assigned triangles and old counts are skipped
+        while(aiTrianglePartitions[seedQueue.top().miTriangle] != UINT32_MAX ||
+            aiNumClosedEdges[seedQueue.top().miTriangle] != seedQueue.top().miNumClosedEdges)
         {
-            break;
+            seedQueue.pop();
         }
+        uint32_t iSeedTri = seedQueue.top().miTriangle;
 
-        aaiClusterTriangles.resize(aaiClusterTriangles.size() + 1);
+        uint32_t iCurrPartition = static_cast<uint32_t>(aaiClusterTriangles.size());
+        aaiClusterTriangles.emplace_back();
+        auto& aiPartitionTriangles = aaiClusterTriangles.back();
+        float3 partitionCentroidSum = float3(0.0f, 0.0f, 0.0f);
 
-        // add starting triangle ID
-        uint32_t iNumClusterTriAdded = 0;
-        for(uint32_t iStartTri = 0; iStartTri < iNumTrianglePositionIndices; iStartTri += 3)
+        candidateQueue = decltype(candidateQueue)();
+        candidateQueue.push({ 0.0f, iSeedTri });
+        while(static_cast<uint32_t>(aiPartitionTriangles.size()) < iNumTrianglesPerCluster)
         {
-            uint32_t iStartTriID = iStartTri / 3;
-            assert(iStartTriID < aiAdded.size());
-            if(aiAdded[iStartTriID] > 0)
+            uint32_t iAddTri = UINT32_MAX;
+            while(!candidateQueue.empty())
             {
-                continue;
+                uint32_t iCandidateTri = candidateQueue.top().miTriangle;
+                candidateQueue.pop();
+                if(aiTrianglePartitions[iCandidateTri] == UINT32_MAX)
+                {
+                    iAddTri = iCandidateTri;
+                    break;
+                }
             }
-            //assert(iPartition < MAX_SPLIT_CLUSTERS);
-            //aaiClusterTriangles[iPartition][0] = iStartTri / 3;
-            aaiClusterTriangles[iPartition].push_back(iStartTri / 3);
-
-            //assert(iStartTriID < sizeof(aiAdded) / sizeof(*aiAdded));
-            assert(iStartTriID < aiAdded.size());
-            aiAdded[iStartTriID] = 1;
-
-            ++iNumClusterTriAdded;
-            ++iNumTotalTriAdded;
-            ++aiNumPartitionTriangles[iPartition];
-
-            break;
-        }
 
-        assert(aaiClusterTriangles[iPartition].size() == iNumClusterTriAdded);
-        for(uint32_t iTri = 0; iTri < iNumClusterTriAdded; iTri++)
-        {
-            // add adjacent triangle IDs
-            assert(iTri < aaiClusterTriangles[iPartition].size());
-            uint32_t iTriID = aaiClusterTriangles[iPartition][iTri];
-            AdjacencyInfo adjacencyInfo = aTriangleAdjacencyInfo[iTriID];
-            for(uint32_t iAddTri = 0; iAddTri < adjacencyInfo.miNumAdjacentTriangles; iAddTri++)
+            // nothing left across the partition's edges, continue with the closest triangle only sharing a vertex
+            if(iAddTri == UINT32_MAX)
             {
-                if(iNumClusterTriAdded >= iNumTrianglesPerCluster)
+                float3 partitionCentroid = partitionCentroidSum / static_cast<float>(aiPartitionTriangles.size());
+                float fClosestDistance = FLT_MAX;
+                for(auto const& iPartitionTri : aiPartitionTriangles)
                 {
-                    break;
+                    for(uint32_t i = 0; i < 3; i++)
+                    {
+                        uint32_t iPos = aiClusterTrianglePositionIndices[iPartitionTri * 3 + i];
+                        uint32_t iRingStart = connectivity.maiVertexRingStart[iPos];
+                        uint32_t iRingEnd = iRingStart + connectivity.maiVertexRingCount[iPos];
+                        for(uint32_t iRing = iRingStart; iRing < iRingEnd; iRing++)
+                        {
+                            uint32_t iCheckTri = connectivity.maiCorners[iRing] / 3;
+                            float fDistance = length(aTriangleCentroids[iCheckTri] - partitionCentroid);
+                            if(aiTrianglePartitions[iCheckTri] == UINT32_MAX && fDistance < fClosestDistance)
+                            {
+                                fClosestDistance = fDistance;
+                                iAddTri = iCheckTri;
+                            }
+                        }
+                    }
                 }
 
-                uint32_t iAdjacentTriID = adjacencyInfo.maiAdjacentTriangles[iAddTri];
-                if(iAdjacentTriID >= aiAdded.size())
+                if(iAddTri == UINT32_MAX)
                 {
-                    uint32_t iPrevSize = static_cast<uint32_t>(aiAdded.size());
-                    aiAdded.resize(aiAdded.size() + aiAdded.size());
-                    memset(aiAdded.data() + iPrevSize, 0, aiAdded.size() * sizeof(uint32_t));
+                    break;
                 }
+            }
+
+            aiTrianglePartitions[iAddTri] = iCurrPartition;
+            aiPartitionTriangles.push_back(iAddTri);
+            ++iNumTotalTriAdded;
+
+            partitionCentroidSum += aTriangleCentroids[iAddTri];
+            float3 partitionCentroid = partitionCentroidSum / static_cast<float>(aiPartitionTriangles.size());
 
-                if(aiAdded[iAdjacentTriID] > 0)
+            for(uint32_t iAdjacent = aiAdjacencyStart[iAddTri]; iAdjacent < aiAdjacencyStart[iAddTri + 1]; iAdjacent++)
+            {
+                uint32_t iAdjacentTri = aiAdjacentTriangles[iAdjacent];
+                if(aiTrianglePartitions[iAdjacentTri] != UINT32_MAX)
                 {
                     continue;
                 }
 
-                assert(iAdjacentTriID * 3 < iNumTrianglePositionIndices);
-                //aaiClusterTriangles[iPartition][iNumClusterTriAdded] = iAdjacentTriID;
-                aaiClusterTriangles[iPartition].push_back(iAdjacentTriID);
-                aiAdded[iAdjacentTriID] = 1;
+                ++aiNumClosedEdges[iAdjacentTri];
+                seedQueue.push({ aiNumClosedEdges[iAdjacentTri], iAdjacentTri });
 
-                ++iNumClusterTriAdded;
-                ++iNumTotalTriAdded;
-                ++aiNumPartitionTriangles[iPartition];
-            }
+                if(aiNumSharedEdges[iAdjacentTri] == 0)
+                {
+                    aiTouchedTriangles.push_back(iAdjacentTri);
+                }
+                ++aiNumSharedEdges[iAdjacentTri];
 
-            if(iNumClusterTriAdded >= iNumTrianglesPerCluster)
-            {
-                break;
+                float fScore = length(aTriangleCentroids[iAdjacentTri] - partitionCentroid) - fAverageEdgeLength * static_cast<float>(aiNumSharedEdges[iAdjacentTri]);
+                candidateQueue.push({ fScore, iAdjacentTri });
             }
 
-        }   // for tri = 0 to curr num tri added 
+        }   // while partition is not full
 
-    }   // for partition = 0 to num partitions
+        for(auto const& iTouchedTri : aiTouchedTriangles)
+        {
+            aiNumSharedEdges[iTouchedTri] = 0;
+        }
+        aiTouchedTriangles.clear();
+
+    }   // while triangles left to add
+
+    uint32_t iPartition = static_cast<uint32_t>(aaiClusterTriangles.size());
 
     aaSplitClusterVertexPositions.resize(iPartition);
     aaSplitClusterVertexNormals.resize(iPartition);
@@ -1957,119 +1861,80 @@ void splitCluster3(
     aaiSplitClusterTriangleNormalIndices.resize(iPartition);
     aaiSplitClusterTriangleUVIndices.resize(iPartition);
 
+    // source -> partition index of the positions, normals, and uvs, only the entries used by a partition are reset after it
+    std::vector<uint32_t> aiPositionRemap(aClusterVertexPositions.size(), UINT32_MAX);
+    std::vector<uint32_t> aiNormalRemap(aClusterVertexNormals.size(), UINT32_MAX);
+    std::vector<uint32_t> aiUVRemap(aClusterVertexUVs.size(), UINT32_MAX);
+    std::vector<uint32_t> aiUsedPositions, aiUsedNormals, aiUsedUVs;
     for(uint32_t iCluster = 0; iCluster < iPartition; iCluster++)
     {
-        uint32_t iNumClusterTriangles = aiNumPartitionTriangles[iCluster];
         auto const& aiClusterTriangles = aaiClusterTriangles[iCluster];
-        
-        // partition positions, normals, and uvs
+        uint32_t iNumClusterTriangles = static_cast<uint32_t>(aiClusterTriangles.size());
+
+        auto& aSplitVertexPositions = aaSplitClusterVertexPositions[iCluster];
+        auto& aSplitVertexNormals = aaSplitClusterVertexNormals[iCluster];
+        auto& aSplitVertexUVs = aaSplitClusterVertexUVs[iCluster];
+        auto& aiSplitTrianglePositionIndices = aaiSplitClusterTrianglePositionIndices[iCluster];
+        auto& aiSplitTriangleNormalIndices = aaiSplitClusterTriangleNormalIndices[iCluster];
+        auto& aiSplitTriangleUVIndices = aaiSplitClusterTriangleUVIndices[iCluster];
+        aiSplitTrianglePositionIndices.reserve(iNumClusterTriangles * 3);
+        aiSplitTriangleNormalIndices.reserve(iNumClusterTriangles * 3);
+        aiSplitTriangleUVIndices.reserve(iNumClusterTriangles * 3);
+
+        // partition positions, normals, uvs, and their triangle indices in order of first use
         for(uint32_t iTri = 0; iTri < iNumClusterTriangles; iTri++)
         {
             uint32_t iTriID = aiClusterTriangles[iTri];
             for(uint32_t i = 0; i < 3; i++)
             {
                 uint32_t iSrcIndex = iTriID * 3 + i;
-                
-                // position
-                float3 const& position = aClusterVertexPositions[aiClusterTrianglePositionIndices[iSrcIndex]];
-                auto positionIter = std::find_if(
-                    aaSplitClusterVertexPositions[iCluster].begin(),
-                    aaSplitClusterVertexPositions[iCluster].end(),
-                    [position](float3 const& checkPosition)
-                    {
-                        return (lengthSquared(position - checkPosition) <= 1.0e-8f);
-                    });
-                if(positionIter == aaSplitClusterVertexPositions[iCluster].end())
+
+                uint32_t iSrcPosition = aiClusterTrianglePositionIndices[iSrcIndex];
+                if(aiPositionRemap[iSrcPosition] == UINT32_MAX)
                 {
-                    aaSplitClusterVertexPositions[iCluster].push_back(position);
+                    aiPositionRemap[iSrcPosition] = static_cast<uint32_t>(aSplitVertexPositions.size());
+                    aSplitVertexPositions.push_back(aClusterVertexPositions[iSrcPosition]);
+                    aiUsedPositions.push_back(iSrcPosition);
                 }
+                aiSplitTrianglePositionIndices.push_back(aiPositionRemap[iSrcPosition]);
 
-                // normal
-                float3 const& normal = aClusterVertexNormals[aiClusterTriangleNormalIndices[iSrcIndex]];
-                auto normalIter = std::find_if(
-                    aaSplitClusterVertexNormals[iCluster].begin(),
-                    aaSplitClusterVertexNormals[iCluster].end(),
-                    [normal](float3 const& checkNormal)
-                    {
-                        return (lengthSquared(normal - checkNormal) <= 1.0e-8f);
-                    });
-                if(normalIter == aaSplitClusterVertexNormals[iCluster].end())
+                uint32_t iSrcNormal = aiClusterTriangleNormalIndices[iSrcIndex];
+                if(aiNormalRemap[iSrcNormal] == UINT32_MAX)
                 {
-                    aaSplitClusterVertexNormals[iCluster].push_back(normal);
+                    aiNormalRemap[iSrcNormal] = static_cast<uint32_t>(aSplitVertexNormals.size());
+                    aSplitVertexNormals.push_back(aClusterVertexNormals[iSrcNormal]);
+                    aiUsedNormals.push_back(iSrcNormal);
                 }
-                
-                // uv
-                float2 const& uv = aClusterVertexUVs[aiClusterTriangleUVIndices[iSrcIndex]];
-                auto uvIter = std::find_if(
-                    aaSplitClusterVertexUVs[iCluster].begin(),
-                    aaSplitClusterVertexUVs[iCluster].end(),
-                    [uv](float2 const& checkUV)
-                    {
-                        return (lengthSquared(uv - checkUV) <= 1.0e-8f);
-                    });
-                if(uvIter == aaSplitClusterVertexUVs[iCluster].end())
+                aiSplitTriangleNormalIndices.push_back(aiNormalRemap[iSrcNormal]);
+
+                uint32_t iSrcUV = aiClusterTriangleUVIndices[iSrcIndex];
+                if(aiUVRemap[iSrcUV] == UINT32_MAX)
                 {
-                    aaSplitClusterVertexUVs[iCluster].push_back(uv);
+                    aiUVRemap[iSrcUV] = static_cast<uint32_t>(aSplitVertexUVs.size());
+                    aSplitVertexUVs.push_back(aClusterVertexUVs[iSrcUV]);
+                    aiUsedUVs.push_back(iSrcUV);
                 }
-
-            }   // for i = 0 to 3 
-        
-        }   // for tri = 0 to num triangles
-
-        // partition position indices, normal indices, and uv indices
-        for(uint32_t iTri = 0; iTri < iNumClusterTriangles; iTri++)
-        {
-            uint32_t iTriID = aiClusterTriangles[iTri];
-            for(uint32_t i = 0; i < 3; i++)
-            {
-                uint32_t iSrcIndex = iTriID * 3 + i;
-                uint32_t iDestIndex = iTri * 3 + i;
-
-                // position
-                float3 const& position = aClusterVertexPositions[aiClusterTrianglePositionIndices[iSrcIndex]];
-                auto positionIter = std::find_if(
-                    aaSplitClusterVertexPositions[iCluster].begin(),
-                    aaSplitClusterVertexPositions[iCluster].end(),
-                    [position](float3 const& checkPosition)
-                    {
-                        return (lengthSquared(position - checkPosition) <= 1.0e-8f);
-                    });
-                assert(positionIter != aaSplitClusterVertexPositions[iCluster].end());
-                uint32_t iPositionIndex = static_cast<uint32_t>(std::distance(aaSplitClusterVertexPositions[iCluster].begin(), positionIter));
-                aaiSplitClusterTrianglePositionIndices[iCluster].push_back(iPositionIndex);
-                assert(lengthSquared(aaSplitClusterVertexPositions[iCluster][iPositionIndex] - position) <= 1.0e-8f);
-
-                // normal
-                float3 const& normal = aClusterVertexNormals[aiClusterTriangleNormalIndices[iSrcIndex]];
-                auto normalIter = std::find_if(
-                    aaSplitClusterVertexNormals[iCluster].begin(),
-                    aaSplitClusterVertexNormals[iCluster].end(),
-                    [normal](float3 const& checkNormal)
-                    {
-                        return (lengthSquared(normal - checkNormal) <= 1.0e-8f);
-                    });
-                assert(normalIter != aaSplitClusterVertexNormals[iCluster].end());
-                uint32_t iNormalIndex = static_cast<uint32_t>(std::distance(aaSplitClusterVertexNormals[iCluster].begin(), normalIter));
-                aaiSplitClusterTriangleNormalIndices[iCluster].push_back(iNormalIndex);
-                assert(lengthSquared(aaSplitClusterVertexNormals[iCluster][iNormalIndex] - normal) <= 1.0e-8f);
-
-                // uv
-                float2 const& uv = aClusterVertexUVs[aiClusterTriangleUVIndices[iSrcIndex]];
-                auto uvIter = std::find_if(
-                    aaSplitClusterVertexUVs[iCluster].begin(),
-                    aaSplitClusterVertexUVs[iCluster].end(),
-                    [uv](float2 const& checkUV)
-                    {
-                        return (lengthSquared(uv - checkUV) <= 1.0e-8f);
-                    });
-                assert(uvIter != aaSplitClusterVertexUVs[iCluster].end());
-                uint32_t iUVIndex = static_cast<uint32_t>(std::distance(aaSplitClusterVertexUVs[iCluster].begin(), uvIter));
-                aaiSplitClusterTriangleUVIndices[iCluster].push_back(iUVIndex);
-                assert(lengthSquared(aaSplitClusterVertexUVs[iCluster][iUVIndex] - uv) <= 1.0e-8f);
+                aiSplitTriangleUVIndices.push_back(aiUVRemap[iSrcUV]);
 
             }   // for i = 0 to 3
 
         }   // for tri = 0 to num cluster triangles
-        
+
+        for(auto const& iSrcPosition : aiUsedPositions)
+        {
+            aiPositionRemap[iSrcPosition] = UINT32_MAX;
+        }
+        for(auto const& iSrcNormal : aiUsedNormals)
+        {
+            aiNormalRemap[iSrcNormal] = UINT32_MAX;
+        }
+        for(auto const& iSrcUV : aiUsedUVs)
+        {
+            aiUVRemap[iSrcUV] = UINT32_MAX;
+        }
+        aiUsedPositions.clear();
+        aiUsedNormals.clear();
+        aiUsedUVs.clear();
+
     }   // for cluster = 0 to num clusters
 }
\ No newline at end of file
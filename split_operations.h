@@ -1,6 +1,7 @@
 #pragma once
 
 #include "vec.h"
+#include "cluster_store.h"
 #include <mutex>
 #include <vector>
 
@@ -69,12 +70,7 @@ void splitCluster(
     uint32_t iMaxTriangles);
 
 void splitClusterGroups(
-    std::vector<std::vector<float3>>& aaClusterVertexPositions,
-    std::vector<std::vector<float3>>& aaClusterVertexNormals,
-    std::vector<std::vector<float2>>& aaClusterVertexUVs,
-    std::vector<std::vector<uint32_t>>& aaiClusterTrianglePositionIndices,
-    std::vector<std::vector<uint32_t>>& aaiClusterTriangleNormalIndices,
-    std::vector<std::vector<uint32_t>>& aaiClusterTriangleUVIndices,
+    ClusterStore& clusters,
     uint32_t& iTotalClusterIndex,
     std::vector<float3> const& aClusterGroupVertexPositions,
     std::vector<float3> const& aClusterGroupVertexNormals,
@@ -82,12 +78,7 @@ void splitClusterGroups(
     std::vector<uint32_t> const& aiClusterTrianglePositionIndices,
     std::vector<uint32_t> const& aiClusterTriangleNormalIndices,
     std::vector<uint32_t> const& aiClusterTriangleUVIndices,
-    uint32_t iMaxTrianglesPerCluster,
-    uint32_t iNumSplitClusters,
-    uint32_t iLODLevel,
-    uint32_t iClusterGroup,
-    std::string const& meshModelName,
-    std::string const& homeDirectory);
+    uint32_t iMaxTrianglesPerCluster);
 
 
 void splitLargeClusters(
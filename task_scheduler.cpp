@@ -0,0 +1,318 @@
+#include "task_scheduler.h"
+
+#include <cassert>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+struct Task
+{
+    std::function<void()>       mTask;
+    TaskCounter*                mpCounter;
+};
+
+struct TaskQueue
+{
+    std::mutex                  mMutex;
+    std::deque<Task>            maTasks;
+};
+
+// worker threads own queues 0 to num threads - 1, the last queue belongs to no worker and is shared by all the threads outside
+// of the pool (main thread included), workers steal from it like from each other
+//      one condition variable for idle workers and waiting threads, woken on queued tasks and on counters reaching 0
+struct TaskScheduler
+{
+    std::vector<std::unique_ptr<TaskQueue>>     mapQueues;
+    std::vector<std::thread>                    maThreads;
+
+    std::mutex                                  mSleepMutex;
+    std::condition_variable                     mWakeCondition;
+    std::atomic<uint32_t>                       miNumQueuedTasks{ 0 };
+    bool                                        mbShutdown = false;
+
+    TaskScheduler();
+    ~TaskScheduler();
+};
+
+static thread_local uint32_t siWorkerQueue = UINT32_MAX;
+
+/*
+**
+*/
+static TaskScheduler& getTaskScheduler()
+{
+    static TaskScheduler sScheduler;
+    return sScheduler;
+}
+
+/*
+**
+*/
+static uint32_t getHomeQueue(TaskScheduler const& scheduler)
+{
+    return (siWorkerQueue != UINT32_MAX) ? siWorkerQueue : static_cast<uint32_t>(scheduler.mapQueues.size() - 1);
+}
+
+/*
+**
+*/
+static bool tryRunTask(
+    TaskScheduler& scheduler,
+    uint32_t iHomeQueue)
+{
+    uint32_t iNumQueues = static_cast<uint32_t>(scheduler.mapQueues.size());
+
+    // own queue newest first, then steal the oldest task of the other queues
+    Task task;
+    bool bFound = false;
+    for(uint32_t i = 0; i < iNumQueues && !bFound; i++)
+    {
+        uint32_t iQueue = (iHomeQueue + i) % iNumQueues;
+        TaskQueue& queue = *scheduler.mapQueues[iQueue];
+        std::lock_guard<std::mutex> lock(queue.mMutex);
+        if(queue.maTasks.empty())
+        {
+            continue;
+        }
+
+        if(iQueue == iHomeQueue)
+        {
+            task = std::move(queue.maTasks.back());
+            queue.maTasks.pop_back();
+        }
+        else
+        {
+            task = std::move(queue.maTasks.front());
+            queue.maTasks.pop_front();
+        }
+        scheduler.miNumQueuedTasks.fetch_sub(1);
+        bFound = true;
+    }
+
+    if(!bFound)
+    {
+        return false;
+    }
+
+    task.mTask();
+
+    // last task of the counter wakes the threads sleeping in waitForTasks(), the counter may be gone after the decrement
+    if(task.mpCounter->miNumPending.fetch_sub(1) == 1)
+    {
+        {
+            std::lock_guard<std::mutex> lock(scheduler.mSleepMutex);
+        }
+        scheduler.mWakeCondition.notify_all();
+    }
+
+    return true;
+}
+
+/*
+**
+*/
+TaskScheduler::TaskScheduler()
+{
+    uint32_t iNumWorkers = std::max(std::thread::hardware_concurrency(), 1u);
+    char const* szNumThreads = getenv("MESH_NUM_THREADS");
+    if(szNumThreads != nullptr && atoi(szNumThreads) > 0)
+    {
+        iNumWorkers = static_cast<uint32_t>(atoi(szNumThreads));
+    }
+
+    // the thread waiting on the tasks is a worker too
+    uint32_t iNumThreads = iNumWorkers - 1;
+    for(uint32_t iQueue = 0; iQueue <= iNumThreads; iQueue++)
+    {
+        mapQueues.push_back(std::make_unique<TaskQueue>());
+    }
+
+    for(uint32_t iThread = 0; iThread < iNumThreads; iThread++)
+    {
+        maThreads.emplace_back(
+            [this, iThread]()
+            {
+                siWorkerQueue = iThread;
+                for(;;)
+                {
+                    if(tryRunTask(*this, iThread))
+                    {
+                        continue;
+                    }
+
+                    std::unique_lock<std::mutex> lock(mSleepMutex);
+                    mWakeCondition.wait(
+                        lock,
+                        [this]()
+                        {
+                            return mbShutdown || miNumQueuedTasks.load() > 0;
+                        });
+                    if(mbShutdown)
+                    {
+                        break;
+                    }
+                }
+            });
+    }
+}
+
+/*
+**
+*/
+TaskScheduler::~TaskScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(mSleepMutex);
+        mbShutdown = true;
+    }
+    mWakeCondition.notify_all();
+
+    for(auto& thread : maThreads)
+    {
+        thread.join();
+    }
+}
+
+/*
+**
+*/
+uint32_t getNumTaskWorkers()
+{
+    return static_cast<uint32_t>(getTaskScheduler().mapQueues.size());
+}
+
+/*
+**
+*/
+void submitTask(
+    TaskCounter& counter,
+    std::function<void()> task)
+{
+    TaskScheduler& scheduler = getTaskScheduler();
+    counter.miNumPending.fetch_add(1);
+    {
+        TaskQueue& queue = *scheduler.mapQueues[getHomeQueue(scheduler)];
+        std::lock_guard<std::mutex> lock(queue.mMutex);
+        queue.maTasks.push_back(Task{ std::move(task), &counter });
+        scheduler.miNumQueuedTasks.fetch_add(1);
+    }
+
+    // taking the lock orders the wake up after a sleeping worker's check of the queued count
+    {
+        std::lock_guard<std::mutex> lock(scheduler.mSleepMutex);
+    }
+    scheduler.mWakeCondition.notify_one();
+}
+
+/*
+**
+*/
+void waitForTasks(TaskCounter& counter)
+{
+    TaskScheduler& scheduler = getTaskScheduler();
+    uint32_t iHomeQueue = getHomeQueue(scheduler);
+    while(counter.miNumPending.load() > 0)
+    {
+        if(tryRunTask(scheduler, iHomeQueue))
+        {
+            continue;
+        }
+
+        // the remaining tasks are running on other threads, sleep until one of them queues more work or the last one finishes
+        std::unique_lock<std::mutex> lock(scheduler.mSleepMutex);
+        scheduler.mWakeCondition.wait(
+            lock,
+            [&scheduler,
+            &counter]()
+            {
+                return counter.miNumPending.load() == 0 || scheduler.miNumQueuedTasks.load() > 0;
+            });
+    }
+}
+
+/*
+**
+*/
+uint32_t addTaskGraphTask(
+    TaskGraph& graph,
+    std::function<void()> task)
+{
+    graph.maTasks.push_back(std::move(task));
+    graph.maaiSuccessors.emplace_back();
+    graph.maiNumPrerequisites.push_back(0);
+
+    return static_cast<uint32_t>(graph.maTasks.size() - 1);
+}
+
+/*
+**
+*/
+void addTaskGraphDependency(
+    TaskGraph& graph,
+    uint32_t iTask,
+    uint32_t iPrerequisiteTask)
+{
+    assert(iTask < graph.maTasks.size());
+    assert(iPrerequisiteTask < graph.maTasks.size());
+    graph.maaiSuccessors[iPrerequisiteTask].push_back(iTask);
+    graph.maiNumPrerequisites[iTask] += 1;
+}
+
+/*
+**
+*/
+void runTaskGraph(TaskGraph& graph)
+{
+    uint32_t iNumTasks = static_cast<uint32_t>(graph.maTasks.size());
+    std::unique_ptr<std::atomic<uint32_t>[]> aiNumRemainingPrerequisites(new std::atomic<uint32_t>[iNumTasks]);
+    for(uint32_t iTask = 0; iTask < iNumTasks; iTask++)
+    {
+        aiNumRemainingPrerequisites[iTask] = graph.maiNumPrerequisites[iTask];
+    }
+
+    // successors are submitted before the finished task's pending count is released, so the counter can't hit 0 early
+    TaskCounter counter;
+    std::atomic<uint32_t> iNumTasksRun{ 0 };
+    std::function<void(uint32_t)> submitGraphTask;
+    submitGraphTask = [&graph,
+        &aiNumRemainingPrerequisites,
+        &counter,
+        &iNumTasksRun,
+        &submitGraphTask](uint32_t iTask)
+    {
+        submitTask(
+            counter,
+            [&graph,
+            &aiNumRemainingPrerequisites,
+            &iNumTasksRun,
+            &submitGraphTask,
+            iTask]()
+            {
+                graph.maTasks[iTask]();
+                iNumTasksRun.fetch_add(1);
+                for(auto const& iSuccessor : graph.maaiSuccessors[iTask])
+                {
+                    if(aiNumRemainingPrerequisites[iSuccessor].fetch_sub(1) == 1)
+                    {
+                        submitGraphTask(iSuccessor);
+                    }
+                }
+            });
+    };
+
+    for(uint32_t iTask = 0; iTask < iNumTasks; iTask++)
+    {
+        if(graph.maiNumPrerequisites[iTask] == 0)
+        {
+            submitGraphTask(iTask);
+        }
+    }
+
+    waitForTasks(counter);
+
+    // tasks left over are part of a dependency cycle
+    assert(iNumTasksRun.load() == iNumTasks);
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+// number of outstanding tasks submitted with it, waitForTasks() returns when it reaches 0
+struct TaskCounter
+{
+    std::atomic<uint32_t>       miNumPending{ 0 };
+};
+
+// tasks with dependencies, a task is submitted once all of its prerequisite tasks have finished
+struct TaskGraph
+{
+    std::vector<std::function<void()>>      maTasks;
+    std::vector<std::vector<uint32_t>>      maaiSuccessors;
+    std::vector<uint32_t>                   maiNumPrerequisites;
+};
+
+// persistent work-stealing pool, created on first use with one worker per hardware thread (MESH_NUM_THREADS overrides)
+//      workers push to and pop from the back of their own queue, idle workers steal from the front of the others
+//      threads outside of the pool all submit to one extra queue that the workers steal from
+//      threads waiting on tasks run queued tasks instead of blocking, so parallel sections can be nested, and only
+//      sleep when nothing is queued
+uint32_t getNumTaskWorkers();
+
+void submitTask(
+    TaskCounter& counter,
+    std::function<void()> task);
+
+void waitForTasks(TaskCounter& counter);
+
+uint32_t addTaskGraphTask(
+    TaskGraph& graph,
+    std::function<void()> task);
+
+void addTaskGraphDependency(
+    TaskGraph& graph,
+    uint32_t iTask,
+    uint32_t iPrerequisiteTask);
+
+void runTaskGraph(TaskGraph& graph);
+
+/*
+**  func(iItem, iSlot) for items 0 to num items, handed out grain size items at a time
+**  slot is below getNumTaskWorkers() and not shared by concurrent calls of this loop, use it to index per-thread scratch data
+**  the calling thread works on the loop too, it returns when all the items are done
+*/
+template<typename Func>
+void parallelFor(
+    uint32_t iNumItems,
+    uint32_t iGrainSize,
+    Func const& func)
+{
+    iGrainSize = std::max(iGrainSize, 1u);
+    uint32_t iNumChunks = (iNumItems + iGrainSize - 1) / iGrainSize;
+    uint32_t iNumSlots = std::min(getNumTaskWorkers(), iNumChunks);
+
+    std::atomic<uint32_t> iCurrChunk{ 0 };
+    auto runSlot = [&iCurrChunk,
+        &func,
+        iNumItems,
+        iGrainSize,
+        iNumChunks](uint32_t iSlot)
+    {
+        for(;;)
+        {
+            uint32_t iChunk = iCurrChunk.fetch_add(1);
+            if(iChunk >= iNumChunks)
+            {
+                break;
+            }
+
+            uint32_t iEnd = std::min(iChunk * iGrainSize + iGrainSize, iNumItems);
+            for(uint32_t iItem = iChunk * iGrainSize; iItem < iEnd; iItem++)
+            {
+                func(iItem, iSlot);
+            }
+        }
+    };
+
+    // small loops stay on the calling thread
+    if(iNumSlots <= 1)
+    {
+        runSlot(0);
+        return;
+    }
+
+    TaskCounter counter;
+    for(uint32_t iSlot = 1; iSlot < iNumSlots; iSlot++)
+    {
+        submitTask(
+            counter,
+            [&runSlot, iSlot]()
+            {
+                runSlot(iSlot);
+            });
+    }
+
+    runSlot(0);
+    waitForTasks(counter);
+}
@@ -1594,6 +1594,22 @@ void projectVertices(
 /*
 **
 */
+__device__
+bool _isSamePosition(
+    float const* pafTotalClusterVertexPositions,
+    uint32_t iComponentOffset0,
+    uint32_t iComponentOffset1)
+{
+    float fLength = _length(
+        pafTotalClusterVertexPositions[iComponentOffset0] - pafTotalClusterVertexPositions[iComponentOffset1],
+        pafTotalClusterVertexPositions[iComponentOffset0 + 1] - pafTotalClusterVertexPositions[iComponentOffset1 + 1],
+        pafTotalClusterVertexPositions[iComponentOffset0 + 2] - pafTotalClusterVertexPositions[iComponentOffset1 + 2]);
+    return (fLength <= 1.0e-8f);
+}
+
+/*
+**  number of shared triangle edges with each of the 10 closest clusters, same definition as buildClusterEdgeAdjacencyCPU2
+*/
 __global__
 void buildClusterEdgeAdjacency2(
     uint32_t* paaiRetAdjacentEdgeClusters,
@@ -1615,67 +1631,54 @@ void buildClusterEdgeAdjacency2(
 
     uint32_t iVertexPositionComponentOffset = paiVertexPositionComponentOffsets[iCluster];
     uint32_t iVertexPositionIndexOffset = paiVertexPositionIndexOffsets[iCluster];
-
     uint32_t iNumTri = paiNumVertexPositionIndices[iCluster];
-    for(uint32_t iTri = 0; iTri < iNumTri; iTri += 3)
+
+    uint32_t iNumCandidates = min(10u, iNumClusters);
+    for(uint32_t iCandidate = 0; iCandidate < iNumCandidates; iCandidate++)
     {
-        for(uint32_t iCheckCluster = 0; iCheckCluster < 10; iCheckCluster++)
+        uint32_t iCheckClusterID = paiDistanceSortedCluster[iCluster * iNumClusters + iCandidate];
+        if(iCheckClusterID == iCluster)
         {
-            uint32_t iCheckClusterID = paiDistanceSortedCluster[iCluster * iNumClusters + iCheckCluster];
-            if(iCheckClusterID == iCluster)
-            {
-                continue;
-            }
+            continue;
+        }
 
-            uint32_t iCheckVertexPositionComponentOffset = paiVertexPositionComponentOffsets[iCheckClusterID];
-            uint32_t iCheckVertexPositionIndexOffset = paiVertexPositionIndexOffsets[iCheckClusterID];
+        uint32_t iCheckVertexPositionComponentOffset = paiVertexPositionComponentOffsets[iCheckClusterID];
+        uint32_t iCheckVertexPositionIndexOffset = paiVertexPositionIndexOffsets[iCheckClusterID];
+        uint32_t iNumCheckTri = paiNumVertexPositionIndices[iCheckClusterID];
 
-            uint32_t iNumSamePos = 0;
-            uint32_t iNumCheckTri = paiNumVertexPositionIndices[iCheckClusterID];
-            for(uint32_t iCheckTri = 0; iCheckTri < iNumCheckTri; iCheckTri += 3)
+        // every (edge, check edge) pair with the same end positions in either order
+        uint32_t iNumSharedEdges = 0;
+        for(uint32_t iTri = 0; iTri < iNumTri; iTri += 3)
+        {
+            for(uint32_t iEdge = 0; iEdge < 3; iEdge++)
             {
-                // check same positions for the triangles
-                for(uint32_t i = 0; i < 3; i++)
+                uint32_t iPos0 = iVertexPositionComponentOffset + paaiVertexPositionIndices[iVertexPositionIndexOffset + iTri + iEdge] * 3;
+                uint32_t iPos1 = iVertexPositionComponentOffset + paaiVertexPositionIndices[iVertexPositionIndexOffset + iTri + (iEdge + 1) % 3] * 3;
+                for(uint32_t iCheckTri = 0; iCheckTri < iNumCheckTri; iCheckTri += 3)
                 {
-                    uint32_t iPos = paaiVertexPositionIndices[iVertexPositionIndexOffset + iTri];
-                    uint32_t iCheckPos = paaiVertexPositionIndices[iCheckVertexPositionIndexOffset + iCheckTri];
-
-                    float fX = pafTotalClusterVertexPositions[iVertexPositionComponentOffset + (iPos + i) * 3];
-                    float fY = pafTotalClusterVertexPositions[iVertexPositionComponentOffset + (iPos + i) * 3 + 1];
-                    float fZ = pafTotalClusterVertexPositions[iVertexPositionComponentOffset + (iPos + i) * 3 + 2];
-
-                    bool bSame = false;
-                    for(uint32_t j = 0; j < 3; j++)
+                    for(uint32_t iCheckEdge = 0; iCheckEdge < 3; iCheckEdge++)
                     {
-                        float fCheckX = pafTotalClusterVertexPositions[iCheckVertexPositionComponentOffset + (iCheckPos + j) * 3];
-                        float fCheckY = pafTotalClusterVertexPositions[iCheckVertexPositionComponentOffset + (iCheckPos + j) * 3 + 1];
-                        float fCheckZ = pafTotalClusterVertexPositions[iCheckVertexPositionComponentOffset + (iCheckPos + j) * 3 + 2];
-
-                        float fLength = _length(fX - fCheckX, fY - fCheckY, fZ - fCheckZ);
-                        if(fLength <= 1.0e-8f)
+                        uint32_t iCheckPos0 = iCheckVertexPositionComponentOffset + paaiVertexPositionIndices[iCheckVertexPositionIndexOffset + iCheckTri + iCheckEdge] * 3;
+                        uint32_t iCheckPos1 = iCheckVertexPositionComponentOffset + paaiVertexPositionIndices[iCheckVertexPositionIndexOffset + iCheckTri + (iCheckEdge + 1) % 3] * 3;
+                        bool bSame =
+                            (_isSamePosition(pafTotalClusterVertexPositions, iPos0, iCheckPos0) && _isSamePosition(pafTotalClusterVertexPositions, iPos1, iCheckPos1)) ||
+                            (_isSamePosition(pafTotalClusterVertexPositions, iPos0, iCheckPos1) && _isSamePosition(pafTotalClusterVertexPositions, iPos1, iCheckPos0));
+                        if(bSame)
                         {
-                            ++iNumSamePos;
-                            bSame = true;
-                            break;
+                            ++iNumSharedEdges;
                         }
                     }
-
-                    if(bSame)
-                    {
-                        break;
-                    }
                 }
-
-            }   // for check tri
-
-            if(iNumSamePos > 0)
-            {
-                paaiRetAdjacentEdgeClusters[iCluster * iNumClusters + iCheckClusterID] = iNumSamePos;
             }
 
-        }   // for check cluster
+        }   // for tri
 
-    }   // for tri
+        if(iNumSharedEdges > 0)
+        {
+            paaiRetAdjacentEdgeClusters[iCluster * iNumClusters + iCheckClusterID] = iNumSharedEdges;
+        }
+
+    }   // for candidate
 }
 
 /*
@@ -2385,8 +2388,7 @@ void computeEdgeCollapseInfoCUDA(
     std::vector<uint32_t> const& aiClusterGroupNonBoundaryVertices,
     std::vector<uint32_t> const& aiClusterGroupTrianglePositionIndices,
     std::vector<uint32_t> const& aiClusterGroupTriangleNormalIndices,
-    std::vector<uint32_t> const& aiClusterGroupTriangleUVIndices,
-    std::vector<std::pair<uint32_t, uint32_t>> const& aBoundaryVertices)
+    std::vector<uint32_t> const& aiClusterGroupTriangleUVIndices)
 {
 //DEBUG_PRINTF("*** start computeEdgeCollapseInfoCUDA ***\n");
 //auto start = std::chrono::high_resolution_clock::now();
@@ -2991,33 +2993,20 @@ void getShortestVertexDistancesCUDA(
 */
 void getSortedEdgeAdjacentClustersCUDA(
     std::vector<std::vector<uint32_t>>& aaiSortedAdjacentEdgeClusters,
-    std::vector<std::vector<vec3>> const& aaVertexPositions,
-    std::vector<std::vector<uint32_t>> const& aaiVertexPositionIndices)
+    std::vector<std::vector<vec3>> const& aaVertexPositions)
 {
     DEBUG_PRINTF("*** start getSortedEdgeAdjacentClustersCUDA ***\n");
     auto start = std::chrono::high_resolution_clock::now();
 
-    uint32_t iCurrVertexPositionIndexDataOffset = 0;
     uint32_t iCurrVertexPositionDataOffset = 0;
     uint32_t iNumClusters = static_cast<uint32_t>(aaVertexPositions.size());
     std::vector<uint32_t> aiNumVertexPositionComponents(iNumClusters);
     std::vector<uint32_t> aiVertexPositionComponentArrayOffsets(iNumClusters);
-    std::vector<uint32_t> aiVertexPositionIndexArrayOffsets(iNumClusters);
-    std::vector<uint32_t> aiNumVertexPositionIndices(iNumClusters);
     for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
     {
-        //DEBUG_PRINTF("cluster %d vertex position offset: %d vertex position index offset: %d\n",
-        //    iCluster,
-        //    iCurrVertexPositionDataOffset,
-        //    iCurrVertexPositionIndexDataOffset);
-
         aiNumVertexPositionComponents[iCluster] = static_cast<uint32_t>(aaVertexPositions[iCluster].size() * 3);
         aiVertexPositionComponentArrayOffsets[iCluster] = iCurrVertexPositionDataOffset;
         iCurrVertexPositionDataOffset += static_cast<uint32_t>(aaVertexPositions[iCluster].size() * 3);
-
-        aiNumVertexPositionIndices[iCluster] = static_cast<uint32_t>(aaiVertexPositionIndices[iCluster].size());
-        aiVertexPositionIndexArrayOffsets[iCluster] = iCurrVertexPositionIndexDataOffset;
-        iCurrVertexPositionIndexDataOffset += static_cast<uint32_t>(aaiVertexPositionIndices[iCluster].size());
     }
 
     // allocate device memory
@@ -3045,22 +3034,6 @@ void getSortedEdgeAdjacentClustersCUDA(
         aiVertexPositionComponentArrayOffsets.size() * sizeof(int),
         cudaMemcpyHostToDevice);
 
-    uint32_t* paiVertexPositionIndexOffsets;
-    cudaMalloc(&paiVertexPositionIndexOffsets, iNumClusters * sizeof(uint32_t));
-    cudaMemcpy(
-        paiVertexPositionIndexOffsets,
-        aiVertexPositionIndexArrayOffsets.data(),
-        aiVertexPositionIndexArrayOffsets.size() * sizeof(int),
-        cudaMemcpyHostToDevice);
-
-    uint32_t* paiNumVertexPositionIndices;
-    cudaMalloc(&paiNumVertexPositionIndices, iNumClusters * sizeof(uint32_t));
-    cudaMemcpy(
-        paiNumVertexPositionIndices,
-        aiNumVertexPositionIndices.data(),
-        aiNumVertexPositionIndices.size() * sizeof(int),
-        cudaMemcpyHostToDevice);
-
 
     // copy vertex positions
     float* pafTotalClusterVertexPositions;
@@ -3076,21 +3049,6 @@ void getSortedEdgeAdjacentClustersCUDA(
         iArrayIndexOffset += static_cast<uint32_t>(aaVertexPositions[iCluster].size() * 3);
     }
 
-    // copy vertex indices
-    uint32_t* paaiVertexPositionIndices;
-    cudaMalloc(&paaiVertexPositionIndices, iCurrVertexPositionIndexDataOffset * sizeof(uint32_t));
-    iArrayIndexOffset = 0;
-    for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
-    {
-        cudaMemcpy(
-            paaiVertexPositionIndices + iArrayIndexOffset,
-            aaiVertexPositionIndices[iCluster].data(),
-            aaiVertexPositionIndices[iCluster].size() * sizeof(uint32_t),
-            cudaMemcpyHostToDevice);
-
-        iArrayIndexOffset += static_cast<uint32_t>(aaiVertexPositionIndices[iCluster].size());
-    }
-
     float* pafClusterMinMaxCenterRadius;
     cudaMalloc(&pafClusterMinMaxCenterRadius, iNumClusters * 10 * sizeof(float));
 
@@ -3204,10 +3162,7 @@ void getSortedEdgeAdjacentClustersCUDA(
     cudaFree(paiRetNumAdjacentEdgeClusters);
     cudaFree(paiNumVertexPositionComponents);
     cudaFree(paiVertexPositionComponentOffsets);
-    cudaFree(paiVertexPositionIndexOffsets);
-    cudaFree(paiNumVertexPositionIndices);
     cudaFree(pafTotalClusterVertexPositions);
-    cudaFree(paaiVertexPositionIndices);
 
     auto end = std::chrono::high_resolution_clock::now();
     uint64_t iSeconds = std::chrono::duration_cast<std::chrono::seconds>(end - start).count();
@@ -3692,7 +3647,8 @@ void buildClusterEdgeAdjacencyCUDA2(
             aaClusterDistanceInfo[iCluster].end(),
             [](ClusterDistanceInfo const& checkInfo0, ClusterDistanceInfo const& checkInfo1)
             {
-                return checkInfo0.mfDistance < checkInfo1.mfDistance;
+                // ties go to the smaller cluster index, same candidate order as the cpu version
+                return (checkInfo0.mfDistance == checkInfo1.mfDistance) ? checkInfo0.miCluster < checkInfo1.miCluster : checkInfo0.mfDistance < checkInfo1.mfDistance;
             }
         );
     }
@@ -3772,4 +3728,14 @@ void buildClusterEdgeAdjacencyCUDA2(
     uint64_t iSeconds = std::chrono::duration_cast<std::chrono::seconds>(end - start).count();
     DEBUG_PRINTF("*** took %lld seconds for buildClusterEdgeAdjacencyCUDA2 to finish ***\n",
         iSeconds);
+}
+
+/*
+**
+*/
+bool isCUDADeviceAvailable()
+{
+    int iNumDevices = 0;
+    cudaError_t error = cudaGetDeviceCount(&iNumDevices);
+    return (error == cudaSuccess && iNumDevices > 0);
 }
\ No newline at end of file
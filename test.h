@@ -30,8 +30,7 @@ void computeEdgeCollapseInfoCUDA(
     std::vector<uint32_t> const& aiClusterGroupNonBoundaryVertices,
     std::vector<uint32_t> const& aiClusterGroupTrianglePositionIndices,
     std::vector<uint32_t> const& aiClusterGroupTriangleNormalIndices,
-    std::vector<uint32_t> const& aiClusterGroupTriangleUVIndices,
-    std::vector<std::pair<uint32_t, uint32_t>> const& aBoundaryVertices);
+    std::vector<uint32_t> const& aiClusterGroupTriangleUVIndices);
 
 void getShortestVertexDistancesCUDA(
     std::vector<float>& afClosestDistances,
@@ -51,8 +50,7 @@ void buildClusterEdgeAdjacencyCUDA2(
 
 void getSortedEdgeAdjacentClustersCUDA(
     std::vector<std::vector<uint32_t>>& aaiSortedAdjacentEdgeClusters,
-    std::vector<std::vector<vec3>> const& aaVertexPositions,
-    std::vector<std::vector<uint32_t>> const& aaiVertexPositionIndices);
+    std::vector<std::vector<vec3>> const& aaVertexPositions);
 
 void getProjectVertexDistancesCUDA(
     std::vector<vec3>& aProjectedPositions,
@@ -61,4 +59,6 @@ void getProjectVertexDistancesCUDA(
 
 void getClusterGroupBoundaryVerticesCUDA2(
     std::vector<std::vector<uint32_t>>& aaiClusterGroupBoundaryVertices,
-    std::vector<std::vector<vec3>> const& aaClusterGroupVertexPositions);
\ No newline at end of file
+    std::vector<std::vector<vec3>> const& aaClusterGroupVertexPositions);
+
+bool isCUDADeviceAvailable();
\ No newline at end of file
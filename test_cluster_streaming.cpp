@@ -44,6 +44,7 @@ void testClusterRequests(
     std::vector<uint32_t>& aiNumClusterIndices,
     std::vector<uint64_t>& saiVertexBufferArrayOffsets,
     std::vector<uint64_t>& saiIndexBufferArrayOffsets,
+    uint32_t iIndexSize,
     std::vector<uint32_t> const& aiDrawClusters)
 {
     //static std::vector<uint8_t> saReadWriteBuffer(1 << 24);
@@ -117,7 +118,7 @@ void testClusterRequests(
         };
 
         uint32_t const kiMaxVertexBufferSize = sizeof(ConvertedMeshVertexFormat) * 180;
-        uint32_t const kiMaxIndexBufferSize = sizeof(uint32_t) * 128 * 3;
+        uint32_t const kiMaxIndexBufferSize = iIndexSize * 128 * 3;
 
         uint64_t iCurrTimeUS = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - sStartTime).count() + 1;
         uint32_t iCurrRequestClusterInfoAddress = iClusterInfoAddress;
@@ -132,7 +133,7 @@ void testClusterRequests(
             uint32_t iOldestLoadedIndex = UINT32_MAX;
 
             uint32_t iClusterVertexBufferSize = aiNumClusterVertices[iDrawCluster] * sizeof(ConvertedMeshVertexFormat);
-            uint32_t iClusterIndexBufferSize = aiNumClusterIndices[iDrawCluster] * sizeof(uint32_t);
+            uint32_t iClusterIndexBufferSize = aiNumClusterIndices[iDrawCluster] * iIndexSize;
 
             assert(iClusterVertexBufferSize <= kiMaxVertexBufferSize);
             assert(iClusterIndexBufferSize <= kiMaxIndexBufferSize);
@@ -434,7 +435,7 @@ void testUploadClusterData(
     void* paClusterRequestInfo,
     std::vector<uint32_t> const& aiDrawList,
     std::vector<std::vector<ConvertedMeshVertexFormat>> const& aaVertices,
-    std::vector<std::vector<uint32_t>> const& aaiIndices,
+    std::vector<std::vector<uint8_t>> const& aacIndexData,
     uint32_t iRequestClusterDataSize)
 {
     uint8_t* pVertexDataBuffer = reinterpret_cast<uint8_t*>(testGetVertexDataBuffer());
@@ -477,7 +478,7 @@ void testUploadClusterData(
             clusterInfo.miVertexBufferSize);
         memcpy(
             pIndexDataBuffer + clusterInfo.miIndexBufferAddress,
-            aaiIndices[iCluster].data(),
+            aacIndexData[iCluster].data(),
             clusterInfo.miIndexBufferSize);
 
         // mark as loaded
@@ -522,7 +523,8 @@ void testVerifyStreamClusterData(
     void const* aClusterInfoRequestBuffer,
     std::vector<uint32_t> const& aiDrawClusters,
     std::vector<std::vector<ConvertedMeshVertexFormat>> const& aaClusterTriangleVertices,
-    std::vector<std::vector<uint32_t>> const& aaiClusterTriangleVertexIndices)
+    std::vector<std::vector<uint32_t>> const& aaiClusterTriangleVertexIndices,
+    uint32_t iIndexSize)
 {
     uint32_t iVertexBufferAddress = 0;
     uint32_t iIndexBufferAddress = 0;
@@ -578,7 +580,7 @@ void testVerifyStreamClusterData(
         std::vector<uint8_t> aVertexBuffer(clusterInfo.miVertexBufferSize);
         memcpy(aVertexBuffer.data(), vertexDataBuffer + clusterInfo.miVertexBufferAddress + iVertexBufferAddress, clusterInfo.miVertexBufferSize);
 
-        uint32_t iNumIndices = clusterInfo.miIndexBufferSize / sizeof(uint32_t);
+        uint32_t iNumIndices = clusterInfo.miIndexBufferSize / iIndexSize;
         std::vector<uint8_t> aIndexBuffer(clusterInfo.miIndexBufferSize);
         memcpy(aIndexBuffer.data(), indexDataBuffer + clusterInfo.miIndexBufferAddress + iIndexBufferAddress, clusterInfo.miIndexBufferSize);
 
@@ -588,7 +590,7 @@ void testVerifyStreamClusterData(
         {
             for(uint32_t i = 0; i < 3; i++)
             {
-                uint32_t iV = aiIndices[iTri + i];
+                uint32_t iV = (iIndexSize == sizeof(uint8_t)) ? aIndexBuffer[iTri + i] : aiIndices[iTri + i];
                 assert(iV < iNumVertices);
                 ConvertedMeshVertexFormat const& vertex = aVertices[iV];
 
@@ -10,24 +10,27 @@ void testClusterRequests(
     std::vector<uint32_t>& saiNumClusterIndices,
     std::vector<uint64_t>& saiVertexBufferArrayOffsets,
     std::vector<uint64_t>& saiIndexBufferArrayOffsets,
+    uint32_t iIndexSize,
     std::vector<uint32_t> const& aiDrawClusters);
 
 void testGetClusterRequests(
     std::vector<uint8_t>& aClusterRequestInfo);
 
 
+// index data is uploaded as stored, see loadMeshClusterTriangleIndexDataChunk()
 void testUploadClusterData(
     void* paClusterRequestInfo,
     std::vector<uint32_t> const& aiDrawList,
     std::vector<std::vector<ConvertedMeshVertexFormat>> const& aaVertices,
-    std::vector<std::vector<uint32_t>> const& aaiIndices,
+    std::vector<std::vector<uint8_t>> const& aacIndexData,
     uint32_t iRequestClusterDataSize);
 
 void testVerifyStreamClusterData(
     void const* aClusterInfoRequestBuffer,
     std::vector<uint32_t> const& aiDrawClusters,
     std::vector<std::vector<ConvertedMeshVertexFormat>> const& aaClusterTriangleVertices,
-    std::vector<std::vector<uint32_t>> const& aaiClusterTriangleVertexIndices);
+    std::vector<std::vector<uint32_t>> const& aaiClusterTriangleVertexIndices,
+    uint32_t iIndexSize);
 
 void* testGetVertexDataBuffer();
 void* testGetIndexDataBuffer();
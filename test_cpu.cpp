@@ -0,0 +1,1198 @@
+#include "test_cpu.h"
+#include "barycentric.h"
+#include "connectivity_operations.h"
+#include "spatial_index.h"
+#include "task_scheduler.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+
+#include <emmintrin.h>
+
+// positions of all the clusters/cluster groups in one spatial hash
+//      global index = owner offset + local index
+//      cell size is at least the match distance so matches are always in the 27 surrounding cells
+struct PositionIndexCPU
+{
+    std::vector<vec3>                               maPositions;
+    std::vector<uint32_t>                           maiOwners;
+    std::vector<uint32_t>                           maiOwnerOffsets;
+    std::vector<std::pair<uint64_t, uint32_t>>      maKeyIndices;
+    float                                           mfCellSize;
+};
+
+/*
+**
+*/
+void buildPositionIndexCPU(
+    PositionIndexCPU& index,
+    std::vector<std::vector<vec3>> const& aaPositions,
+    float fMaxDistance)
+{
+    uint32_t iNumOwners = static_cast<uint32_t>(aaPositions.size());
+    index.maiOwnerOffsets.resize(iNumOwners + 1);
+    uint32_t iNumPositions = 0;
+    for(uint32_t iOwner = 0; iOwner < iNumOwners; iOwner++)
+    {
+        index.maiOwnerOffsets[iOwner] = iNumPositions;
+        iNumPositions += static_cast<uint32_t>(aaPositions[iOwner].size());
+    }
+    index.maiOwnerOffsets[iNumOwners] = iNumPositions;
+
+    index.maPositions.resize(iNumPositions);
+    index.maiOwners.resize(iNumPositions);
+    for(uint32_t iOwner = 0; iOwner < iNumOwners; iOwner++)
+    {
+        uint32_t iOffset = index.maiOwnerOffsets[iOwner];
+        for(uint32_t i = 0; i < static_cast<uint32_t>(aaPositions[iOwner].size()); i++)
+        {
+            index.maPositions[iOffset + i] = aaPositions[iOwner][i];
+            index.maiOwners[iOffset + i] = iOwner;
+        }
+    }
+
+    // keep the cell coordinates within 24 bits for very small match distances
+    index.mfCellSize = getSpatialHashCellSize(index.maPositions.data(), iNumPositions, fMaxDistance);
+    buildSpatialHashIndex(
+        index.maKeyIndices,
+        index.maPositions.data(),
+        iNumPositions,
+        index.mfCellSize);
+}
+
+/*
+**
+*/
+template<typename Func>
+void visitPositionIndexNeighbors(
+    PositionIndexCPU const& index,
+    vec3 const& position,
+    Func const& func)
+{
+    // func returns true to stop, entries within a cell are visited in ascending global index
+    uint64_t aiKeys[27];
+    uint32_t iNumKeys = 0;
+    int3 cell = getSpatialHashCell(position, index.mfCellSize);
+    for(int32_t iZ = -1; iZ <= 1; iZ++)
+    {
+        for(int32_t iY = -1; iY <= 1; iY++)
+        {
+            for(int32_t iX = -1; iX <= 1; iX++)
+            {
+                aiKeys[iNumKeys++] = getSpatialHashKey(int3(cell.x + iX, cell.y + iY, cell.z + iZ));
+            }
+        }
+    }
+
+    // colliding keys of neighboring cells would visit the same entries twice
+    std::sort(aiKeys, aiKeys + iNumKeys);
+    iNumKeys = static_cast<uint32_t>(std::unique(aiKeys, aiKeys + iNumKeys) - aiKeys);
+
+    for(uint32_t iKey = 0; iKey < iNumKeys; iKey++)
+    {
+        auto iter = std::lower_bound(
+            index.maKeyIndices.begin(),
+            index.maKeyIndices.end(),
+            std::make_pair(aiKeys[iKey], 0u));
+        for(; iter != index.maKeyIndices.end() && iter->first == aiKeys[iKey]; ++iter)
+        {
+            if(func(iter->second))
+            {
+                return;
+            }
+        }
+    }
+}
+
+/*
+**
+*/
+void getCanonicalPositionIndicesCPU(
+    std::vector<uint32_t>& aiCanonicalPositions,
+    PositionIndexCPU const& index,
+    float fMaxDistance)
+{
+    // smallest global index within the max distance, positions sharing it are treated as the same position
+    uint32_t const kiChunkSize = 1024;
+    uint32_t iNumPositions = static_cast<uint32_t>(index.maPositions.size());
+    aiCanonicalPositions.resize(iNumPositions);
+    parallelFor(
+        (iNumPositions + kiChunkSize - 1) / kiChunkSize,
+        4,
+        [&aiCanonicalPositions,
+        &index,
+        fMaxDistance,
+        iNumPositions,
+        kiChunkSize](uint32_t iChunk, uint32_t /*iSlot*/)
+        {
+            uint32_t iEnd = std::min((iChunk + 1) * kiChunkSize, iNumPositions);
+            for(uint32_t i = iChunk * kiChunkSize; i < iEnd; i++)
+            {
+                vec3 const& position = index.maPositions[i];
+                uint32_t iCanonical = i;
+                visitPositionIndexNeighbors(
+                    index,
+                    position,
+                    [&iCanonical,
+                    &index,
+                    &position,
+                    fMaxDistance](uint32_t iCheck)
+                    {
+                        if(iCheck < iCanonical && length(index.maPositions[iCheck] - position) <= fMaxDistance)
+                        {
+                            iCanonical = iCheck;
+                        }
+
+                        return false;
+                    });
+
+                aiCanonicalPositions[i] = iCanonical;
+            }
+        });
+}
+
+/*
+**
+*/
+inline uint64_t getCanonicalEdgeKey(uint32_t iPos0, uint32_t iPos1)
+{
+    return (static_cast<uint64_t>(std::min(iPos0, iPos1)) << 32) | static_cast<uint64_t>(std::max(iPos0, iPos1));
+}
+
+/*
+**
+*/
+void checkClusterGroupBoundaryVerticesCPU(
+    std::vector<std::vector<uint32_t>>& aaiClusterGroupBoundaryVertices,
+    std::vector<std::vector<vec3>> const& aaClusterGroupVertexPositions,
+    std::vector<std::vector<uint32_t>> const& aaiClusterGroupTrianglePositionIndices)
+{
+    // same position test of the cuda version is squared distance < 1.0e-6
+    float const kfMaxDistance = 1.0e-3f;
+    PositionIndexCPU index;
+    buildPositionIndexCPU(index, aaClusterGroupVertexPositions, kfMaxDistance);
+    std::vector<uint32_t> aiCanonicalPositions;
+    getCanonicalPositionIndicesCPU(aiCanonicalPositions, index, kfMaxDistance);
+
+    // keys of all the triangle edges, edges used by more than one triangle across all the cluster groups are shared
+    uint32_t iNumClusterGroups = static_cast<uint32_t>(aaClusterGroupVertexPositions.size());
+    std::vector<uint32_t> aiEdgeKeyOffsets(iNumClusterGroups + 1, 0);
+    for(uint32_t iClusterGroup = 0; iClusterGroup < iNumClusterGroups; iClusterGroup++)
+    {
+        aiEdgeKeyOffsets[iClusterGroup + 1] = aiEdgeKeyOffsets[iClusterGroup] + static_cast<uint32_t>(aaiClusterGroupTrianglePositionIndices[iClusterGroup].size());
+    }
+
+    std::vector<uint64_t> aiEdgeKeys(aiEdgeKeyOffsets[iNumClusterGroups]);
+    parallelFor(
+        iNumClusterGroups,
+        16,
+        [&aiEdgeKeys,
+        &aiEdgeKeyOffsets,
+        &aiCanonicalPositions,
+        &index,
+        &aaiClusterGroupTrianglePositionIndices](uint32_t iClusterGroup, uint32_t /*iSlot*/)
+        {
+            auto const& aiTrianglePositionIndices = aaiClusterGroupTrianglePositionIndices[iClusterGroup];
+            uint32_t iPositionOffset = index.maiOwnerOffsets[iClusterGroup];
+            uint64_t* paiEdgeKeys = aiEdgeKeys.data() + aiEdgeKeyOffsets[iClusterGroup];
+            for(uint32_t iTri = 0; iTri < static_cast<uint32_t>(aiTrianglePositionIndices.size()); iTri += 3)
+            {
+                uint32_t iPos0 = aiCanonicalPositions[iPositionOffset + aiTrianglePositionIndices[iTri]];
+                uint32_t iPos1 = aiCanonicalPositions[iPositionOffset + aiTrianglePositionIndices[iTri + 1]];
+                uint32_t iPos2 = aiCanonicalPositions[iPositionOffset + aiTrianglePositionIndices[iTri + 2]];
+                paiEdgeKeys[iTri] = getCanonicalEdgeKey(iPos0, iPos1);
+                paiEdgeKeys[iTri + 1] = getCanonicalEdgeKey(iPos0, iPos2);
+                paiEdgeKeys[iTri + 2] = getCanonicalEdgeKey(iPos1, iPos2);
+            }
+        });
+
+    std::vector<uint64_t> aiSortedEdgeKeys = aiEdgeKeys;
+    std::sort(aiSortedEdgeKeys.begin(), aiSortedEdgeKeys.end());
+
+    // first edge of the triangle not shared with another triangle, in (v0, v1), (v0, v2), (v1, v2) order
+    aaiClusterGroupBoundaryVertices.resize(iNumClusterGroups);
+    parallelFor(
+        iNumClusterGroups,
+        16,
+        [&aaiClusterGroupBoundaryVertices,
+        &aiEdgeKeys,
+        &aiSortedEdgeKeys,
+        &aiEdgeKeyOffsets,
+        &aaiClusterGroupTrianglePositionIndices](uint32_t iClusterGroup, uint32_t /*iSlot*/)
+        {
+            auto const& aiTrianglePositionIndices = aaiClusterGroupTrianglePositionIndices[iClusterGroup];
+            auto& aiBoundaryVertices = aaiClusterGroupBoundaryVertices[iClusterGroup];
+            aiBoundaryVertices.clear();
+
+            uint64_t const* paiEdgeKeys = aiEdgeKeys.data() + aiEdgeKeyOffsets[iClusterGroup];
+            uint32_t const aiEdgeCorner0[3] = { 0, 0, 1 };
+            uint32_t const aiEdgeCorner1[3] = { 1, 2, 2 };
+            for(uint32_t iTri = 0; iTri < static_cast<uint32_t>(aiTrianglePositionIndices.size()); iTri += 3)
+            {
+                for(uint32_t iEdge = 0; iEdge < 3; iEdge++)
+                {
+                    auto range = std::equal_range(aiSortedEdgeKeys.begin(), aiSortedEdgeKeys.end(), paiEdgeKeys[iTri + iEdge]);
+                    if(range.second - range.first < 2)
+                    {
+                        aiBoundaryVertices.push_back(aiTrianglePositionIndices[iTri + aiEdgeCorner0[iEdge]]);
+                        aiBoundaryVertices.push_back(aiTrianglePositionIndices[iTri + aiEdgeCorner1[iEdge]]);
+                        break;
+                    }
+                }
+            }
+
+            std::sort(aiBoundaryVertices.begin(), aiBoundaryVertices.end());
+            aiBoundaryVertices.erase(std::unique(aiBoundaryVertices.begin(), aiBoundaryVertices.end()), aiBoundaryVertices.end());
+        });
+}
+
+/*
+**
+*/
+void buildClusterAdjacencyCPU(
+    std::vector<std::vector<uint32_t>>& aaiNumAdjacentVertices,
+    std::vector<std::vector<vec3>> const& aaVertexPositions,
+    bool bOnlyEdgeAdjacent)
+{
+    float const kfMaxDistanceSquared = 1.0e-8f;
+    PositionIndexCPU index;
+    buildPositionIndexCPU(index, aaVertexPositions, sqrtf(kfMaxDistanceSquared));
+
+    // number of vertices of the cluster with a matching position in the check cluster, capped at 2 for edge adjacency
+    uint32_t iNumClusters = static_cast<uint32_t>(aaVertexPositions.size());
+    aaiNumAdjacentVertices.resize(iNumClusters);
+    parallelFor(
+        iNumClusters,
+        16,
+        [&aaiNumAdjacentVertices,
+        &aaVertexPositions,
+        &index,
+        kfMaxDistanceSquared,
+        iNumClusters,
+        bOnlyEdgeAdjacent](uint32_t iCluster, uint32_t /*iSlot*/)
+        {
+            auto& aiNumAdjacentVertices = aaiNumAdjacentVertices[iCluster];
+            aiNumAdjacentVertices.assign(iNumClusters, 0);
+
+            std::vector<uint32_t> aiVertexAdjacentClusters;
+            for(auto const& position : aaVertexPositions[iCluster])
+            {
+                aiVertexAdjacentClusters.clear();
+                visitPositionIndexNeighbors(
+                    index,
+                    position,
+                    [&aiVertexAdjacentClusters,
+                    &index,
+                    &position,
+                    kfMaxDistanceSquared,
+                    iCluster](uint32_t iCheck)
+                    {
+                        if(index.maiOwners[iCheck] != iCluster && lengthSquared(position - index.maPositions[iCheck]) <= kfMaxDistanceSquared)
+                        {
+                            aiVertexAdjacentClusters.push_back(index.maiOwners[iCheck]);
+                        }
+
+                        return false;
+                    });
+
+                std::sort(aiVertexAdjacentClusters.begin(), aiVertexAdjacentClusters.end());
+                aiVertexAdjacentClusters.erase(std::unique(aiVertexAdjacentClusters.begin(), aiVertexAdjacentClusters.end()), aiVertexAdjacentClusters.end());
+                for(auto const& iCheckCluster : aiVertexAdjacentClusters)
+                {
+                    if(!bOnlyEdgeAdjacent || aiNumAdjacentVertices[iCheckCluster] < 2)
+                    {
+                        ++aiNumAdjacentVertices[iCheckCluster];
+                    }
+                }
+            }
+        });
+}
+
+/*
+**
+*/
+void getClusterGroupBoundaryVerticesCPU(
+    std::vector<std::vector<uint32_t>>& aaiClusterGroupBoundaryVertices,
+    std::vector<std::vector<vec3>> const& aaClusterGroupVertexPositions)
+{
+    float const kfMaxDistanceSquared = 1.0e-10f;
+    PositionIndexCPU index;
+    buildPositionIndexCPU(index, aaClusterGroupVertexPositions, sqrtf(kfMaxDistanceSquared));
+
+    // vertex is added once for every matching vertex in the other cluster groups
+    uint32_t iNumClusterGroups = static_cast<uint32_t>(aaClusterGroupVertexPositions.size());
+    aaiClusterGroupBoundaryVertices.resize(iNumClusterGroups);
+    parallelFor(
+        iNumClusterGroups,
+        16,
+        [&aaiClusterGroupBoundaryVertices,
+        &aaClusterGroupVertexPositions,
+        &index,
+        kfMaxDistanceSquared](uint32_t iClusterGroup, uint32_t /*iSlot*/)
+        {
+            auto& aiBoundaryVertices = aaiClusterGroupBoundaryVertices[iClusterGroup];
+            aiBoundaryVertices.clear();
+
+            auto const& aVertexPositions = aaClusterGroupVertexPositions[iClusterGroup];
+            for(uint32_t iVertex = 0; iVertex < static_cast<uint32_t>(aVertexPositions.size()); iVertex++)
+            {
+                vec3 const& position = aVertexPositions[iVertex];
+                uint32_t iNumMatches = 0;
+                visitPositionIndexNeighbors(
+                    index,
+                    position,
+                    [&iNumMatches,
+                    &index,
+                    &position,
+                    kfMaxDistanceSquared,
+                    iClusterGroup](uint32_t iCheck)
+                    {
+                        if(index.maiOwners[iCheck] != iClusterGroup && lengthSquared(position - index.maPositions[iCheck]) <= kfMaxDistanceSquared)
+                        {
+                            ++iNumMatches;
+                        }
+
+                        return false;
+                    });
+
+                aiBoundaryVertices.insert(aiBoundaryVertices.end(), iNumMatches, iVertex);
+            }
+        });
+}
+
+/*
+**
+*/
+void getClusterGroupBoundaryVerticesCPU2(
+    std::vector<std::vector<uint32_t>>& aaiClusterGroupBoundaryVertices,
+    std::vector<std::vector<vec3>> const& aaClusterGroupVertexPositions)
+{
+    float const kfMaxDistanceSquared = 1.0e-10f;
+    PositionIndexCPU index;
+    buildPositionIndexCPU(index, aaClusterGroupVertexPositions, sqrtf(kfMaxDistanceSquared));
+
+    // vertices with a matching vertex in any other cluster group, in vertex order
+    uint32_t iNumClusterGroups = static_cast<uint32_t>(aaClusterGroupVertexPositions.size());
+    aaiClusterGroupBoundaryVertices.resize(iNumClusterGroups);
+    parallelFor(
+        iNumClusterGroups,
+        16,
+        [&aaiClusterGroupBoundaryVertices,
+        &aaClusterGroupVertexPositions,
+        &index,
+        kfMaxDistanceSquared](uint32_t iClusterGroup, uint32_t /*iSlot*/)
+        {
+            auto& aiBoundaryVertices = aaiClusterGroupBoundaryVertices[iClusterGroup];
+            aiBoundaryVertices.clear();
+
+            auto const& aVertexPositions = aaClusterGroupVertexPositions[iClusterGroup];
+            for(uint32_t iVertex = 0; iVertex < static_cast<uint32_t>(aVertexPositions.size()); iVertex++)
+            {
+                vec3 const& position = aVertexPositions[iVertex];
+                bool bHasAdjacentVertex = false;
+                visitPositionIndexNeighbors(
+                    index,
+                    position,
+                    [&bHasAdjacentVertex,
+                    &index,
+                    &position,
+                    kfMaxDistanceSquared,
+                    iClusterGroup](uint32_t iCheck)
+                    {
+                        bHasAdjacentVertex = (index.maiOwners[iCheck] != iClusterGroup && lengthSquared(position - index.maPositions[iCheck]) <= kfMaxDistanceSquared);
+                        return bHasAdjacentVertex;
+                    });
+
+                if(bHasAdjacentVertex)
+                {
+                    aiBoundaryVertices.push_back(iVertex);
+                }
+            }
+        });
+}
+
+/*
+**
+*/
+void computeEdgeCollapseInfoCPU(
+    std::vector<float>& afCollapseCosts,
+    std::vector<vec3>& aOptimalVertexPositions,
+    std::vector<vec3>& aOptimalVertexNormals,
+    std::vector<vec2>& aOptimalVertexUVs,
+    std::vector<std::pair<uint32_t, uint32_t>>& aEdges,
+    std::vector<vec3> const& aClusterGroupVertexPositions,
+    std::vector<vec3> const& aClusterGroupVertexNormals,
+    std::vector<vec2> const& aClusterGroupVertexUVs,
+    std::vector<std::pair<uint32_t, uint32_t>> const& aiValidClusterGroupEdgePairs,
+    std::vector<uint32_t> const& aiClusterGroupNonBoundaryVertices,
+    std::vector<uint32_t> const& aiClusterGroupTrianglePositionIndices,
+    std::vector<uint32_t> const& aiClusterGroupTriangleNormalIndices,
+    std::vector<uint32_t> const& aiClusterGroupTriangleUVIndices)
+{
+    uint32_t const kiChunkSize = 256;
+    uint32_t iNumVertices = static_cast<uint32_t>(aClusterGroupVertexPositions.size());
+    uint32_t iNumEdges = static_cast<uint32_t>(aiValidClusterGroupEdgePairs.size());
+
+    MeshConnectivity connectivity;
+    buildMeshConnectivity(
+        connectivity,
+        aiClusterGroupTrianglePositionIndices,
+        iNumVertices);
+
+    std::vector<uint8_t> aiNonBoundaryVertexFlags(iNumVertices, 0);
+    for(auto const& iVertex : aiClusterGroupNonBoundaryVertices)
+    {
+        assert(iVertex < iNumVertices);
+        aiNonBoundaryVertexFlags[iVertex] = 1;
+    }
+
+    // vertex quadrics from the planes of the adjacent triangles, average of |dot(average normal, plane normal)| for the feature value
+    std::vector<float> afQuadrics(iNumVertices * 16, 0.0f);
+    std::vector<float> afNormalPlaneAngles(iNumVertices, 0.0f);
+    parallelFor(
+        (iNumVertices + kiChunkSize - 1) / kiChunkSize,
+        4,
+        [&afQuadrics,
+        &afNormalPlaneAngles,
+        &connectivity,
+        &aClusterGroupVertexPositions,
+        &aiClusterGroupTrianglePositionIndices,
+        iNumVertices,
+        kiChunkSize](uint32_t iChunk, uint32_t /*iSlot*/)
+        {
+            std::vector<vec3> aPlaneNormals;
+            uint32_t iEnd = std::min((iChunk + 1) * kiChunkSize, iNumVertices);
+            for(uint32_t iVertex = iChunk * kiChunkSize; iVertex < iEnd; iVertex++)
+            {
+                aPlaneNormals.clear();
+                vec3 averageNormal(0.0f, 0.0f, 0.0f);
+                float* pafQuadric = afQuadrics.data() + iVertex * 16;
+
+                uint32_t iPrevTri = UINT32_MAX;
+                uint32_t iRingStart = connectivity.maiVertexRingStart[iVertex];
+                uint32_t iRingEnd = iRingStart + connectivity.maiVertexRingCount[iVertex];
+                for(uint32_t iRing = iRingStart; iRing < iRingEnd; iRing++)
+                {
+                    uint32_t iTri = connectivity.maiCorners[iRing] / 3;
+                    if(iTri == iPrevTri)
+                    {
+                        continue;
+                    }
+                    iPrevTri = iTri;
+
+                    uint32_t iV0 = aiClusterGroupTrianglePositionIndices[iTri * 3];
+                    uint32_t iV1 = aiClusterGroupTrianglePositionIndices[iTri * 3 + 1];
+                    uint32_t iV2 = aiClusterGroupTrianglePositionIndices[iTri * 3 + 2];
+
+                    vec3 diff0, diff1;
+                    if(iV0 == iVertex)
+                    {
+                        diff0 = aClusterGroupVertexPositions[iV1] - aClusterGroupVertexPositions[iV0];
+                        diff1 = aClusterGroupVertexPositions[iV2] - aClusterGroupVertexPositions[iV0];
+                    }
+                    else if(iV1 == iVertex)
+                    {
+                        diff0 = aClusterGroupVertexPositions[iV0] - aClusterGroupVertexPositions[iV1];
+                        diff1 = aClusterGroupVertexPositions[iV2] - aClusterGroupVertexPositions[iV1];
+                    }
+                    else
+                    {
+                        diff0 = aClusterGroupVertexPositions[iV0] - aClusterGroupVertexPositions[iV2];
+                        diff1 = aClusterGroupVertexPositions[iV1] - aClusterGroupVertexPositions[iV2];
+                    }
+
+                    vec3 planeNormal = cross(normalize(diff1), normalize(diff0));
+                    float afPlane[4] = { planeNormal.x, planeNormal.y, planeNormal.z, dot(planeNormal, aClusterGroupVertexPositions[iV0]) * -1.0f };
+                    for(uint32_t iRow = 0; iRow < 4; iRow++)
+                    {
+                        for(uint32_t iColumn = 0; iColumn < 4; iColumn++)
+                        {
+                            pafQuadric[iRow * 4 + iColumn] += afPlane[iRow] * afPlane[iColumn];
+                        }
+                    }
+
+                    averageNormal += planeNormal;
+                    aPlaneNormals.push_back(planeNormal);
+
+                }   // for ring = ring start to ring end
+
+                if(averageNormal.x != 0.0f || averageNormal.y != 0.0f || averageNormal.z != 0.0f)
+                {
+                    averageNormal = normalize(averageNormal);
+                }
+
+                float fTotalAngle = 0.0f;
+                for(auto const& planeNormal : aPlaneNormals)
+                {
+                    fTotalAngle += fabsf(dot(averageNormal, planeNormal));
+                }
+                afNormalPlaneAngles[iVertex] = fTotalAngle / std::max(static_cast<float>(aPlaneNormals.size()), 0.001f);
+
+            }   // for vertex = chunk start to chunk end
+        });
+
+    afCollapseCosts.resize(iNumEdges);
+    aOptimalVertexPositions.resize(iNumEdges);
+    aOptimalVertexNormals.resize(iNumEdges);
+    aOptimalVertexUVs.resize(iNumEdges);
+    aEdges.resize(iNumEdges);
+    parallelFor(
+        (iNumEdges + kiChunkSize - 1) / kiChunkSize,
+        4,
+        [&afCollapseCosts,
+        &aOptimalVertexPositions,
+        &aOptimalVertexNormals,
+        &aOptimalVertexUVs,
+        &aEdges,
+        &afQuadrics,
+        &afNormalPlaneAngles,
+        &aiNonBoundaryVertexFlags,
+        &connectivity,
+        &aClusterGroupVertexPositions,
+        &aClusterGroupVertexNormals,
+        &aClusterGroupVertexUVs,
+        &aiValidClusterGroupEdgePairs,
+        &aiClusterGroupTrianglePositionIndices,
+        &aiClusterGroupTriangleNormalIndices,
+        &aiClusterGroupTriangleUVIndices,
+        iNumEdges,
+        kiChunkSize](uint32_t iChunk, uint32_t /*iSlot*/)
+        {
+            uint32_t iEnd = std::min((iChunk + 1) * kiChunkSize, iNumEdges);
+            for(uint32_t iEdge = iChunk * kiChunkSize; iEdge < iEnd; iEdge++)
+            {
+                uint32_t iEdgePos0 = aiValidClusterGroupEdgePairs[iEdge].first;
+                uint32_t iEdgePos1 = aiValidClusterGroupEdgePairs[iEdge].second;
+                aEdges[iEdge] = std::make_pair(iEdgePos0, iEdgePos1);
+
+                if(aiNonBoundaryVertexFlags[iEdgePos0] == 0)
+                {
+                    afCollapseCosts[iEdge] = 1.0e+10f;
+                    aEdges[iEdge] = std::make_pair(0u, 0u);
+                    aOptimalVertexPositions[iEdge] = vec3(0.0f, 0.0f, 0.0f);
+                    aOptimalVertexNormals[iEdge] = vec3(0.0f, 0.0f, 0.0f);
+                    aOptimalVertexUVs[iEdge] = vec2(0.0f, 0.0f);
+                    continue;
+                }
+
+                // normal and uv of the edge vertices from the first triangle with the edge, in the triangle's vertex order
+                vec3 normal0(0.0f, 0.0f, 0.0f), normal1(0.0f, 0.0f, 0.0f);
+                vec2 uv0(0.0f, 0.0f), uv1(0.0f, 0.0f);
+                uint32_t iMatchingTri = findConnectivityEdgeTriangle(
+                    connectivity,
+                    aiClusterGroupTrianglePositionIndices,
+                    iEdgePos0,
+                    iEdgePos1);
+                if(iMatchingTri != UINT32_MAX)
+                {
+                    uint32_t aiTriIndices[3] = { 0, 0, 0 };
+                    uint32_t iNumSamePosition = 0;
+                    for(uint32_t i = 0; i < 3; i++)
+                    {
+                        uint32_t iPos = aiClusterGroupTrianglePositionIndices[iMatchingTri * 3 + i];
+                        if(iPos == iEdgePos0 || iPos == iEdgePos1)
+                        {
+                            aiTriIndices[iNumSamePosition++] = iMatchingTri * 3 + i;
+                        }
+                    }
+
+                    normal0 = aClusterGroupVertexNormals[aiClusterGroupTriangleNormalIndices[aiTriIndices[0]]];
+                    normal1 = aClusterGroupVertexNormals[aiClusterGroupTriangleNormalIndices[aiTriIndices[1]]];
+                    uv0 = aClusterGroupVertexUVs[aiClusterGroupTriangleUVIndices[aiTriIndices[0]]];
+                    uv1 = aClusterGroupVertexUVs[aiClusterGroupTriangleUVIndices[aiTriIndices[1]]];
+                }
+
+                vec3 const& position0 = aClusterGroupVertexPositions[iEdgePos0];
+                vec3 const& position1 = aClusterGroupVertexPositions[iEdgePos1];
+                float fFeatureValue = lengthSquared(position1 - position0) * (1.0f + 0.5f * (afNormalPlaneAngles[iEdgePos0] + afNormalPlaneAngles[iEdgePos1]));
+
+                float afEdgeQuadrics[16];
+                for(uint32_t i = 0; i < 16; i++)
+                {
+                    afEdgeQuadrics[i] = afQuadrics[iEdgePos0 * 16 + i] + afQuadrics[iEdgePos1 * 16 + i];
+                }
+                afEdgeQuadrics[15] += fFeatureValue;
+
+                if(aiNonBoundaryVertexFlags[iEdgePos1] == 0)
+                {
+                    // boundary
+                    aOptimalVertexPositions[iEdge] = position1;
+                    aOptimalVertexNormals[iEdge] = normal1;
+                    aOptimalVertexUVs[iEdge] = uv1;
+                }
+                else
+                {
+                    // mid point
+                    aOptimalVertexPositions[iEdge] = (position0 + position1) * 0.5f;
+                    aOptimalVertexNormals[iEdge] = (normal0 + normal1) * 0.5f;
+                    aOptimalVertexUVs[iEdge] = (uv0 + uv1) * 0.5f;
+                }
+
+                // compute the cost of the contraction (transpose(v_optimal) * M * v_optimal)
+                vec3 const& v = aOptimalVertexPositions[iEdge];
+                afCollapseCosts[iEdge] =
+                    afEdgeQuadrics[0] * v.x * v.x +
+                    2.0f * afEdgeQuadrics[1] * v.x * v.y +
+                    2.0f * afEdgeQuadrics[2] * v.x * v.z +
+                    2.0f * afEdgeQuadrics[3] * v.x +
+                    afEdgeQuadrics[5] * v.y * v.y +
+                    2.0f * afEdgeQuadrics[6] * v.y * v.z +
+                    2.0f * afEdgeQuadrics[7] * v.y +
+                    afEdgeQuadrics[10] * v.z * v.z +
+                    2.0f * afEdgeQuadrics[11] * v.z +
+                    afEdgeQuadrics[15];
+
+            }   // for edge = chunk start to chunk end
+        });
+}
+
+/*
+**
+*/
+void getShortestVertexDistancesCPU(
+    std::vector<float>& afClosestDistances,
+    std::vector<uint32_t>& aiClosestVertexPositionIndices,
+    std::vector<vec3> const& aVertexPositions0,
+    std::vector<vec3> const& aVertexPositions1)
+{
+    uint32_t iNumVertices0 = static_cast<uint32_t>(aVertexPositions0.size());
+    uint32_t iNumVertices1 = static_cast<uint32_t>(aVertexPositions1.size());
+    afClosestDistances.assign(iNumVertices0, 0.0f);
+    aiClosestVertexPositionIndices.assign(iNumVertices0, 0);
+
+    // check positions as 4-wide x, y, z streams, padding is far enough to never be the closest
+    uint32_t iNumPadded1 = (iNumVertices1 + 3) & ~3u;
+    std::vector<float> afX(iNumPadded1, 1.0e+18f), afY(iNumPadded1, 1.0e+18f), afZ(iNumPadded1, 1.0e+18f);
+    for(uint32_t i = 0; i < iNumVertices1; i++)
+    {
+        afX[i] = aVertexPositions1[i].x;
+        afY[i] = aVertexPositions1[i].y;
+        afZ[i] = aVertexPositions1[i].z;
+    }
+
+    uint32_t const kiChunkSize = 64;
+    uint32_t iMinChunksPerThread = std::max(1u, (1u << 16) / std::max(iNumPadded1 * kiChunkSize, 1u));
+    parallelFor(
+        (iNumVertices0 + kiChunkSize - 1) / kiChunkSize,
+        iMinChunksPerThread,
+        [&afClosestDistances,
+        &aiClosestVertexPositionIndices,
+        &aVertexPositions0,
+        &afX,
+        &afY,
+        &afZ,
+        iNumVertices0,
+        iNumPadded1,
+        kiChunkSize](uint32_t iChunk, uint32_t /*iSlot*/)
+        {
+            uint32_t iEnd = std::min((iChunk + 1) * kiChunkSize, iNumVertices0);
+            for(uint32_t iVertex = iChunk * kiChunkSize; iVertex < iEnd; iVertex++)
+            {
+                __m128 x = _mm_set1_ps(aVertexPositions0[iVertex].x);
+                __m128 y = _mm_set1_ps(aVertexPositions0[iVertex].y);
+                __m128 z = _mm_set1_ps(aVertexPositions0[iVertex].z);
+
+                // per lane closest, strictly smaller keeps the first index of equal distances
+                __m128 shortestLength = _mm_set1_ps(1.0e+10f);
+                __m128i shortestIndex = _mm_set1_epi32(-1);
+                __m128i index = _mm_setr_epi32(0, 1, 2, 3);
+                __m128i const four = _mm_set1_epi32(4);
+                for(uint32_t iPos = 0; iPos < iNumPadded1; iPos += 4)
+                {
+                    __m128 diffX = _mm_sub_ps(_mm_loadu_ps(&afX[iPos]), x);
+                    __m128 diffY = _mm_sub_ps(_mm_loadu_ps(&afY[iPos]), y);
+                    __m128 diffZ = _mm_sub_ps(_mm_loadu_ps(&afZ[iPos]), z);
+                    __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(diffX, diffX), _mm_mul_ps(diffY, diffY)), _mm_mul_ps(diffZ, diffZ)));
+
+                    __m128 closer = _mm_cmplt_ps(length, shortestLength);
+                    shortestLength = _mm_or_ps(_mm_and_ps(closer, length), _mm_andnot_ps(closer, shortestLength));
+                    __m128i closerIndex = _mm_castps_si128(closer);
+                    shortestIndex = _mm_or_si128(_mm_and_si128(closerIndex, index), _mm_andnot_si128(closerIndex, shortestIndex));
+                    index = _mm_add_epi32(index, four);
+                }
+
+                float afShortestLengths[4];
+                uint32_t aiShortestIndices[4];
+                _mm_storeu_ps(afShortestLengths, shortestLength);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(aiShortestIndices), shortestIndex);
+
+                float fShortestLength = 1.0e+10f;
+                uint32_t iShortestIndex = UINT32_MAX;
+                for(uint32_t iLane = 0; iLane < 4; iLane++)
+                {
+                    if(afShortestLengths[iLane] < fShortestLength ||
+                        (afShortestLengths[iLane] == fShortestLength && aiShortestIndices[iLane] < iShortestIndex))
+                    {
+                        fShortestLength = afShortestLengths[iLane];
+                        iShortestIndex = aiShortestIndices[iLane];
+                    }
+                }
+
+                if(iShortestIndex != UINT32_MAX)
+                {
+                    afClosestDistances[iVertex] = fShortestLength;
+                    aiClosestVertexPositionIndices[iVertex] = iShortestIndex;
+                }
+            }
+        });
+}
+
+/*
+**
+*/
+void buildClusterEdgeAdjacencyCPU(
+    std::vector<std::vector<uint32_t>>& aaiAdjacentEdgeClusters,
+    std::vector<std::vector<vec3>> const& aaVertexPositions,
+    std::vector<std::vector<uint32_t>> const& aaiVertexPositionIndices)
+{
+    float const kfMaxDistance = 1.0e-7f;
+    PositionIndexCPU index;
+    buildPositionIndexCPU(index, aaVertexPositions, kfMaxDistance);
+    std::vector<uint32_t> aiCanonicalPositions;
+    getCanonicalPositionIndicesCPU(aiCanonicalPositions, index, kfMaxDistance);
+
+    // (edge key, cluster) of all the triangle edges, clusters with the same edge key are edge adjacent
+    uint32_t iNumClusters = static_cast<uint32_t>(aaVertexPositions.size());
+    std::vector<uint32_t> aiEdgeOffsets(iNumClusters + 1, 0);
+    for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
+    {
+        aiEdgeOffsets[iCluster + 1] = aiEdgeOffsets[iCluster] + static_cast<uint32_t>(aaiVertexPositionIndices[iCluster].size());
+    }
+
+    std::vector<std::pair<uint64_t, uint32_t>> aEdgeClusters(aiEdgeOffsets[iNumClusters]);
+    parallelFor(
+        iNumClusters,
+        16,
+        [&aEdgeClusters,
+        &aiEdgeOffsets,
+        &aiCanonicalPositions,
+        &index,
+        &aaiVertexPositionIndices](uint32_t iCluster, uint32_t /*iSlot*/)
+        {
+            auto const& aiTrianglePositionIndices = aaiVertexPositionIndices[iCluster];
+            uint32_t iPositionOffset = index.maiOwnerOffsets[iCluster];
+            std::pair<uint64_t, uint32_t>* paEdgeClusters = aEdgeClusters.data() + aiEdgeOffsets[iCluster];
+            for(uint32_t iTri = 0; iTri < static_cast<uint32_t>(aiTrianglePositionIndices.size()); iTri += 3)
+            {
+                uint32_t iPos0 = aiCanonicalPositions[iPositionOffset + aiTrianglePositionIndices[iTri]];
+                uint32_t iPos1 = aiCanonicalPositions[iPositionOffset + aiTrianglePositionIndices[iTri + 1]];
+                uint32_t iPos2 = aiCanonicalPositions[iPositionOffset + aiTrianglePositionIndices[iTri + 2]];
+                paEdgeClusters[iTri] = std::make_pair(getCanonicalEdgeKey(iPos0, iPos1), iCluster);
+                paEdgeClusters[iTri + 1] = std::make_pair(getCanonicalEdgeKey(iPos0, iPos2), iCluster);
+                paEdgeClusters[iTri + 2] = std::make_pair(getCanonicalEdgeKey(iPos1, iPos2), iCluster);
+            }
+        });
+
+    std::sort(aEdgeClusters.begin(), aEdgeClusters.end());
+
+    aaiAdjacentEdgeClusters.resize(iNumClusters);
+    for(auto& aiAdjacentEdgeClusters : aaiAdjacentEdgeClusters)
+    {
+        aiAdjacentEdgeClusters.clear();
+    }
+
+    for(uint32_t iStart = 0; iStart < static_cast<uint32_t>(aEdgeClusters.size());)
+    {
+        uint32_t iEnd = iStart + 1;
+        while(iEnd < static_cast<uint32_t>(aEdgeClusters.size()) && aEdgeClusters[iEnd].first == aEdgeClusters[iStart].first)
+        {
+            ++iEnd;
+        }
+
+        for(uint32_t i = iStart; i < iEnd; i++)
+        {
+            for(uint32_t j = i + 1; j < iEnd; j++)
+            {
+                if(aEdgeClusters[i].second != aEdgeClusters[j].second)
+                {
+                    aaiAdjacentEdgeClusters[aEdgeClusters[i].second].push_back(aEdgeClusters[j].second);
+                    aaiAdjacentEdgeClusters[aEdgeClusters[j].second].push_back(aEdgeClusters[i].second);
+                }
+            }
+        }
+
+        iStart = iEnd;
+    }
+
+    parallelFor(
+        iNumClusters,
+        64,
+        [&aaiAdjacentEdgeClusters](uint32_t iCluster, uint32_t /*iSlot*/)
+        {
+            auto& aiAdjacentEdgeClusters = aaiAdjacentEdgeClusters[iCluster];
+            std::sort(aiAdjacentEdgeClusters.begin(), aiAdjacentEdgeClusters.end());
+            aiAdjacentEdgeClusters.erase(std::unique(aiAdjacentEdgeClusters.begin(), aiAdjacentEdgeClusters.end()), aiAdjacentEdgeClusters.end());
+        });
+}
+
+/*
+**
+*/
+void buildClusterEdgeAdjacencyCPU2(
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>>& aaiAdjacentEdgeClusters,
+    std::vector<std::vector<vec3>> const& aaVertexPositions,
+    std::vector<std::vector<uint32_t>> const& aaiVertexPositionIndices)
+{
+    // same definition as buildClusterEdgeAdjacencyCUDA2: number of shared triangle edges with each of the 10 clusters
+    // closest by bounding box center (including the cluster itself, ties to the smaller index)
+    uint32_t const kiNumCandidates = 10;
+    float const kfMaxDistance = 1.0e-8f;
+    PositionIndexCPU index;
+    buildPositionIndexCPU(index, aaVertexPositions, kfMaxDistance);
+    std::vector<uint32_t> aiCanonicalPositions;
+    getCanonicalPositionIndicesCPU(aiCanonicalPositions, index, kfMaxDistance);
+
+    // sorted edge keys of each cluster's triangles and the cluster's bounding box center
+    uint32_t iNumClusters = static_cast<uint32_t>(aaVertexPositions.size());
+    std::vector<std::vector<uint64_t>> aaiClusterEdgeKeys(iNumClusters);
+    std::vector<vec3> aClusterCenters(iNumClusters);
+    parallelFor(
+        iNumClusters,
+        16,
+        [&aaiClusterEdgeKeys,
+        &aClusterCenters,
+        &aiCanonicalPositions,
+        &index,
+        &aaVertexPositions,
+        &aaiVertexPositionIndices](uint32_t iCluster, uint32_t /*iSlot*/)
+        {
+            auto const& aiTrianglePositionIndices = aaiVertexPositionIndices[iCluster];
+            auto& aiEdgeKeys = aaiClusterEdgeKeys[iCluster];
+            aiEdgeKeys.resize(aiTrianglePositionIndices.size());
+            uint32_t iPositionOffset = index.maiOwnerOffsets[iCluster];
+            for(uint32_t iTri = 0; iTri < static_cast<uint32_t>(aiTrianglePositionIndices.size()); iTri += 3)
+            {
+                uint32_t iPos0 = aiCanonicalPositions[iPositionOffset + aiTrianglePositionIndices[iTri]];
+                uint32_t iPos1 = aiCanonicalPositions[iPositionOffset + aiTrianglePositionIndices[iTri + 1]];
+                uint32_t iPos2 = aiCanonicalPositions[iPositionOffset + aiTrianglePositionIndices[iTri + 2]];
+                aiEdgeKeys[iTri] = getCanonicalEdgeKey(iPos0, iPos1);
+                aiEdgeKeys[iTri + 1] = getCanonicalEdgeKey(iPos1, iPos2);
+                aiEdgeKeys[iTri + 2] = getCanonicalEdgeKey(iPos2, iPos0);
+            }
+            std::sort(aiEdgeKeys.begin(), aiEdgeKeys.end());
+
+            vec3 minBounds(1.0e+10f, 1.0e+10f, 1.0e+10f);
+            vec3 maxBounds(-1.0e+10f, -1.0e+10f, -1.0e+10f);
+            for(auto const& position : aaVertexPositions[iCluster])
+            {
+                minBounds = fminf(minBounds, position);
+                maxBounds = fmaxf(maxBounds, position);
+            }
+            aClusterCenters[iCluster] = (maxBounds + minBounds) * 0.5f;
+        });
+
+    PointKDTree centerTree;
+    buildPointKDTree(centerTree, aClusterCenters);
+
+    // (candidate cluster, number of shared edges) in ascending cluster order, every (edge, candidate edge) pair is counted
+    aaiAdjacentEdgeClusters.resize(iNumClusters);
+    parallelFor(
+        iNumClusters,
+        16,
+        [&aaiAdjacentEdgeClusters,
+        &aaiClusterEdgeKeys,
+        &aClusterCenters,
+        &centerTree](uint32_t iCluster, uint32_t /*iSlot*/)
+        {
+            uint32_t aiCandidates[kiNumCandidates];
+            float afCandidateDistances[kiNumCandidates];
+            uint32_t iNumFound = getNearestPointsSquared(
+                aiCandidates,
+                afCandidateDistances,
+                centerTree,
+                aClusterCenters[iCluster],
+                kiNumCandidates);
+            std::sort(aiCandidates, aiCandidates + iNumFound);
+
+            auto const& aiEdgeKeys = aaiClusterEdgeKeys[iCluster];
+            auto& aiAdjacentEdgeClusters = aaiAdjacentEdgeClusters[iCluster];
+            aiAdjacentEdgeClusters.clear();
+            for(uint32_t iCandidate = 0; iCandidate < iNumFound; iCandidate++)
+            {
+                uint32_t iCheckCluster = aiCandidates[iCandidate];
+                if(iCheckCluster == iCluster)
+                {
+                    continue;
+                }
+
+                // merge the two sorted key lists, runs of the same key count as the product of their lengths
+                auto const& aiCheckEdgeKeys = aaiClusterEdgeKeys[iCheckCluster];
+                uint32_t iNumSharedEdges = 0;
+                uint32_t i = 0, j = 0;
+                while(i < static_cast<uint32_t>(aiEdgeKeys.size()) && j < static_cast<uint32_t>(aiCheckEdgeKeys.size()))
+                {
+                    if(aiEdgeKeys[i] < aiCheckEdgeKeys[j])
+                    {
+                        ++i;
+                    }
+                    else if(aiCheckEdgeKeys[j] < aiEdgeKeys[i])
+                    {
+                        ++j;
+                    }
+                    else
+                    {
+                        uint64_t iKey = aiEdgeKeys[i];
+                        uint32_t iNumKeys = 0, iNumCheckKeys = 0;
+                        for(; i < static_cast<uint32_t>(aiEdgeKeys.size()) && aiEdgeKeys[i] == iKey; i++)
+                        {
+                            ++iNumKeys;
+                        }
+                        for(; j < static_cast<uint32_t>(aiCheckEdgeKeys.size()) && aiCheckEdgeKeys[j] == iKey; j++)
+                        {
+                            ++iNumCheckKeys;
+                        }
+                        iNumSharedEdges += iNumKeys * iNumCheckKeys;
+                    }
+                }
+
+                if(iNumSharedEdges > 0)
+                {
+                    aiAdjacentEdgeClusters.push_back(std::make_pair(iCheckCluster, iNumSharedEdges));
+                }
+            }
+        });
+}
+
+/*
+**
+*/
+void getSortedEdgeAdjacentClustersCPU(
+    std::vector<std::vector<uint32_t>>& aaiSortedAdjacentEdgeClusters,
+    std::vector<std::vector<vec3>> const& aaVertexPositions)
+{
+    // bounding box centers as 4-wide x, y, z streams
+    uint32_t iNumClusters = static_cast<uint32_t>(aaVertexPositions.size());
+    uint32_t iNumPaddedClusters = (iNumClusters + 3) & ~3u;
+    std::vector<float> afCenterX(iNumPaddedClusters, 0.0f), afCenterY(iNumPaddedClusters, 0.0f), afCenterZ(iNumPaddedClusters, 0.0f);
+    parallelFor(
+        iNumClusters,
+        64,
+        [&afCenterX,
+        &afCenterY,
+        &afCenterZ,
+        &aaVertexPositions](uint32_t iCluster, uint32_t /*iSlot*/)
+        {
+            vec3 minBounds(1.0e+10f, 1.0e+10f, 1.0e+10f);
+            vec3 maxBounds(-1.0e+10f, -1.0e+10f, -1.0e+10f);
+            for(auto const& position : aaVertexPositions[iCluster])
+            {
+                minBounds = fminf(minBounds, position);
+                maxBounds = fmaxf(maxBounds, position);
+            }
+
+            afCenterX[iCluster] = (maxBounds.x + minBounds.x) * 0.5f;
+            afCenterY[iCluster] = (maxBounds.y + minBounds.y) * 0.5f;
+            afCenterZ[iCluster] = (maxBounds.z + minBounds.z) * 0.5f;
+        });
+
+    struct ClusterDistanceInfo
+    {
+        uint32_t        miCluster;
+        float           mfDistance;
+    };
+
+    aaiSortedAdjacentEdgeClusters.resize(iNumClusters);
+    parallelFor(
+        iNumClusters,
+        16,
+        [&aaiSortedAdjacentEdgeClusters,
+        &afCenterX,
+        &afCenterY,
+        &afCenterZ,
+        iNumClusters,
+        iNumPaddedClusters](uint32_t iCluster, uint32_t /*iSlot*/)
+        {
+            std::vector<float> afDistances(iNumPaddedClusters);
+            __m128 x = _mm_set1_ps(afCenterX[iCluster]);
+            __m128 y = _mm_set1_ps(afCenterY[iCluster]);
+            __m128 z = _mm_set1_ps(afCenterZ[iCluster]);
+            for(uint32_t iCheckCluster = 0; iCheckCluster < iNumPaddedClusters; iCheckCluster += 4)
+            {
+                __m128 diffX = _mm_sub_ps(x, _mm_loadu_ps(&afCenterX[iCheckCluster]));
+                __m128 diffY = _mm_sub_ps(y, _mm_loadu_ps(&afCenterY[iCheckCluster]));
+                __m128 diffZ = _mm_sub_ps(z, _mm_loadu_ps(&afCenterZ[iCheckCluster]));
+                _mm_storeu_ps(
+                    &afDistances[iCheckCluster],
+                    _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(diffX, diffX), _mm_mul_ps(diffY, diffY)), _mm_mul_ps(diffZ, diffZ))));
+            }
+            afDistances[iCluster] = 0.0f;
+
+            std::vector<ClusterDistanceInfo> aClusterDistanceInfo(iNumClusters);
+            for(uint32_t iCheckCluster = 0; iCheckCluster < iNumClusters; iCheckCluster++)
+            {
+                aClusterDistanceInfo[iCheckCluster].miCluster = iCheckCluster;
+                aClusterDistanceInfo[iCheckCluster].mfDistance = afDistances[iCheckCluster];
+            }
+
+            std::sort(
+                aClusterDistanceInfo.begin(),
+                aClusterDistanceInfo.end(),
+                [](ClusterDistanceInfo const& checkInfo0, ClusterDistanceInfo const& checkInfo1)
+                {
+                    return checkInfo0.mfDistance < checkInfo1.mfDistance;
+                });
+
+            auto& aiSortedAdjacentEdgeClusters = aaiSortedAdjacentEdgeClusters[iCluster];
+            aiSortedAdjacentEdgeClusters.resize(iNumClusters);
+            for(uint32_t i = 0; i < iNumClusters; i++)
+            {
+                aiSortedAdjacentEdgeClusters[i] = aClusterDistanceInfo[i].miCluster;
+            }
+        });
+}
+
+/*
+**
+*/
+void getProjectVertexDistancesCPU(
+    std::vector<vec3>& aProjectedPositions,
+    std::vector<vec3> const& aTriangleVertexPositions0,
+    std::vector<vec3> const& aTriangleVertexPositions1)
+{
+    uint32_t iNumVertices0 = static_cast<uint32_t>(aTriangleVertexPositions0.size());
+    uint32_t iNumVertices1 = static_cast<uint32_t>(aTriangleVertexPositions1.size());
+    assert(iNumVertices0 % 3 == 0);
+    assert(iNumVertices1 % 3 == 0);
+
+    // planes of the check triangles as 4-wide streams, padding has a zero normal and is never hit
+    uint32_t iNumCheckTriangles = iNumVertices1 / 3;
+    uint32_t iNumPaddedCheckTriangles = (iNumCheckTriangles + 3) & ~3u;
+    std::vector<float> afNormalX(iNumPaddedCheckTriangles, 0.0f), afNormalY(iNumPaddedCheckTriangles, 0.0f), afNormalZ(iNumPaddedCheckTriangles, 0.0f), afPlaneD(iNumPaddedCheckTriangles, 0.0f);
+    for(uint32_t iCheckTriangle = 0; iCheckTriangle < iNumCheckTriangles; iCheckTriangle++)
+    {
+        vec3 const& checkPos0 = aTriangleVertexPositions1[iCheckTriangle * 3];
+        vec3 const& checkPos1 = aTriangleVertexPositions1[iCheckTriangle * 3 + 1];
+        vec3 const& checkPos2 = aTriangleVertexPositions1[iCheckTriangle * 3 + 2];
+        vec3 checkNormal = cross(normalize(checkPos2 - checkPos0), normalize(checkPos1 - checkPos0));
+        afNormalX[iCheckTriangle] = checkNormal.x;
+        afNormalY[iCheckTriangle] = checkNormal.y;
+        afNormalZ[iCheckTriangle] = checkNormal.z;
+        afPlaneD[iCheckTriangle] = dot(checkNormal, checkPos0) * -1.0f;
+    }
+
+    // project each vertex along its face normal onto the first check triangle it lands in
+    aProjectedPositions.resize(iNumVertices0);
+    uint32_t iNumTriangles = iNumVertices0 / 3;
+    parallelFor(
+        iNumTriangles,
+        16,
+        [&aProjectedPositions,
+        &aTriangleVertexPositions0,
+        &aTriangleVertexPositions1,
+        &afNormalX,
+        &afNormalY,
+        &afNormalZ,
+        &afPlaneD,
+        iNumPaddedCheckTriangles](uint32_t iTriangle, uint32_t /*iSlot*/)
+        {
+            vec3 const& pos0 = aTriangleVertexPositions0[iTriangle * 3];
+            vec3 const& pos1 = aTriangleVertexPositions0[iTriangle * 3 + 1];
+            vec3 const& pos2 = aTriangleVertexPositions0[iTriangle * 3 + 2];
+            vec3 faceNormal = cross(normalize(pos2 - pos0), normalize(pos1 - pos0));
+
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                vec3 const& pos = aTriangleVertexPositions0[iTriangle * 3 + i];
+                vec3 pt1 = pos + faceNormal * 100.0f;
+                vec3 v = pt1 - pos;
+
+                __m128 posX = _mm_set1_ps(pos.x), posY = _mm_set1_ps(pos.y), posZ = _mm_set1_ps(pos.z);
+                __m128 vX = _mm_set1_ps(v.x), vY = _mm_set1_ps(v.y), vZ = _mm_set1_ps(v.z);
+                __m128 const signMask = _mm_set1_ps(-0.0f);
+                __m128 const minDenom = _mm_set1_ps(0.00001f);
+                __m128 const one = _mm_set1_ps(1.0f);
+                __m128 const negativeOne = _mm_set1_ps(-1.0f);
+
+                bool bProjected = false;
+                vec3 ret;
+                for(uint32_t iCheckTriangle = 0; iCheckTriangle < iNumPaddedCheckTriangles && !bProjected; iCheckTriangle += 4)
+                {
+                    // ray plane intersection t for 4 triangles, only the ones within [-1, 1] need the barycentric test
+                    __m128 normalX = _mm_loadu_ps(&afNormalX[iCheckTriangle]);
+                    __m128 normalY = _mm_loadu_ps(&afNormalY[iCheckTriangle]);
+                    __m128 normalZ = _mm_loadu_ps(&afNormalZ[iCheckTriangle]);
+                    __m128 denom = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vX, normalX), _mm_mul_ps(vY, normalY)), _mm_mul_ps(vZ, normalZ));
+                    __m128 numer = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(posX, normalX), _mm_mul_ps(posY, normalY)), _mm_mul_ps(posZ, normalZ)), _mm_loadu_ps(&afPlaneD[iCheckTriangle]));
+                    __m128 t = _mm_div_ps(_mm_xor_ps(numer, signMask), denom);
+                    __m128 valid = _mm_and_ps(
+                        _mm_cmpgt_ps(_mm_andnot_ps(signMask, denom), minDenom),
+                        _mm_and_ps(_mm_cmpge_ps(t, negativeOne), _mm_cmple_ps(t, one)));
+
+                    float afT[4];
+                    _mm_storeu_ps(afT, t);
+                    int32_t iValidMask = _mm_movemask_ps(valid);
+                    for(uint32_t iLane = 0; iLane < 4 && iValidMask != 0; iLane++)
+                    {
+                        if((iValidMask & (1 << iLane)) == 0)
+                        {
+                            continue;
+                        }
+
+                        uint32_t iCheckIndex = (iCheckTriangle + iLane) * 3;
+                        vec3 const& checkPos0 = aTriangleVertexPositions1[iCheckIndex];
+                        vec3 const& checkPos1 = aTriangleVertexPositions1[iCheckIndex + 1];
+                        vec3 const& checkPos2 = aTriangleVertexPositions1[iCheckIndex + 2];
+
+                        vec3 intersectionPt = pos + v * afT[iLane];
+                        vec3 barycentricPt = barycentric(intersectionPt, checkPos0, checkPos1, checkPos2);
+                        if(barycentricPt.x >= -0.01f && barycentricPt.x <= 1.01f &&
+                            barycentricPt.y >= -0.01f && barycentricPt.y <= 1.01f &&
+                            barycentricPt.z >= -0.01f && barycentricPt.z <= 1.01f)
+                        {
+                            ret = checkPos0 * barycentricPt.x + checkPos1 * barycentricPt.y + checkPos2 * barycentricPt.z;
+                            bProjected = true;
+                            break;
+                        }
+                    }
+
+                }   // for check triangle = 0 to num check triangles
+
+                aProjectedPositions[iTriangle * 3 + i] = bProjected ? ret : pos + faceNormal * 10.0f;
+
+            }   // for i = 0 to 3
+        });
+}
+
+/*
+**
+*/
+void getClosestSurfaceDistancesCPU(
+    std::vector<float>& afClosestDistances,
+    std::vector<vec3>& aClosestPositions,
+    std::vector<vec3> const& aVertexPositions,
+    std::vector<vec3> const& aTriangleVertexPositions)
+{
+    TriangleBVH bvh;
+    buildTriangleBVH(bvh, aTriangleVertexPositions);
+    getClosestSurfaceDistancesCPU(
+        afClosestDistances,
+        aClosestPositions,
+        aVertexPositions,
+        bvh);
+}
+
+/*
+**
+*/
+void getClosestSurfaceDistancesCPU(
+    std::vector<float>& afClosestDistances,
+    std::vector<vec3>& aClosestPositions,
+    std::vector<vec3> const& aVertexPositions,
+    TriangleBVH const& bvh)
+{
+    uint32_t iNumVertices = static_cast<uint32_t>(aVertexPositions.size());
+    afClosestDistances.resize(iNumVertices);
+    aClosestPositions.resize(iNumVertices);
+
+    for(uint32_t iVertex = 0; iVertex < iNumVertices; iVertex++)
+    {
+        uint32_t iClosestTriangle = UINT32_MAX;
+        afClosestDistances[iVertex] = getClosestPointOnTriangles(
+            aClosestPositions[iVertex],
+            iClosestTriangle,
+            bvh,
+            aVertexPositions[iVertex]);
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <vector>
+
+#include "vec.h"
+
+struct TriangleBVH;
+
+// multi-threaded cpu versions of the entry points in test.h, same inputs and outputs as the cuda ones
+void checkClusterGroupBoundaryVerticesCPU(
+    std::vector<std::vector<uint32_t>>& aaiClusterGroupBoundaryVertices,
+    std::vector<std::vector<vec3>> const& aaClusterGroupVertexPositions,
+    std::vector<std::vector<uint32_t>> const& aaiClusterGroupTrianglePositionIndices);
+
+void buildClusterAdjacencyCPU(
+    std::vector<std::vector<uint32_t>>& aaiNumAdjacentVertices,
+    std::vector<std::vector<vec3>> const& aaVertexPositions,
+    bool bOnlyEdgeAdjacent);
+
+void getClusterGroupBoundaryVerticesCPU(
+    std::vector<std::vector<uint32_t>>& aaiClusterGroupBoundaryVertices,
+    std::vector<std::vector<vec3>> const& aaClusterGroupVertexPositions);
+
+void computeEdgeCollapseInfoCPU(
+    std::vector<float>& afCollapseCosts,
+    std::vector<vec3>& aOptimalVertexPositions,
+    std::vector<vec3>& aOptimalVertexNormals,
+    std::vector<vec2>& aOptimalVertexUVs,
+    std::vector<std::pair<uint32_t, uint32_t>>& aEdges,
+    std::vector<vec3> const& aClusterGroupVertexPositions,
+    std::vector<vec3> const& aClusterGroupVertexNormals,
+    std::vector<vec2> const& aClusterGroupVertexUVs,
+    std::vector<std::pair<uint32_t, uint32_t>> const& aiValidClusterGroupEdgePairs,
+    std::vector<uint32_t> const& aiClusterGroupNonBoundaryVertices,
+    std::vector<uint32_t> const& aiClusterGroupTrianglePositionIndices,
+    std::vector<uint32_t> const& aiClusterGroupTriangleNormalIndices,
+    std::vector<uint32_t> const& aiClusterGroupTriangleUVIndices);
+
+void getShortestVertexDistancesCPU(
+    std::vector<float>& afClosestDistances,
+    std::vector<uint32_t>& aiClosestVertexPositionIndices,
+    std::vector<vec3> const& aVertexPositions0,
+    std::vector<vec3> const& aVertexPositions1);
+
+void buildClusterEdgeAdjacencyCPU(
+    std::vector<std::vector<uint32_t>>& aaiAdjacentEdgeClusters,
+    std::vector<std::vector<vec3>> const& aaVertexPositions,
+    std::vector<std::vector<uint32_t>> const& aaiVertexPositionIndices);
+
+void buildClusterEdgeAdjacencyCPU2(
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>>& aaiAdjacentEdgeClusters,
+    std::vector<std::vector<vec3>> const& aaVertexPositions,
+    std::vector<std::vector<uint32_t>> const& aaiVertexPositionIndices);
+
+void getSortedEdgeAdjacentClustersCPU(
+    std::vector<std::vector<uint32_t>>& aaiSortedAdjacentEdgeClusters,
+    std::vector<std::vector<vec3>> const& aaVertexPositions);
+
+void getProjectVertexDistancesCPU(
+    std::vector<vec3>& aProjectedPositions,
+    std::vector<vec3> const& aTriangleVertexPositions0,
+    std::vector<vec3> const& aTriangleVertexPositions1);
+
+void getClusterGroupBoundaryVerticesCPU2(
+    std::vector<std::vector<uint32_t>>& aaiClusterGroupBoundaryVertices,
+    std::vector<std::vector<vec3>> const& aaClusterGroupVertexPositions);
+
+// closest point on the triangle list (3 positions per triangle) to each vertex and its distance, through a triangle bvh
+//      max of the distances is the one-sided hausdorff distance from the vertices to the surface, cpu only
+//      runs on the calling thread, a cluster's worth of vertices is too little work to split, parallelize over the clusters instead
+void getClosestSurfaceDistancesCPU(
+    std::vector<float>& afClosestDistances,
+    std::vector<vec3>& aClosestPositions,
+    std::vector<vec3> const& aVertexPositions,
+    std::vector<vec3> const& aTriangleVertexPositions);
+
+// same with a prebuilt triangle bvh, for when several vertex sets are checked against the same triangles
+void getClosestSurfaceDistancesCPU(
+    std::vector<float>& afClosestDistances,
+    std::vector<vec3>& aClosestPositions,
+    std::vector<vec3> const& aVertexPositions,
+    TriangleBVH const& bvh);
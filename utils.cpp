@@ -1,5 +1,8 @@
 #include "utils.h"
 
+#include <algorithm>
+#include <cfloat>
+
 /*
 **
 */
@@ -28,4 +31,110 @@ uint32_t getBitFlag(uint32_t* aiFlags, uint32_t iIndex)
     uint32_t iBitIndex = iIndex % 32;
     uint32_t iRet = (aiFlags[iArrayIndex] & (1 << iBitIndex)) >> iBitIndex;
     return iRet;
-}
\ No newline at end of file
+}
+
+/*
+**
+*/
+int3 getSpatialHashCell(float3 const& position, float fCellSize)
+{
+    // clamped so out of range cells saturate instead of overflowing, see getSpatialHashCellSize()
+    float const kfMaxCell = 2147483520.0f;
+    return int3(
+        static_cast<int32_t>(std::min(std::max(floorf(position.x / fCellSize), -kfMaxCell), kfMaxCell)),
+        static_cast<int32_t>(std::min(std::max(floorf(position.y / fCellSize), -kfMaxCell), kfMaxCell)),
+        static_cast<int32_t>(std::min(std::max(floorf(position.z / fCellSize), -kfMaxCell), kfMaxCell)));
+}
+
+/*
+**  at least the given size, and large enough to keep the cell coordinates of the positions within 24 bits
+*/
+float getSpatialHashCellSize(float3 const* aPositions, uint32_t iNumPositions, float fMinCellSize)
+{
+    float fLargestCoordinate = 0.0f;
+    for(uint32_t i = 0; i < iNumPositions; i++)
+    {
+        float3 const& position = aPositions[i];
+        fLargestCoordinate = std::max(fLargestCoordinate, std::max(fabsf(position.x), std::max(fabsf(position.y), fabsf(position.z))));
+    }
+
+    float fCellSize = std::max(fMinCellSize, fLargestCoordinate / 16777216.0f);
+    return std::max(fCellSize, FLT_MIN);
+}
+
+/*
+**
+*/
+uint64_t getSpatialHashKey(int3 const& cell)
+{
+    // large primes from "optimized spatial hashing for collision detection of deformable objects"
+    uint64_t iKey = static_cast<uint64_t>(static_cast<uint32_t>(cell.x)) * 73856093ull;
+    iKey ^= static_cast<uint64_t>(static_cast<uint32_t>(cell.y)) * 19349663ull;
+    iKey ^= static_cast<uint64_t>(static_cast<uint32_t>(cell.z)) * 83492791ull;
+    
+    return iKey;
+}
+
+/*
+**
+*/
+void buildSpatialHashIndex(
+    std::vector<std::pair<uint64_t, uint32_t>>& aKeyIndices,
+    float3 const* aPositions,
+    uint32_t iNumPositions,
+    float fCellSize)
+{
+    aKeyIndices.resize(iNumPositions);
+    for(uint32_t i = 0; i < iNumPositions; i++)
+    {
+        aKeyIndices[i] = std::make_pair(getSpatialHashKey(getSpatialHashCell(aPositions[i], fCellSize)), i);
+    }
+
+    // sorted by key then index, so the entries of a cell are contiguous and in ascending index order
+    std::sort(aKeyIndices.begin(), aKeyIndices.end());
+}
+
+/*
+**
+*/
+uint32_t findSpatialHashMatch(
+    std::vector<std::pair<uint64_t, uint32_t>> const& aKeyIndices,
+    float3 const* aPositions,
+    float3 const& position,
+    float fCellSize,
+    float fMaxDistance)
+{
+    // smallest index within max distance, same as a linear search from the start of the array
+    // max distance needs to be no larger than the cell size for the neighboring cells to cover it
+    uint32_t iRet = UINT32_MAX;
+    int3 cell = getSpatialHashCell(position, fCellSize);
+    for(int32_t iZ = -1; iZ <= 1; iZ++)
+    {
+        for(int32_t iY = -1; iY <= 1; iY++)
+        {
+            for(int32_t iX = -1; iX <= 1; iX++)
+            {
+                uint64_t iKey = getSpatialHashKey(int3(cell.x + iX, cell.y + iY, cell.z + iZ));
+                auto iter = std::lower_bound(
+                    aKeyIndices.begin(),
+                    aKeyIndices.end(),
+                    std::make_pair(iKey, 0u));
+                for(; iter != aKeyIndices.end() && iter->first == iKey; ++iter)
+                {
+                    if(iter->second >= iRet)
+                    {
+                        break;
+                    }
+
+                    if(length(aPositions[iter->second] - position) <= fMaxDistance)
+                    {
+                        iRet = iter->second;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    return iRet;
+}
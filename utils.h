@@ -2,5 +2,26 @@
 
 #include <stdint.h>
 
+#include <vector>
+
+#include "vec.h"
+
 void setBitFlag(uint32_t* aiFlags, uint32_t iIndex, uint32_t iValue);
-uint32_t getBitFlag(uint32_t* aiFlags, uint32_t iIndex);
\ No newline at end of file
+uint32_t getBitFlag(uint32_t* aiFlags, uint32_t iIndex);
+
+int3 getSpatialHashCell(float3 const& position, float fCellSize);
+float getSpatialHashCellSize(float3 const* aPositions, uint32_t iNumPositions, float fMinCellSize);
+uint64_t getSpatialHashKey(int3 const& cell);
+
+void buildSpatialHashIndex(
+    std::vector<std::pair<uint64_t, uint32_t>>& aKeyIndices,
+    float3 const* aPositions,
+    uint32_t iNumPositions,
+    float fCellSize);
+
+uint32_t findSpatialHashMatch(
+    std::vector<std::pair<uint64_t, uint32_t>> const& aKeyIndices,
+    float3 const* aPositions,
+    float3 const& position,
+    float fCellSize,
+    float fMaxDistance);
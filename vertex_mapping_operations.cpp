@@ -1,14 +1,18 @@
 #include "vertex_mapping_operations.h"
 
 #include <cassert>
-#include <mutex>
+#include <cinttypes>
+#include <cfloat>
+#include <chrono>
 
 #include "LogPrint.h"
+#include "spatial_index.h"
+#include "task_scheduler.h"
 
 /*
-**
+**  upper LOD vertices are put in a k-d tree once, every vertex of the given LOD then looks up its closest one
+**  clusters are processed in parallel, each writing its own result slot, and the slots are merged in cluster order
 */
-static std::mutex sMutex;
 void getVertexMappingAndMaxDistances(
     std::vector<float>& afMaxClusterDistances,
     std::map<std::pair<uint32_t, uint32_t>, VertexMappingInfo>& aVertexMapping,
@@ -24,117 +28,129 @@ void getVertexMappingAndMaxDistances(
 
     auto start = std::chrono::high_resolution_clock::now();
 
-    auto const& aMeshClusters = aaMeshClusters[iLODLevel];
-    uint32_t iNumMeshClusters = static_cast<uint32_t>(aMeshClusters.size());
-    for(uint32_t iMeshCluster = 0; iMeshCluster < iNumMeshClusters; iMeshCluster++)
+    uint32_t const kiMIPLevel = 0;
+
+    // vertices of the upper LOD clusters of the upper LOD cluster groups, with the group, cluster and vertex they came from
+    struct UpperVertexInfo
     {
-        float fMaxVertexPositionDistance = 0.0f;
+        uint32_t        miClusterGroup;
+        uint32_t        miCluster;
+        uint32_t        miClusterVertexID;
+    };
+    std::vector<float3> aUpperVertexPositions;
+    std::vector<UpperVertexInfo> aUpperVertexInfo;
+    if(iLODLevel > 0)
+    {
+        uint32_t iNumUpperMeshClusterGroups = static_cast<uint32_t>(aaMeshClusterGroups[iUpperLODLevel].size());
+        for(uint32_t iUpperMeshClusterGroup = 0; iUpperMeshClusterGroup < iNumUpperMeshClusterGroups; iUpperMeshClusterGroup++)
+        {
+            auto const& meshClusterGroup = aaMeshClusterGroups[iUpperLODLevel][iUpperMeshClusterGroup];
+            for(uint32_t iUpperMeshClusterIndex = 0; iUpperMeshClusterIndex < static_cast<uint32_t>(meshClusterGroup.maiNumClusters[kiMIPLevel]); iUpperMeshClusterIndex++)
+            {
+                uint32_t iMeshClusterID = meshClusterGroup.maiClusters[kiMIPLevel][iUpperMeshClusterIndex];
+                auto const& upperMeshCluster = *apTotalMeshClusters[iMeshClusterID];
 
-        auto const& meshCluster = aMeshClusters[iMeshCluster];
-        std::pair<float3, float3> maxErrorPositions;
+                float3 const* aUpperMeshClusterVertexPositions = reinterpret_cast<float3 const*>(vertexPositionBuffer.data() + upperMeshCluster.miVertexPositionStartArrayAddress * sizeof(float3));
+                for(uint32_t iUpperClusterVertex = 0; iUpperClusterVertex < static_cast<uint32_t>(upperMeshCluster.miNumVertexPositions); iUpperClusterVertex++)
+                {
+                    aUpperVertexPositions.push_back(aUpperMeshClusterVertexPositions[iUpperClusterVertex]);
+                    aUpperVertexInfo.push_back(UpperVertexInfo{ iUpperMeshClusterGroup, iMeshClusterID, iUpperClusterVertex });
+                }
+            }
+        }
+    }
 
-        uint32_t const kiMIPLevel = 0;
+    PointKDTree upperVertexTree;
+    buildPointKDTree(upperVertexTree, aUpperVertexPositions);
 
-        // get closest vertex positions from the upper clusters (given upper LOD)
-        for(uint32_t iVertex = 0; iVertex < static_cast<uint32_t>(meshCluster.miNumVertexPositions); iVertex++)
-        {
-            uint32_t iBestUpperMeshCluster = UINT32_MAX;
-            uint32_t iBestUpperMeshClusterGroup = UINT32_MAX;
-            uint32_t iBestUpperClusterVertexID = UINT32_MAX;
-            float3 bestUpperClusterVertexPosition = float3(FLT_MAX, FLT_MAX, FLT_MAX);
-            float fShortestDistance = FLT_MAX;
+    struct ClusterResult
+    {
+        float                                               mfMaxVertexPositionDistance = 0.0f;
+        std::pair<float3, float3>                           mMaxErrorPositions;
+        std::vector<VertexMappingInfo>                      maVertexMapping;
+    };
 
-            float3 const* aClusterVertexPositions = reinterpret_cast<float3 const*>(vertexPositionBuffer.data() + meshCluster.miVertexPositionStartArrayAddress * sizeof(float3));
-            auto const& vertexPosition = aClusterVertexPositions[iVertex];
+    auto const& aMeshClusters = aaMeshClusters[iLODLevel];
+    uint32_t iNumMeshClusters = static_cast<uint32_t>(aMeshClusters.size());
+    std::vector<ClusterResult> aClusterResults(iNumMeshClusters);
+    parallelFor(
+        iNumMeshClusters,
+        1,
+        [&aClusterResults,
+         &aMeshClusters,
+         &aUpperVertexInfo,
+         &upperVertexTree,
+         &vertexPositionBuffer,
+         &apTotalMeshClusters,
+         iLODLevel,
+         iUpperLODLevel](uint32_t iMeshCluster, uint32_t /*iSlot*/)
+        {
+            auto const& meshCluster = aMeshClusters[iMeshCluster];
+            ClusterResult& result = aClusterResults[iMeshCluster];
 
+            // LOD 0 vertices map onto themselves
             if(iLODLevel == 0)
             {
-                fShortestDistance = 0.0f;
-                bestUpperClusterVertexPosition = aClusterVertexPositions[iVertex];
-                iBestUpperClusterVertexID = iMeshCluster;
-                iBestUpperMeshClusterGroup = 0;
-                iBestUpperMeshCluster = iMeshCluster;
-
-                continue;
+                return;
             }
 
-            // mesh cluster group of given upper LOD
-            uint32_t iNumUpperMeshClusterGroups = static_cast<uint32_t>(aaMeshClusterGroups[iUpperLODLevel].size());
-            for(uint32_t iUpperMeshClusterGroup = 0; iUpperMeshClusterGroup < iNumUpperMeshClusterGroups; iUpperMeshClusterGroup++)
-            {
-                auto const& meshClusterGroup = aaMeshClusterGroups[iUpperLODLevel][iUpperMeshClusterGroup];
+            float3 const* aClusterVertexPositions = reinterpret_cast<float3 const*>(vertexPositionBuffer.data() + meshCluster.miVertexPositionStartArrayAddress * sizeof(float3));
+            result.maVertexMapping.resize(meshCluster.miNumVertexPositions);
 
-                // mesh clusters of given upper LOD associated with this mesh cluster group
-                for(uint32_t iUpperMeshClusterIndex = 0; iUpperMeshClusterIndex < static_cast<uint32_t>(meshClusterGroup.maiNumClusters[kiMIPLevel]); iUpperMeshClusterIndex++)
-                {
-                    uint32_t iMeshClusterID = meshClusterGroup.maiClusters[kiMIPLevel][iUpperMeshClusterIndex];
-                    auto const& upperMeshCluster = *apTotalMeshClusters[iMeshClusterID];
-
-                    float3 const* aUpperMeshClusterVertexPositions = reinterpret_cast<float3 const*>(vertexPositionBuffer.data() + upperMeshCluster.miVertexPositionStartArrayAddress * sizeof(float3));
-                    for(uint32_t iUpperClusterVertex = 0; iUpperClusterVertex < static_cast<uint32_t>(upperMeshCluster.miNumVertexPositions); iUpperClusterVertex++)
-                    {
-                        auto const& upperMeshClusterVertexPosition = aUpperMeshClusterVertexPositions[iUpperClusterVertex];
-                        float fDistance = lengthSquared(vertexPosition - upperMeshClusterVertexPosition);
-                        if(fDistance < fShortestDistance)
-                        {
-                            fShortestDistance = fDistance;
-                            bestUpperClusterVertexPosition = upperMeshClusterVertexPosition;
-                            iBestUpperClusterVertexID = iUpperClusterVertex;
-                            iBestUpperMeshClusterGroup = iUpperMeshClusterGroup;
-                            iBestUpperMeshCluster = iMeshClusterID;
-                        }
-                    }
-
-                }   // for cluster = 0 to num upper cluster
-
-            }   // for cluster group = 0 to num upper cluster group
-
-            // verify
-            float3 const* aCheckClusterVertexPositions = reinterpret_cast<float3 const*>(vertexPositionBuffer.data() + apTotalMeshClusters[iBestUpperMeshCluster]->miVertexPositionStartArrayAddress * sizeof(float3));
-            auto const& checkVertexPosition = aCheckClusterVertexPositions[iBestUpperClusterVertexID];
-            float fCheckDistance = length(checkVertexPosition - bestUpperClusterVertexPosition);
-            assert(fCheckDistance <= 1.0e-5f);
-            //DEBUG_PRINTF("found cluster %d of lod %d with position (%.4f, %.4f, %.4f) compared to\n cluster %d of lod %d with position (%.4f, %.4f, %.4f)\ndistance: %.4f\n",
-            //    iBestUpperMeshCluster,
-            //    iUpperLODLevel,
-            //    checkVertexPosition.x,
-            //    checkVertexPosition.y,
-            //    checkVertexPosition.z,
-            //    iMeshCluster,
-            //    iLODLevel,
-            //    vertexPosition.x,
-            //    vertexPosition.y,
-            //    vertexPosition.z,
-            //    fShortestDistance);
-
-            VertexMappingInfo mappingInfo;
-            mappingInfo.miCluster = iBestUpperMeshCluster;
-            mappingInfo.miClusterGroup = iBestUpperMeshClusterGroup;
-            mappingInfo.miLODLevel = iUpperLODLevel;
-            mappingInfo.mPosition = bestUpperClusterVertexPosition;
-            mappingInfo.miClusterVertexID = iBestUpperClusterVertexID;
-            mappingInfo.mfDistance = fShortestDistance;
-
-            aVertexMapping[std::make_pair(iMeshCluster, iVertex)] = mappingInfo;
-
-            if(fShortestDistance > fMaxVertexPositionDistance)
+            // get closest vertex positions from the upper clusters (given upper LOD)
+            for(uint32_t iVertex = 0; iVertex < static_cast<uint32_t>(meshCluster.miNumVertexPositions); iVertex++)
             {
-                fMaxVertexPositionDistance = fShortestDistance;
-
-                maxErrorPositions = std::make_pair(mappingInfo.mPosition, vertexPosition);
-            }
+                auto const& vertexPosition = aClusterVertexPositions[iVertex];
+
+                uint32_t iClosestUpperVertex = UINT32_MAX;
+                float fShortestDistance = FLT_MAX;
+                uint32_t iNumFound = getNearestPointsSquared(
+                    &iClosestUpperVertex,
+                    &fShortestDistance,
+                    upperVertexTree,
+                    vertexPosition,
+                    1);
+                assert(iNumFound == 1);
+                UpperVertexInfo const& upperVertexInfo = aUpperVertexInfo[iClosestUpperVertex];
+                float3 const& bestUpperClusterVertexPosition = upperVertexTree.maPositions[iClosestUpperVertex];
+
+                // verify
+                float3 const* aCheckClusterVertexPositions = reinterpret_cast<float3 const*>(vertexPositionBuffer.data() + apTotalMeshClusters[upperVertexInfo.miCluster]->miVertexPositionStartArrayAddress * sizeof(float3));
+                auto const& checkVertexPosition = aCheckClusterVertexPositions[upperVertexInfo.miClusterVertexID];
+                float fCheckDistance = length(checkVertexPosition - bestUpperClusterVertexPosition);
+                assert(fCheckDistance <= 1.0e-5f);
+
+                VertexMappingInfo& mappingInfo = result.maVertexMapping[iVertex];
+                mappingInfo.miCluster = upperVertexInfo.miCluster;
+                mappingInfo.miClusterGroup = upperVertexInfo.miClusterGroup;
+                mappingInfo.miLODLevel = iUpperLODLevel;
+                mappingInfo.mPosition = bestUpperClusterVertexPosition;
+                mappingInfo.miClusterVertexID = upperVertexInfo.miClusterVertexID;
+                mappingInfo.mfDistance = fShortestDistance;
+
+                if(fShortestDistance > result.mfMaxVertexPositionDistance)
+                {
+                    result.mfMaxVertexPositionDistance = fShortestDistance;
+                    result.mMaxErrorPositions = std::make_pair(mappingInfo.mPosition, vertexPosition);
+                }
 
-        }   // for vertex = 0 to num vertices in cluster
+            }   // for vertex = 0 to num vertices in cluster
+        });
 
+    for(uint32_t iMeshCluster = 0; iMeshCluster < iNumMeshClusters; iMeshCluster++)
+    {
+        ClusterResult const& result = aClusterResults[iMeshCluster];
+        for(uint32_t iVertex = 0; iVertex < static_cast<uint32_t>(result.maVertexMapping.size()); iVertex++)
         {
-            std::lock_guard<std::mutex> lock(sMutex);
-            afMaxClusterDistances.push_back(fMaxVertexPositionDistance);
-            aMaxErrorPositions.push_back(maxErrorPositions);
+            aVertexMapping[std::make_pair(iMeshCluster, iVertex)] = result.maVertexMapping[iVertex];
         }
 
+        afMaxClusterDistances.push_back(result.mfMaxVertexPositionDistance);
+        aMaxErrorPositions.push_back(result.mMaxErrorPositions);
+
     }   // for cluster = 0 to num clusters
 
     auto end = std::chrono::high_resolution_clock::now();
     uint64_t iSeconds = std::chrono::duration_cast<std::chrono::seconds>(end - start).count();
-    DEBUG_PRINTF("took total %lld seconds to get lod distance error between lod %d and lod %d\n", iSeconds, iLODLevel, iUpperLODLevel);
-}
\ No newline at end of file
+    DEBUG_PRINTF("took total %" PRIu64 " seconds to get lod distance error between lod %d and lod %d\n", iSeconds, iLODLevel, iUpperLODLevel);
+}